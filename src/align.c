@@ -27,6 +27,7 @@
 #include "pjl_config.h"                 /* must go first */
 #include "cc_map.h"
 #include "common.h"
+#include "line_reader.h"
 #include "options.h"
 #include "util.h"
 
@@ -39,6 +40,7 @@
 #include <stddef.h>                     /* for size_t */
 #include <stdio.h>
 #include <string.h>                     /* for str...() */
+#include <sysexits.h>
 
 /// @endcond
 
@@ -145,19 +147,36 @@ static bool is_eol_comment( char const *s ) {
 
 ////////// extern functions ///////////////////////////////////////////////////
 
-void align_eol_comments( char input_buf[const] ) {
+void align_eol_comments( char **pline, size_t *pline_cap,
+                         line_reader_t *lr ) {
+  assert( pline != NULL );
+  assert( pline_cap != NULL );
+
+  char       *output_buf = NULL;
+  size_t      output_cap = 0;
+  size_t      line_len = strlen( *pline );
+
   do {
+    char const *const input_buf = *pline;
     size_t      col = 0;
     bool        is_backslash = false;   // got a backslash?
     bool        is_word = false;        // got a word character?
     ssize_t     last_nonws_col = -1;    // last non-whitespace column
     ssize_t     last_nonws_len = -1;    // length to non-whitespace character
     char        last_ws = ' ';          // last whitespace encountered
-    line_buf_t  output_buf;
     size_t      output_len = 0;
     char        quote = '\0';           // between quotes?
     unsigned    token_count = 0;
 
+    //
+    // Every input character is copied at most once, at most opt_align_column
+    // characters are inserted to align the comment, and the end-of-line is
+    // appended so the line is written with a single call.
+    //
+    str_reserve( &output_buf, &output_cap,
+      line_len + opt_align_column + 2/*\r\n*/ + 1/*\0*/
+    );
+
     for ( char const *s = input_buf; *s != '\0' && !is_eol( *s ); ++s ) {
       bool const was_backslash = true_clear( &is_backslash );
       bool const was_word = true_clear( &is_word );
@@ -291,9 +310,13 @@ void align_eol_comments( char input_buf[const] ) {
     } // for
 
 print_line:
-    output_buf[ output_len ] = '\0';
-    PRINTF( "%s%s", output_buf, eol() );
-  } while ( check_readline( input_buf, stdin ) );
+    output_len += strcpy_len( output_buf + output_len, eol() );
+    PERROR_EXIT_IF(
+      fwrite( output_buf, 1, output_len, stdout ) < output_len, EX_IOERR
+    );
+  } while ( (line_len = check_readline( pline, pline_cap, lr )) > 0 );
+
+  free( output_buf );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
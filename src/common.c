@@ -33,16 +33,23 @@
 
 // standard
 #include <assert.h>
+#include <stdint.h>                     /* for SIZE_MAX */
+#include <string.h>                     /* for memcpy() */
 
 /// @endcond
 
 ////////// extern functions ///////////////////////////////////////////////////
 
-size_t check_readline( line_buf_t line, FILE *ffrom ) {
-  assert( ffrom != NULL );
-  size_t size = sizeof( line_buf_t );
-  if ( fgetsz( line, &size, ffrom ) == NULL )
-    FERROR( ffrom );
+size_t check_readline( char **pline, size_t *pcap, line_reader_t *lr ) {
+  assert( lr != NULL );
+  size_t size;
+  char const *const buf = line_reader_getline( lr, SIZE_MAX, &size );
+  if ( buf == NULL )
+    size = 0;
+  str_reserve( pline, pcap, size + 1/*\0*/ );
+  if ( size > 0 )
+    memcpy( *pline, buf, size );
+  (*pline)[ size ] = '\0';
   return size;
 }
 
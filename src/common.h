@@ -29,6 +29,7 @@
 
 // local
 #include "pjl_config.h"                 /* must go first */
+#include "line_reader.h"
 #include "options.h"                    /* for opt_eol */
 
 /// @cond DOXYGEN_IGNORE
@@ -48,7 +49,7 @@ _GL_INLINE_HEADER_BEGIN
 
 #define CONF_FILE_NAME_DEFAULT    "." PACKAGE "rc"
 #define EOS_SPACES_DEFAULT        2     /* # spaces after end-of-sentence */
-#define LINE_BUF_SIZE             8192  /* hopefully, no one will exceed this */
+#define LINE_BUF_SIZE             8192  /* initial/prototype buffer size */
 #define LINE_WIDTH_DEFAULT        80    /* wrap text to this line width */
 #define LINE_WIDTH_MINIMUM        1
 #define NEWLINES_DELIMIT_DEFAULT  2     /* # newlines that delimit a para */
@@ -79,7 +80,8 @@ _GL_INLINE_HEADER_BEGIN
 #define WRAP_LICENSE_URL          "https://gnu.org/licenses/gpl.html"
 
 /**
- * Line buffer.
+ * Fixed-size buffer for short strings derived from a line, e.g., a prototype
+ * or comment prefix.  Lines themselves are read into growable buffers.
  */
 typedef char line_buf_t[ LINE_BUF_SIZE ];
 
@@ -232,29 +234,48 @@ size_t char_width( char c, size_t width ) {
 }
 
 /**
- * Reads a newline-terminated line from \a ffrom.
- * If reading fails, prints an error message and exits.
+ * Reads a newline-terminated line of any length from \a lr into \a *pline,
+ * growing it as needed, and null-terminates it.
  *
- * @param line The line buffer to read into.
- * @param ffrom The `FILE` to read from.
- * @return Returns the number of characters read.
+ * @param pline A pointer to the line buffer to read into.  It may point to
+ * NULL initially.
+ * @param pcap A pointer to the capacity of \a *pline.
+ * @param lr The \ref line_reader to read from.
+ * @return Returns the number of characters read or 0 on EOF.
+ *
+ * @sa str_reserve()
  */
 NODISCARD
-size_t check_readline( line_buf_t line, FILE *ffrom );
+size_t check_readline( char **pline, size_t *pcap, line_reader_t *lr );
 
 /**
  * Cleans up all data and closes files.
  */
 void common_cleanup( void );
 
+/**
+ * Gets the end-of-line string to use for \a eol.
+ *
+ * @param eol The \ref eol to get the end-of-line string for.
+ * @return Returns said end-of-line string.
+ *
+ * @sa eol()
+ */
+NODISCARD W_COMMON_H_INLINE
+char const* eol_str( eol_t eol ) {
+  return (char const*)"\r\n" + (eol != EOL_WINDOWS);
+}
+
 /**
  * Gets the end-of-line string to use.
  *
  * @return Returns said end-of-line string.
+ *
+ * @sa eol_str()
  */
 NODISCARD W_COMMON_H_INLINE
 char const* eol( void ) {
-  return (char const*)"\r\n" + (opt_eol != EOL_WINDOWS);
+  return eol_str( opt_eol );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1438 @@
+/*
+**      wrap -- text reformatter
+**      src/dfa.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines a small built-in regular expression engine: a POSIX extended
+ * regular expression is parsed into an abstract syntax tree that's compiled
+ * into a Thompson NFA whose sets of states are then turned into DFA states as
+ * input reaches them.
+ *
+ * @remarks Assertions (`^`, `$`, and word boundaries) depend on the
+ * characters around a position, so a DFA state also records whether it's at
+ * the beginning of the string and whether the previous character was a word
+ * character; the character about to be consumed (or the end of the string)
+ * supplies the rest.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "dfa.h"
+#include "unicode.h"
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <assert.h>
+#include <limits.h>                     /* for UINT_MAX */
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint32_t */
+#include <stdlib.h>                     /* for qsort(3) */
+#include <string.h>
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Maximum repetition count in a `{m,n}` interval.
+#define DFA_DUP_MAX               255u
+
+/// Maximum number of NFA states.
+#define DFA_NFA_MAX               (1u << 20)
+
+/// Number of DFA states at which all of them are thrown away and rebuilt.
+#define DFA_STATES_MAX            4096u
+
+/// No node or NFA state.
+#define DFA_NONE                  UINT32_MAX
+
+/**
+ * Kinds of assertion.
+ */
+enum dfa_assert {
+  DFA_ASSERT_BEGIN,                     ///< `^` or `` \` ``.
+  DFA_ASSERT_END,                       ///< `$` or `\'`.
+  DFA_ASSERT_WORD_B,                    ///< `\b`.
+  DFA_ASSERT_NOT_WORD_B,                ///< `\B`.
+  DFA_ASSERT_WORD_BEGIN,                ///< `\<`.
+  DFA_ASSERT_WORD_END                   ///< `\>`.
+};
+
+/**
+ * Context in which an assertion is evaluated.
+ */
+enum dfa_ctx {
+  DFA_CTX_BEGIN      = 1u << 0,          ///< At beginning of string.
+  DFA_CTX_PREV_WORD  = 1u << 1,          ///< Previous character is a word one.
+  DFA_CTX_UNANCHORED = 1u << 2,          ///< A match may start anywhere.
+  DFA_CTX_NEXT_WORD  = 1u << 3,          ///< Next character is a word one.
+  DFA_CTX_END        = 1u << 4          ///< At end of string.
+};
+
+/**
+ * What follows a position: indexes \ref dfa_state::accepts.
+ */
+enum dfa_next {
+  DFA_NEXT_NON_WORD,                    ///< A non-word character.
+  DFA_NEXT_WORD,                        ///< A word character.
+  DFA_NEXT_END                          ///< The end of the string.
+};
+
+/**
+ * Classes of non-ASCII code-points a character set may contain.
+ */
+enum dfa_cset_prop {
+  DFA_CSET_ALPHA    = 1u << 0,          ///< Letters.
+  DFA_CSET_CNTRL    = 1u << 1,          ///< Control characters.
+  DFA_CSET_GRAPH    = 1u << 2,          ///< Neither space nor control.
+  DFA_CSET_PUNCT    = 1u << 3,          ///< Graphic but not word.
+  DFA_CSET_SPACE    = 1u << 4,          ///< Whitespace.
+  DFA_CSET_WORD     = 1u << 5           ///< Letters and digits.
+};
+
+/**
+ * A set of characters.
+ */
+struct dfa_cset {
+  uint32_t    ascii[4];                 ///< Bitmap of ASCII characters.
+  char32_t  (*ranges)[2];               ///< Non-ASCII inclusive ranges.
+  size_t      ranges_len;               ///< Number of \ref ranges.
+  unsigned    props;                    ///< Bitwise-or of \ref dfa_cset_prop.
+  bool        negated;                  ///< Is set negated?
+};
+typedef struct dfa_cset dfa_cset_t;
+
+/**
+ * Kinds of NFA state.
+ */
+enum dfa_nfa_kind {
+  DFA_NFA_ASSERT,                       ///< Assertion.
+  DFA_NFA_CSET,                         ///< Consumes a character in a set.
+  DFA_NFA_MATCH,                        ///< Match.
+  DFA_NFA_SPLIT                         ///< Epsilon to both outs.
+};
+
+/**
+ * An NFA state.
+ */
+struct dfa_nfa_state {
+  uint8_t     kind;                     ///< The \ref dfa_nfa_kind.
+  uint8_t     assertion;                ///< The \ref dfa_assert, if any.
+  uint32_t    cset;                     ///< Index of character set, if any.
+  uint32_t    out[2];                   ///< Next NFA states.
+};
+typedef struct dfa_nfa_state dfa_nfa_state_t;
+
+/**
+ * A DFA state: a set of NFA states reached after consuming some character
+ * (before taking the epsilon closure) plus the context it was reached in.
+ */
+struct dfa_state {
+  struct dfa_state *next[128];          ///< Transitions on ASCII, if built.
+  uint32_t          hash;               ///< Hash of \ref ctx and \ref set.
+  uint32_t          set_len;            ///< Number of NFA states.
+  uint8_t           ctx;                ///< Bitwise-or of \ref dfa_ctx.
+  int8_t            accepts[3];         ///< Indexed by \ref dfa_next.
+  uint32_t          set[];              ///< Sorted NFA state indices.
+};
+typedef struct dfa_state dfa_state_t;
+
+/**
+ * Kinds of abstract syntax tree node.
+ */
+enum dfa_node_kind {
+  DFA_NODE_ALT,                         ///< `left|right`
+  DFA_NODE_ASSERT,                      ///< Assertion.
+  DFA_NODE_CAT,                         ///< `left right`
+  DFA_NODE_CSET,                        ///< Character set.
+  DFA_NODE_EMPTY,                       ///< Empty expression.
+  DFA_NODE_REPEAT                       ///< `left{min,max}`
+};
+
+/**
+ * An abstract syntax tree node.
+ */
+struct dfa_node {
+  uint8_t     kind;                     ///< The \ref dfa_node_kind.
+  uint8_t     assertion;                ///< The \ref dfa_assert, if any.
+  uint32_t    left;                     ///< Left or only child.
+  uint32_t    right;                    ///< Right child.
+  uint32_t    cset;                     ///< Index of character set.
+  unsigned    min;                      ///< Minimum repetitions.
+  unsigned    max;                      ///< Maximum repetitions or UINT_MAX.
+};
+typedef struct dfa_node dfa_node_t;
+
+/**
+ * Regular expression parser state.
+ */
+struct dfa_parser {
+  dfa_t        *dfa;                    ///< The dfa_t being compiled.
+  char const   *p;                      ///< Current position in pattern.
+  dfa_node_t   *nodes;                  ///< Abstract syntax tree nodes.
+  uint32_t      nodes_len;              ///< Number of nodes.
+  uint32_t      nodes_cap;              ///< Capacity of nodes.
+  uint32_t      csets_cap;              ///< Capacity of dfa_t::csets.
+  uint32_t      nfa_cap;                ///< Capacity of dfa_t::nfa.
+  unsigned      depth;                  ///< Parenthesis depth.
+  int           err;                    ///< The \ref dfa_err, if any.
+};
+typedef struct dfa_parser dfa_parser_t;
+
+// local functions
+NODISCARD
+static bool         assert_holds( unsigned, unsigned );
+static bool         cset_add_class( dfa_cset_t*, char const*, size_t );
+static void         cset_add_range( dfa_cset_t*, char32_t, char32_t );
+NODISCARD
+static bool         cset_has( dfa_cset_t const*, char32_t );
+static void         dfa_cache_init( dfa_t const*, dfa_cache_t* );
+NODISCARD
+static bool         dfa_scan( dfa_t const*, dfa_cache_t*, char const*,
+                              char const*, bool, char const** );
+NODISCARD
+static bool         dfa_state_accepts( dfa_t const*, dfa_cache_t*,
+                                       dfa_state_t*, unsigned );
+NODISCARD
+static dfa_state_t* dfa_state_get( dfa_t const*, dfa_cache_t*,
+                                   uint32_t const*, uint32_t, unsigned,
+                                   bool* );
+NODISCARD
+static dfa_state_t* dfa_state_next( dfa_t const*, dfa_cache_t*, dfa_state_t*,
+                                    char32_t );
+static void         dfa_states_free( dfa_cache_t* );
+NODISCARD
+static uint32_t     nfa_build( dfa_parser_t*, uint32_t, uint32_t );
+NODISCARD
+static bool         nfa_closure( dfa_t const*, dfa_cache_t*, uint32_t const*,
+                                 uint32_t, unsigned, uint32_t* );
+NODISCARD
+static int          nfa_index_cmp( void const*, void const* );
+NODISCARD
+static uint32_t     nfa_new( dfa_parser_t*, unsigned, uint32_t, uint32_t );
+NODISCARD
+static bool         node_is_anchored( dfa_parser_t const*, uint32_t );
+NODISCARD
+static unsigned     nodes_ctx_mask( dfa_parser_t const* );
+NODISCARD
+static uint32_t     parse_alt( dfa_parser_t* );
+NODISCARD
+static uint32_t     parse_atom( dfa_parser_t* );
+NODISCARD
+static uint32_t     parse_bracket( dfa_parser_t* );
+NODISCARD
+static char32_t     parse_bracket_char( dfa_parser_t* );
+NODISCARD
+static uint32_t     parse_cat( dfa_parser_t* );
+NODISCARD
+static uint32_t     parse_cset_new( dfa_parser_t* );
+static void         parse_interval( dfa_parser_t*, unsigned*, unsigned* );
+NODISCARD
+static uint32_t     parse_node_cset( dfa_parser_t*, uint32_t* );
+NODISCARD
+static uint32_t     parse_node_new( dfa_parser_t*, unsigned, uint32_t, uint32_t );
+NODISCARD
+static uint32_t     parse_repeat( dfa_parser_t* );
+
+////////// inline functions ///////////////////////////////////////////////////
+
+/**
+ * Adds an ASCII character to a character set.
+ *
+ * @param cs The dfa_cset to add to.
+ * @param c The ASCII character to add.
+ */
+static inline void cset_add_ascii( dfa_cset_t *cs, unsigned c ) {
+  assert( c < 128 );
+  cs->ascii[ c >> 5 ] |= 1u << (c & 31);
+}
+
+
+/**
+ * Gets the number of bytes of the UTF-8 character at \a s.
+ *
+ * @param s A pointer to the character; must not be at the terminating null.
+ * @return Returns said number of bytes or 0 if the byte sequence is invalid.
+ */
+NODISCARD
+static inline size_t dfa_char_len( char const *s ) {
+  size_t const len = utf8_len( *s );
+  for ( size_t i = 1; i < len; ++i ) {
+    if ( !utf8_is_cont( s[i] ) )
+      return 0;
+  } // for
+  return len;
+}
+
+
+/**
+ * Decodes the UTF-8 character at \a s.
+ *
+ * @param s A pointer to the character to decode; must not be at the
+ * terminating null.
+ * @param plen A pointer to receive the number of bytes of the character.  An
+ * invalid byte sequence is taken to be one byte long.
+ * @return Returns said character or \ref CP_INVALID.
+ */
+NODISCARD
+static inline char32_t dfa_decode( char const *s, size_t *plen ) {
+  if ( cp_is_ascii( STATIC_CAST( unsigned char, *s ) ) ) {
+    *plen = 1;
+    return STATIC_CAST( unsigned char, *s );
+  }
+  size_t const len = dfa_char_len( s );
+  if ( len == 0 ) {
+    *plen = 1;
+    return CP_INVALID;
+  }
+  *plen = len;
+  return utf8_decode( s );
+}
+
+
+/**
+ * Gets what \a cp is as what follows a position.
+ *
+ * @param cp The code-point to check.
+ * @return Returns said \ref dfa_next.
+ */
+NODISCARD
+static inline unsigned dfa_next_of( char32_t cp ) {
+  return cp_is_word_char( cp ) ? DFA_NEXT_WORD : DFA_NEXT_NON_WORD;
+}
+
+/**
+ * Gets a new mark for visiting NFA states.
+ *
+ * @param cache The dfa_cache_t to use.
+ * @return Returns said mark.
+ */
+NODISCARD
+static inline uint32_t nfa_mark_next( dfa_cache_t *cache ) {
+  if ( ++cache->mark == 0 ) {
+    memset( cache->marks, 0, cache->nfa_len * sizeof *cache->marks );
+    cache->mark = 1;
+  }
+  return cache->mark;
+}
+
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Checks whether an assertion holds in a context.
+ *
+ * @param assertion The \ref dfa_assert to check.
+ * @param ctx The bitwise-or of \ref dfa_ctx.
+ * @return Returns `true` only if it holds.
+ */
+NODISCARD
+static bool assert_holds( unsigned assertion, unsigned ctx ) {
+  bool const prev_word = (ctx & DFA_CTX_PREV_WORD) != 0;
+  bool const next_word = (ctx & DFA_CTX_NEXT_WORD) != 0;
+  switch ( assertion ) {
+    case DFA_ASSERT_BEGIN:
+      return (ctx & DFA_CTX_BEGIN) != 0;
+    case DFA_ASSERT_END:
+      return (ctx & DFA_CTX_END) != 0;
+    case DFA_ASSERT_WORD_B:
+      return prev_word != next_word;
+    case DFA_ASSERT_NOT_WORD_B:
+      return prev_word == next_word;
+    case DFA_ASSERT_WORD_BEGIN:
+      return !prev_word && next_word;
+    case DFA_ASSERT_WORD_END:
+      return prev_word && !next_word;
+  } // switch
+  UNEXPECTED_INT_VALUE( assertion );
+}
+
+
+/**
+ * Adds a named POSIX character class to a character set.
+ *
+ * @param cs The dfa_cset to add to.
+ * @param name The name of the class, e.g., `alpha`.
+ * @param name_len The length of \a name.
+ * @return Returns `true` only if \a name is a valid class name.
+ */
+static bool cset_add_class( dfa_cset_t *cs, char const *name,
+                            size_t name_len ) {
+  static struct {
+    char const *name;
+    unsigned    props;
+  } const CLASSES[] = {
+    { "alnum",  DFA_CSET_WORD   },
+    { "alpha",  DFA_CSET_ALPHA  },
+    { "blank",  DFA_CSET_SPACE  },
+    { "cntrl",  DFA_CSET_CNTRL  },
+    { "digit",  0               },
+    { "graph",  DFA_CSET_GRAPH  },
+    { "lower",  DFA_CSET_ALPHA  },
+    { "print",  DFA_CSET_GRAPH | DFA_CSET_SPACE },
+    { "punct",  DFA_CSET_PUNCT  },
+    { "space",  DFA_CSET_SPACE  },
+    { "upper",  DFA_CSET_ALPHA  },
+    { "xdigit", 0               },
+  };
+
+  for ( size_t i = 0; i < ARRAY_SIZE( CLASSES ); ++i ) {
+    if ( strlen( CLASSES[i].name ) != name_len ||
+         strncmp( CLASSES[i].name, name, name_len ) != 0 ) {
+      continue;
+    }
+    for ( unsigned c = 0; c < 128; ++c ) {
+      bool const is_upper = c >= 'A' && c <= 'Z';
+      bool const is_lower = c >= 'a' && c <= 'z';
+      bool const is_digit = c >= '0' && c <= '9';
+      bool const is_alnum = is_upper || is_lower || is_digit;
+      bool const is_graph = c > ' ' && c < 0x7F;
+      bool has;
+      switch ( name[0] ) {
+        case 'a': has = name[2] == 'n' ? is_alnum : is_upper || is_lower;
+                  break;
+        case 'b': has = c == ' ' || c == '\t';                      break;
+        case 'c': has = c < ' ' || c == 0x7F;                       break;
+        case 'd': has = is_digit;                                   break;
+        case 'g': has = is_graph;                                   break;
+        case 'l': has = is_lower;                                   break;
+        case 'p': has = name[1] == 'r' ? is_graph || c == ' ' :
+                        is_graph && !is_alnum;
+                  break;
+        case 's': has = c == ' ' || (c >= '\t' && c <= '\r');       break;
+        case 'u': has = is_upper;                                   break;
+        case 'x': has = is_digit || (c >= 'A' && c <= 'F') ||
+                        (c >= 'a' && c <= 'f');
+                  break;
+        default : UNEXPECTED_INT_VALUE( name[0] );
+      } // switch
+      if ( has )
+        cset_add_ascii( cs, c );
+    } // for
+    cs->props |= CLASSES[i].props;
+    return true;
+  } // for
+
+  return false;
+}
+
+
+/**
+ * Adds a range of characters to a character set.
+ *
+ * @param cs The dfa_cset to add to.
+ * @param lo The first character of the range.
+ * @param hi The last character of the range.
+ */
+static void cset_add_range( dfa_cset_t *cs, char32_t lo, char32_t hi ) {
+  for ( ; lo <= hi && lo < 128; ++lo )
+    cset_add_ascii( cs, lo );
+  if ( lo > hi )
+    return;
+  REALLOC( cs->ranges, char32_t[2], cs->ranges_len + 1 );
+  cs->ranges[ cs->ranges_len ][0] = lo;
+  cs->ranges[ cs->ranges_len ][1] = hi;
+  ++cs->ranges_len;
+}
+
+
+/**
+ * Checks whether a character set contains a character.
+ *
+ * @param cs The dfa_cset to check.
+ * @param cp The code-point to check for.
+ * @return Returns `true` only if it does.
+ */
+NODISCARD
+static bool cset_has( dfa_cset_t const *cs, char32_t cp ) {
+  bool has = false;
+  if ( cp < 128 ) {
+    has = (cs->ascii[ cp >> 5 ] >> (cp & 31)) & 1;
+  }
+  else if ( cp != CP_INVALID ) {
+    if ( cs->props != 0 ) {
+      unsigned const p = cp_props( cp );
+      bool const is_graph = (p & (CP_PROP_CONTROL | CP_PROP_SPACE)) == 0;
+      has = ((cs->props & DFA_CSET_ALPHA) != 0 && (p & CP_PROP_ALPHA) != 0)
+         || ((cs->props & DFA_CSET_CNTRL) != 0 && (p & CP_PROP_CONTROL) != 0)
+         || ((cs->props & DFA_CSET_GRAPH) != 0 && is_graph)
+         || ((cs->props & DFA_CSET_PUNCT) != 0 && is_graph &&
+             (p & CP_PROP_WORD) == 0)
+         || ((cs->props & DFA_CSET_SPACE) != 0 && (p & CP_PROP_SPACE) != 0)
+         || ((cs->props & DFA_CSET_WORD) != 0 && (p & CP_PROP_WORD) != 0);
+    }
+    for ( size_t i = 0; !has && i < cs->ranges_len; ++i )
+      has = cp >= cs->ranges[i][0] && cp <= cs->ranges[i][1];
+  }
+  return has != cs->negated;
+}
+
+
+/**
+ * Allocates the hash table of DFA states and the scratch buffers of \a cache
+ * for \a dfa.
+ *
+ * @param dfa The dfa_t \a cache is to be used with.
+ * @param cache The zero-initialized dfa_cache_t to initialize.
+ */
+static void dfa_cache_init( dfa_t const *dfa, dfa_cache_t *cache ) {
+  cache->nfa_len = dfa->nfa_len;
+  cache->marks = MALLOC( uint32_t, dfa->nfa_len );
+  memset( cache->marks, 0, dfa->nfa_len * sizeof *cache->marks );
+  cache->closure_buf = MALLOC( uint32_t, dfa->nfa_len );
+  cache->step_buf = MALLOC( uint32_t, dfa->nfa_len );
+  cache->stack_buf = MALLOC( uint32_t, dfa->nfa_len );
+  cache->states_cap = DFA_STATES_MAX * 2;
+  cache->states = MALLOC( dfa_state_t*, cache->states_cap );
+  memset( cache->states, 0, cache->states_cap * sizeof *cache->states );
+}
+
+
+/**
+ * Scans \a s starting at \a p for the end of a match.
+ *
+ * @param dfa The dfa_t to use.
+ * @param cache The dfa_cache_t to use.
+ * @param s The null-terminated UTF-8 string being matched.
+ * @param p The position within \a s to start at.
+ * @param unanchored If `true`, a match may start at or after \a p and the
+ * earliest end of any match is found; if `false`, a match must start at \a p
+ * and the end of the longest match is found.
+ * @param pend A pointer to receive said end -- set only if there is a match.
+ * @return Returns `true` only if there is a match.
+ */
+NODISCARD
+static bool dfa_scan( dfa_t const *dfa, dfa_cache_t *cache, char const *s,
+                      char const *p, bool unanchored, char const **pend ) {
+  unsigned ctx = unanchored ? DFA_CTX_UNANCHORED : 0;
+  if ( p == s ) {
+    ctx |= DFA_CTX_BEGIN;
+  }
+  else {
+    char const *const prev = utf8_rsync( s, p - 1 );
+    size_t len;
+    if ( prev != NULL && cp_is_word_char( dfa_decode( prev, &len ) ) )
+      ctx |= DFA_CTX_PREV_WORD;
+  }
+
+  bool flushed;
+  dfa_state_t *state =
+    dfa_state_get( dfa, cache, &dfa->nfa_start, 1, ctx, &flushed );
+  bool matched = false;
+
+  for (;;) {
+    char32_t cp = 0;
+    size_t len = 0;
+    unsigned next = DFA_NEXT_END;
+    if ( *p != '\0' ) {
+      cp = dfa_decode( p, &len );
+      next = dfa_next_of( cp );
+    }
+    if ( dfa_state_accepts( dfa, cache, state, next ) ) {
+      *pend = p;
+      matched = true;
+      if ( unanchored )
+        break;
+    }
+    if ( *p == '\0' )
+      break;
+    state = dfa_state_next( dfa, cache, state, cp );
+    if ( state->set_len == 0 )
+      break;
+    p += len;
+  } // for
+
+  return matched;
+}
+
+
+/**
+ * Gets whether a DFA state accepts, i.e., whether a match can end here.
+ *
+ * @param dfa The dfa_t to use.
+ * @param cache The dfa_cache_t to use.
+ * @param state The DFA state to check.
+ * @param next What follows: the \ref dfa_next.
+ * @return Returns `true` only if it does.
+ */
+NODISCARD
+static bool dfa_state_accepts( dfa_t const *dfa, dfa_cache_t *cache,
+                               dfa_state_t *state, unsigned next ) {
+  if ( state->accepts[ next ] < 0 ) {
+    unsigned ctx = state->ctx;
+    if ( next == DFA_NEXT_WORD )
+      ctx |= DFA_CTX_NEXT_WORD;
+    else if ( next == DFA_NEXT_END )
+      ctx |= DFA_CTX_END;
+    uint32_t closure_len;
+    bool const matched =
+      nfa_closure( dfa, cache, state->set, state->set_len, ctx, &closure_len );
+    state->accepts[ next ] = matched ? 1 : 0;
+  }
+  return state->accepts[ next ] != 0;
+}
+
+
+/**
+ * Gets the DFA state for a set of NFA states in a context, creating it if
+ * necessary.
+ *
+ * @param dfa The dfa_t to use.
+ * @param cache The dfa_cache_t to get the state from.
+ * @param set The sorted set of NFA states.
+ * @param set_len The number of NFA states in \a set.
+ * @param ctx The bitwise-or of \ref dfa_ctx.
+ * @param pflushed A pointer to receive whether all existing DFA states were
+ * freed to make room.
+ * @return Returns said state.
+ */
+NODISCARD
+static dfa_state_t* dfa_state_get( dfa_t const *dfa, dfa_cache_t *cache,
+                                   uint32_t const *set, uint32_t set_len,
+                                   unsigned ctx, bool *pflushed ) {
+  ctx &= dfa->flags_mask;
+  uint32_t hash = 2166136261u ^ ctx;    // FNV-1a
+  for ( uint32_t i = 0; i < set_len; ++i )
+    hash = (hash ^ set[i]) * 16777619u;
+
+  *pflushed = false;
+  size_t const mask = cache->states_cap - 1;
+  size_t i = hash & mask;
+  for ( dfa_state_t *state; (state = cache->states[i]) != NULL;
+        i = (i + 1) & mask ) {
+    if ( state->hash == hash && state->ctx == ctx &&
+         state->set_len == set_len &&
+         memcmp( state->set, set, set_len * sizeof *set ) == 0 ) {
+      return state;
+    }
+  } // for
+
+  if ( cache->states_len >= DFA_STATES_MAX ) {
+    dfa_states_free( cache );
+    *pflushed = true;
+    i = hash & mask;
+  }
+
+  dfa_state_t *const state =
+    check_realloc( NULL, sizeof( dfa_state_t ) + set_len * sizeof *set );
+  memset( state->next, 0, sizeof state->next );
+  state->hash = hash;
+  state->set_len = set_len;
+  state->ctx = STATIC_CAST( uint8_t, ctx );
+  memset( state->accepts, -1, sizeof state->accepts );
+  memcpy( state->set, set, set_len * sizeof *set );
+  cache->states[i] = state;
+  ++cache->states_len;
+  return state;
+}
+
+
+/**
+ * Gets the DFA state reached from \a state by consuming \a cp.
+ *
+ * @param dfa The dfa_t to use.
+ * @param cache The dfa_cache_t to use.
+ * @param state The DFA state to transition from.
+ * @param cp The code-point to consume.
+ * @return Returns said state.
+ */
+NODISCARD
+static dfa_state_t* dfa_state_next( dfa_t const *dfa, dfa_cache_t *cache,
+                                    dfa_state_t *state, char32_t cp ) {
+  if ( cp < 128 && state->next[ cp ] != NULL )
+    return state->next[ cp ];
+
+  bool const is_word = cp_is_word_char( cp );
+  unsigned ctx = state->ctx;
+  if ( is_word )
+    ctx |= DFA_CTX_NEXT_WORD;
+  uint32_t closure_len;
+  bool const matched =
+    nfa_closure( dfa, cache, state->set, state->set_len, ctx, &closure_len );
+  state->accepts[ dfa_next_of( cp ) ] = matched ? 1 : 0;
+
+  uint32_t const mark = nfa_mark_next( cache );
+  uint32_t step_len = 0;
+  for ( uint32_t i = 0; i < closure_len; ++i ) {
+    dfa_nfa_state_t const *const ns = &dfa->nfa[ cache->closure_buf[i] ];
+    if ( cset_has( &dfa->csets[ ns->cset ], cp ) &&
+         cache->marks[ ns->out[0] ] != mark ) {
+      cache->marks[ ns->out[0] ] = mark;
+      cache->step_buf[ step_len++ ] = ns->out[0];
+    }
+  } // for
+  if ( (state->ctx & DFA_CTX_UNANCHORED) != 0 &&
+       cache->marks[ dfa->nfa_start ] != mark ) {
+    cache->step_buf[ step_len++ ] = dfa->nfa_start;
+  }
+  qsort( cache->step_buf, step_len, sizeof *cache->step_buf, &nfa_index_cmp );
+
+  ctx = state->ctx & DFA_CTX_UNANCHORED;
+  if ( is_word )
+    ctx |= DFA_CTX_PREV_WORD;
+  bool flushed;
+  dfa_state_t *const next =
+    dfa_state_get( dfa, cache, cache->step_buf, step_len, ctx, &flushed );
+  if ( cp < 128 && !flushed )
+    state->next[ cp ] = next;
+  return next;
+}
+
+
+/**
+ * Frees all DFA states, e.g., when there are too many of them.
+ *
+ * @param cache The dfa_cache_t to free the DFA states of.
+ */
+static void dfa_states_free( dfa_cache_t *cache ) {
+  for ( size_t i = 0; i < cache->states_cap; ++i ) {
+    FREE( cache->states[i] );
+    cache->states[i] = NULL;
+  } // for
+  cache->states_len = 0;
+}
+
+
+/**
+ * Builds the NFA states for an abstract syntax tree node.
+ *
+ * @remarks The states are built back to front: given the state to continue
+ * to after matching \a node, returns the state at which to start matching it,
+ * so repetitions can simply build their node again.
+ *
+ * @param pp The dfa_parser to use.
+ * @param node_i The index of the node to build.
+ * @param next The index of the NFA state to continue to.
+ * @return Returns the index of the first NFA state.
+ */
+NODISCARD
+static uint32_t nfa_build( dfa_parser_t *pp, uint32_t node_i, uint32_t next ) {
+  if ( pp->err != DFA_OK )
+    return next;
+  dfa_node_t const node = pp->nodes[ node_i ];
+  uint32_t ns;
+
+  switch ( node.kind ) {
+    case DFA_NODE_ALT:
+      ns = nfa_build( pp, node.left, next );
+      return nfa_new( pp, DFA_NFA_SPLIT, ns, nfa_build( pp, node.right, next ) );
+
+    case DFA_NODE_ASSERT:
+      ns = nfa_new( pp, DFA_NFA_ASSERT, next, DFA_NONE );
+      pp->dfa->nfa[ ns ].assertion = node.assertion;
+      return ns;
+
+    case DFA_NODE_CAT:
+      return nfa_build( pp, node.left, nfa_build( pp, node.right, next ) );
+
+    case DFA_NODE_CSET:
+      ns = nfa_new( pp, DFA_NFA_CSET, next, DFA_NONE );
+      pp->dfa->nfa[ ns ].cset = node.cset;
+      return ns;
+
+    case DFA_NODE_EMPTY:
+      return next;
+
+    case DFA_NODE_REPEAT:
+      if ( node.max == UINT_MAX ) {
+        //
+        // The loop's split state has to exist before its body that leads back
+        // to it, so create it first and set its first out afterwards.
+        //
+        ns = nfa_new( pp, DFA_NFA_SPLIT, DFA_NONE, next );
+        uint32_t const body = nfa_build( pp, node.left, ns );
+        if ( pp->err == DFA_OK )
+          pp->dfa->nfa[ ns ].out[0] = body;
+      }
+      else {
+        ns = next;
+        for ( unsigned i = node.min; i < node.max; ++i ) {
+          uint32_t const body = nfa_build( pp, node.left, ns );
+          ns = nfa_new( pp, DFA_NFA_SPLIT, body, next );
+        } // for
+      }
+      for ( unsigned i = 0; i < node.min; ++i )
+        ns = nfa_build( pp, node.left, ns );
+      return ns;
+  } // switch
+
+  UNEXPECTED_INT_VALUE( node.kind );
+}
+
+
+/**
+ * Computes the epsilon closure of a set of NFA states.
+ *
+ * @param dfa The dfa_t to use.
+ * @param cache The dfa_cache_t to use.
+ * @param set The set of NFA states.
+ * @param set_len The number of NFA states in \a set.
+ * @param ctx The bitwise-or of \ref dfa_ctx that assertions are evaluated in.
+ * @param pclosure_len A pointer to receive the number of character set NFA
+ * states in the closure that are put into dfa_cache_t::closure_buf.
+ * @return Returns `true` only if the match state is in the closure.
+ */
+NODISCARD
+static bool nfa_closure( dfa_t const *dfa, dfa_cache_t *cache,
+                         uint32_t const *set, uint32_t set_len, unsigned ctx,
+                         uint32_t *pclosure_len ) {
+  uint32_t const mark = nfa_mark_next( cache );
+  uint32_t closure_len = 0, stack_len = 0;
+  bool matched = false;
+
+  for ( uint32_t i = set_len; i-- > 0; ) {
+    if ( cache->marks[ set[i] ] != mark ) {
+      cache->marks[ set[i] ] = mark;
+      cache->stack_buf[ stack_len++ ] = set[i];
+    }
+  } // for
+
+  while ( stack_len > 0 ) {
+    dfa_nfa_state_t const *const ns =
+      &dfa->nfa[ cache->stack_buf[ --stack_len ] ];
+    uint32_t out_len = 0;
+    switch ( ns->kind ) {
+      case DFA_NFA_ASSERT:
+        if ( assert_holds( ns->assertion, ctx ) )
+          out_len = 1;
+        break;
+      case DFA_NFA_CSET:
+        cache->closure_buf[ closure_len++ ] =
+          STATIC_CAST( uint32_t, ns - dfa->nfa );
+        break;
+      case DFA_NFA_MATCH:
+        matched = true;
+        break;
+      case DFA_NFA_SPLIT:
+        out_len = 2;
+        break;
+    } // switch
+    while ( out_len-- > 0 ) {
+      uint32_t const out = ns->out[ out_len ];
+      if ( cache->marks[ out ] != mark ) {
+        cache->marks[ out ] = mark;
+        cache->stack_buf[ stack_len++ ] = out;
+      }
+    } // while
+  } // while
+
+  *pclosure_len = closure_len;
+  return matched;
+}
+
+
+/**
+ * Compares two NFA state indices for qsort(3).
+ *
+ * @param i_ptr A pointer to the first index.
+ * @param j_ptr A pointer to the second index.
+ * @return Returns a number less than 0, 0, or greater than 0 if the first is
+ * less than, equal to, or greater than the second, respectively.
+ */
+NODISCARD
+static int nfa_index_cmp( void const *i_ptr, void const *j_ptr ) {
+  uint32_t const i = *POINTER_CAST( uint32_t const*, i_ptr );
+  uint32_t const j = *POINTER_CAST( uint32_t const*, j_ptr );
+  return (i > j) - (i < j);
+}
+
+
+/**
+ * Creates a new NFA state.
+ *
+ * @param pp The dfa_parser to use.
+ * @param kind The \ref dfa_nfa_kind of state.
+ * @param out0 The first next state.
+ * @param out1 The second next state, if any.
+ * @return Returns the index of the new state.
+ */
+NODISCARD
+static uint32_t nfa_new( dfa_parser_t *pp, unsigned kind, uint32_t out0,
+                         uint32_t out1 ) {
+  dfa_t *const dfa = pp->dfa;
+  if ( dfa->nfa_len == DFA_NFA_MAX ) {
+    pp->err = DFA_ESIZE;
+    return 0;
+  }
+  if ( dfa->nfa_len == pp->nfa_cap ) {
+    pp->nfa_cap = pp->nfa_cap < 64 ? 64 : pp->nfa_cap * 2;
+    REALLOC( dfa->nfa, dfa_nfa_state_t, pp->nfa_cap );
+  }
+  dfa_nfa_state_t *ns = &dfa->nfa[ dfa->nfa_len ];
+  MEM_ZERO( ns );
+  ns->kind = STATIC_CAST( uint8_t, kind );
+  ns->out[0] = out0;
+  ns->out[1] = out1;
+  return dfa->nfa_len++;
+}
+
+
+/**
+ * Checks whether every match of an abstract syntax tree node must start with
+ * a beginning-of-string assertion.
+ *
+ * @param pp The dfa_parser to use.
+ * @param node_i The index of the node to check.
+ * @return Returns `true` only if it must.
+ */
+NODISCARD
+static bool node_is_anchored( dfa_parser_t const *pp, uint32_t node_i ) {
+  dfa_node_t const *const node = &pp->nodes[ node_i ];
+  switch ( node->kind ) {
+    case DFA_NODE_ALT:
+      return  node_is_anchored( pp, node->left ) &&
+              node_is_anchored( pp, node->right );
+    case DFA_NODE_ASSERT:
+      return node->assertion == DFA_ASSERT_BEGIN;
+    case DFA_NODE_CAT:
+      return node_is_anchored( pp, node->left );
+    case DFA_NODE_REPEAT:
+      return node->min > 0 && node_is_anchored( pp, node->left );
+  } // switch
+  return false;
+}
+
+
+/**
+ * Gets the \ref dfa_ctx flags that the assertions in an abstract syntax tree
+ * depend on.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns said flags.
+ */
+NODISCARD
+static unsigned nodes_ctx_mask( dfa_parser_t const *pp ) {
+  unsigned mask = DFA_CTX_UNANCHORED;
+  for ( uint32_t i = 0; i < pp->nodes_len; ++i ) {
+    if ( pp->nodes[i].kind != DFA_NODE_ASSERT )
+      continue;
+    switch ( pp->nodes[i].assertion ) {
+      case DFA_ASSERT_BEGIN:
+        mask |= DFA_CTX_BEGIN;
+        break;
+      case DFA_ASSERT_END:
+        break;
+      default:
+        mask |= DFA_CTX_PREV_WORD;
+        break;
+    } // switch
+  } // for
+  return mask;
+}
+
+/**
+ * Parses an alternation of one or more concatenations.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_alt( dfa_parser_t *pp ) {
+  uint32_t node = parse_cat( pp );
+  while ( pp->err == DFA_OK && *pp->p == '|' ) {
+    ++pp->p;
+    uint32_t const right = parse_cat( pp );
+    node = parse_node_new( pp, DFA_NODE_ALT, node, right );
+  } // while
+  return node;
+}
+
+
+/**
+ * Parses an atom: a parenthesized expression, bracket expression, `.`, an
+ * assertion, an escaped character, or a literal character.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_atom( dfa_parser_t *pp ) {
+  uint32_t node, cset_i;
+  char const c = *pp->p++;
+
+  switch ( c ) {
+    case '(':
+      ++pp->depth;
+      node = parse_alt( pp );
+      if ( pp->err != DFA_OK )
+        return node;
+      if ( *pp->p != ')' ) {
+        pp->err = DFA_EPAREN;
+        return node;
+      }
+      ++pp->p;
+      --pp->depth;
+      return node;
+
+    case '[':
+      return parse_bracket( pp );
+
+    case '.':
+      node = parse_node_cset( pp, &cset_i );
+      pp->dfa->csets[ cset_i ].negated = true;
+      return node;
+
+    case '^':
+    case '$':
+      node = parse_node_new( pp, DFA_NODE_ASSERT, DFA_NONE, DFA_NONE );
+      pp->nodes[ node ].assertion =
+        c == '^' ? DFA_ASSERT_BEGIN : DFA_ASSERT_END;
+      return node;
+
+    case '*':
+    case '+':
+    case '?':
+      pp->err = DFA_EBADRPT;
+      return DFA_NONE;
+
+    case '{':
+      if ( *pp->p >= '0' && *pp->p <= '9' ) {
+        pp->err = DFA_EBADRPT;
+        return DFA_NONE;
+      }
+      break;
+
+    case '\\':
+      switch ( *pp->p ) {
+        case '\0':
+          pp->err = DFA_EESCAPE;
+          return DFA_NONE;
+        case '1': case '2': case '3': case '4': case '5':
+        case '6': case '7': case '8': case '9':
+          pp->err = DFA_EBACKREF;
+          return DFA_NONE;
+        case '<' : node = DFA_ASSERT_WORD_BEGIN;  break;
+        case '>' : node = DFA_ASSERT_WORD_END;    break;
+        case 'b' : node = DFA_ASSERT_WORD_B;      break;
+        case 'B' : node = DFA_ASSERT_NOT_WORD_B;  break;
+        case '`' : node = DFA_ASSERT_BEGIN;       break;
+        case '\'': node = DFA_ASSERT_END;         break;
+        case 'w':
+        case 'W':
+        case 's':
+        case 'S': {
+          char const esc = *pp->p++;
+          node = parse_node_cset( pp, &cset_i );
+          dfa_cset_t *const cs = &pp->dfa->csets[ cset_i ];
+          if ( esc == 'w' || esc == 'W' ) {
+            cset_add_class( cs, "alnum", 5 );
+            cset_add_ascii( cs, '_' );
+          } else {
+            cset_add_class( cs, "space", 5 );
+          }
+          cs->negated = esc == 'W' || esc == 'S';
+          return node;
+        }
+        default:
+          goto literal;
+      } // switch
+      ++pp->p;
+      uint32_t const assertion = node;
+      node = parse_node_new( pp, DFA_NODE_ASSERT, DFA_NONE, DFA_NONE );
+      pp->nodes[ node ].assertion = STATIC_CAST( uint8_t, assertion );
+      return node;
+  } // switch
+
+  --pp->p;
+
+literal:;
+  size_t len;
+  char32_t const cp = dfa_decode( pp->p, &len );
+  pp->p += len;
+  node = parse_node_cset( pp, &cset_i );
+  if ( cp != CP_INVALID )
+    cset_add_range( &pp->dfa->csets[ cset_i ], cp, cp );
+  return node;
+}
+
+
+/**
+ * Parses a bracket expression, e.g., `[a-z]`.
+ *
+ * @param pp The dfa_parser to use; dfa_parser::p must be just past the `[`.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_bracket( dfa_parser_t *pp ) {
+  uint32_t cset_i;
+  uint32_t const node = parse_node_cset( pp, &cset_i );
+
+  bool negated = false;
+  if ( *pp->p == '^' ) {
+    negated = true;
+    ++pp->p;
+  }
+
+  for ( bool is_first = true;; is_first = false ) {
+    if ( *pp->p == '\0' ) {
+      pp->err = DFA_EBRACK;
+      return node;
+    }
+    if ( *pp->p == ']' && !is_first ) {
+      ++pp->p;
+      break;
+    }
+
+    dfa_cset_t *const cs = &pp->dfa->csets[ cset_i ];
+    if ( pp->p[0] == '[' && pp->p[1] == ':' ) {
+      char const *const name = pp->p + 2;
+      char const *const name_end = strstr( name, ":]" );
+      if ( name_end == NULL || !cset_add_class(
+              cs, name, STATIC_CAST( size_t, name_end - name ) ) ) {
+        pp->err = DFA_ECTYPE;
+        return node;
+      }
+      pp->p = name_end + 2;
+      continue;
+    }
+
+    char32_t const lo = parse_bracket_char( pp );
+    if ( pp->err != DFA_OK )
+      return node;
+    char32_t hi = lo;
+    if ( pp->p[0] == '-' && pp->p[1] != ']' && pp->p[1] != '\0' ) {
+      ++pp->p;
+      hi = parse_bracket_char( pp );
+      if ( pp->err != DFA_OK )
+        return node;
+      if ( hi < lo ) {
+        pp->err = DFA_ERANGE;
+        return node;
+      }
+    }
+    if ( lo != CP_INVALID )
+      cset_add_range( cs, lo, hi );
+  } // for
+
+  pp->dfa->csets[ cset_i ].negated = negated;
+  return node;
+}
+
+
+/**
+ * Parses a bracket expression character, including a collating symbol or
+ * equivalence class of a single character, e.g., `[.-.]`.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns said character or \ref CP_INVALID on error.
+ */
+NODISCARD
+static char32_t parse_bracket_char( dfa_parser_t *pp ) {
+  char const *p = pp->p;
+  char delim = '\0';
+  if ( p[0] == '[' && (p[1] == '.' || p[1] == '=') ) {
+    delim = p[1];
+    p += 2;
+  }
+  if ( *p == '\0' ) {
+    pp->err = DFA_EBRACK;
+    return CP_INVALID;
+  }
+  size_t len;
+  char32_t const cp = dfa_decode( p, &len );
+  p += len;
+  if ( delim != '\0' ) {
+    if ( p[0] != delim || p[1] != ']' ) {
+      pp->err = DFA_EBRACK;
+      return CP_INVALID;
+    }
+    p += 2;
+  }
+  pp->p = p;
+  return cp;
+}
+
+
+/**
+ * Parses a concatenation of zero or more repeated atoms.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_cat( dfa_parser_t *pp ) {
+  uint32_t node = DFA_NONE;
+  while ( pp->err == DFA_OK ) {
+    char const c = *pp->p;
+    if ( c == '\0' || c == '|' || (c == ')' && pp->depth > 0) )
+      break;
+    uint32_t const repeat = parse_repeat( pp );
+    node = node == DFA_NONE ?
+      repeat : parse_node_new( pp, DFA_NODE_CAT, node, repeat );
+  } // while
+  return node != DFA_NONE ?
+    node : parse_node_new( pp, DFA_NODE_EMPTY, DFA_NONE, DFA_NONE );
+}
+
+
+/**
+ * Creates a new, empty character set.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns the index of the new character set.
+ */
+NODISCARD
+static uint32_t parse_cset_new( dfa_parser_t *pp ) {
+  dfa_t *const dfa = pp->dfa;
+  if ( dfa->csets_len == pp->csets_cap ) {
+    pp->csets_cap = pp->csets_cap < 16 ? 16 : pp->csets_cap * 2;
+    REALLOC( dfa->csets, dfa_cset_t, pp->csets_cap );
+  }
+  dfa_cset_t *cs = &dfa->csets[ dfa->csets_len ];
+  MEM_ZERO( cs );
+  return dfa->csets_len++;
+}
+
+
+/**
+ * Parses a `{m}`, `{m,}`, or `{m,n}` interval.
+ *
+ * @param pp The dfa_parser to use; dfa_parser::p must be just past the `{`.
+ * @param pmin A pointer to receive the minimum.
+ * @param pmax A pointer to receive the maximum or `UINT_MAX` if none.
+ */
+static void parse_interval( dfa_parser_t *pp, unsigned *pmin,
+                            unsigned *pmax ) {
+  unsigned n[2] = { 0, 0 };
+  unsigned n_len = 0;
+  for ( ; n_len < 2; ++n_len ) {
+    if ( *pp->p < '0' || *pp->p > '9' )
+      break;
+    for ( ; *pp->p >= '0' && *pp->p <= '9'; ++pp->p ) {
+      n[ n_len ] = n[ n_len ] * 10 + STATIC_CAST( unsigned, *pp->p - '0' );
+      if ( n[ n_len ] > DFA_DUP_MAX ) {
+        pp->err = DFA_EBRACE;
+        return;
+      }
+    } // for
+    if ( n_len == 1 || *pp->p != ',' )
+      break;
+    ++pp->p;
+  } // for
+
+  if ( *pp->p != '}' ) {
+    pp->err = DFA_EBRACE;
+    return;
+  }
+  ++pp->p;
+
+  *pmin = n[0];
+  if ( n_len == 0 )                     // {m}
+    *pmax = n[0];
+  else if ( pp->p[-2] == ',' )           // {m,}
+    *pmax = UINT_MAX;
+  else                                  // {m,n}
+    *pmax = n[1];
+
+  if ( *pmax < *pmin )
+    pp->err = DFA_EBRACE;
+}
+
+
+/**
+ * Creates a new character set node.
+ *
+ * @param pp The dfa_parser to use.
+ * @param pcset A pointer to receive the index of the new character set.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_node_cset( dfa_parser_t *pp, uint32_t *pcset ) {
+  uint32_t const node = parse_node_new( pp, DFA_NODE_CSET, DFA_NONE, DFA_NONE );
+  pp->nodes[ node ].cset = *pcset = parse_cset_new( pp );
+  return node;
+}
+
+
+/**
+ * Creates a new abstract syntax tree node.
+ *
+ * @param pp The dfa_parser to use.
+ * @param kind The \ref dfa_node_kind of node.
+ * @param left The left or only child, if any.
+ * @param right The right child, if any.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_node_new( dfa_parser_t *pp, unsigned kind, uint32_t left,
+                                uint32_t right ) {
+  if ( pp->nodes_len == pp->nodes_cap ) {
+    pp->nodes_cap = pp->nodes_cap < 64 ? 64 : pp->nodes_cap * 2;
+    REALLOC( pp->nodes, dfa_node_t, pp->nodes_cap );
+  }
+  dfa_node_t *node = &pp->nodes[ pp->nodes_len ];
+  MEM_ZERO( node );
+  node->kind = STATIC_CAST( uint8_t, kind );
+  node->left = left;
+  node->right = right;
+  return pp->nodes_len++;
+}
+
+
+/**
+ * Parses an atom followed by zero or more repetition operators.
+ *
+ * @param pp The dfa_parser to use.
+ * @return Returns the index of the new node.
+ */
+NODISCARD
+static uint32_t parse_repeat( dfa_parser_t *pp ) {
+  uint32_t node = parse_atom( pp );
+
+  while ( pp->err == DFA_OK ) {
+    unsigned min, max;
+    switch ( *pp->p ) {
+      case '*': min = 0; max = UINT_MAX;  break;
+      case '+': min = 1; max = UINT_MAX;  break;
+      case '?': min = 0; max = 1;         break;
+      case '{':
+        if ( pp->p[1] < '0' || pp->p[1] > '9' )
+          return node;
+        ++pp->p;
+        parse_interval( pp, &min, &max );
+        if ( pp->err != DFA_OK )
+          return node;
+        --pp->p;
+        break;
+      default:
+        return node;
+    } // switch
+    ++pp->p;
+    node = parse_node_new( pp, DFA_NODE_REPEAT, node, DFA_NONE );
+    pp->nodes[ node ].min = min;
+    pp->nodes[ node ].max = max;
+  } // while
+
+  return node;
+}
+
+
+////////// extern functions ///////////////////////////////////////////////////
+
+void dfa_cache_free( dfa_cache_t *cache ) {
+  assert( cache != NULL );
+  if ( cache->states != NULL ) {
+    dfa_states_free( cache );
+    FREE( cache->states );
+  }
+  FREE( cache->marks );
+  FREE( cache->closure_buf );
+  FREE( cache->step_buf );
+  FREE( cache->stack_buf );
+  MEM_ZERO( cache );
+}
+
+int dfa_compile( dfa_t *dfa, char const *pattern ) {
+  assert( dfa != NULL );
+  assert( pattern != NULL );
+
+  MEM_ZERO( dfa );
+  dfa_parser_t pp = { .dfa = dfa, .p = pattern };
+
+  uint32_t const root = parse_alt( &pp );
+  if ( pp.err == DFA_OK && *pp.p != '\0' )
+    pp.err = DFA_EPAREN;                // can only be an unmatched ')'
+
+  if ( pp.err == DFA_OK ) {
+    uint32_t const match = nfa_new( &pp, DFA_NFA_MATCH, DFA_NONE, DFA_NONE );
+    dfa->nfa_start = nfa_build( &pp, root, match );
+  }
+  if ( pp.err == DFA_OK ) {
+    dfa->flags_mask = nodes_ctx_mask( &pp );
+    dfa->is_anchored = node_is_anchored( &pp, root );
+  }
+
+  FREE( pp.nodes );
+  if ( pp.err != DFA_OK )
+    dfa_free( dfa );
+  return pp.err;
+}
+
+char const* dfa_error( int err_code ) {
+  switch ( err_code ) {
+    case DFA_OK       : return "success";
+    case DFA_EBACKREF : return "back-references are not supported";
+    case DFA_EBADRPT  : return "invalid preceding regular expression";
+    case DFA_EBRACE   : return "invalid content of \\{\\}";
+    case DFA_EBRACK   : return "unmatched [, [^, [:, [., or [=";
+    case DFA_ECTYPE   : return "invalid character class name";
+    case DFA_EESCAPE  : return "trailing backslash";
+    case DFA_EPAREN   : return "unmatched ( or )";
+    case DFA_ERANGE   : return "invalid range end";
+    case DFA_ESIZE    : return "regular expression too big";
+  } // switch
+  UNEXPECTED_INT_VALUE( err_code );
+}
+
+void dfa_free( dfa_t *dfa ) {
+  assert( dfa != NULL );
+  for ( uint32_t i = 0; i < dfa->csets_len; ++i )
+    FREE( dfa->csets[i].ranges );
+  FREE( dfa->csets );
+  FREE( dfa->nfa );
+  MEM_ZERO( dfa );
+}
+
+bool dfa_match( dfa_t const *dfa, dfa_cache_t *cache, char const *s,
+                size_t *range ) {
+  assert( dfa != NULL );
+  assert( cache != NULL );
+  assert( s != NULL );
+  assert( range != NULL );
+
+  if ( cache->states == NULL )
+    dfa_cache_init( dfa, cache );
+  assert( cache->nfa_len == dfa->nfa_len );
+
+  char const *end;
+  if ( !dfa->is_anchored ) {
+    //
+    // First find the earliest end of any match: if there is none, which is the
+    // common case, that's all that's needed.  Otherwise, the leftmost match
+    // must start at or before it.
+    //
+    char const *earliest_end;
+    if ( !dfa_scan( dfa, cache, s, s, /*unanchored=*/true, &earliest_end ) )
+      return false;
+    for ( char const *p = s; p <= earliest_end; ) {
+      if ( dfa_scan( dfa, cache, s, p, /*unanchored=*/false, &end ) ) {
+        range[0] = STATIC_CAST( size_t, p - s );
+        range[1] = STATIC_CAST( size_t, end - s );
+        return true;
+      }
+      if ( *p == '\0' )
+        break;
+      size_t const len = dfa_char_len( p );
+      p += len > 0 ? len : 1;
+    } // for
+    return false;
+  }
+
+  if ( !dfa_scan( dfa, cache, s, s, /*unanchored=*/false, &end ) )
+    return false;
+  range[0] = 0;
+  range[1] = STATIC_CAST( size_t, end - s );
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
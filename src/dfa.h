@@ -0,0 +1,175 @@
+/*
+**      wrap -- text reformatter
+**      src/dfa.h
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef wrap_dfa_H
+#define wrap_dfa_H
+
+/**
+ * @file
+ * Declares a small built-in regular expression engine that compiles a POSIX
+ * extended regular expression into a Thompson NFA that's then converted into a
+ * DFA lazily, i.e., only the DFA states that input actually reaches are ever
+ * built.
+ *
+ * @remarks The engine works on Unicode code-points decoded from UTF-8, so `.`
+ * and bracket expressions match whole characters.  In addition to POSIX
+ * extended regular expressions, it supports the GNU word-boundary assertions
+ * `\<`, `\>`, `\b`, and `\B`, the string anchors `` \` `` and `\'`, and the
+ * classes `\w`, `\W`, `\s`, and `\S` natively.  It doesn't support
+ * back-references.
+ *
+ * @remarks A \ref dfa is read-only once compiled; the DFA states built while
+ * matching are kept in a separate \ref dfa_cache, so any number of threads may
+ * match against the same \ref dfa at the same time as long as each uses its
+ * own \ref dfa_cache.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint32_t */
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Error codes returned by dfa_compile().
+ */
+enum dfa_err {
+  DFA_OK,                               ///< No error.
+  DFA_EBACKREF,                         ///< Back-reference not supported.
+  DFA_EBADRPT,                          ///< Repetition of nothing.
+  DFA_EBRACE,                           ///< Invalid repetition count.
+  DFA_EBRACK,                           ///< Unmatched `[`.
+  DFA_ECTYPE,                           ///< Invalid character class name.
+  DFA_EESCAPE,                          ///< Trailing backslash.
+  DFA_EPAREN,                           ///< Unmatched `(`.
+  DFA_ERANGE,                           ///< Invalid range end.
+  DFA_ESIZE                             ///< Regular expression too big.
+};
+
+struct dfa_cset;
+struct dfa_nfa_state;
+struct dfa_state;
+
+/**
+ * A compiled regular expression.
+ */
+struct dfa {
+  struct dfa_nfa_state *nfa;            ///< NFA states.
+  uint32_t              nfa_len;        ///< Number of NFA states.
+  uint32_t              nfa_start;      ///< Index of the NFA start state.
+  struct dfa_cset      *csets;          ///< Character sets.
+  uint32_t              csets_len;      ///< Number of character sets.
+  unsigned              flags_mask;     ///< DFA state flags that matter.
+  bool                  is_anchored;    ///< Must every match start at `^`?
+};
+typedef struct dfa dfa_t;
+
+/**
+ * The DFA states of a \ref dfa built lazily while matching along with the
+ * scratch buffers needed to build them.
+ *
+ * @remarks It must be zero-initialized before its first use, used with only
+ * one \ref dfa, and freed by dfa_cache_free() before that \ref dfa is.
+ */
+struct dfa_cache {
+  struct dfa_state    **states;         ///< Hash table of DFA states.
+  size_t                states_cap;     ///< Capacity of \ref states.
+  size_t                states_len;     ///< Number of DFA states.
+
+  uint32_t              nfa_len;        ///< dfa::nfa_len it was built for.
+  uint32_t             *marks;          ///< Per NFA state visited marks.
+  uint32_t              mark;           ///< Current visited mark.
+  uint32_t             *closure_buf;    ///< Epsilon closure of NFA states.
+  uint32_t             *step_buf;       ///< NFA states after a step.
+  uint32_t             *stack_buf;      ///< Stack for epsilon closure.
+};
+typedef struct dfa_cache dfa_cache_t;
+
+////////// extern functions ///////////////////////////////////////////////////
+
+/**
+ * Frees all memory used by a dfa_cache_t.  It may then be used again.
+ *
+ * @param cache A pointer to the dfa_cache_t to free.
+ *
+ * @sa dfa_match()
+ */
+void dfa_cache_free( dfa_cache_t *cache );
+
+/**
+ * Compiles a regular expression pattern.
+ *
+ * @param dfa A pointer to the dfa_t to compile to.
+ * @param pattern The POSIX extended regular expression pattern to compile.
+ * @return Returns \ref DFA_OK on success or another \ref dfa_err for an
+ * invalid \a pattern.
+ *
+ * @sa dfa_free()
+ */
+NODISCARD
+int dfa_compile( dfa_t *dfa, char const *pattern );
+
+/**
+ * Gets the error message corresponding to \a err_code.
+ *
+ * @param err_code The \ref dfa_err returned by dfa_compile().
+ * @return Returns said message.
+ */
+NODISCARD
+char const* dfa_error( int err_code );
+
+/**
+ * Frees all memory used by a dfa_t.
+ *
+ * @param dfa A pointer to the dfa_t to free.
+ *
+ * @sa dfa_compile()
+ */
+void dfa_free( dfa_t *dfa );
+
+/**
+ * Finds the leftmost-longest match of the previously compiled regular
+ * expression in \a s.
+ *
+ * @param dfa A pointer to the dfa_t to match against.
+ * @param cache A pointer to the dfa_cache_t to use.  DFA states are built into
+ * it as needed.
+ * @param s The null-terminated UTF-8 string to match.
+ * @param range A pointer to an array of size 2 to receive the beginning
+ * position and one past the end position of the match -- set only if there
+ * was a match.
+ * @return Returns `true` only if there was a match.
+ */
+NODISCARD
+bool dfa_match( dfa_t const *dfa, dfa_cache_t *cache, char const *s,
+                size_t *range );
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* wrap_dfa_H */
+/* vim:set et sw=2 ts=2: */
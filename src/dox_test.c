@@ -0,0 +1,231 @@
+/*
+**      wrap -- text reformatter
+**      src/dox_test.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Tests dox_find_cmd() by enumerating every command in \ref DOX_COMMANDS and
+ * every string one edit away from one and comparing the result with
+ * **bsearch**(3) and, with `-b`, benchmarks the two.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "doxygen.h"
+#include "util.h"
+
+// standard
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Words that commonly follow `@` or `\` in comments that aren't Doxygen
+ * commands to mix in with commands when benchmarking.
+ */
+static char const *const BENCH_NON_COMMAND[] = {
+  "brief_", "deprecate", "endparblock", "exampl", "notes", "override",
+  "params", "retval_", "returns_", "see_also", "throw_", "todos"
+};
+
+/// Number of times each name is looked up when benchmarking.
+static unsigned const BENCH_REPS = 20000;
+
+// extern variable definitions
+char const       *me;                   ///< Program name.
+
+// local functions
+NODISCARD
+static dox_cmd_t const* ref_find_cmd( char const* );
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Benchmarks dox_find_cmd() against ref_find_cmd().
+ */
+static void bench( void ) {
+  size_t const names_len = DOX_COMMANDS_LEN + ARRAY_SIZE( BENCH_NON_COMMAND );
+  char const **const names = MALLOC( char const*, names_len );
+  for ( size_t i = 0; i < DOX_COMMANDS_LEN; ++i )
+    names[i] = DOX_COMMANDS[i].name;
+  for ( size_t i = 0; i < ARRAY_SIZE( BENCH_NON_COMMAND ); ++i )
+    names[ DOX_COMMANDS_LEN + i ] = BENCH_NON_COMMAND[i];
+
+  //
+  // Count the commands found so the compiler can't elide the lookups.
+  //
+  size_t hash_found = 0, ref_found = 0;
+
+  struct timespec t0, t1, t2;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &t0 ) != 0, EX_OSERR );
+  for ( unsigned rep = 0; rep < BENCH_REPS; ++rep ) {
+    for ( size_t i = 0; i < names_len; ++i )
+      hash_found += dox_find_cmd( names[i] ) != NULL;
+  } // for
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &t1 ) != 0, EX_OSERR );
+  for ( unsigned rep = 0; rep < BENCH_REPS; ++rep ) {
+    for ( size_t i = 0; i < names_len; ++i )
+      ref_found += ref_find_cmd( names[i] ) != NULL;
+  } // for
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &t2 ) != 0, EX_OSERR );
+
+  FREE( names );
+  if ( hash_found != ref_found )
+    fatal_error( EX_SOFTWARE, "perfect hash and bsearch results differ\n" );
+
+  double const lookups = STATIC_CAST( double, names_len ) * BENCH_REPS;
+  double const hash_ns =
+    (STATIC_CAST( double, t1.tv_sec - t0.tv_sec ) * 1e9 +
+     STATIC_CAST( double, t1.tv_nsec - t0.tv_nsec )) / lookups;
+  double const ref_ns =
+    (STATIC_CAST( double, t2.tv_sec - t1.tv_sec ) * 1e9 +
+     STATIC_CAST( double, t2.tv_nsec - t1.tv_nsec )) / lookups;
+
+  printf( "perfect hash: %7.2f ns/lookup\n", hash_ns );
+  printf( "bsearch     : %7.2f ns/lookup\n", ref_ns );
+  printf( "speedup     : %7.2fx\n", ref_ns / hash_ns );
+}
+
+/**
+ * Checks that dox_find_cmd() and ref_find_cmd() agree on \a s.
+ *
+ * @param s The null-terminated string to check.
+ * @return Returns 1 if they disagree or 0 if they agree.
+ */
+NODISCARD
+static unsigned check( char const *s ) {
+  dox_cmd_t const *const got = dox_find_cmd( s );
+  dox_cmd_t const *const expected = ref_find_cmd( s );
+  if ( got == expected )
+    return 0;
+  EPRINTF( "\"%s\": got \"%s\"; expected \"%s\"\n",
+    s,
+    got != NULL ? got->name : "(null)",
+    expected != NULL ? expected->name : "(null)"
+  );
+  return 1;
+}
+
+/**
+ * Checks \a name along with every string that's one edit away from it.
+ *
+ * @param name The null-terminated name to check.
+ * @return Returns the number of mismatches.
+ */
+NODISCARD
+static unsigned check_edits( char const *name ) {
+  static char const ALPHABET[] = "()[]{}abcdefghijklmnopqrstuvwxyz";
+  char buf[ DOX_CMD_NAME_SIZE_MAX + 2 ];
+  size_t const len = strlen( name );
+  unsigned mismatches = check( name );
+
+  for ( size_t i = 0; i <= len; ++i ) {
+    if ( i < len ) {                    // deletion
+      memcpy( buf, name, i );
+      strcpy( buf + i, name + i + 1 );
+      mismatches += check( buf );
+    }
+    for ( char const *c = ALPHABET; *c != '\0'; ++c ) {
+      memcpy( buf, name, i );           // insertion
+      buf[i] = *c;
+      strcpy( buf + i + 1, name + i );
+      mismatches += check( buf );
+      if ( i < len ) {                  // substitution
+        strcpy( buf, name );
+        buf[i] = *c;
+        mismatches += check( buf );
+      }
+    } // for
+  } // for
+
+  return mismatches;
+}
+
+/**
+ * Comparison function for \ref dox_cmd.
+ *
+ * @param i_dox The first \ref dox_cmd.
+ * @param j_dox The second \ref dox_cmd.
+ * @return Returns an integer less than, equal to, or greater than 0, according
+ * to whether the data pointed to by \a i_dox is less than, equal to, or
+ * greater than the data pointed to by \a j_dox.
+ */
+NODISCARD
+static int dox_cmd_cmp( dox_cmd_t const *i_dox, dox_cmd_t const *j_dox ) {
+  return strcmp( i_dox->name, j_dox->name );
+}
+
+/**
+ * Looks up \a s in \ref DOX_COMMANDS via **bsearch**(3) the way
+ * dox_find_cmd() used to.
+ *
+ * @param s The null-terminated string to look up.
+ * @return Returns a pointer to the Doxygen command or null if not found.
+ */
+NODISCARD
+static dox_cmd_t const* ref_find_cmd( char const *s ) {
+  return bsearch(
+    &(dox_cmd_t){ .name = s }, DOX_COMMANDS,
+    DOX_COMMANDS_LEN, sizeof( DOX_COMMANDS[0] ),
+    POINTER_CAST( bsearch_cmp_fn_t, &dox_cmd_cmp )
+  );
+}
+
+/**
+ * Prints the usage message to standard error and exits.
+ */
+_Noreturn
+static void usage( void ) {
+  EPRINTF( "usage: %s [-b]\n", me );
+  exit( EX_USAGE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( int argc, char const *argv[] ) {
+  me = base_name( argv[0] );
+  if ( argc > 2 || (argc == 2 && strcmp( argv[1], "-b" ) != 0) )
+    usage();
+  if ( argc == 2 ) {
+    bench();
+    exit( EX_OK );
+  }
+
+  unsigned mismatches = 0;
+  for ( size_t i = 0; i < DOX_COMMANDS_LEN; ++i ) {
+    if ( dox_find_cmd( DOX_COMMANDS[i].name ) != &DOX_COMMANDS[i] ) {
+      EPRINTF( "\"%s\": not found\n", DOX_COMMANDS[i].name );
+      ++mismatches;
+    }
+    mismatches += check_edits( DOX_COMMANDS[i].name );
+  } // for
+  for ( size_t i = 0; i < ARRAY_SIZE( BENCH_NON_COMMAND ); ++i )
+    mismatches += check_edits( BENCH_NON_COMMAND[i] );
+
+  printf( "%u mismatches\n", mismatches );
+  exit( mismatches > 0 ? EX_SOFTWARE : EX_OK );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
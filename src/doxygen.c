@@ -34,12 +34,6 @@
 // standard
 #include <assert.h>
 
-#define DOX_INIT_INLINE            DOX_INLINE
-#define DOX_INIT_BOL               DOX_BOL
-#define DOX_INIT_EOL              (DOX_BOL | DOX_EOL)
-#define DOX_INIT_PAR              (DOX_BOL | DOX_PAR)
-#define DOX_INIT_PRE              (DOX_INIT_PAR | DOX_PRE)
-
 /// @endcond
 
 /**
@@ -52,260 +46,15 @@
  */
 #define DOX_CMD_CHARS             "abcdefghijklmnopqrstuvwxyz()[]{}"
 
-///////////////////////////////////////////////////////////////////////////////
-
-/**
- * Array of all [Doxygen
- * commands](https://www.doxygen.nl/manual/commands.html).
- */
-static dox_cmd_t const DOX_COMMANDS[] = {
-
-  { "a",                      DOX_INIT_INLINE,  NULL },
-  { "addindex",               DOX_INIT_EOL,     NULL },
-  { "addtogroup",             DOX_INIT_EOL,     NULL },
-  { "anchor",                 DOX_INIT_INLINE,  NULL },
-  { "arg",                    DOX_INIT_PAR,     NULL },
-  { "attention",              DOX_INIT_PAR,     NULL },
-  { "author",                 DOX_INIT_PAR,     NULL },
-  { "authors",                DOX_INIT_PAR,     NULL },
-
-  { "b",                      DOX_INIT_INLINE,  NULL },
-  { "brief",                  DOX_INIT_PAR,     NULL },
-  { "bug",                    DOX_INIT_PAR,     NULL },
-
-  { "c",                      DOX_INIT_INLINE,  NULL },
-  { "callergraph",            DOX_INIT_EOL,     NULL },
-  { "callgraph",              DOX_INIT_EOL,     NULL },
-  { "category",               DOX_INIT_EOL,     NULL },
-  { "cite",                   DOX_INIT_EOL,     NULL },
-  { "class",                  DOX_INIT_EOL,     NULL },
-  { "code",                   DOX_INIT_PRE,     "endcode" },
-  { "collaborationgraph",     DOX_INIT_EOL,     NULL },
-  { "concept",                DOX_INIT_EOL,     NULL },
-  { "cond",                   DOX_INIT_PAR,     "endcond" },
-  { "copybrief",              DOX_INIT_EOL,     NULL },
-  { "copydetails",            DOX_INIT_EOL,     NULL },
-  { "copydoc",                DOX_INIT_EOL,     NULL },
-  { "copyright",              DOX_INIT_PAR,     NULL },
-
-  { "date",                   DOX_INIT_PAR,     NULL },
-  { "def",                    DOX_INIT_EOL,     NULL },
-  { "defgroup",               DOX_INIT_EOL,     NULL },
-  { "deprecated",             DOX_INIT_PAR,     NULL },
-  { "details",                DOX_INIT_PAR,     NULL },
-  { "diafile",                DOX_INIT_EOL,     NULL },
-  { "dir",                    DOX_INIT_EOL,     NULL },
-  { "directorygraph",         DOX_INIT_EOL,     NULL },
-  { "docbookinclude",         DOX_INIT_EOL,     NULL },
-  { "docbookonly",            DOX_INIT_PRE,     "enddocbookonly" },
-  { "dontinclude",            DOX_INIT_EOL,     NULL },
-  { "dot",                    DOX_INIT_PRE,     "enddot" },
-  { "dotfile",                DOX_INIT_EOL,     NULL },
-  { "doxyconfig",             DOX_INIT_EOL,     NULL },
-
-  { "e",                      DOX_INIT_INLINE,  NULL },
-  { "else",                   DOX_INIT_EOL,     NULL },
-  { "elseif",                 DOX_INIT_EOL,     NULL },
-  { "em",                     DOX_INIT_INLINE,  NULL },
-  { "emoji",                  DOX_INIT_INLINE,  NULL },
-  { "endcode",                DOX_INIT_EOL,     NULL },
-  { "endcond",                DOX_INIT_EOL,     NULL },
-  { "enddocbookonly",         DOX_INIT_EOL,     NULL },
-  { "enddot",                 DOX_INIT_EOL,     NULL },
-  { "endhtmlonly",            DOX_INIT_EOL,     NULL },
-  { "endif",                  DOX_INIT_EOL,     NULL },
-  { "endinternal",            DOX_INIT_EOL,     NULL },
-  { "endlatexonly",           DOX_INIT_EOL,     NULL },
-  { "endlink",                DOX_INIT_EOL,     NULL },
-  { "endmanonly",             DOX_INIT_EOL,     NULL },
-  { "endmsc",                 DOX_INIT_EOL,     NULL },
-  { "endparblock",            DOX_INIT_EOL,     NULL },
-  { "endrtfonly",             DOX_INIT_EOL,     NULL },
-  { "endsecreflist",          DOX_INIT_EOL,     NULL },
-  { "endverbatim",            DOX_INIT_EOL,     NULL },
-  { "enduml",                 DOX_INIT_EOL,     NULL },
-  { "endxmlonly",             DOX_INIT_EOL,     NULL },
-  { "enum",                   DOX_INIT_INLINE,  NULL },
-  { "example",                DOX_INIT_EOL,     NULL },
-  { "exception",              DOX_INIT_PAR,     NULL },
-  { "extends",                DOX_INIT_INLINE,  NULL },
-
-  { "f$",                     DOX_INIT_INLINE,  NULL },
-  { "f(",                     DOX_INIT_PRE,     "f)" },
-  { "f)",                     DOX_INIT_EOL,     NULL },
-  { "f[",                     DOX_INIT_PRE,     "f]" },
-  { "f]",                     DOX_INIT_EOL,     NULL },
-  { "f{",                     DOX_INIT_PRE,     "f}" },
-  { "f}",                     DOX_INIT_EOL,     NULL },
-  { "file",                   DOX_INIT_EOL,     NULL },
-  { "fileinfo",               DOX_INIT_INLINE,  NULL },
-  { "fn",                     DOX_INIT_EOL,     NULL },
-
-  { "groupgraph",             DOX_INIT_EOL,     NULL },
-
-  { "headerfile",             DOX_INIT_EOL,     NULL },
-  { "hidecallergraph",        DOX_INIT_EOL,     NULL },
-  { "hidecallgraph",          DOX_INIT_EOL,     NULL },
-  { "hidecollaborationgraph", DOX_INIT_EOL,     NULL },
-  { "hidedirectorygraph",     DOX_INIT_EOL,     NULL },
-  { "hidegroupgraph",         DOX_INIT_EOL,     NULL },
-  { "hideincludedbygraph",    DOX_INIT_EOL,     NULL },
-  { "hideincludegraph",       DOX_INIT_EOL,     NULL },
-  { "hideinitializer",        DOX_INIT_EOL,     NULL },
-  { "hiderefby",              DOX_INIT_EOL,     NULL },
-  { "hiderefs",               DOX_INIT_EOL,     NULL },
-  { "htmlinclude",            DOX_INIT_EOL,     NULL },
-  { "htmlonly",               DOX_INIT_PRE,     "endhtmlonly" },
-
-  { "idlexcept",              DOX_INIT_EOL,     NULL },
-  { "if",                     DOX_INIT_EOL,     "endif" },
-  { "ifnot",                  DOX_INIT_EOL,     "endif" },
-  { "image",                  DOX_INIT_EOL,     NULL },
-  { "implements",             DOX_INIT_EOL,     NULL },
-  { "include",                DOX_INIT_EOL,     NULL },
-  { "includedbygraph",        DOX_INIT_EOL,     NULL },
-  { "includedoc",             DOX_INIT_EOL,     NULL },
-  { "includegraph",           DOX_INIT_EOL,     NULL },
-  { "includelineno",          DOX_INIT_EOL,     NULL },
-  { "ingroup",                DOX_INIT_EOL,     NULL },
-  { "interface",              DOX_INIT_EOL,     NULL },
-  { "internal",               DOX_INIT_EOL,     "endinternal" },
-  { "invariant",              DOX_INIT_PAR,     NULL },
-
-  { "latexinclude",           DOX_INIT_EOL,     NULL },
-  { "latexonly",              DOX_INIT_PRE,     "endlatexonly" },
-  { "li",                     DOX_INIT_PAR,     NULL },
-  { "line",                   DOX_INIT_EOL,     NULL },
-  { "link",                   DOX_INIT_INLINE,  "endlink" },
-
-  { "mainpage",               DOX_INIT_EOL,     NULL },
-  { "maninclude",             DOX_INIT_EOL,     NULL },
-  { "manonly",                DOX_INIT_PRE,     "endmanonly" },
-  { "memberof",               DOX_INIT_EOL,     NULL },
-  { "module",                 DOX_INIT_EOL,     NULL },
-  { "msc",                    DOX_INIT_PRE,     "endmsc" },
-  { "mscfile",                DOX_INIT_EOL,     NULL },
-
-  { "n",                      DOX_INIT_EOL,     NULL },
-  { "name",                   DOX_INIT_EOL,     NULL },
-  { "noop",                   DOX_INIT_EOL,     NULL },
-  { "namespace",              DOX_INIT_EOL,     NULL },
-  { "nosubgrouping",          DOX_INIT_EOL,     NULL },
-  { "note",                   DOX_INIT_PAR,     NULL },
-
-  { "overload",               DOX_INIT_EOL,     NULL },
-
-  { "p",                      DOX_INIT_INLINE,  NULL },
-  { "package",                DOX_INIT_EOL,     NULL },
-  { "page",                   DOX_INIT_EOL,     NULL },
-  { "par",                    DOX_INIT_EOL,     NULL },
-  { "paragraph",              DOX_INIT_EOL,     NULL },
-  { "param",                  DOX_INIT_PAR,     NULL },
-  { "parblock",               DOX_INIT_EOL,     NULL },
-  { "post",                   DOX_INIT_PAR,     NULL },
-  { "pre",                    DOX_INIT_PAR,     NULL },
-  { "private",                DOX_INIT_EOL,     NULL },
-  { "privatesection",         DOX_INIT_EOL,     NULL },
-  { "property",               DOX_INIT_EOL,     NULL },
-  { "protected",              DOX_INIT_EOL,     NULL },
-  { "protectedsection",       DOX_INIT_EOL,     NULL },
-  { "protocol",               DOX_INIT_EOL,     NULL },
-  { "public",                 DOX_INIT_EOL,     NULL },
-  { "publicsection",          DOX_INIT_EOL,     NULL },
-  { "pure",                   DOX_INIT_BOL,     NULL },
-
-  { "qualifier",              DOX_INIT_EOL,     NULL },
-
-  { "raisewarning",           DOX_INIT_EOL,     NULL },
-  { "ref",                    DOX_INIT_INLINE,  NULL },
-  { "refitem",                DOX_INIT_INLINE,  NULL },
-  { "related",                DOX_INIT_EOL,     NULL },
-  { "relates",                DOX_INIT_EOL,     NULL },
-  { "relatedalso",            DOX_INIT_EOL,     NULL },
-  { "relatesalso",            DOX_INIT_EOL,     NULL },
-  { "remark",                 DOX_INIT_PAR,     NULL },
-  { "remarks",                DOX_INIT_PAR,     NULL },
-  { "result",                 DOX_INIT_PAR,     NULL },
-  { "return",                 DOX_INIT_PAR,     NULL },
-  { "returns",                DOX_INIT_PAR,     NULL },
-  { "retval",                 DOX_INIT_PAR,     NULL },
-  { "rtfonly",                DOX_INIT_PAR,     "endrtfonly" },
-
-  { "sa",                     DOX_INIT_EOL,     NULL },
-  { "secreflist",             DOX_INIT_EOL,     "endsecreflist" },
-  { "section",                DOX_INIT_EOL,     NULL },
-  { "see",                    DOX_INIT_PAR,     NULL },
-  { "short",                  DOX_INIT_PAR,     NULL },
-  { "showdate",               DOX_INIT_INLINE,  NULL },
-  { "showinitializer",        DOX_INIT_EOL,     NULL },
-  { "showrefby",              DOX_INIT_EOL,     NULL },
-  { "showrefs",               DOX_INIT_EOL,     NULL },
-  { "since",                  DOX_INIT_PAR,     NULL },
-  { "skip",                   DOX_INIT_EOL,     NULL },
-  { "skipline",               DOX_INIT_EOL,     NULL },
-  { "snippet",                DOX_INIT_EOL,     NULL },
-  { "snippetdoc",             DOX_INIT_EOL,     NULL },
-  { "snippetlineno",          DOX_INIT_EOL,     NULL },
-  { "startuml",               DOX_INIT_PRE,     "enduml" },
-  { "static",                 DOX_INIT_EOL,     NULL },
-  { "struct",                 DOX_INIT_INLINE,  NULL },
-  { "subpage",                DOX_INIT_EOL,     NULL },
-  { "subsection",             DOX_INIT_EOL,     NULL },
-  { "subsubsection",          DOX_INIT_EOL,     NULL },
-
-  { "tableofcontents",        DOX_INIT_EOL,     NULL },
-  { "test",                   DOX_INIT_PAR,     NULL },
-  { "throw",                  DOX_INIT_PAR,     NULL },
-  { "throws",                 DOX_INIT_PAR,     NULL },
-  { "todo",                   DOX_INIT_PAR,     NULL },
-  { "tparam",                 DOX_INIT_PAR,     NULL },
-  { "typedef",                DOX_INIT_EOL,     NULL },
-
-  { "union",                  DOX_INIT_EOL,     NULL },
-  { "until",                  DOX_INIT_EOL,     NULL },
-
-  { "var",                    DOX_INIT_EOL,     NULL },
-  { "verbatim",               DOX_INIT_PRE,     "endverbatim" },
-  { "verbinclude",            DOX_INIT_EOL,     NULL },
-  { "version",                DOX_INIT_PAR,     NULL },
-  { "vhdlflow",               DOX_INIT_EOL,     NULL },
-
-  { "warning",                DOX_INIT_PAR,     NULL },
-  { "weakgroup",              DOX_INIT_EOL,     NULL },
-
-  { "xmlinclude",             DOX_INIT_EOL,     NULL },
-  { "xmlonly",                DOX_INIT_PRE,     "endxml" },
-  { "xrefitem",               DOX_INIT_PAR,     NULL },
-
-  { "{",                      DOX_INIT_EOL,     NULL },
-  { "}",                      DOX_INIT_EOL,     NULL },
-};
-
-////////// local functions ////////////////////////////////////////////////////
-
-/**
- * Comparison function for \ref dox_cmd.
- *
- * @param i_dox The first \ref dox_cmd.
- * @param j_dox The second \ref dox_cmd.
- * @return Returns an integer less than, equal to, or greater than 0, according
- * to whether the data pointed to by \a i_dox is less than, equal to, or
- * greater than the data pointed to by \a j_dox.
-
- */
-NODISCARD
-static int dox_cmd_cmp( dox_cmd_t const *i_dox, dox_cmd_t const *j_dox ) {
-  return strcmp( i_dox->name, j_dox->name );
-}
-
 ////////// extern functions ///////////////////////////////////////////////////
 
 dox_cmd_t const* dox_find_cmd( char const *s ) {
-  return bsearch(
-    &(dox_cmd_t){ .name = s }, DOX_COMMANDS,
-    ARRAY_SIZE( DOX_COMMANDS ), sizeof( DOX_COMMANDS[0] ),
-    POINTER_CAST( bsearch_cmp_fn_t, &dox_cmd_cmp )
-  );
+  assert( s != NULL );
+  uint32_t const hash = dox_hash( s );
+  uint16_t const seed = DOX_HASH_SEED[ dox_hash_bucket( hash ) ];
+  dox_cmd_t const *const dox_cmd =
+    &DOX_COMMANDS[ DOX_HASH_INDEX[ dox_hash_slot( hash, seed ) ] ];
+  return strcmp( dox_cmd->name, s ) == 0 ? dox_cmd : NULL;
 }
 
 bool dox_parse_cmd_name( char const *s, char *dox_cmd_name ) {
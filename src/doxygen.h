@@ -35,9 +35,15 @@
 // standard
 #include <stdbool.h>
 #include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint*_t */
 
 /// @endcond
 
+_GL_INLINE_HEADER_BEGIN
+#ifndef W_DOXYGEN_H_INLINE
+# define W_DOXYGEN_H_INLINE _GL_INLINE
+#endif /* W_DOXYGEN_H_INLINE */
+
 /**
  * @ingroup wrapc-group
  * @defgroup doxygen-group Doxygen Support
@@ -55,6 +61,11 @@
  */
 #define DOX_CMD_NAME_SIZE_MAX     22
 
+/**
+ * Number of bits of a dox_hash() value used by dox_hash_bucket().
+ */
+#define DOX_HASH_BUCKET_BITS      6
+
 /**
  * Doxygen command type.
  */
@@ -211,6 +222,33 @@ struct dox_cmd {
 };
 typedef struct dox_cmd dox_cmd_t;
 
+// extern variables
+
+/**
+ * All [Doxygen](http://www.doxygen.org/) commands sorted by name.
+ */
+extern dox_cmd_t const  DOX_COMMANDS[];
+
+/**
+ * Number of elements in \ref DOX_COMMANDS.
+ */
+extern size_t const     DOX_COMMANDS_LEN;
+
+/**
+ * Indexed by dox_hash_slot(), gives the index into \ref DOX_COMMANDS of the
+ * only command that can have that slot.
+ *
+ * @note This is generated at build time by `gen_dox_hash`.
+ */
+extern uint8_t const    DOX_HASH_INDEX[];
+
+/**
+ * Indexed by dox_hash_bucket(), gives the seed to pass to dox_hash_slot().
+ *
+ * @note This is generated at build time by `gen_dox_hash`.
+ */
+extern uint16_t const   DOX_HASH_SEED[];
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -223,6 +261,51 @@ typedef struct dox_cmd dox_cmd_t;
 NODISCARD
 dox_cmd_t const* dox_find_cmd( char const *s );
 
+/**
+ * Hashes a Doxygen command name.
+ *
+ * @param s The null-terminated command name to hash.
+ * @return Returns the FNV-1a hash of \a s.
+ *
+ * @sa dox_hash_bucket()
+ * @sa dox_hash_slot()
+ */
+NODISCARD W_DOXYGEN_H_INLINE
+uint32_t dox_hash( char const *s ) {
+  uint32_t hash = 2166136261u;
+  while ( *s != '\0' )
+    hash = (hash ^ (unsigned char)*s++) * 16777619u;
+  return hash;
+}
+
+/**
+ * Gets the bucket for a command name.
+ *
+ * @param hash The dox_hash() of the command name.
+ * @return Returns the index into \ref DOX_HASH_SEED of the seed to pass to
+ * dox_hash_slot().
+ */
+NODISCARD W_DOXYGEN_H_INLINE
+size_t dox_hash_bucket( uint32_t hash ) {
+  return hash >> (32 - DOX_HASH_BUCKET_BITS);
+}
+
+/**
+ * Gets the slot for a command name.
+ *
+ * @remarks Together with the seeds in \ref DOX_HASH_SEED, this is a minimal
+ * perfect hash function over the names in \ref DOX_COMMANDS: each command
+ * has a distinct slot in the range [0, \ref DOX_COMMANDS_LEN).
+ *
+ * @param hash The dox_hash() of the command name.
+ * @param seed The seed for the command name's bucket.
+ * @return Returns the index into \ref DOX_HASH_INDEX.
+ */
+NODISCARD W_DOXYGEN_H_INLINE
+size_t dox_hash_slot( uint32_t hash, uint16_t seed ) {
+  return (((hash ^ seed) * 2654435761u) >> 16) % DOX_COMMANDS_LEN;
+}
+
 /**
  * Attempts to parse a Doxygen command at the start of \a s.
  *
@@ -237,6 +320,8 @@ bool dox_parse_cmd_name( char const *s, char *dox_cmd_name );
 
 ///////////////////////////////////////////////////////////////////////////////
 
+_GL_INLINE_HEADER_END
+
 /** @} */
 
 #endif /* wrap_doxygen_H */
@@ -0,0 +1,1782 @@
+/*
+**      wrap -- text reformatter
+**      src/engine.c
+**
+**      Copyright (C) 1996-2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines functions for the reentrant text-wrapping engine that **wrap**(1) is
+ * built upon.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "engine.h"
+#include "common.h"
+#include "markdown.h"
+#include "options.h"
+#include "trace.h"
+#include "unicode.h"
+#include "uri.h"
+#include "util.h"
+#include "wregex.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif /* __SSE2__ */
+
+/// @endcond
+
+/**
+ * @addtogroup engine-group
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define WIPC_DEFERF(BUF,SIZE,CODE,FORMAT,...) \
+  snprintf( (BUF), (SIZE), ("%c" FORMAT), (CODE), __VA_ARGS__ )
+
+/**
+ * Cost of a line that's too long when doing optimal-fit filling.  It's large
+ * enough never to be chosen over any other way of breaking lines, but small
+ * enough that adding any number of other line costs to it can't overflow.
+ */
+#define FIT_COST_INFINITY         (UINT64_MAX / 2)
+
+/**
+ * Length of the output buffer after which, when doing optimal-fit filling, all
+ * but the last line of the paragraph so far are printed.
+ */
+#define FIT_OUTPUT_LEN_MAX        (LINE_BUF_SIZE / 2)
+
+/**
+ * Length of assembled output after which it's written.
+ */
+#define PUT_BUF_SIZE              (64 * 1024)
+
+// local variable definitions
+static bool         ascii_is_plain[256];///< See copy_plain_ascii().
+#ifdef __SSE2__
+static __m128i      ascii_special[16];  ///< Printable, but not plain, ASCII.
+static size_t       ascii_special_len;  ///< Length of ascii_special.
+#endif /* __SSE2__ */
+static bool         ascii_is_para_delim[128];///< From opt_para_delims.
+static wregex_t     block_regex;        ///< Compiled from opt_block_regex.
+
+// local functions
+NODISCARD
+static char32_t     buf_getcp( wrap_ctx_t*, char const**, utf8c_t );
+
+NODISCARD
+static bool         buf_readline( wrap_ctx_t* );
+
+static void         copy_plain_ascii( wrap_ctx_t*, char const**,
+                                      char const* );
+static void         delimit_paragraph( wrap_ctx_t*, trace_delim_t );
+static void         engine_cleanup( void );
+static void         find_nonws_no_wrap_spans( wrap_ctx_t*, size_t );
+static void         fit_add_break( wrap_ctx_t*, size_t );
+
+NODISCARD
+static uint64_t     fit_cost( wrap_ctx_t const*, size_t, size_t, bool );
+
+static void         fit_put_lines( wrap_ctx_t*, bool );
+static void         fit_reserve( wrap_ctx_t*, size_t );
+static void         init_first_line( wrap_ctx_t*, size_t );
+
+NODISCARD
+static bool         markdown_adjust( wrap_ctx_t* );
+
+static void         markdown_reset( wrap_ctx_t* );
+
+NODISCARD
+static size_t       plain_ascii_span( char const*, size_t );
+
+static void         put_flush( wrap_ctx_t* );
+static void         put_lead_chars( wrap_ctx_t* );
+static void         put_line( wrap_ctx_t*, size_t, bool );
+static void         put_tabs_spaces( wrap_ctx_t*, size_t, size_t );
+static void         wipc_parse( wrap_ctx_t*, char const** );
+static void         wipc_send( wrap_ctx_t* );
+static void         wrap_line( wrap_ctx_t* );
+
+////////// inline functions ///////////////////////////////////////////////////
+
+/**
+ * Checks whether the "block" regular expression matches the input buffer.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @return Returns `true` only if it does.
+ */
+NODISCARD
+static inline bool block_regex_matches( wrap_ctx_t *ctx ) {
+  if ( opt_block_regex == NULL )
+    return false;
+  ++ctx->stats.block_regex_calls;
+  TRACE_BEGIN( prev_phase, TRACE_PHASE_REGEX );
+  bool matched = regex_can_match( &block_regex, ctx->input_buf, 0 );
+  if ( matched ) {
+    ++ctx->stats.block_regex_execs;
+    matched = regex_exec(
+      &block_regex, &ctx->block_regex_cache, ctx->input_buf, 0, NULL
+    );
+  } else {
+    ++ctx->stats.block_regex_rejects;
+  }
+  TRACE_END( prev_phase );
+  if ( !matched )
+    return false;
+  ++ctx->stats.block_regex_matches;
+  return true;
+}
+
+/**
+ * Checks whether \a cp is a paragraph delimiter Unicode character.
+ *
+ * @param cp The Unicode code-point to check.
+ * @return Returns `true` only if \a cp is a paragraph delimiter character.
+ */
+NODISCARD
+static inline bool cp_is_para_delim( char32_t cp ) {
+  return cp_is_ascii( cp ) && ascii_is_para_delim[ cp ];
+}
+
+/**
+ * Ensures there's room for at least \a n more characters (plus a terminating
+ * null) in the output buffer.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param n The number of characters.
+ */
+static inline void output_reserve( wrap_ctx_t *ctx, size_t n ) {
+  size_t const size = ctx->output_len + n + 1/*\0*/;
+  if ( unlikely( size > ctx->output_cap ) )
+    str_reserve( &ctx->output_buf, &ctx->output_cap, size );
+}
+
+/**
+ * Appends \a n bytes to the assembled output, writing it if it's gotten big
+ * enough.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param s A pointer to the bytes to append.
+ * @param n The number of bytes.
+ *
+ * @sa put_chars()
+ * @sa put_flush()
+ * @sa put_str()
+ */
+static inline void put_bytes( wrap_ctx_t *ctx, char const *s, size_t n ) {
+  size_t const size = ctx->put_len + n;
+  if ( unlikely( size > ctx->put_cap ) )
+    str_reserve( &ctx->put_buf, &ctx->put_cap, size );
+  memcpy( ctx->put_buf + ctx->put_len, s, n );
+  ctx->put_len = size;
+  if ( unlikely( size >= PUT_BUF_SIZE ) )
+    put_flush( ctx );
+}
+
+/**
+ * Appends \a n copies of \a c to the assembled output.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param c The character to append.
+ * @param n The number of times to append it.
+ *
+ * @sa put_bytes()
+ */
+static inline void put_chars( wrap_ctx_t *ctx, char c, size_t n ) {
+  if ( n == 0 )
+    return;
+  size_t const size = ctx->put_len + n;
+  if ( unlikely( size > ctx->put_cap ) )
+    str_reserve( &ctx->put_buf, &ctx->put_cap, size );
+  memset( ctx->put_buf + ctx->put_len, c, n );
+  ctx->put_len = size;
+}
+
+/**
+ * Appends \a s to the assembled output.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param s The null-terminated string to append.
+ *
+ * @sa put_bytes()
+ */
+static inline void put_str( wrap_ctx_t *ctx, char const *s ) {
+  put_bytes( ctx, s, strlen( s ) );
+}
+
+/**
+ * Prints an end-of-line and sends any pending IPC message to **wrapc**(1).
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ */
+static inline void put_eol( wrap_ctx_t *ctx ) {
+  put_str( ctx, eol_str( ctx->opt_eol ) );
+  ++ctx->stats.lines_emitted;
+  wipc_send( ctx );
+}
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Gets the next character from the current line of input.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param ppc A pointer to the pointer to character to advance.
+ * @return Returns said character or \c EOF if either the end of the line has
+ * been reached or the rest of the line has otherwise been consumed.
+ */
+NODISCARD
+static int buf_getc( wrap_ctx_t *ctx, char const **ppc ) {
+  assert( ctx != NULL );
+  assert( ppc != NULL );
+  assert( *ppc != NULL );
+
+  if ( **ppc == '\0' )
+    return EOF;
+
+  if ( !opt_no_hyphen ) {
+    size_t const pos = STATIC_CAST( size_t, *ppc - ctx->input_buf );
+    //
+    // If we're past the current non-whitespace-no-wrap range, make the next
+    // one on the line, if any, current.
+    //
+    while ( pos >= ctx->nonws_no_wrap_range[1] &&
+            ctx->nonws_no_wrap_next < ctx->nonws_no_wrap_spans_len ) {
+      memcpy(
+        ctx->nonws_no_wrap_range,
+        ctx->nonws_no_wrap_spans[ ctx->nonws_no_wrap_next++ ],
+        sizeof ctx->nonws_no_wrap_range
+      );
+    } // while
+  }
+
+  int const c = STATIC_CAST( unsigned char, *(*ppc)++ );
+
+  if ( !opt_data_link_esc )
+    return c;
+
+  if ( c == WIPC_CODE_HELLO ) {
+    wipc_parse( ctx, ppc );
+    return EOF;
+  }
+
+  if ( ctx->is_preformatted ) {
+    put_str( ctx, ctx->input_buf );
+    return EOF;
+  }
+
+  return c;
+}
+
+/**
+ * Gets bytes comprising the next UTF-8 character and its corresponding Unicode
+ * code-point from the current line of input.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param ppc A pointer to the pointer to character to advance.
+ * @param utf8c The buffer to put the UTF-8 bytes into.
+ * @return Returns said code-point or \c CP_EOF.
+ */
+NODISCARD
+static char32_t buf_getcp( wrap_ctx_t *ctx, char const **ppc, utf8c_t utf8c ) {
+  int c;
+  if ( unlikely( (c = buf_getc( ctx, ppc )) == EOF ) )
+    return CP_EOF;
+  size_t const len = utf8_len( STATIC_CAST( char, c ) );
+  if ( unlikely( len == 0 ) )
+    return CP_INVALID;
+  utf8c[0] = STATIC_CAST( char, c );
+  for ( size_t i = 1; i < len; ++i ) {
+    if ( unlikely( (c = buf_getc( ctx, ppc )) == EOF ) )
+      return CP_EOF;
+    if ( unlikely( !utf8_is_cont( STATIC_CAST( char, c ) ) ) )
+      return CP_INVALID;
+    utf8c[i] = STATIC_CAST( char, c );
+  } // for
+
+  return utf8_decode( utf8c );
+}
+
+/**
+ * Checks whether the line just read should be wrapped.  If wrapping Markdown,
+ * adjust wrap's settings.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @return Returns `true` only if the line should be wrapped.
+ */
+NODISCARD
+static bool buf_readline( wrap_ctx_t *ctx ) {
+  //
+  // If we're doing Markdown, we might have to adjust wrap's indent,
+  // hang-indent, and line-width for each Markdown line.
+  //
+  // However, don't pass either IPC lines or any lines while is_preformatted
+  // is true through the Markdown parser.
+  //
+  bool const is_wrap = !opt_markdown ||
+    ctx->input_buf[0] == WIPC_CODE_HELLO || ctx->is_preformatted ||
+    markdown_adjust( ctx );
+
+  TRACE_EVENT(
+    TRACE_EVENT_READLINE, is_wrap, ctx->stats.lines_read, ctx->output_len,
+    ctx->hyphen
+  );
+  return is_wrap;
+}
+
+/**
+ * Copies a run of "plain" ASCII characters, that is characters that need none
+ * of the special handling wrap_line() does for the others, e.g., spaces,
+ * hyphens, and end-of-sentence characters, from the current line of input to
+ * the output buffer all at once.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param ppc A pointer to the pointer to character to advance.
+ * @param end A pointer to one past the last character of the line.
+ *
+ * @remarks The run is copied only if the state is such that wrap_line() would
+ * have done nothing else for each character in it but append it to the output
+ * buffer.  It stops short of either the line width being reached (or, when
+ * doing optimal-fit filling, the output buffer filling up).  Since plain ASCII
+ * characters are never hyphens, it doesn't matter whether they're within a
+ * non-whitespace-no-wrap range.
+ */
+static void copy_plain_ascii( wrap_ctx_t *ctx, char const **ppc,
+                              char const *end ) {
+  if ( ctx->cp_prev == '\n' || ctx->put_spaces > 0 ||
+       ctx->indent != INDENT_NONE || ctx->hyphen == HYPHEN_MAYBE ||
+       ctx->is_preformatted ) {
+    return;
+  }
+
+  //
+  // The number of characters that can be appended before the output buffer is
+  // full -- either by the line width or, when doing optimal-fit filling, by
+  // length.
+  //
+  size_t const used = opt_optimal ? ctx->output_len + 1 : ctx->output_width + 1;
+  size_t const full = opt_optimal ? FIT_OUTPUT_LEN_MAX : ctx->line_width;
+  if ( used >= full )
+    return;
+  size_t max_n = full - used;
+
+  size_t const end_n = STATIC_CAST( size_t, end - *ppc );
+  size_t const n = plain_ascii_span( *ppc, end_n < max_n ? end_n : max_n );
+  if ( n == 0 )
+    return;
+
+  output_reserve( ctx, n );
+  memcpy( ctx->output_buf + ctx->output_len, *ppc, n );
+  ctx->output_len += n;
+  ctx->output_width += n;
+  ctx->stats.cps_read += n;
+  *ppc += n;
+
+  ctx->consec_newlines = 0;
+  ctx->cp_prev = STATIC_CAST( unsigned char, (*ppc)[-1] );
+  ctx->encountered_nonws = true;
+  ctx->was_eos_char = false;
+}
+
+/**
+ * Delimits a paragraph.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param why The reason the paragraph is being delimited (used only for
+ * tracing).
+ */
+static void delimit_paragraph( wrap_ctx_t *ctx,
+                               MAYBE_UNUSED trace_delim_t why ) {
+  TRACE_EVENT(
+    TRACE_EVENT_DELIMIT, why, ctx->stats.lines_read, ctx->output_len,
+    ctx->hyphen
+  );
+  if ( ctx->output_len > 0 || ctx->is_long_line )
+    ++ctx->stats.paras_delimited;
+
+  if ( ctx->output_len > 0 ) {
+    //
+    // Print what's in the buffer before delimiting the paragraph.  If we've
+    // been handling a "long line," it's now finally ended; otherwise, print
+    // the leading characters.
+    //
+    if ( !true_clear( &ctx->is_long_line ) )
+      put_lead_chars( ctx );
+    put_line( ctx, ctx->output_len, /*do_eol=*/true );
+  } else if ( ctx->is_long_line ) {
+    put_eol( ctx );                     // delimit the "long line"
+  }
+
+  if ( opt_unbuffered ) {
+    put_flush( ctx );
+    PERROR_EXIT_IF( fflush( ctx->fout ) != 0, EX_IOERR );
+  }
+
+  ctx->encountered_nonws = false;
+  ctx->hyphen = HYPHEN_NO;
+  ctx->indent = opt_markdown ? INDENT_NONE : INDENT_LINE;
+  ctx->put_spaces = 0;
+  ctx->was_eos_char = false;
+  //
+  // Forget any position at which we could have wrapped: it's a position in
+  // the previous paragraph's output.  Were it kept and the first word of the
+  // next paragraph is longer than the line width, we'd wrap the word there
+  // (and drop the character at that position).
+  //
+  ctx->wrap_pos = 0;
+
+  if ( ctx->consec_newlines == 2 ||
+      (ctx->consec_newlines > 2 && opt_newlines_delimit == 1) ) {
+    put_lead_chars( ctx );
+    put_eol( ctx );
+  }
+}
+
+/**
+ * Cleans up wrap engine data.
+ */
+static void engine_cleanup( void ) {
+  regex_free( &block_regex );
+}
+
+/**
+ * Finds all the non-whitespace-no-wrap ranges in the current line of input in
+ * a single left-to-right scan so buf_getc() need only compare its position
+ * against the next one.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param offset The offset into the input buffer to start.
+ */
+static void find_nonws_no_wrap_spans( wrap_ctx_t *ctx, size_t offset ) {
+  ctx->nonws_no_wrap_range[0] = ctx->nonws_no_wrap_range[1] = 0;
+  ctx->nonws_no_wrap_spans_len = ctx->nonws_no_wrap_next = 0;
+
+  ++ctx->stats.uri_find_calls;
+  TRACE_BEGIN( prev_phase, TRACE_PHASE_REGEX );
+  for ( size_t range[2];
+        uri_find( ctx->input_buf, offset, range ); offset = range[1] ) {
+    ++ctx->stats.uri_find_matches;
+    if ( ctx->nonws_no_wrap_spans_len == ctx->nonws_no_wrap_spans_cap ) {
+      ctx->nonws_no_wrap_spans_cap = ctx->nonws_no_wrap_spans_cap < 8 ?
+        8 : ctx->nonws_no_wrap_spans_cap * 2;
+      REALLOC(
+        ctx->nonws_no_wrap_spans, size_t[2], ctx->nonws_no_wrap_spans_cap
+      );
+    }
+    memcpy(
+      ctx->nonws_no_wrap_spans[ ctx->nonws_no_wrap_spans_len++ ],
+      range, sizeof range
+    );
+  } // for
+  TRACE_END( prev_phase );
+}
+
+/**
+ * Adds a place at which a line may be broken when doing optimal-fit filling:
+ * at the current end of the output buffer.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param spaces The number of spaces about to be put into the output buffer
+ * that are to be dropped if a line is broken here.
+ */
+static void fit_add_break( wrap_ctx_t *ctx, size_t spaces ) {
+  fit_reserve( ctx, ctx->breaks_len + 2/*start + this*/ + 1/*end*/ );
+  if ( ctx->breaks_len == 0 ) {
+    //
+    // Break 0 is always the start of the output buffer.
+    //
+    MEM_ZERO( &ctx->breaks[0] );
+    ctx->breaks_len = 1;
+  }
+  ctx->breaks[ ctx->breaks_len++ ] = (wrap_break_t){
+    .end_len    = ctx->output_len,
+    .end_width  = ctx->output_width,
+    .next_len   = ctx->output_len + spaces,
+    .next_width = ctx->output_width + spaces
+  };
+}
+
+/**
+ * Gets the total cost of the lines through break \a i followed by a line from
+ * break \a i to break \a j when doing optimal-fit filling.  The cost of a
+ * line is the square of the width left unused at the end of the line.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param i The index of the break the line starts after.
+ * @param j The index of the break the line ends at.
+ * @param is_last If `true`, the line is the last one of the paragraph so its
+ * unused width costs nothing.
+ * @return Returns said cost or #FIT_COST_INFINITY if the line is too long.
+ */
+NODISCARD
+static uint64_t fit_cost( wrap_ctx_t const *ctx, size_t i, size_t j,
+                          bool is_last ) {
+  assert( i < j );
+  wrap_break_t const *const b = ctx->breaks;
+  size_t width = b[j].end_width - b[i].next_width;
+  if ( i > 0 )
+    width += opt_hang_tabs * opt_tab_spaces + ctx->opt_hang_spaces;
+  //
+  // The greedy algorithm wraps as soon as a line's width reaches line_width,
+  // so the longest line it ever prints is one less than that.
+  //
+  size_t const max_width = ctx->line_width - 1;
+  if ( width > max_width ) {
+    //
+    // A line that's too long is acceptable only if it can't be broken at all
+    // (it's a "long line") since it then has to be on a line by itself anyway.
+    //
+    return j == i + 1 ? b[i].cost : FIT_COST_INFINITY;
+  }
+  if ( is_last )
+    return b[i].cost;
+  uint64_t const slack = max_width - width;
+  return b[i].cost + slack * slack;
+}
+
+/**
+ * Prints all but the last line of the text in the output buffer, choosing the
+ * breaks between lines so as to minimize the sum of the costs of all lines.
+ * The last line is then moved to the start of the output buffer.
+ *
+ * @remarks Because the cost of a line increases ever faster the wider the line
+ * is, the best previous break for each break is non-decreasing.  Hence, rather than
+ * checking every previous break for every break (that would be quadratic),
+ * candidate previous breaks are kept in a queue each along with the first
+ * break it's best for: this makes the time taken _O(n log n)_ rather than
+ * _O(n^2)_.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param is_end If `true`, the caller has already printed the leading
+ * characters for the first line and is about to print the last line, so the
+ * leading characters for the last line are printed (if there is more than one
+ * line); if `false`, the output buffer is merely filling up, so the leading
+ * characters for the first line are printed instead.
+ */
+static void fit_put_lines( wrap_ctx_t *ctx, bool is_end ) {
+  assert( ctx->breaks_len > 1 );
+  size_t const n = ctx->breaks_len;     // breaks are [0,n); end of text is n
+  fit_reserve( ctx, n + 1 );
+  wrap_break_t *const b = ctx->breaks;
+  wrap_fit_cand_t *const q = ctx->fit_cands;
+
+  b[n] = (wrap_break_t){
+    .end_len    = ctx->output_len,
+    .end_width  = ctx->output_width,
+    .next_len   = ctx->output_len,
+    .next_width = ctx->output_width
+  };
+
+#define COST_VIA(I,J)   fit_cost( ctx, (I), (J), /*is_last=*/false )
+
+  b[0].cost = 0;
+  size_t q_head = 0, q_tail = 0;
+  q[ q_tail++ ] = (wrap_fit_cand_t){ .node = 0, .from = 1 };
+
+  for ( size_t j = 1; j < n; ++j ) {
+    while ( q_head + 1 < q_tail && q[ q_head + 1 ].from <= j )
+      ++q_head;
+    b[j].prev = q[ q_head ].node;
+    b[j].cost = COST_VIA( b[j].prev, j );
+
+    //
+    // Now consider break j as a candidate previous break for all subsequent
+    // breaks: first drop all candidates it's better than for their entire
+    // ranges.
+    //
+    size_t from = j + 1;
+    while ( q_tail > q_head ) {
+      wrap_fit_cand_t const *const c = &q[ q_tail - 1 ];
+      size_t const c_from = c->from > j + 1 ? c->from : j + 1;
+      if ( COST_VIA( j, c_from ) > COST_VIA( c->node, c_from ) )
+        break;
+      from = c_from;
+      --q_tail;
+    } // while
+
+    if ( q_tail > q_head ) {
+      //
+      // Binary search for the first break for which j is better than the last
+      // remaining candidate, if any.
+      //
+      wrap_fit_cand_t const *const c = &q[ q_tail - 1 ];
+      size_t const c_node = c->node;
+      size_t lo = (c->from > j + 1 ? c->from : j + 1) + 1, hi = n;
+      while ( lo < hi ) {
+        size_t const mid = lo + (hi - lo) / 2;
+        if ( COST_VIA( j, mid ) <= COST_VIA( c_node, mid ) )
+          hi = mid;
+        else
+          lo = mid + 1;
+      } // while
+      from = lo;
+    }
+    if ( from < n )
+      q[ q_tail++ ] = (wrap_fit_cand_t){ .node = j, .from = from };
+  } // for
+
+  //
+  // The last line costs nothing (if it fits) so it would break the property
+  // that the best previous break is non-decreasing: just check every break.
+  //
+  b[n].prev = 0;
+  b[n].cost = FIT_COST_INFINITY;
+  for ( size_t i = 0; i < n; ++i ) {
+    uint64_t const cost = fit_cost( ctx, i, n, /*is_last=*/true );
+    if ( cost <= b[n].cost ) {
+      b[n].cost = cost;
+      b[n].prev = i;
+    }
+  } // for
+
+#undef COST_VIA
+
+  //
+  // Follow the chain of best previous breaks backwards from the end of the
+  // text, reusing the candidate queue to hold the breaks in reverse order.
+  //
+  size_t lines = 0;
+  for ( size_t j = n; j > 0; j = b[j].prev )
+    q[ lines++ ].node = j;
+  if ( lines < 2 )
+    return;
+
+  size_t start = 0;
+  while ( --lines > 0 ) {
+    size_t const end = q[ lines ].node;
+    if ( start > 0 || !is_end )
+      put_lead_chars( ctx );
+    if ( start > 0 ) {
+      put_chars( ctx, '\t', opt_hang_tabs );
+      put_chars( ctx, ' ', ctx->opt_hang_spaces );
+    }
+    put_bytes(
+      ctx, ctx->output_buf + b[start].next_len,
+      b[end].end_len - b[start].next_len
+    );
+    put_eol( ctx );
+    if ( b[end].next_len == b[end].end_len )
+      ++ctx->stats.hyphen_wraps;        // no spaces to drop: at a hyphen
+    start = end;
+  } // while
+
+  if ( is_end )
+    put_lead_chars( ctx );
+
+  //
+  // Move the last line to the start of the output buffer preceded by the
+  // hang indent and adjust the remaining breaks accordingly.
+  //
+  size_t const last_len = ctx->output_len - b[start].next_len;
+  size_t const last_width = ctx->output_width - b[start].next_width;
+  size_t const hang_len = opt_hang_tabs + ctx->opt_hang_spaces;
+  memmove(
+    ctx->output_buf + hang_len, ctx->output_buf + b[start].next_len, last_len
+  );
+  size_t const old_next_len = b[start].next_len;
+  size_t const old_next_width = b[start].next_width;
+  ctx->output_len = ctx->output_width = 0;
+  put_tabs_spaces( ctx, opt_hang_tabs, ctx->opt_hang_spaces );
+  ctx->output_len += last_len;
+  ctx->output_width += last_width;
+
+  size_t const hang_width = ctx->output_width - last_width;
+  ctx->breaks_len = 1;
+  for ( size_t i = start + 1; i < n; ++i ) {
+    wrap_break_t *const to = &b[ ctx->breaks_len++ ];
+    *to = b[i];
+    to->end_len    = to->end_len    - old_next_len   + hang_len;
+    to->end_width  = to->end_width  - old_next_width + hang_width;
+    to->next_len   = to->next_len   - old_next_len   + hang_len;
+    to->next_width = to->next_width - old_next_width + hang_width;
+  } // for
+  if ( ctx->breaks_len == 1 )
+    ctx->breaks_len = 0;
+}
+
+/**
+ * Ensures there's room for at least \a n breaks.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param n The number of breaks.
+ */
+static void fit_reserve( wrap_ctx_t *ctx, size_t n ) {
+  if ( n <= ctx->breaks_cap )
+    return;
+  ctx->breaks_cap = ctx->breaks_cap < 64 ? 64 : ctx->breaks_cap * 2;
+  if ( ctx->breaks_cap < n )
+    ctx->breaks_cap = n;
+  REALLOC( ctx->breaks, wrap_break_t, ctx->breaks_cap );
+  REALLOC( ctx->fit_cands, wrap_fit_cand_t, ctx->breaks_cap );
+}
+
+/**
+ * Initializes the parts of \a ctx that depend on the first line of input:
+ * probes it for end-of-line type and copies the prototype.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param bytes_read The number of bytes comprising the first line.
+ */
+static void init_first_line( wrap_ctx_t *ctx, size_t bytes_read ) {
+  if ( ctx->opt_eol == EOL_INPUT ) {
+    //
+    // We're supposed to use the same end-of-lines as the input, but we can't
+    // just wait until we read a \r as part of the normal character-at-a-time
+    // input stream to know it's using Windows end-of-lines because if the
+    // first line is a long line, we'll need to wrap it (by emitting a newline)
+    // before we get to the end of the line and read the \r.
+    //
+    // Therefore, we have to peek at only the first line in its entirety to see
+    // if it ends with \r\n.
+    //
+    ctx->opt_eol = is_windows_eol( ctx->input_buf, bytes_read ) ?
+      EOL_WINDOWS : EOL_UNIX;
+  }
+
+  //
+  // Copy the prototype and calculate its width.
+  //
+  if ( opt_lead_string != NULL || opt_prototype ) {
+    size_t proto_len = 0;
+    size_t proto_width = 0;
+    for ( char const *s =
+            opt_lead_string != NULL ? opt_lead_string : ctx->input_buf;
+          *s != '\0';
+          ++s, ++proto_len ) {
+      if ( opt_prototype && !is_space( *s ) )
+        break;
+      if ( proto_len == sizeof ctx->proto_buf - 1 )
+        break;
+      ctx->proto_buf[ proto_len ] = *s;
+      proto_width += *s == '\t' ?
+        (opt_tab_spaces - proto_len % opt_tab_spaces) : 1;
+    } // for
+    ctx->line_width = ctx->opt_line_width - proto_width;
+    if ( opt_lead_string != NULL ) {
+      //
+      // Split off the trailing whitespace (tws) from the prototype so that if
+      // we read a line that's empty, we won't emit trailing whitespace when we
+      // prepend the prototype. For example, given:
+      //
+      //      # foo
+      //      #
+      //      # bar
+      //
+      // and a prototype of "# ", if we didn't split off trailing whitespace,
+      // then when we wrapped the text above, the second line would become "# "
+      // containing a trailing whitespace.
+      //
+      split_tws( ctx->proto_buf, proto_len, ctx->proto_tws );
+    }
+  }
+}
+
+/**
+ * Adjusts wrap's indent, hang-indent, and line-width for each Markdown line.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @return Returns `true` if we're to proceed or \c false if the line has been
+ * handled.
+ */
+NODISCARD
+static bool markdown_adjust( wrap_ctx_t *ctx ) {
+  TRACE_BEGIN( prev_phase, TRACE_PHASE_MARKDOWN );
+  md_state_t const *const md = markdown_parse( &ctx->md, ctx->input_buf );
+  TRACE_END( prev_phase );
+  stats_md_line( &ctx->stats, md->line_type );
+  MD_DEBUG(
+    "T=%c N=%2u D=%u L=%u H=%u|%s",
+    STATIC_CAST( char, md->line_type ), md->seq_num, md->depth,
+    md->indent_left, md->indent_hang, ctx->input_buf
+  );
+
+  if ( ctx->md_prev_line_type != md->line_type ) {
+    switch ( ctx->md_prev_line_type ) {
+      case MD_CODE:
+      case MD_HEADER_ATX:
+      case MD_HR:
+      case MD_HTML_ABBR:
+      case MD_HTML_BLOCK:
+      case MD_LINK_LABEL:
+      case MD_TABLE:
+        ctx->consec_newlines = 0;
+        if ( is_blank_line( ctx->input_buf ) ) {
+          //
+          // Prevent blank lines immediately after these Markdown line types
+          // from being swallowed by wrap by just printing them directly.
+          //
+          put_str( ctx, ctx->input_buf );
+        }
+        break;
+      case MD_DL:
+      case MD_FOOTNOTE_DEF:
+      case MD_HEADER_LINE:
+      case MD_NONE:
+      case MD_OL:
+      case MD_TEXT:
+      case MD_UL:
+        // nothing to do
+        break;
+    } // switch
+
+    if ( md->line_type == MD_FOOTNOTE_DEF && !md->footnote_def_has_text ) {
+      //
+      // For a footnote definition line that does not have text on the same
+      // line:
+      //
+      //      [^1]:
+      //          Like this.
+      //
+      // print the marker line as-is "behind wrap's back" so it won't be
+      // wrapped.
+      //
+      put_str( ctx, ctx->input_buf );
+      ctx->input_buf[0] = '\0';
+    }
+
+    ctx->md_prev_line_type = md->line_type;
+  }
+
+  switch ( md->line_type ) {
+    case MD_CODE:
+    case MD_HEADER_ATX:
+    case MD_HEADER_LINE:
+    case MD_HR:
+    case MD_HTML_ABBR:
+    case MD_HTML_BLOCK:
+    case MD_LINK_LABEL:
+    case MD_TABLE:
+      //
+      // Flush output_buf and print the Markdown line as-is "behind wrap's
+      // back" because these line types are never wrapped.
+      //
+      put_lead_chars( ctx );
+      put_line( ctx, ctx->output_len, /*do_eol=*/true );
+      put_str( ctx, ctx->input_buf );
+      return false;
+
+    case MD_DL:
+    case MD_FOOTNOTE_DEF:
+    case MD_OL:
+    case MD_UL:
+      if ( md->seq_num > ctx->md_prev_seq_num ) {
+        //
+        // We're changing line types: flush output_buf.
+        //
+        put_lead_chars( ctx );
+        put_line( ctx, ctx->output_len, /*do_eol=*/true );
+        ctx->md_prev_seq_num = md->seq_num;
+      }
+      else if ( ctx->output_len == 0 && !is_blank_line( ctx->input_buf ) ) {
+        //
+        // Same line type, but new line: hang indent.
+        //
+        put_tabs_spaces( ctx, /*tabs=*/0, md->indent_hang );
+      }
+      ctx->line_width = ctx->opt_line_width - md->indent_left;
+      ctx->opt_lead_spaces = md->indent_left;
+      ctx->opt_hang_spaces = md->indent_hang;
+      return true;
+
+    case MD_NONE:
+    case MD_TEXT:
+      markdown_reset( ctx );
+      return true;
+  } // switch
+
+  UNEXPECTED_INT_VALUE( md->line_type );
+}
+
+/**
+ * Resets variables affected by the Markdown parser.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ */
+static void markdown_reset( wrap_ctx_t *ctx ) {
+  ctx->line_width = ctx->opt_line_width;
+  ctx->opt_hang_spaces = ctx->opt_lead_spaces = 0;
+}
+
+/**
+ * Gets the number of leading characters of \a s that are "plain" ASCII.
+ *
+ * @param s A pointer to the characters.
+ * @param n The maximum number of characters to check.
+ * @return Returns said number of characters.
+ *
+ * @sa copy_plain_ascii()
+ */
+static size_t plain_ascii_span( char const *s, size_t n ) {
+  size_t i = 0;
+#ifdef __SSE2__
+  //
+  // Check 16 characters at a time: bytes >= 0x80 compare as negative, so the
+  // single signed comparison catches both control and non-ASCII characters.
+  //
+  __m128i const above_space = _mm_set1_epi8( ' ' + 1 );
+  __m128i const del = _mm_set1_epi8( 0x7F );
+  for ( ; n - i >= 16; i += 16 ) {
+    __m128i const v = _mm_loadu_si128( POINTER_CAST( __m128i const*, s + i ) );
+    __m128i m = _mm_or_si128(
+      _mm_cmplt_epi8( v, above_space ), _mm_cmpeq_epi8( v, del )
+    );
+    for ( size_t j = 0; j < ascii_special_len; ++j )
+      m = _mm_or_si128( m, _mm_cmpeq_epi8( v, ascii_special[j] ) );
+    unsigned const mask = STATIC_CAST( unsigned, _mm_movemask_epi8( m ) );
+    if ( mask != 0 )
+      return i + STATIC_CAST( size_t, __builtin_ctz( mask ) );
+  } // for
+#endif /* __SSE2__ */
+  while ( i < n && ascii_is_plain[ STATIC_CAST( unsigned char, s[i] ) ] )
+    ++i;
+  return i;
+}
+
+/**
+ * Writes the assembled output, if any.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ */
+static void put_flush( wrap_ctx_t *ctx ) {
+  if ( ctx->put_len > 0 ) {
+    TRACE_BEGIN( prev_phase, TRACE_PHASE_EMIT );
+    PERROR_EXIT_IF(
+      fwrite( ctx->put_buf, 1, ctx->put_len, ctx->fout ) < ctx->put_len,
+      EX_IOERR
+    );
+    ctx->put_len = 0;
+    TRACE_END( prev_phase );
+  }
+}
+
+/**
+ * Prints the leading characters for lines.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ */
+static void put_lead_chars( wrap_ctx_t *ctx ) {
+  if ( ctx->proto_buf[0] != '\0' ) {
+    put_str( ctx, ctx->proto_buf );
+    if ( ctx->output_len > 0 )
+      put_str( ctx, ctx->proto_tws );
+  }
+  else if ( ctx->output_len > 0 ) {
+    put_chars( ctx, '\t', opt_lead_tabs );
+    put_chars( ctx, ' ', ctx->opt_lead_spaces );
+  }
+}
+
+/**
+ * Prints the current output buffer as a line and resets the output buffer's
+ * length.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param len The length of the output buffer.
+ * @param do_eol If `true`, prints and end-of-line afterwards.
+ */
+static void put_line( wrap_ctx_t *ctx, size_t len, bool do_eol ) {
+  TRACE_BEGIN( prev_phase, TRACE_PHASE_EMIT );
+  TRACE_EVENT(
+    TRACE_EVENT_BREAK, do_eol, ctx->stats.lines_read, len, ctx->hyphen
+  );
+  if ( ctx->breaks_len > 0 ) {
+    assert( len == ctx->output_len );
+    fit_put_lines( ctx, /*is_end=*/true );
+    len = ctx->output_len;
+    ctx->breaks_len = 0;
+  }
+  ctx->output_buf[ len ] = '\0';
+  if ( len > 0 ) {
+    put_bytes( ctx, ctx->output_buf, len );
+    if ( do_eol )
+      put_eol( ctx );
+  }
+  ctx->output_len = ctx->output_width = 0;
+  TRACE_END( prev_phase );
+}
+
+/**
+ * Puts \a tabs tabs and \a spaces spaces (in that order) into the output
+ * buffer and increments the output width accordingly.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param tabs The number of tabs to put.
+ * @param spaces The number of spaces to put.
+ */
+static void put_tabs_spaces( wrap_ctx_t *ctx, size_t tabs, size_t spaces ) {
+  output_reserve( ctx, tabs + spaces );
+  ctx->output_width += tabs * opt_tab_spaces + spaces;
+  while ( tabs-- > 0 )
+    ctx->output_buf[ ctx->output_len++ ] = '\t';
+  while ( spaces-- > 0 )
+    ctx->output_buf[ ctx->output_len++ ] = ' ';
+}
+
+/**
+ * Parses a \ref wipc_code.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param ppc A pointer to the pointer to character to advance.  It must be
+ * positioned at the IPC code after #WIPC_CODE_HELLO.
+ */
+static void wipc_parse( wrap_ctx_t *ctx, char const **ppc ) {
+  assert( ppc != NULL );
+  assert( *ppc != NULL );
+
+  char const c = *(*ppc)++;
+  if ( unlikely( c == '\0' ) )
+    return;
+  TRACE_EVENT(
+    TRACE_EVENT_IPC, STATIC_CAST( unsigned char, c ), ctx->stats.lines_read,
+    ctx->output_len, ctx->hyphen
+  );
+
+  switch ( STATIC_CAST( wipc_code_t, c ) ) {
+    case WIPC_CODE_HELLO:               // shouldn't happen
+      break;
+
+    case WIPC_CODE_DELIMIT_PARAGRAPH:
+      ctx->consec_newlines = 0;
+      delimit_paragraph( ctx, TRACE_DELIM_IPC );
+      put_flush( ctx );
+      WIPC_SEND( ctx->fout, WIPC_CODE_DELIMIT_PARAGRAPH );
+      break;
+
+    case WIPC_CODE_NEW_LEADER:
+      NO_OP;
+      //
+      // We've been told by wrapc (child 1) that the comment characters and/or
+      // leading whitespace has changed: we have to echo it back to the other
+      // wrapc process (parent).
+      //
+      // If an output line has already been started, we have to defer the IPC
+      // until just after the line is sent; otherwise, we must send it
+      // immediately.
+      //
+      char *sep;
+      size_t const new_line_width = strtoul( *ppc, &sep, 10 );
+      if ( ctx->output_len > 0 ) {
+        WIPC_DEFERF(
+          ctx->ipc_buf, sizeof ctx->ipc_buf,
+          WIPC_CODE_NEW_LEADER, "%zu" WIPC_PARAM_SEP "%s",
+          new_line_width, sep + 1
+        );
+        ctx->ipc_width = new_line_width;
+      } else {
+        put_flush( ctx );
+        WIPC_SENDF(
+          ctx->fout,
+          WIPC_CODE_NEW_LEADER, "%zu" WIPC_PARAM_SEP "%s",
+          new_line_width, sep + 1
+        );
+        ctx->line_width = ctx->opt_line_width = new_line_width;
+      }
+      break;
+
+    case WIPC_CODE_PREFORMATTED_BEGIN:
+      delimit_paragraph( ctx, TRACE_DELIM_IPC );
+      put_flush( ctx );
+      WIPC_SEND( ctx->fout, WIPC_CODE_PREFORMATTED_BEGIN );
+      ctx->is_preformatted = true;
+      break;
+
+    case WIPC_CODE_PREFORMATTED_END:
+      ctx->consec_newlines = 1;
+      delimit_paragraph( ctx, TRACE_DELIM_IPC );
+      put_flush( ctx );
+      WIPC_SEND( ctx->fout, WIPC_CODE_PREFORMATTED_END );
+      ctx->is_preformatted = false;
+      break;
+
+    case WIPC_CODE_WRAP_END:
+      //
+      // We've been told by wrapc (child 1) that we've reached the end of the
+      // comment: dump any remaining buffer, propagate the interprocess message
+      // to the other wrapc process (parent), and pass all subsequent text
+      // through verbatim.
+      //
+      ctx->consec_newlines = 0;
+      delimit_paragraph( ctx, TRACE_DELIM_IPC );
+      put_flush( ctx );
+      WIPC_SEND( ctx->fout, WIPC_CODE_WRAP_END );
+      ctx->is_passthru = true;
+      break;
+  } // switch
+}
+
+/**
+ * Sends an already formatted, deferred IPC (interprocess communication)
+ * message (if not empty) to **wrapc**(1).
+ *
+ * @param ctx The \ref wrap_ctx to use.  If sent, its `ipc_buf` is truncated.
+ */
+static void wipc_send( wrap_ctx_t *ctx ) {
+  char *const msg = ctx->ipc_buf;
+  if ( msg[0] != '\0' ) {
+    put_flush( ctx );
+    WIPC_SENDF( ctx->fout, /*IPC_code=*/msg[0], "%s", msg + 1 );
+    msg[0] = '\0';
+    if ( ctx->ipc_width > 0 ) {
+      ctx->line_width = ctx->opt_line_width = ctx->ipc_width;
+      ctx->ipc_width = 0;
+    }
+  }
+}
+
+/**
+ * Wraps the line of input that's in the input buffer.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ */
+static void wrap_line( wrap_ctx_t *ctx ) {
+  size_t const bytes_read = ctx->input_len;
+  ctx->input_buf[ bytes_read ] = '\0';
+  ctx->input_len = 0;
+  ++ctx->stats.lines_read;
+
+  if ( !buf_readline( ctx ) )
+    return;
+  if ( !true_or_set( &ctx->read_first_line ) )
+    init_first_line( ctx, bytes_read );
+
+  char const *pb = ctx->input_buf;      // pointer to current byte
+  //
+  // When wrapping Markdown, we have to strip leading whitespace from lines
+  // since it interferes with indenting.
+  //
+  if ( opt_markdown && *SKIP_CHARS( pb, WS_STR ) == '\0' )
+    return;
+  if ( !opt_no_hyphen )
+    find_nonws_no_wrap_spans( ctx, STATIC_CAST( size_t, pb - ctx->input_buf ) );
+
+  char const *const end = ctx->input_buf + bytes_read;
+  utf8c_t utf8c;                        // current character's UTF-8 byte(s)
+
+  for ( char32_t cp;; ctx->cp_prev = cp ) {
+    copy_plain_ascii( ctx, &pb, end );
+    if ( (cp = buf_getcp( ctx, &pb, utf8c )) == CP_EOF )
+      break;
+    ++ctx->stats.cps_read;
+
+    if ( cp == CP_BYTE_ORDER_MARK || cp == CP_INVALID )
+      continue;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  HANDLE NEWLINE(s)
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ( cp == '\r' ) {
+      //
+      // The code is simpler if we always strip \r and add it back later (if
+      // opt_eol is EOL_WINDOWS).
+      //
+      continue;
+    }
+
+    if ( cp == '\n' ) {
+      ctx->encountered_nonws = false;
+
+      if ( ++ctx->consec_newlines >= opt_newlines_delimit ) {
+        //
+        // At least opt_newlines_delimit consecutive newlines: set that the
+        // next line is a title line and delimit the paragraph.
+        //
+        ctx->next_line_is_title = opt_title_line;
+        delimit_paragraph( ctx, TRACE_DELIM_NEWLINES );
+        continue;
+      }
+      if ( ctx->output_len > 0 && true_clear( &ctx->next_line_is_title ) ) {
+        //
+        // The first line of the next paragraph is title line and the buffer
+        // isn't empty (there is a title): print the title.
+        //
+        delimit_paragraph( ctx, TRACE_DELIM_TITLE );
+        ctx->indent = INDENT_HANG;
+        continue;
+      }
+      if ( ctx->was_eos_char ) {
+        if ( opt_eos_delimit ) {
+          //
+          // End-of-sentence characters delimit paragraphs and the previous
+          // character was an end-of-sentence character: delimit the paragraph.
+          //
+          delimit_paragraph( ctx, TRACE_DELIM_EOS );
+        } else {
+          //
+          // We are joining a line after the end of a sentence: force requested
+          // number of spaces.
+          //
+          ctx->put_spaces = opt_eos_spaces;
+        }
+        continue;
+      }
+      if ( ctx->hyphen == HYPHEN_MAYBE ) {
+        //
+        // We've encountered H-\n meaning that a potentially hyphenated word
+        // ends a line: eat the newline so the word can potentially be rejoined
+        // to the next word when wrapped, e.g.:
+        //
+        //      non-
+        //      whitespace
+        //
+        // can become:
+        //
+        //      non-whitespace
+        //
+        // instead of:
+        //
+        //      non- whitespace
+        //
+        continue;
+      }
+    } else {
+      ctx->consec_newlines = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  HANDLE WHITESPACE
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ( cp_is_space( cp ) ) {
+      if (  //
+            // We've been handling a "long line" and finally got a whitespace
+            // character at which we can finally wrap: delimit the paragraph.
+            //
+            ctx->is_long_line ||
+            //
+            // Leading whitespace characters delimit paragraphs and the
+            // previous character was a newline which means this whitespace
+            // character is at the beginning of a line: delimit the paragraph.
+            //
+            (opt_lead_ws_delimit && ctx->cp_prev == '\n') ||
+            //
+            // End-of-sentence characters delimit paragraphs and the previous
+            // character was an end-of-sentence character: delimit the
+            // paragraph.
+            //
+            (opt_eos_delimit && ctx->was_eos_char) ||
+            //
+            // The previous character was a paragraph-delimiter character (set
+            // only if opt_para_delims was set): delimit the paragraph.
+            //
+            cp_is_para_delim( ctx->cp_prev ) ) {
+        delimit_paragraph( ctx, TRACE_DELIM_WHITESPACE );
+      }
+      else if ( ctx->hyphen == HYPHEN_MAYBE && !ctx->encountered_nonws ) {
+        //
+        // This case is similar to above: we've encountered H-\n meaning that a
+        // potentially hyphenated word ended a line and we've only encountered
+        // leading whitespace on the next line so far: eat the space so the
+        // word can potentially be rejoined to the next word when wrapped.
+        //
+      }
+      else if ( ctx->output_len > 0 &&
+                ctx->put_spaces < (ctx->was_eos_char ? opt_eos_spaces : 1) ) {
+        //
+        // We are not at the beginning of a line: remember to insert 1 space
+        // later and allow opt_eos_spaces after the end of a sentence.
+        //
+        ++ctx->put_spaces;
+      }
+      continue;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  DISCARD CONTROL CHARACTERS
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ( cp_is_control( cp ) )
+      continue;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  HANDLE LEADING-PARAGRAPH-DELIMITERS, LEADING-DOT, END-OF-SENTENCE, AND
+    //  PARAGRAPH-DELIMITERS
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ( ctx->cp_prev == '\n' ) {
+      if ( opt_lead_dot_ignore && cp == '.' ) {
+        ctx->consec_newlines = 0;
+        delimit_paragraph( ctx, TRACE_DELIM_LEAD_DOT );
+        put_str( ctx, ctx->input_buf );   // print the line as-is
+        //
+        // Make state as if line never happened.
+        //
+        ctx->cp_prev = '\n';
+        return;
+      }
+      if ( block_regex_matches( ctx ) ) {
+        delimit_paragraph( ctx, TRACE_DELIM_BLOCK_REGEX );
+        if ( opt_markdown ) {
+          markdown_init( &ctx->md );
+          markdown_reset( ctx );
+        }
+      }
+      else if ( ctx->hyphen == HYPHEN_MAYBE && !cp_is_hyphen_adjacent( cp ) ) {
+        //
+        // We had encountered H-\n on the previous line meaning that a
+        // potentially hyphenated word ends a line, but the first character on
+        // the next line is not a "hyphen adjacent character" so forget about
+        // hyphenation and put the previously eaten whitespace back.
+        //
+        ctx->hyphen = HYPHEN_NO;
+        ctx->put_spaces = 1;
+      }
+    }
+
+    ctx->was_eos_char = cp_is_eos( cp ) ||
+      (ctx->was_eos_char && cp_is_eos_ext( cp ));
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  INSERT SPACES
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ( ctx->put_spaces > 0 ) {
+      if ( ctx->output_len > 0 ) {
+        //
+        // Mark position at a space to perform a wrap if necessary.
+        //
+        ctx->wrap_pos = ctx->output_len;
+        if ( opt_optimal )
+          fit_add_break( ctx, ctx->put_spaces );
+        ctx->output_width += ctx->put_spaces;
+        output_reserve( ctx, ctx->put_spaces );
+        do {
+          ctx->output_buf[ ctx->output_len++ ] = ' ';
+        } while ( --ctx->put_spaces > 0 );
+        ctx->wrap_word_pos = ctx->output_len;
+        ctx->wrap_word_width = ctx->output_width;
+      } else {
+        //
+        // Never put spaces at the beginning of a line.
+        //
+        ctx->put_spaces = 0;
+      }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  PERFORM INDENTATION
+    ///////////////////////////////////////////////////////////////////////////
+
+    switch ( ctx->indent ) {
+      case INDENT_NONE:
+        break;
+      case INDENT_HANG:
+        put_tabs_spaces( ctx, opt_hang_tabs, ctx->opt_hang_spaces );
+        break;
+      case INDENT_LINE:
+        put_tabs_spaces( ctx, opt_indt_tabs, opt_indt_spaces );
+        break;
+    } // switch
+    ctx->indent = INDENT_NONE;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  INSERT NON-SPACE CHARACTER
+    ///////////////////////////////////////////////////////////////////////////
+
+    ctx->encountered_nonws = true;
+
+    if ( !opt_no_hyphen ) {
+      size_t const pos = STATIC_CAST( size_t, pb - ctx->input_buf );
+      if ( pos >= ctx->nonws_no_wrap_range[1] ||
+           pos < ctx->nonws_no_wrap_range[0] ) {
+        //
+        // We're outside the non-whitespace-no-wrap range.
+        //
+        if ( ctx->hyphen == HYPHEN_MAYBE ) {
+          if ( cp_is_hyphen_adjacent( cp ) ) {
+            //
+            // We've encountered H-H meaning that this is definitely a
+            // hyphenated word: set wrap_pos to be here.
+            //
+            ctx->hyphen = HYPHEN_YES;
+            ctx->wrap_pos = ctx->wrap_word_pos = ctx->output_len;
+            ctx->wrap_word_width = ctx->output_width;
+            if ( opt_optimal )
+              fit_add_break( ctx, /*spaces=*/0 );
+          }
+          else if ( !cp_is_hyphen( cp ) ) {
+            //
+            // We've encountered H-X meaning that this is not a hyphenated
+            // word.
+            //
+            ctx->hyphen = HYPHEN_NO;
+          }
+          else {
+            //
+            // We've encountered H-- meaning that this is still potentially a
+            // hyphenated word.
+            //
+          }
+        }
+        else if ( cp_is_hyphen_adjacent( ctx->cp_prev ) && cp_is_hyphen( cp ) ) {
+          //
+          // We've encountered H- meaning that this is potentially a
+          // hyphenated word.
+          //
+          ctx->hyphen = HYPHEN_MAYBE;
+        }
+      }
+    }
+
+    output_reserve( ctx, UTF8_CHAR_SIZE_MAX );
+    ctx->output_len +=
+      utf8_copy_char( ctx->output_buf + ctx->output_len, utf8c );
+
+    if ( opt_optimal ) {
+      //
+      // When doing optimal-fit filling, lines are broken only when the
+      // paragraph ends -- unless the output buffer is filling up in which case
+      // print all but the last line of what we've got so far.
+      //
+      ctx->output_width += cp_width( cp );
+      if ( ctx->output_len < FIT_OUTPUT_LEN_MAX )
+        continue;
+      if ( ctx->breaks_len > 0 ) {
+        fit_put_lines( ctx, /*is_end=*/false );
+        if ( ctx->output_len < FIT_OUTPUT_LEN_MAX )
+          continue;
+        ctx->breaks_len = 0;
+      }
+    }
+    else if ( (ctx->output_width += cp_width( cp )) < ctx->line_width ) {
+      continue;                         // haven't exceeded line width yet
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //  EXCEEDED LINE WIDTH; PRINT LINE OUT
+    ///////////////////////////////////////////////////////////////////////////
+
+    if ( opt_optimal || ctx->wrap_pos == 0 ) {
+      //
+      // We've exceeded the line width, but haven't encountered a whitespace
+      // character at which to wrap; therefore, we've got a "long line."
+      //
+      if ( !ctx->is_long_line )
+        put_lead_chars( ctx );
+      put_line( ctx, ctx->output_len, /*do_eol=*/false );
+      ctx->is_long_line = true;
+      ++ctx->stats.long_line_breaks;
+      continue;
+    }
+
+    //
+    // Everything in output_buf from wrap_word_pos on is the (partial) word
+    // after wrap_pos, so it can later be slid to the left as a single span
+    // without having to decode it or recompute its width.
+    //
+    size_t const wrap_pos = ctx->wrap_pos;
+    size_t const word_pos = ctx->wrap_word_pos;
+    size_t const word_len = ctx->output_len - word_pos;
+    size_t const word_width = ctx->output_width - ctx->wrap_word_width;
+
+    //
+    // A call to put_line() will terminate output_buf with a NULL at wrap_pos
+    // that is ordinarily at a space and so doesn't need to be preserved.
+    // However, when wrapping at a hyphen, it's at the first character of the
+    // word that must be preserved in the output so we keep a copy of it to be
+    // restored after the call to put_line().
+    //
+    char const c_at_wrap_pos = ctx->output_buf[ wrap_pos ];
+
+    put_lead_chars( ctx );
+    put_line( ctx, wrap_pos, /*do_eol=*/true );
+    ctx->output_buf[ wrap_pos ] = c_at_wrap_pos;
+    if ( c_at_wrap_pos != ' ' )
+      ++ctx->stats.hyphen_wraps;
+
+    put_tabs_spaces( ctx, opt_hang_tabs, ctx->opt_hang_spaces );
+
+    //
+    // Slide the partial word to the left where we can pick up from where we
+    // left off the next time around.
+    //
+    output_reserve( ctx, word_len );
+    memmove(
+      ctx->output_buf + ctx->output_len, ctx->output_buf + word_pos, word_len
+    );
+    ctx->output_len += word_len;
+    ctx->output_width += word_width;
+
+    ctx->hyphen = HYPHEN_NO;
+    ctx->is_long_line = false;
+    ctx->wrap_pos = 0;
+  } // for
+}
+
+////////// extern functions ///////////////////////////////////////////////////
+
+void wrap_ctx_feed( wrap_ctx_t *ctx, char const *buf, size_t size ) {
+  assert( ctx != NULL );
+  assert( buf != NULL || size == 0 );
+  ctx->stats.bytes_read += size;
+
+  for ( char const *const end = buf + size; buf < end; ) {
+    if ( ctx->is_passthru ) {
+      put_flush( ctx );
+      size_t const n = STATIC_CAST( size_t, end - buf );
+      PERROR_EXIT_IF( fwrite( buf, 1, n, ctx->fout ) < n, EX_IOERR );
+      return;
+    }
+
+    TRACE_BEGIN( prev_read, TRACE_PHASE_READ );
+    size_t n = STATIC_CAST( size_t, end - buf );
+    char const *const nl = memchr( buf, '\n', n );
+    if ( nl != NULL )
+      n = STATIC_CAST( size_t, nl - buf ) + 1;
+    str_reserve(
+      &ctx->input_buf, &ctx->input_cap, ctx->input_len + n + 1/*\0*/
+    );
+    memcpy( ctx->input_buf + ctx->input_len, buf, n );
+    ctx->input_len += n;
+    buf += n;
+    TRACE_END( prev_read );
+
+    if ( nl == NULL )
+      break;                            // partial line: wait for more
+    TRACE_BEGIN( prev_classify, TRACE_PHASE_CLASSIFY );
+    wrap_line( ctx );
+    TRACE_END( prev_classify );
+  } // for
+
+  put_flush( ctx );
+}
+
+void wrap_ctx_finish( wrap_ctx_t *ctx ) {
+  assert( ctx != NULL );
+
+  if ( ctx->input_len > 0 && !ctx->is_passthru ) {
+    TRACE_BEGIN( prev_phase, TRACE_PHASE_CLASSIFY );
+    wrap_line( ctx );                   // wrap left-over partial line
+    TRACE_END( prev_phase );
+  }
+  if ( ctx->output_len > 0 ) {          // print left-over text
+    if ( !ctx->is_long_line )
+      put_lead_chars( ctx );
+    put_line( ctx, ctx->output_len, /*do_eol=*/true );
+  }
+  put_flush( ctx );
+  PERROR_EXIT_IF( fflush( ctx->fout ) != 0, EX_IOERR );
+}
+
+void wrap_ctx_free( wrap_ctx_t *ctx ) {
+  assert( ctx != NULL );
+  markdown_cleanup( &ctx->md );
+  FREE( ctx->breaks );
+  FREE( ctx->fit_cands );
+  FREE( ctx->input_buf );
+  FREE( ctx->nonws_no_wrap_spans );
+  FREE( ctx->output_buf );
+  FREE( ctx->put_buf );
+  regex_cache_free( &ctx->block_regex_cache );
+}
+
+void wrap_ctx_init( wrap_ctx_t *ctx, FILE *fout ) {
+  assert( ctx != NULL );
+
+  MEM_ZERO( ctx );
+  str_reserve( &ctx->input_buf, &ctx->input_cap, LINE_BUF_SIZE );
+  str_reserve( &ctx->output_buf, &ctx->output_cap, LINE_BUF_SIZE );
+  str_reserve( &ctx->put_buf, &ctx->put_cap, PUT_BUF_SIZE + LINE_BUF_SIZE );
+  wrap_ctx_reset( ctx, fout );
+}
+
+void wrap_ctx_init_para( wrap_ctx_t *ctx, FILE *fout, char const *doc,
+                         size_t doc_len, size_t consec_newlines ) {
+  assert( doc != NULL || doc_len == 0 );
+  assert( !opt_markdown );
+
+  wrap_ctx_reset( ctx, fout );
+
+  //
+  // Do what wrap_line() does for the first line of the document, but without
+  // wrapping it.
+  //
+  size_t n = doc_len;
+  char const *const nl = memchr( doc, '\n', n );
+  if ( nl != NULL )
+    n = STATIC_CAST( size_t, nl - doc ) + 1;
+  str_reserve( &ctx->input_buf, &ctx->input_cap, n + 1/*\0*/ );
+  memcpy( ctx->input_buf, doc, n );
+  ctx->input_buf[ n ] = '\0';
+  ctx->read_first_line = true;
+  init_first_line( ctx, n );
+
+  ctx->consec_newlines = consec_newlines;
+}
+
+void wrap_ctx_reset( wrap_ctx_t *ctx, FILE *fout ) {
+  assert( ctx != NULL );
+  assert( fout != NULL );
+
+  //
+  // Keep all allocated memory, including the Markdown parser's stack and the
+  // block regex's cache, but nothing else.
+  //
+  *ctx = (wrap_ctx_t){
+    .fout                     = fout,
+    .input_buf                = ctx->input_buf,
+    .input_cap                = ctx->input_cap,
+    .output_buf               = ctx->output_buf,
+    .output_cap               = ctx->output_cap,
+    .put_buf                  = ctx->put_buf,
+    .put_cap                  = ctx->put_cap,
+    .nonws_no_wrap_spans      = ctx->nonws_no_wrap_spans,
+    .nonws_no_wrap_spans_cap  = ctx->nonws_no_wrap_spans_cap,
+    .cp_prev                  = '\n',
+    .indent                   = INDENT_LINE,
+    .next_line_is_title       = opt_title_line,
+    .opt_eol                  = opt_eol,
+    .opt_hang_spaces          = opt_hang_spaces,
+    .opt_lead_spaces          = opt_lead_spaces,
+    .line_width               = opt_line_width,
+    .opt_line_width           = opt_line_width,
+    .md                       = ctx->md,
+    .md_prev_seq_num          = MD_SEQ_NUM_INIT,
+    .breaks                   = ctx->breaks,
+    .breaks_cap               = ctx->breaks_cap,
+    .fit_cands                = ctx->fit_cands,
+    .block_regex_cache        = ctx->block_regex_cache
+  };
+  if ( opt_markdown )
+    markdown_restart( &ctx->md );
+}
+
+bool wrap_ctx_same_state( wrap_ctx_t const *i_ctx, wrap_ctx_t const *j_ctx ) {
+  assert( i_ctx != NULL );
+  assert( j_ctx != NULL );
+  assert( !opt_markdown );
+
+  if ( i_ctx->breaks_len > 0 || j_ctx->breaks_len > 0 )
+    return false;                       // not worth comparing
+
+#define SAME(FIELD)     (i_ctx->FIELD == j_ctx->FIELD)
+#define SAME_BUF(BUF,LEN) \
+  (SAME( LEN ) && memcmp( i_ctx->BUF, j_ctx->BUF, i_ctx->LEN ) == 0)
+#define SAME_STR(STR)   (strcmp( i_ctx->STR, j_ctx->STR ) == 0)
+
+  bool const same =
+    SAME_BUF( input_buf, input_len ) &&
+    SAME_BUF( output_buf, output_len ) && SAME( output_width ) &&
+    SAME_STR( proto_buf ) && SAME_STR( proto_tws ) &&
+    SAME_STR( ipc_buf ) && SAME( ipc_width ) &&
+    SAME( line_width ) && SAME( put_spaces ) && SAME( consec_newlines ) &&
+    SAME( wrap_pos ) && SAME( cp_prev ) && SAME( hyphen ) && SAME( indent ) &&
+    SAME( encountered_nonws ) && SAME( is_long_line ) &&
+    SAME( is_passthru ) && SAME( is_preformatted ) &&
+    SAME( next_line_is_title ) && SAME( read_first_line ) &&
+    SAME( was_eos_char ) && SAME( opt_eol ) && SAME( opt_hang_spaces ) &&
+    SAME( opt_lead_spaces ) && SAME( opt_line_width );
+
+#undef SAME
+#undef SAME_BUF
+#undef SAME_STR
+
+  return same;
+}
+
+void wrap_engine_compile( void ) {
+  static bool is_compiled;
+  if ( true_or_set( &is_compiled ) )
+    return;
+  ATEXIT( engine_cleanup );
+
+  for ( char32_t cp = '!'; cp < 0x7F; ++cp ) {
+    ascii_is_plain[ cp ] =
+      !cp_is_eos( cp ) && !cp_is_eos_ext( cp ) && !cp_is_hyphen( cp );
+#ifdef __SSE2__
+    if ( !ascii_is_plain[ cp ] ) {
+      assert( ascii_special_len < ARRAY_SIZE( ascii_special ) );
+      ascii_special[ ascii_special_len++ ] =
+        _mm_set1_epi8( STATIC_CAST( char, cp ) );
+    }
+#endif /* __SSE2__ */
+  } // for
+
+  if ( opt_para_delims != NULL ) {
+    for ( char const *d = opt_para_delims; *d != '\0'; ++d ) {
+      if ( cp_is_ascii( STATIC_CAST( char8_t, *d ) ) )
+        ascii_is_para_delim[ STATIC_CAST( char8_t, *d ) ] = true;
+    } // for
+  }
+
+  if ( opt_block_regex != NULL ) {
+    if ( opt_block_regex[0] != '^' ) {
+      char *const temp = free_later(
+        MALLOC( char, 1/*^*/ + strlen( opt_block_regex ) + 1/*\0*/ )
+      );
+      temp[0] = '^';
+      strcpy( temp + 1, opt_block_regex );
+      opt_block_regex = temp;
+    }
+    int const regex_err_code = regex_compile( &block_regex, opt_block_regex );
+    if ( regex_err_code != 0 ) {
+      fatal_error( EX_USAGE,
+        "\"%s\": regular expression error (%d): %s\n",
+        opt_block_regex, regex_err_code,
+        regex_error( &block_regex, regex_err_code )
+      );
+    }
+  }
+}
+
+void wrap_engine_init( void ) {
+  ASSERT_RUN_ONCE();
+
+  if ( opt_markdown )
+    opt_tab_spaces = MD_TAB_SPACES;
+
+  int const temp_width = STATIC_CAST( int, opt_line_width ) -
+    STATIC_CAST( int,
+      2 * (opt_mirror_tabs * opt_tab_spaces + opt_mirror_spaces) +
+      opt_lead_tabs * opt_tab_spaces + opt_lead_spaces
+    );
+
+  if ( temp_width < LINE_WIDTH_MINIMUM ) {
+    fatal_error( EX_USAGE,
+      "line-width (%d) is too small (<%d)\n",
+      temp_width, LINE_WIDTH_MINIMUM
+    );
+  }
+  opt_line_width = STATIC_CAST( size_t, temp_width );
+
+  opt_lead_tabs   += opt_mirror_tabs;
+  opt_lead_spaces += opt_mirror_spaces;
+
+  wrap_engine_compile();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+/* vim:set et sw=2 ts=2: */
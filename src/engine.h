@@ -0,0 +1,322 @@
+/*
+**      wrap -- text reformatter
+**      src/engine.h
+**
+**      Copyright (C) 1996-2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef wrap_engine_H
+#define wrap_engine_H
+
+/**
+ * @file
+ * Declares types and functions for the reentrant text-wrapping engine that
+ * **wrap**(1) is built upon.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "common.h"
+#include "markdown.h"
+#include "options.h"
+#include "stats.h"
+#include "unicode.h"
+#include "wregex.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint64_t */
+#include <stdio.h>                      /* for FILE */
+
+/// @endcond
+
+/**
+ * @defgroup engine-group Wrap Engine
+ * Types and functions for the reentrant text-wrapping engine.
+ *
+ * @remarks The engine is used as follows:
+ *
+ *  1. After the `opt_` variables have been set (typically by options_init()),
+ *     call wrap_engine_init() exactly once.
+ *  2. For each document, call wrap_ctx_init() (or, to reuse a \ref wrap_ctx
+ *     from a previous document, wrap_ctx_reset()); then call wrap_ctx_feed()
+ *     as many times as needed with the document's bytes; then call
+ *     wrap_ctx_finish().
+ *  3. Once a \ref wrap_ctx is no longer needed, call wrap_ctx_free().
+ *
+ * Each \ref wrap_ctx is independent of every other so any number of them may
+ * be used concurrently, e.g., on different threads.
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Hyphenation states.
+ */
+enum hyphen {                           // H = hyphen-adjacent char
+  HYPHEN_NO,                            ///< Didn't encounter a hyphen.
+  HYPHEN_MAYBE,                         ///< Encountered `H-`.
+  HYPHEN_YES                            ///< Encountered `H-H`.
+};
+typedef enum hyphen hyphen_t;
+
+/**
+ * Line indentation type.
+ */
+enum indent {
+  INDENT_NONE,                          ///< No indentation.
+
+  /// Indent only first line of a paragraph.
+  INDENT_LINE,
+
+  /// Indent all lines but first of a paragraph.
+  INDENT_HANG
+};
+typedef enum indent indent_t;
+
+/**
+ * A place in the output buffer at which a line may be broken when doing
+ * optimal-fit filling, i.e., where **wrap**(1) would otherwise set `wrap_pos`.
+ */
+struct wrap_break {
+  size_t    end_len;                    ///< Length of a line ending here.
+  size_t    end_width;                  ///< Width of a line ending here.
+  size_t    next_len;                   ///< Where the next line starts.
+  size_t    next_width;                 ///< Width up to \ref next_len.
+  uint64_t  cost;                       ///< Least cost of lines ending here.
+  size_t    prev;                       ///< Previous break for \ref cost.
+};
+typedef struct wrap_break wrap_break_t;
+
+/**
+ * A candidate previous break when doing optimal-fit filling: \ref node is
+ * the best previous break for all breaks from \ref from up to the next
+ * candidate's \ref from.
+ */
+struct wrap_fit_cand {
+  size_t    node;                       ///< Index of the previous break.
+  size_t    from;                       ///< First break it's best for.
+};
+typedef struct wrap_fit_cand wrap_fit_cand_t;
+
+/**
+ * Wrap context: all the state needed to wrap one document.
+ */
+struct wrap_ctx {
+  FILE         *fout;                   ///< File to write to.
+
+  char         *input_buf;              ///< Input buffer.
+  size_t        input_len;              ///< Length of partial line, if any.
+  size_t        input_cap;              ///< Capacity of input_buf.
+  char         *output_buf;             ///< Output buffer.
+  size_t        output_len;             ///< Number of characters in output_buf.
+  size_t        output_cap;             ///< Capacity of output_buf.
+  size_t        output_width;           ///< Actual width of output_buf.
+  char         *put_buf;                ///< Assembled output not yet written.
+  size_t        put_len;                ///< Number of characters in put_buf.
+  size_t        put_cap;                ///< Capacity of put_buf.
+  line_buf_t    proto_buf;              ///< Prototype buffer.
+  line_buf_t    proto_tws;              ///< Prototype trailing whitespace.
+  line_buf_t    ipc_buf;                ///< Deferred IPC message.
+  size_t        ipc_width;              ///< Deferred IPC line width.
+
+  size_t        line_width;             ///< Maximum width of a line.
+  size_t        nonws_no_wrap_range[2]; ///< Current range not to wrap within.
+  size_t      (*nonws_no_wrap_spans)[2];///< All such ranges on the line.
+  size_t        nonws_no_wrap_spans_len;///< Number of nonws_no_wrap_spans.
+  size_t        nonws_no_wrap_spans_cap;///< Capacity of nonws_no_wrap_spans.
+  size_t        nonws_no_wrap_next;     ///< Index of next span to use.
+  size_t        put_spaces;             ///< Spaces to put between words.
+  size_t        consec_newlines;        ///< Number of consecutive newlines.
+  size_t        wrap_pos;               ///< Position at which we can wrap.
+  size_t        wrap_word_pos;          ///< Position of word after wrap_pos.
+  size_t        wrap_word_width;        ///< output_width at wrap_word_pos.
+  char32_t      cp_prev;                ///< Previous code-point.
+  hyphen_t      hyphen;                 ///< Hyphen state.
+  indent_t      indent;                 ///< Indentation for next line.
+
+  bool          encountered_nonws;      ///< Encountered a non-whitespace char?
+  bool          is_long_line;           ///< Line longer than line_width?
+  bool          is_passthru;            ///< Passing all input through verbatim?
+  bool          is_preformatted;        ///< Passing through preformatted text?
+  bool          next_line_is_title;     ///< Is next line a title line?
+  bool          read_first_line;        ///< Have we read the first line?
+  bool          was_eos_char;           ///< Prev char an end-of-sentence char?
+
+  /// @name Per-context copies of options the engine changes
+  /// @{
+  eol_t         opt_eol;                ///< Resolved end-of-line treatment.
+  size_t        opt_hang_spaces;        ///< Hang-indent spaces.
+  size_t        opt_lead_spaces;        ///< Leading spaces.
+  size_t        opt_line_width;         ///< Line width.
+  /// @}
+
+  /// @name Markdown
+  /// @{
+  md_parser_t   md;                     ///< Markdown parser.
+  md_line_t     md_prev_line_type;      ///< Previous Markdown line type.
+  md_seq_t      md_prev_seq_num;        ///< Previous Markdown seq number.
+  /// @}
+
+  /// @name Optimal-fit filling
+  /// @{
+  wrap_break_t     *breaks;             ///< Where lines may be broken.
+  size_t            breaks_len;         ///< Number of breaks, if any.
+  size_t            breaks_cap;         ///< Capacity of breaks.
+  wrap_fit_cand_t  *fit_cands;          ///< Candidate previous breaks.
+  /// @}
+
+  wregex_cache_t block_regex_cache;     ///< For matching the block regex.
+  wrap_stats_t  stats;                  ///< Counters for `--stats`.
+};
+typedef struct wrap_ctx wrap_ctx_t;
+
+////////// extern functions ///////////////////////////////////////////////////
+
+/**
+ * Finishes wrapping the document by wrapping any remaining partial line and
+ * printing any text left in the output buffer.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ *
+ * @sa wrap_ctx_feed()
+ */
+void wrap_ctx_finish( wrap_ctx_t *ctx );
+
+/**
+ * Feeds bytes of a document to be wrapped.  Only complete lines are wrapped;
+ * any trailing partial line is kept until either the next call to this
+ * function or to wrap_ctx_finish().  The wrapped text is assembled into large
+ * blocks, but all of it has been written to the \ref wrap_ctx's `FILE` by the
+ * time this function returns.
+ *
+ * @param ctx The \ref wrap_ctx to use.
+ * @param buf A pointer to the bytes to wrap.
+ * @param size The number of bytes.
+ *
+ * @sa wrap_ctx_finish()
+ */
+void wrap_ctx_feed( wrap_ctx_t *ctx, char const *buf, size_t size );
+
+/**
+ * Frees all memory used by a \ref wrap_ctx.
+ *
+ * @param ctx The \ref wrap_ctx to free.  The object pointed to is not freed.
+ *
+ * @sa wrap_ctx_init()
+ */
+void wrap_ctx_free( wrap_ctx_t *ctx );
+
+/**
+ * Initializes a \ref wrap_ctx.
+ *
+ * @param ctx The \ref wrap_ctx to initialize.
+ * @param fout The file to write the wrapped text to.
+ *
+ * @sa wrap_ctx_free()
+ * @sa wrap_ctx_reset()
+ * @sa wrap_engine_init()
+ */
+void wrap_ctx_init( wrap_ctx_t *ctx, FILE *fout );
+
+/**
+ * Initializes a \ref wrap_ctx to be in the state it would be in had it
+ * wrapped a document up to just after a paragraph delimited by blank lines.
+ * This allows a document that's been split at such paragraphs to have its
+ * parts wrapped concurrently, each by its own \ref wrap_ctx.
+ *
+ * @param ctx The \ref wrap_ctx to initialize.  It must have been initialized
+ * by wrap_ctx_init(); it's reset by wrap_ctx_reset().
+ * @param fout The file to write the wrapped text to.
+ * @param doc A pointer to the start of the document: only its first line is
+ * used.
+ * @param doc_len The number of bytes of \a doc.
+ * @param consec_newlines The number of consecutive newlines that ended the
+ * paragraph.
+ *
+ * @warning The state is merely presumed: the output is the same as had the
+ * document been wrapped by a single \ref wrap_ctx only if
+ * wrap_ctx_same_state() returns `true` for \a ctx (before it's fed) and the
+ * \ref wrap_ctx that wrapped the document up to that point.  Markdown isn't
+ * supported.
+ *
+ * @sa wrap_ctx_init()
+ * @sa wrap_ctx_reset()
+ * @sa wrap_ctx_same_state()
+ */
+void wrap_ctx_init_para( wrap_ctx_t *ctx, FILE *fout, char const *doc,
+                         size_t doc_len, size_t consec_newlines );
+
+/**
+ * Resets a \ref wrap_ctx to be in the state it was in just after
+ * wrap_ctx_init() so it can be reused for another document.  Unlike calling
+ * wrap_ctx_free() and wrap_ctx_init(), all memory (including that of the
+ * Markdown parser and the block regex cache) is kept.
+ *
+ * @param ctx The \ref wrap_ctx to reset.  It must have been initialized by
+ * wrap_ctx_init().
+ * @param fout The file to write the wrapped text to.
+ *
+ * @sa wrap_ctx_init()
+ */
+void wrap_ctx_reset( wrap_ctx_t *ctx, FILE *fout );
+
+/**
+ * Checks whether two \ref wrap_ctx objects are in the same state, i.e., would
+ * wrap the same input in the same way.
+ *
+ * @param i_ctx The first \ref wrap_ctx.
+ * @param j_ctx The second \ref wrap_ctx.
+ * @return Returns `true` only if they're in the same state.  It may return
+ * `false` for \ref wrap_ctx objects that would wrap the same input in the
+ * same way, but never `true` for ones that wouldn't.  Markdown isn't
+ * supported.
+ *
+ * @sa wrap_ctx_init_para()
+ */
+NODISCARD
+bool wrap_ctx_same_state( wrap_ctx_t const *i_ctx, wrap_ctx_t const *j_ctx );
+
+/**
+ * Compiles the wrap engine's regular expressions based on the current values
+ * of the `opt_` variables, if not already compiled.
+ *
+ * @remarks This is called by wrap_engine_init(), but may also be called ahead
+ * of it, e.g., once before forking processes that each call
+ * wrap_engine_init() so they don't each compile the regular expressions.
+ *
+ * @sa wrap_engine_init()
+ */
+void wrap_engine_compile( void );
+
+/**
+ * Initializes the wrap engine based on the current values of the `opt_`
+ * variables: validates the line width, adjusts options that depend on one
+ * another, and compiles regular expressions (via wrap_engine_compile()).
+ * This must be called exactly once before any call to wrap_ctx_init().
+ */
+void wrap_engine_init( void );
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+#endif /* wrap_engine_H */
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,433 @@
+/*
+**      wrap -- text reformatter
+**      src/gen_corpus.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Generates a synthetic corpus of a given kind and approximate size for
+ * benchmarking **wrap**(1) and **wrapc**(1), e.g.:
+ *
+ *      $ ./gen_corpus markdown 4096 > markdown.md
+ *
+ * The output depends only on the kind and size, so every run of the benchmark
+ * wraps exactly the same bytes.
+ *
+ * Since **wrapc**(1) wraps only the first comment it reads and copies the rest
+ * verbatim, each comment corpus is a single comment of the given size.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "util.h"
+
+// standard
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint32_t */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Seed for the pseudo-random number generator.
+#define CORPUS_SEED               0x5EEDu
+
+/**
+ * Ordinary words, including some hyphenated ones so wrapping at hyphens is
+ * exercised.
+ */
+static char const *const WORDS[] = {
+  "a", "about", "after", "all", "also", "an", "and", "any", "as", "at",
+  "back", "be", "because", "but", "by", "can", "come", "could", "day", "do",
+  "even", "first", "for", "from", "get", "give", "go", "good", "have", "he",
+  "her", "how", "in", "into", "it", "its", "just", "know", "like", "look",
+  "make", "most", "new", "no", "not", "now", "of", "on", "one", "only", "or",
+  "other", "our", "out", "over", "people", "say", "see", "she", "so", "some",
+  "take", "than", "that", "the", "their", "then", "there", "these", "they",
+  "think", "this", "time", "to", "two", "up", "use", "want", "way", "we",
+  "well", "what", "when", "which", "who", "will", "with", "work", "would",
+  "year", "you", "your", "reformatter", "paragraph", "indentation",
+  "well-known", "state-of-the-art", "end-of-line", "up-to-date",
+  "internationalization", "comment", "delimiter", "whitespace"
+};
+
+/**
+ * Non-ASCII words: Latin-1, Greek, and Cyrillic (narrow) and Chinese, Japanese,
+ * and Korean (wide).
+ */
+static char const *const UNICODE_WORDS[] = {
+  "café", "naïve", "façade", "résumé", "über", "Ångström", "señor",
+  "λόγος", "φύσις", "ἀρχή", "слово", "время", "человек",
+  "中文", "漢字", "文字列", "日本語", "ひらがな", "カタカナ", "한국어"
+};
+
+/**
+ * Host names for generated URIs.
+ */
+static char const *const HOSTS[] = {
+  "example.com", "www.example.org", "docs.example.net", "ftp.example.edu",
+  "a.co.uk", "mail.example-site.com"
+};
+
+/**
+ * Generator function for one kind of corpus.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+typedef void (*gen_fn_t)( size_t size );
+
+/**
+ * A corpus kind.
+ */
+struct corpus_kind {
+  char const *name;                     ///< Kind name.
+  gen_fn_t    gen_fn;                   ///< Generator function.
+  char const *begin;                    ///< Line to print first, if any.
+  char const *prefix;                   ///< String to prepend to every line.
+  char const *end;                      ///< Line to print last, if any.
+};
+typedef struct corpus_kind corpus_kind_t;
+
+// extern variable definitions
+char const       *me;                   ///< Program name.
+
+// local variable definitions
+static bool       at_bol = true;        ///< At beginning of line?
+static char const *line_prefix = "";    ///< String to prepend to every line.
+static size_t     out_bytes;            ///< Number of bytes written so far.
+static uint32_t   rng_state = CORPUS_SEED; ///< Random number generator state.
+
+// local functions
+PJL_PRINTF_LIKE_FUNC(1)
+static void       put_fmt( char const*, ... );
+
+static void       put_sentence( size_t, size_t );
+static void       put_str( char const* );
+NODISCARD
+static size_t     rng( size_t );
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Generates C declarations, most having end-of-line comments.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+static void gen_code( size_t size ) {
+  for ( unsigned n = 1; out_bytes < size; ++n ) {
+    put_fmt( "int f%u(", n );
+    for ( size_t i = rng( 4 ); i > 0; --i )
+      put_fmt( " int p%zu%s", i, i > 1 ? "," : "" );
+    put_str( " );" );
+    if ( rng( 4 ) > 0 ) {
+      put_fmt( "%*s// ", STATIC_CAST( int, 1 + rng( 8 ) ), "" );
+      put_sentence( 2, 6 );
+    }
+    put_str( "\n" );
+  } // for
+}
+
+/**
+ * Generates Doxygen paragraphs and commands.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+static void gen_doxygen( size_t size ) {
+  static char const *const DOX_PARAS[] = {
+    "@deprecated", "@note", "@remarks", "@sa", "@warning"
+  };
+
+  while ( out_bytes < size ) {
+    put_sentence( 8, 30 );
+    put_str( "\n\n" );
+    put_str( DOX_PARAS[ rng( ARRAY_SIZE( DOX_PARAS ) ) ] );
+    put_str( " " );
+    put_sentence( 8, 30 );
+    put_str( "\n\n" );
+    for ( size_t i = rng( 4 ); i > 0; --i ) {
+      put_fmt( "@param p%zu ", i );
+      put_sentence( 4, 20 );
+      put_str( "\n" );
+    } // for
+    put_str( "@return Returns " );
+    put_sentence( 3, 12 );
+    put_str( "\n\n" );
+    if ( rng( 4 ) == 0 )
+      put_str( "@code\nint x = f( 1, 2 );\n@endcode\n\n" );
+  } // while
+}
+
+/**
+ * Generates Markdown with deeply nested lists and block quotes, headers, code
+ * blocks, and HTML.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+static void gen_markdown( size_t size ) {
+  while ( out_bytes < size ) {
+    put_str( "## " );
+    put_sentence( 2, 6 );
+    put_str( "\n\n" );
+    put_sentence( 20, 60 );
+    put_str( "\n\n" );
+
+    size_t const depth = 1 + rng( 8 );
+    for ( size_t d = 0; d < depth; ++d ) {
+      put_fmt(
+        "%*s%s ", STATIC_CAST( int, d * 4 ), "", d % 2 != 0 ? "1." : "*"
+      );
+      put_sentence( 10, 40 );
+      put_str( "\n\n" );
+    } // for
+
+    for ( size_t d = 1 + rng( 6 ); d > 0; --d ) {
+      for ( size_t i = 0; i < d; ++i )
+        put_str( "> " );
+      put_sentence( 10, 30 );
+      put_str( "\n" );
+    } // for
+    put_str( "\n" );
+
+    switch ( rng( 3 ) ) {
+      case 0:
+        put_str( "```c\nint main() {\n  return 0;\n}\n```\n\n" );
+        break;
+      case 1:
+        put_str( "<div>\n<p>\n" );
+        put_sentence( 5, 15 );
+        put_str( "\n</p>\n</div>\n\n" );
+        break;
+      default:
+        put_str( "| a | b |\n|---|---|\n| 1 | 2 |\n\n" );
+        break;
+    } // switch
+  } // while
+}
+
+/**
+ * Generates plain paragraphs.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+static void gen_plain( size_t size ) {
+  while ( out_bytes < size ) {
+    for ( size_t lines = 2 + rng( 10 ); lines > 0; --lines ) {
+      put_sentence( 6, 18 );
+      put_str( "\n" );
+    } // for
+    put_str( "\n" );
+  } // while
+}
+
+/**
+ * Generates paragraphs mixing ASCII words with narrow and wide non-ASCII
+ * words.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+static void gen_unicode( size_t size ) {
+  while ( out_bytes < size ) {
+    for ( size_t lines = 2 + rng( 10 ); lines > 0; --lines ) {
+      for ( size_t words = 6 + rng( 12 ); words > 0; --words ) {
+        put_str( rng( 2 ) != 0 ?
+          UNICODE_WORDS[ rng( ARRAY_SIZE( UNICODE_WORDS ) ) ] :
+          WORDS[ rng( ARRAY_SIZE( WORDS ) ) ]
+        );
+        put_str( words > 1 ? " " : ".\n" );
+      } // for
+    } // for
+    put_str( "\n" );
+  } // while
+}
+
+/**
+ * Generates paragraphs with many e-mail addresses and URIs.
+ *
+ * @param size The approximate number of bytes to generate.
+ */
+static void gen_uri( size_t size ) {
+  while ( out_bytes < size ) {
+    for ( size_t lines = 2 + rng( 8 ); lines > 0; --lines ) {
+      put_sentence( 2, 6 );
+      char const *const host = HOSTS[ rng( ARRAY_SIZE( HOSTS ) ) ];
+      size_t const n1 = rng( 1000 );    // separate statements so the
+      size_t const n2 = rng( 1000 );    // order of calls is defined
+      switch ( rng( 4 ) ) {
+        case 0:
+          put_fmt( " user%zu@%s ", n1, host );
+          break;
+        case 1:
+          put_fmt( " ftp://%s/pub/file-%zu.tar.gz ", host, n1 );
+          break;
+        case 2:
+          put_fmt( " file:///usr/share/doc/%zu/README ", n1 );
+          break;
+        default:
+          put_fmt(
+            " http://%s/some/long-path/%zu?q=%zu&x=y#frag ", host, n1, n2
+          );
+          break;
+      } // switch
+      put_sentence( 2, 6 );
+      put_str( "\n" );
+    } // for
+    put_str( "\n" );
+  } // while
+}
+
+/**
+ * Prints the formatted string via put_str().
+ *
+ * @param format The `printf()` style format string.
+ * @param ... The `printf()` arguments.
+ */
+static void put_fmt( char const *format, ... ) {
+  char buf[ 256 ];
+  va_list args;
+  va_start( args, format );
+  int const n = vsnprintf( buf, sizeof buf, format, args );
+  va_end( args );
+  assert( n >= 0 && STATIC_CAST( size_t, n ) < sizeof buf );
+  (void)n;
+  put_str( buf );
+}
+
+/**
+ * Prints a sentence of between \a min and \a max words (without a trailing
+ * newline).
+ *
+ * @param min The minimum number of words.
+ * @param max The maximum number of words.
+ */
+static void put_sentence( size_t min, size_t max ) {
+  size_t const words = min + rng( max - min + 1 );
+  for ( size_t i = 0; i < words; ++i ) {
+    if ( i > 0 )
+      put_str( " " );
+    put_str( WORDS[ rng( ARRAY_SIZE( WORDS ) ) ] );
+  } // for
+  put_str( "." );
+}
+
+/**
+ * Prints \a s, prepending \ref line_prefix to every line, and counts its
+ * bytes.
+ *
+ * @param s The null-terminated string to print.
+ */
+static void put_str( char const *s ) {
+  for ( ; *s != '\0'; ++s ) {
+    if ( at_bol ) {
+      //
+      // For an empty line, print the prefix without trailing whitespace.
+      //
+      size_t len = strlen( line_prefix );
+      if ( *s == '\n' ) {
+        while ( len > 0 && line_prefix[ len - 1 ] == ' ' )
+          --len;
+      }
+      PERROR_EXIT_IF(
+        fwrite( line_prefix, 1, len, stdout ) < len, EX_IOERR
+      );
+      out_bytes += len;
+    }
+    PUTC( *s );
+    ++out_bytes;
+    at_bol = *s == '\n';
+  } // for
+}
+
+/**
+ * Gets a pseudo-random number.
+ *
+ * @param n The upper bound; must be &gt; 0.
+ * @return Returns a pseudo-random number in the range [0, \a n).
+ */
+static size_t rng( size_t n ) {
+  rng_state ^= rng_state << 13;         // xorshift32
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state % n;
+}
+
+/**
+ * Prints the usage message to standard error and exits.
+ *
+ * @param kinds The corpus kinds.
+ * @param kinds_len The number of corpus kinds.
+ */
+_Noreturn
+static void usage( corpus_kind_t const *kinds, size_t kinds_len ) {
+  EPRINTF( "usage: %s kind size-in-KiB\nkinds:", me );
+  for ( size_t i = 0; i < kinds_len; ++i )
+    EPRINTF( " %s", kinds[i].name );
+  EPRINTF( "\n" );
+  exit( EX_USAGE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( int argc, char const *argv[] ) {
+  static corpus_kind_t const KINDS[] = {
+    { "code",          &gen_code,     NULL,  "",    NULL  },
+    { "comments-c",    &gen_plain,    "/*",  " * ", " */" },
+    { "comments-cxx",  &gen_plain,    NULL,  "// ", NULL  },
+    { "comments-lisp", &gen_plain,    NULL,  ";; ", NULL  },
+    { "comments-md",   &gen_markdown, NULL,  "// ", NULL  },
+    { "comments-sh",   &gen_plain,    NULL,  "# ",  NULL  },
+    { "comments-sql",  &gen_plain,    NULL,  "-- ", NULL  },
+    { "doxygen",       &gen_doxygen,  "/**", " * ", " */" },
+    { "markdown",      &gen_markdown, NULL,  "",    NULL  },
+    { "plain",         &gen_plain,    NULL,  "",    NULL  },
+    { "unicode",       &gen_unicode,  NULL,  "",    NULL  },
+    { "uri",           &gen_uri,      NULL,  "",    NULL  },
+  };
+
+  me = base_name( argv[0] );
+  if ( argc != 3 )
+    usage( KINDS, ARRAY_SIZE( KINDS ) );
+
+  for ( size_t i = 0; i < ARRAY_SIZE( KINDS ); ++i ) {
+    corpus_kind_t const *const kind = &KINDS[i];
+    if ( strcmp( argv[1], kind->name ) != 0 )
+      continue;
+    if ( kind->begin != NULL ) {
+      put_str( kind->begin );
+      put_str( "\n" );
+    }
+    line_prefix = kind->prefix;
+    (*kind->gen_fn)( check_atou( argv[2] ) * 1024 );
+    line_prefix = "";
+    if ( kind->end != NULL ) {
+      put_str( kind->end );
+      put_str( "\n" );
+    }
+    PERROR_EXIT_IF( fflush( stdout ) != 0, EX_IOERR );
+    exit( EX_OK );
+  } // for
+
+  usage( KINDS, ARRAY_SIZE( KINDS ) );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,530 @@
+/*
+**      wrap -- text reformatter
+**      src/gen_cp_props.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Generates, at build time, the C source for the two-stage tables of Unicode
+ * code-point properties (\ref cp_prop) used by cp_props() and of display
+ * widths used by cp_width(), e.g.:
+ *
+ *      $ ./gen_cp_props > cp_props.c
+ *
+ * The alphabetic, alphanumeric, and space properties come from the Unicode
+ * character data vendored by Gnulib's `unictype` modules rather than the
+ * current locale, so the tables are the same everywhere.  The display widths
+ * come from the East Asian Width property (UAX #11) and the zero-width
+ * (combining, enclosing, and format) characters listed below.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "unicode.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+// Gnulib
+#include "unictype.h"
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Number of code-points per page, i.e., per second-stage table.
+#define CP_PAGE_SIZE              256
+
+/// Number of pages needed for all code-points.
+#define CP_PAGE_COUNT             ((CP_VALID_MAX + 1) / CP_PAGE_SIZE)
+
+/// Maximum number of distinct pages: page indices must fit in a `uint8_t`.
+#define CP_PAGE_DISTINCT_MAX      256
+
+/**
+ * A page of code-point values.
+ */
+typedef uint8_t cp_page_t[ CP_PAGE_SIZE ];
+
+/**
+ * An inclusive range of code-points.
+ */
+struct cp_range {
+  char32_t  first;                      ///< First code-point in range.
+  char32_t  last;                       ///< Last code-point in range.
+};
+typedef struct cp_range cp_range_t;
+
+/**
+ * Code-points having a display width of 0: non-spacing and enclosing marks,
+ * Hangul medial vowels and final consonants, and zero-width format
+ * characters.
+ */
+static cp_range_t const CP_WIDTH_0_RANGES[] = {
+  { 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD },
+  { 0x05BF, 0x05BF }, { 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 },
+  { 0x05C7, 0x05C7 }, { 0x0610, 0x061A }, { 0x061C, 0x061C },
+  { 0x064B, 0x065F }, { 0x0670, 0x0670 }, { 0x06D6, 0x06DC },
+  { 0x06DF, 0x06E4 }, { 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED },
+  { 0x0711, 0x0711 }, { 0x0730, 0x074A }, { 0x07A6, 0x07B0 },
+  { 0x07EB, 0x07F3 }, { 0x07FD, 0x07FD }, { 0x0816, 0x0819 },
+  { 0x081B, 0x0823 }, { 0x0825, 0x0827 }, { 0x0829, 0x082D },
+  { 0x0859, 0x085B }, { 0x0898, 0x089F }, { 0x08CA, 0x08E1 },
+  { 0x08E3, 0x0902 }, { 0x093A, 0x093A }, { 0x093C, 0x093C },
+  { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 },
+  { 0x0962, 0x0963 }, { 0x0981, 0x0981 }, { 0x09BC, 0x09BC },
+  { 0x09C1, 0x09C4 }, { 0x09CD, 0x09CD }, { 0x09E2, 0x09E3 },
+  { 0x09FE, 0x09FE }, { 0x0A01, 0x0A02 }, { 0x0A3C, 0x0A3C },
+  { 0x0A41, 0x0A42 }, { 0x0A47, 0x0A48 }, { 0x0A4B, 0x0A4D },
+  { 0x0A51, 0x0A51 }, { 0x0A70, 0x0A71 }, { 0x0A75, 0x0A75 },
+  { 0x0A81, 0x0A82 }, { 0x0ABC, 0x0ABC }, { 0x0AC1, 0x0AC5 },
+  { 0x0AC7, 0x0AC8 }, { 0x0ACD, 0x0ACD }, { 0x0AE2, 0x0AE3 },
+  { 0x0AFA, 0x0AFF }, { 0x0B01, 0x0B01 }, { 0x0B3C, 0x0B3C },
+  { 0x0B3F, 0x0B3F }, { 0x0B41, 0x0B44 }, { 0x0B4D, 0x0B4D },
+  { 0x0B55, 0x0B56 }, { 0x0B62, 0x0B63 }, { 0x0B82, 0x0B82 },
+  { 0x0BC0, 0x0BC0 }, { 0x0BCD, 0x0BCD }, { 0x0C00, 0x0C00 },
+  { 0x0C04, 0x0C04 }, { 0x0C3C, 0x0C3C }, { 0x0C3E, 0x0C40 },
+  { 0x0C46, 0x0C48 }, { 0x0C4A, 0x0C4D }, { 0x0C55, 0x0C56 },
+  { 0x0C62, 0x0C63 }, { 0x0C81, 0x0C81 }, { 0x0CBC, 0x0CBC },
+  { 0x0CBF, 0x0CBF }, { 0x0CC6, 0x0CC6 }, { 0x0CCC, 0x0CCD },
+  { 0x0CE2, 0x0CE3 }, { 0x0D00, 0x0D01 }, { 0x0D3B, 0x0D3C },
+  { 0x0D41, 0x0D44 }, { 0x0D4D, 0x0D4D }, { 0x0D62, 0x0D63 },
+  { 0x0D81, 0x0D81 }, { 0x0DCA, 0x0DCA }, { 0x0DD2, 0x0DD4 },
+  { 0x0DD6, 0x0DD6 }, { 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A },
+  { 0x0E47, 0x0E4E }, { 0x0EB1, 0x0EB1 }, { 0x0EB4, 0x0EBC },
+  { 0x0EC8, 0x0ECD }, { 0x0F18, 0x0F19 }, { 0x0F35, 0x0F35 },
+  { 0x0F37, 0x0F37 }, { 0x0F39, 0x0F39 }, { 0x0F71, 0x0F7E },
+  { 0x0F80, 0x0F84 }, { 0x0F86, 0x0F87 }, { 0x0F8D, 0x0F97 },
+  { 0x0F99, 0x0FBC }, { 0x0FC6, 0x0FC6 }, { 0x102D, 0x1030 },
+  { 0x1032, 0x1037 }, { 0x1039, 0x103A }, { 0x103D, 0x103E },
+  { 0x1058, 0x1059 }, { 0x105E, 0x1060 }, { 0x1071, 0x1074 },
+  { 0x1082, 0x1082 }, { 0x1085, 0x1086 }, { 0x108D, 0x108D },
+  { 0x109D, 0x109D }, { 0x1160, 0x11FF }, { 0x135D, 0x135F },
+  { 0x1712, 0x1714 }, { 0x1732, 0x1733 }, { 0x1752, 0x1753 },
+  { 0x1772, 0x1773 }, { 0x17B4, 0x17B5 }, { 0x17B7, 0x17BD },
+  { 0x17C6, 0x17C6 }, { 0x17C9, 0x17D3 }, { 0x17DD, 0x17DD },
+  { 0x180B, 0x180F }, { 0x1885, 0x1886 }, { 0x18A9, 0x18A9 },
+  { 0x1920, 0x1922 }, { 0x1927, 0x1928 }, { 0x1932, 0x1932 },
+  { 0x1939, 0x193B }, { 0x1A17, 0x1A18 }, { 0x1A1B, 0x1A1B },
+  { 0x1A56, 0x1A56 }, { 0x1A58, 0x1A5E }, { 0x1A60, 0x1A60 },
+  { 0x1A62, 0x1A62 }, { 0x1A65, 0x1A6C }, { 0x1A73, 0x1A7C },
+  { 0x1A7F, 0x1A7F }, { 0x1AB0, 0x1ACE }, { 0x1B00, 0x1B03 },
+  { 0x1B34, 0x1B34 }, { 0x1B36, 0x1B3A }, { 0x1B3C, 0x1B3C },
+  { 0x1B42, 0x1B42 }, { 0x1B6B, 0x1B73 }, { 0x1B80, 0x1B81 },
+  { 0x1BA2, 0x1BA5 }, { 0x1BA8, 0x1BA9 }, { 0x1BAB, 0x1BAD },
+  { 0x1BE6, 0x1BE6 }, { 0x1BE8, 0x1BE9 }, { 0x1BED, 0x1BED },
+  { 0x1BEF, 0x1BF1 }, { 0x1C2C, 0x1C33 }, { 0x1C36, 0x1C37 },
+  { 0x1CD0, 0x1CD2 }, { 0x1CD4, 0x1CE0 }, { 0x1CE2, 0x1CE8 },
+  { 0x1CED, 0x1CED }, { 0x1CF4, 0x1CF4 }, { 0x1CF8, 0x1CF9 },
+  { 0x1DC0, 0x1DFF }, { 0x200B, 0x200F }, { 0x202A, 0x202E },
+  { 0x2060, 0x2064 }, { 0x2066, 0x206F }, { 0x20D0, 0x20F0 },
+  { 0x2CEF, 0x2CF1 }, { 0x2D7F, 0x2D7F }, { 0x2DE0, 0x2DFF },
+  { 0x302A, 0x302D }, { 0x3099, 0x309A }, { 0xA66F, 0xA672 },
+  { 0xA674, 0xA67D }, { 0xA69E, 0xA69F }, { 0xA6F0, 0xA6F1 },
+  { 0xA802, 0xA802 }, { 0xA806, 0xA806 }, { 0xA80B, 0xA80B },
+  { 0xA825, 0xA826 }, { 0xA82C, 0xA82C }, { 0xA8C4, 0xA8C5 },
+  { 0xA8E0, 0xA8F1 }, { 0xA8FF, 0xA8FF }, { 0xA926, 0xA92D },
+  { 0xA947, 0xA951 }, { 0xA980, 0xA982 }, { 0xA9B3, 0xA9B3 },
+  { 0xA9B6, 0xA9B9 }, { 0xA9BC, 0xA9BD }, { 0xA9E5, 0xA9E5 },
+  { 0xAA29, 0xAA2E }, { 0xAA31, 0xAA32 }, { 0xAA35, 0xAA36 },
+  { 0xAA43, 0xAA43 }, { 0xAA4C, 0xAA4C }, { 0xAA7C, 0xAA7C },
+  { 0xAAB0, 0xAAB0 }, { 0xAAB2, 0xAAB4 }, { 0xAAB7, 0xAAB8 },
+  { 0xAABE, 0xAABF }, { 0xAAC1, 0xAAC1 }, { 0xAAEC, 0xAAED },
+  { 0xAAF6, 0xAAF6 }, { 0xABE5, 0xABE5 }, { 0xABE8, 0xABE8 },
+  { 0xABED, 0xABED }, { 0xD7B0, 0xD7C6 }, { 0xD7CB, 0xD7FB },
+  { 0xFB1E, 0xFB1E }, { 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F },
+  { 0xFEFF, 0xFEFF }, { 0xFFF9, 0xFFFB }, { 0x101FD, 0x101FD },
+  { 0x102E0, 0x102E0 }, { 0x10376, 0x1037A }, { 0x10A01, 0x10A03 },
+  { 0x10A05, 0x10A06 }, { 0x10A0C, 0x10A0F }, { 0x10A38, 0x10A3A },
+  { 0x10A3F, 0x10A3F }, { 0x10AE5, 0x10AE6 }, { 0x10D24, 0x10D27 },
+  { 0x10EAB, 0x10EAC }, { 0x10F46, 0x10F50 }, { 0x10F82, 0x10F85 },
+  { 0x11001, 0x11001 }, { 0x11038, 0x11046 }, { 0x11070, 0x11070 },
+  { 0x11073, 0x11074 }, { 0x1107F, 0x11081 }, { 0x110B3, 0x110B6 },
+  { 0x110B9, 0x110BA }, { 0x110C2, 0x110C2 }, { 0x11100, 0x11102 },
+  { 0x11127, 0x1112B }, { 0x1112D, 0x11134 }, { 0x11173, 0x11173 },
+  { 0x11180, 0x11181 }, { 0x111B6, 0x111BE }, { 0x111C9, 0x111CC },
+  { 0x111CF, 0x111CF }, { 0x1122F, 0x11231 }, { 0x11234, 0x11234 },
+  { 0x11236, 0x11237 }, { 0x1123E, 0x1123E }, { 0x112DF, 0x112DF },
+  { 0x112E3, 0x112EA }, { 0x11300, 0x11301 }, { 0x1133B, 0x1133C },
+  { 0x11340, 0x11340 }, { 0x11366, 0x1136C }, { 0x11370, 0x11374 },
+  { 0x11438, 0x1143F }, { 0x11442, 0x11444 }, { 0x11446, 0x11446 },
+  { 0x1145E, 0x1145E }, { 0x114B3, 0x114B8 }, { 0x114BA, 0x114BA },
+  { 0x114BF, 0x114C0 }, { 0x114C2, 0x114C3 }, { 0x115B2, 0x115B5 },
+  { 0x115BC, 0x115BD }, { 0x115BF, 0x115C0 }, { 0x115DC, 0x115DD },
+  { 0x11633, 0x1163A }, { 0x1163D, 0x1163D }, { 0x1163F, 0x11640 },
+  { 0x116AB, 0x116AB }, { 0x116AD, 0x116AD }, { 0x116B0, 0x116B5 },
+  { 0x116B7, 0x116B7 }, { 0x1171D, 0x1171F }, { 0x11722, 0x11725 },
+  { 0x11727, 0x1172B }, { 0x1182F, 0x11837 }, { 0x11839, 0x1183A },
+  { 0x1193B, 0x1193C }, { 0x1193E, 0x1193E }, { 0x11943, 0x11943 },
+  { 0x119D4, 0x119D7 }, { 0x119DA, 0x119DB }, { 0x119E0, 0x119E0 },
+  { 0x11A01, 0x11A0A }, { 0x11A33, 0x11A38 }, { 0x11A3B, 0x11A3E },
+  { 0x11A47, 0x11A47 }, { 0x11A51, 0x11A56 }, { 0x11A59, 0x11A5B },
+  { 0x11A8A, 0x11A96 }, { 0x11A98, 0x11A99 }, { 0x11C30, 0x11C36 },
+  { 0x11C38, 0x11C3D }, { 0x11C3F, 0x11C3F }, { 0x11C92, 0x11CA7 },
+  { 0x11CAA, 0x11CB0 }, { 0x11CB2, 0x11CB3 }, { 0x11CB5, 0x11CB6 },
+  { 0x11D31, 0x11D36 }, { 0x11D3A, 0x11D3A }, { 0x11D3C, 0x11D3D },
+  { 0x11D3F, 0x11D45 }, { 0x11D47, 0x11D47 }, { 0x11D90, 0x11D91 },
+  { 0x11D95, 0x11D95 }, { 0x11D97, 0x11D97 }, { 0x11EF3, 0x11EF4 },
+  { 0x13430, 0x13438 }, { 0x16AF0, 0x16AF4 }, { 0x16B30, 0x16B36 },
+  { 0x16F4F, 0x16F4F }, { 0x16F8F, 0x16F92 }, { 0x16FE4, 0x16FE4 },
+  { 0x1BC9D, 0x1BC9E }, { 0x1BCA0, 0x1BCA3 }, { 0x1CF00, 0x1CF2D },
+  { 0x1CF30, 0x1CF46 }, { 0x1D167, 0x1D169 }, { 0x1D173, 0x1D182 },
+  { 0x1D185, 0x1D18B }, { 0x1D1AA, 0x1D1AD }, { 0x1D242, 0x1D244 },
+  { 0x1DA00, 0x1DA36 }, { 0x1DA3B, 0x1DA6C }, { 0x1DA75, 0x1DA75 },
+  { 0x1DA84, 0x1DA84 }, { 0x1DA9B, 0x1DA9F }, { 0x1DAA1, 0x1DAAF },
+  { 0x1E000, 0x1E006 }, { 0x1E008, 0x1E018 }, { 0x1E01B, 0x1E021 },
+  { 0x1E023, 0x1E024 }, { 0x1E026, 0x1E02A }, { 0x1E130, 0x1E136 },
+  { 0x1E2AE, 0x1E2AE }, { 0x1E2EC, 0x1E2EF }, { 0x1E8D0, 0x1E8D6 },
+  { 0x1E944, 0x1E94A }, { 0xE0001, 0xE0001 }, { 0xE0020, 0xE007F },
+  { 0xE0100, 0xE01EF },
+};
+
+/**
+ * Code-points having a display width of 2: East Asian Wide (W) and Fullwidth
+ * (F) characters.
+ */
+static cp_range_t const CP_WIDTH_2_RANGES[] = {
+  { 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A },
+  { 0x23E9, 0x23EC }, { 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 },
+  { 0x25FD, 0x25FE }, { 0x2614, 0x2615 }, { 0x2648, 0x2653 },
+  { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+  { 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 },
+  { 0x26CE, 0x26CE }, { 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA },
+  { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 }, { 0x26FA, 0x26FA },
+  { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+  { 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E },
+  { 0x2753, 0x2755 }, { 0x2757, 0x2757 }, { 0x2795, 0x2797 },
+  { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF }, { 0x2B1B, 0x2B1C },
+  { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x2E99 },
+  { 0x2E9B, 0x2EF3 }, { 0x2F00, 0x2FD5 }, { 0x2FF0, 0x2FFB },
+  { 0x3000, 0x3029 }, { 0x302E, 0x303E }, { 0x3041, 0x3096 },
+  { 0x309B, 0x30FF }, { 0x3105, 0x312F }, { 0x3131, 0x318E },
+  { 0x3190, 0x31E3 }, { 0x31F0, 0x321E }, { 0x3220, 0xA48C },
+  { 0xA490, 0xA4C6 }, { 0xA960, 0xA97C }, { 0xAC00, 0xD7A3 },
+  { 0xF900, 0xFA6D }, { 0xFA70, 0xFAD9 }, { 0xFE10, 0xFE19 },
+  { 0xFE30, 0xFE52 }, { 0xFE54, 0xFE66 }, { 0xFE68, 0xFE6B },
+  { 0xFF01, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE3 },
+  { 0x16FF0, 0x16FF1 }, { 0x17000, 0x187F7 }, { 0x18800, 0x18CD5 },
+  { 0x18D00, 0x18D08 }, { 0x1AFF0, 0x1AFF3 }, { 0x1AFF5, 0x1AFFB },
+  { 0x1AFFD, 0x1AFFE }, { 0x1B000, 0x1B122 }, { 0x1B150, 0x1B152 },
+  { 0x1B164, 0x1B167 }, { 0x1B170, 0x1B2FB }, { 0x1F004, 0x1F004 },
+  { 0x1F0CF, 0x1F0CF }, { 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A },
+  { 0x1F200, 0x1F202 }, { 0x1F210, 0x1F23B }, { 0x1F240, 0x1F248 },
+  { 0x1F250, 0x1F251 }, { 0x1F260, 0x1F265 }, { 0x1F300, 0x1F320 },
+  { 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C }, { 0x1F37E, 0x1F393 },
+  { 0x1F3A0, 0x1F3CA }, { 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 },
+  { 0x1F3F4, 0x1F3F4 }, { 0x1F3F8, 0x1F43E }, { 0x1F440, 0x1F440 },
+  { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D }, { 0x1F54B, 0x1F54E },
+  { 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A }, { 0x1F595, 0x1F596 },
+  { 0x1F5A4, 0x1F5A4 }, { 0x1F5FB, 0x1F64F }, { 0x1F680, 0x1F6C5 },
+  { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 }, { 0x1F6D5, 0x1F6D7 },
+  { 0x1F6DD, 0x1F6DF }, { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC },
+  { 0x1F7E0, 0x1F7EB }, { 0x1F7F0, 0x1F7F0 }, { 0x1F90C, 0x1F93A },
+  { 0x1F93C, 0x1F945 }, { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FA74 },
+  { 0x1FA78, 0x1FA7C }, { 0x1FA80, 0x1FA86 }, { 0x1FA90, 0x1FAAC },
+  { 0x1FAB0, 0x1FABA }, { 0x1FAC0, 0x1FAC5 }, { 0x1FAD0, 0x1FAD9 },
+  { 0x1FAE0, 0x1FAE7 }, { 0x1FAF0, 0x1FAF6 }, { 0x20000, 0x2A6DF },
+  { 0x2A700, 0x2B738 }, { 0x2B740, 0x2B81D }, { 0x2B820, 0x2CEA1 },
+  { 0x2CEB0, 0x2EBE0 }, { 0x2F800, 0x2FA1D }, { 0x30000, 0x3134A },
+};
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Checks whether \a cp is within any of \a ranges.
+ *
+ * @param cp The Unicode code-point to check.
+ * @param ranges The sorted array of ranges to check.
+ * @param n The number of ranges.
+ * @return Returns `true` only if \a cp is within any range.
+ */
+NODISCARD
+static bool cp_in_ranges( char32_t cp, cp_range_t const ranges[], size_t n ) {
+  size_t lo = 0, hi = n;
+  while ( lo < hi ) {
+    size_t const mid = lo + (hi - lo) / 2;
+    if ( cp < ranges[ mid ].first )
+      hi = mid;
+    else if ( cp > ranges[ mid ].last )
+      lo = mid + 1;
+    else
+      return true;
+  } // while
+  return false;
+}
+
+/**
+ * Checks whether \a cp is an "end-of-sentence" character
+ *
+ * @param cp The Unicode code-point to check.
+ * @return Returns `true` only if \a cp is an end-of-sentence character.
+ */
+NODISCARD
+static bool is_eos( char32_t cp ) {
+  switch ( cp ) {
+    case '.'   :  // FULL STOP
+    case 0xFF0E:  // FULLWIDTH FULL STOP
+
+    case '?'   :  // QUESTION MARK
+    case 0x037E:  // GREEK QUESTION MARK
+    case 0x055E:  // ARMENIAN QUESTION MARK
+    case 0x1367:  // ETHIOPIC QUESTION MARK
+    case 0x1945:  // LIMBU QUESTION MARK
+    case 0x2047:  // DOUBLE QUESTION MARK
+    case 0x2048:  // QUESTION EXCLAMATION MARK
+    case 0xA60F:  // VAI QUESTION MARK
+    case 0xA6F7:  // BAMUM QUESTION MARK
+    case 0xFE16:  // PRESENTATION FORM FOR VERTICAL QUESTION MARK
+    case 0xFE56:  // SMALL QUESTION MARK
+    case 0xFF1F:  // FULLWIDTH QUESTION MARK
+
+    case '!'   :  // EXCLAMATION MARK
+    case 0x055C:  // ARMENIAN EXCLAMATION MARK
+    case 0x07F9:  // NKO EXCLAMATION MARK
+    case 0x1944:  // LIMBU EXCLAMATION MARK
+    case 0x203C:  // DOUBLE EXCLAMATION MARK
+    case 0x2049:  // EXCLAMATION QUESTION MARK
+    case 0x2757:  // HEAVY EXCLAMATION MARK SYMBOL
+    case 0x2762:  // HEAVY EXCLAMATION MARK ORNAMENT
+    case 0x2763:  // HEAVY HEART EXCLAMATION MARK ORNAMENT
+    case 0xFE15:  // PRESENTATION FORM FOR VERTICAL EXCLAMATION MARK
+    case 0xFE57:  // SMALL EXCLAMATION MARK
+    case 0xFF01:  // FULLWIDTH EXCLAMATION MARK
+      return true;
+
+    default:
+      return false;
+  } // switch
+}
+
+/**
+ * Checks whether \a cp is an "end-of-sentence-extender" Unicode character,
+ * that is a character that extends being in the end-of-sentence state, e.g.,
+ * a `)` following a period.
+ *
+ * @param cp The Unicode code-point to check.
+ * @return Returns `true` only if \a cp is an end-of-sentence-extender
+ * character.
+ */
+NODISCARD
+static bool is_eos_ext( char32_t cp ) {
+  switch ( cp ) {
+    case '\''  :  // APOSTROPHE
+    case 0x2019:  // RIGHT SINGLE QUOTATION MARK
+    case 0x203A:  // SINGLE RIGHT-POINTING ANGLE QUOTATION MARK
+    case 0x275C:  // HEAVY SINGLE COMMA QUOTATION MARK ORNAMENT
+
+    case '"'   :  // QUOTATION MARK
+    case 0x00BB:  // RIGHT-POINTING DOUBLE ANGLE QUOTATION MARK
+    case 0x201D:  // RIGHT DOUBLE QUOTATION MARK
+    case 0x275E:  // HEAVY DOUBLE COMMA QUOTATION MARK ORNAMENT
+    case 0x276F:  // HEAVY RIGHT-POINTING ANGLE QUOTATION MARK ORNAMENT
+    case 0xFF02:  // FULLWIDTH QUOTATION MARK
+
+    case ')'   :  // RIGHT PARENTHESIS
+    case 0x2769:  // MEDIUM RIGHT PARENTHESIS ORNAMENT
+    case 0x276B:  // MEDIUM FLATTENED RIGHT PARENTHESIS ORNAMENT
+    case 0x27EF:  // MATHEMATICAL RIGHT FLATTENED PARENTHESIS
+    case 0x2986:  // RIGHT WHITE PARENTHESIS
+    case 0x2E29:  // RIGHT DOUBLE PARENTHESIS
+    case 0xFD3F:  // ORNATE RIGHT PARENTHESIS
+    case 0xFE5A:  // SMALL RIGHT PARENTHESIS
+    case 0xFF09:  // FULLWIDTH RIGHT PARENTHESIS
+    case 0xFF60:  // FULLWIDTH RIGHT WHITE PARENTHESIS
+
+    case ']'   :  // RIGHT SQUATE BRACKET
+    case 0x2046:  // RIGHT SQUARE BRACKET WITH QUILL
+    case 0x27E7:  // MATHEMATICAL RIGHT WHITE SQUARE BRACKET
+    case 0x298C:  // RIGHT SQUARE BRACKET WITH UNDERBAR
+    case 0x298E:  // RIGHT SQUARE BRACKET WITH TICK IN BOTTOM CORNER
+    case 0x2990:  // RIGHT SQUARE BRACKET WITH TICK IN TOP CORNER
+    case 0x301B:  // RIGHT WHITE SQUARE BRACKET
+    case 0xFF3D:  // FULLWIDTH RIGHT SQUARE BRACKET
+      return true;
+
+    default:
+      return false;
+  } // switch
+}
+
+/**
+ * Checks whether the given Unicode code-point is a hyphen-like character.
+ *
+ * @param cp The Unicode code-point to check.
+ * @return Returns `true` only if \a cp is a Unicode hyphen-like character.
+ */
+NODISCARD
+static bool is_hyphen( char32_t cp ) {
+  switch ( cp ) {
+    case '-'   :  // HYPHEN-MINUS
+    case 0x00AD:  // SOFT HYPHEN
+    case 0x058A:  // ARMENIAN HYPHEN
+    case 0x05BE:  // HEBREW PUNCTUATION MAQAF
+    case 0x1400:  // CANADIAN SYLLABICS HYPHEN
+    case 0x1806:  // MONGOLIAN SOFT HYPHEN
+    case 0x2010:  // HYPHEN
+//  case 0x2011:  // NON-BREAKING HYPHEN // obviously don't want to wrap here
+    case 0x2013:  // EN DASH
+    case 0x2014:  // EM DASH
+    case 0x2015:  // HORIZONTAL BAR
+    case 0x2027:  // HYPHENATION POINT
+    case 0x2043:  // HYPHEN BULLET
+    case 0x2053:  // SWUNG DASH
+    case 0x2E17:  // DOUBLE OBLIQUE HYPHEN
+    case 0x2E1A:  // HYPHEN WITH DIAERESIS
+    case 0x2E40:  // DOUBLE HYPHEN
+    case 0x301C:  // WAVE DASH
+    case 0x3030:  // WAVY DASH
+    case 0x30A0:  // KATAKANA-HIRAGANA DOUBLE HYPHEN
+    case 0x30FB:  // KATAKANA MIDDLE DOT
+    case 0xFE58:  // SMALL EM DASH
+    case 0xFE63:  // SMALL HYPHEN-MINUS
+    case 0xFF0D:  // FULLWIDTH HYPHEN-MINUS
+    case 0xFF65:  // HALFWIDTH KATAKANA MIDDLE DOT
+      return true;
+
+    default:
+      return false;
+  } // switch
+}
+
+/**
+ * Gets all the properties of \a cp.
+ *
+ * @param cp The Unicode code-point to get the properties of.
+ * @return Returns a bitwise-or of \ref cp_prop values.
+ */
+NODISCARD
+static uint8_t props_of( char32_t cp ) {
+  unsigned props = 0;
+  if ( uc_is_alpha( cp ) )
+    props |= CP_PROP_ALPHA;
+  if ( cp_is_ascii( cp ) && iscntrl( STATIC_CAST( int, cp ) ) )
+    props |= CP_PROP_CONTROL;
+  if ( is_eos( cp ) )
+    props |= CP_PROP_EOS;
+  if ( is_eos_ext( cp ) )
+    props |= CP_PROP_EOS_EXT;
+  if ( is_hyphen( cp ) )
+    props |= CP_PROP_HYPHEN;
+  if ( uc_is_space( cp ) )
+    props |= CP_PROP_SPACE;
+  if ( uc_is_alnum( cp ) || cp == '_' )
+    props |= CP_PROP_WORD;
+  return STATIC_CAST( uint8_t, props );
+}
+
+/**
+ * Prints \a n bytes as a comma-separated list of hexadecimal numbers, 16 per
+ * line.
+ *
+ * @param bytes The bytes to print.
+ * @param n The number of bytes.
+ * @param indent The number of spaces to indent each line.
+ */
+static void put_bytes( uint8_t const *bytes, size_t n, int indent ) {
+  for ( size_t i = 0; i < n; ++i ) {
+    if ( i % 16 == 0 )
+      printf( "%*s", indent, "" );
+    printf( "0x%02X,%c", bytes[i], i % 16 == 15 || i + 1 == n ? '\n' : ' ' );
+  } // for
+}
+
+/**
+ * Prints a two-stage table of per-code-point values as the C definitions of
+ * <code><i>name</i>_PAGE_INDEX</code> and <code><i>name</i>_PAGES</code>.
+ * Identical pages are stored only once.
+ *
+ * @param name The prefix of the table names.
+ * @param value_of A pointer to a function that returns the value for a
+ * code-point.
+ */
+static void put_table( char const *name, uint8_t (*value_of)( char32_t ) ) {
+  static cp_page_t  pages[ CP_PAGE_DISTINCT_MAX ];
+  uint8_t           page_index[ CP_PAGE_COUNT ];
+  size_t            pages_len = 0;
+
+  for ( size_t p = 0; p < CP_PAGE_COUNT; ++p ) {
+    cp_page_t page;
+    for ( size_t i = 0; i < CP_PAGE_SIZE; ++i )
+      page[i] = (*value_of)( STATIC_CAST( char32_t, p * CP_PAGE_SIZE + i ) );
+
+    size_t j = 0;
+    while ( j < pages_len && memcmp( pages[j], page, sizeof page ) != 0 )
+      ++j;
+    if ( j == pages_len ) {
+      if ( pages_len == CP_PAGE_DISTINCT_MAX ) {
+        fprintf( stderr, "gen_cp_props: %s: too many distinct pages\n", name );
+        exit( EX_SOFTWARE );
+      }
+      memcpy( pages[ pages_len++ ], page, sizeof page );
+    }
+    page_index[p] = STATIC_CAST( uint8_t, j );
+  } // for
+
+  printf( "\nuint8_t const %s_PAGE_INDEX[] = {\n", name );
+  put_bytes( page_index, CP_PAGE_COUNT, 2 );
+  printf( "};\n\nuint8_t const %s_PAGES[][%d] = {\n", name, CP_PAGE_SIZE );
+  for ( size_t j = 0; j < pages_len; ++j ) {
+    printf( "  { /* %zu */\n", j );
+    put_bytes( pages[j], CP_PAGE_SIZE, 4 );
+    printf( "  },\n" );
+  } // for
+  printf( "};\n" );
+}
+
+/**
+ * Gets the display width of \a cp.
+ *
+ * @param cp The Unicode code-point to get the width of.
+ * @return Returns said width: 0, 1, or 2.  Control characters have a width of
+ * 1 since that's how they've always been counted.
+ */
+NODISCARD
+static uint8_t width_of( char32_t cp ) {
+  if ( cp_in_ranges( cp, CP_WIDTH_0_RANGES, ARRAY_SIZE( CP_WIDTH_0_RANGES ) ) )
+    return 0;
+  if ( cp_in_ranges( cp, CP_WIDTH_2_RANGES, ARRAY_SIZE( CP_WIDTH_2_RANGES ) ) )
+    return 2;
+  return 1;
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( void ) {
+  printf(
+    "/* DO NOT EDIT! GENERATED AUTOMATICALLY by gen_cp_props. */\n"
+    "\n"
+    "#include \"pjl_config.h\"\n"
+    "#include \"unicode.h\"\n"
+  );
+  put_table( "CP_PROPS", &props_of );
+  put_table( "CP_WIDTH", &width_of );
+  return fflush( stdout ) == 0 ? EX_OK : EX_IOERR;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
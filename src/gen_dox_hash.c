@@ -0,0 +1,209 @@
+/*
+**      wrap -- text reformatter
+**      src/gen_dox_hash.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Generates, at build time, the C source for the tables that, together with
+ * dox_hash_slot(), make a minimal perfect hash function over the names in
+ * \ref DOX_COMMANDS used by dox_find_cmd(), e.g.:
+ *
+ *      $ ./gen_dox_hash > dox_hash.c
+ *
+ * Each command name is put into a bucket by dox_hash_bucket().  Then, for
+ * each bucket from the largest to the smallest, the smallest seed that gives
+ * all of its names distinct, still unused slots is found.  (This is the
+ * "hash, displace, and compress" algorithm minus the compression.)
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "doxygen.h"
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint*_t */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Number of buckets.
+#define DOX_HASH_BUCKETS          (1u << DOX_HASH_BUCKET_BITS)
+
+/// Maximum number of commands: indices must fit in a `uint8_t`.
+#define DOX_COMMANDS_MAX          256
+
+/// Maximum number of commands per bucket.
+#define DOX_BUCKET_SIZE_MAX       32
+
+/**
+ * A bucket of command names having the same dox_hash_bucket().
+ */
+struct dox_bucket {
+  size_t    bucket;                     ///< The bucket's index.
+  size_t    len;                        ///< Number of commands.
+  size_t    cmd_index[ DOX_BUCKET_SIZE_MAX ]; ///< Indices into DOX_COMMANDS.
+};
+typedef struct dox_bucket dox_bucket_t;
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Compares two \ref dox_bucket for qsort() by decreasing length, then by
+ * increasing bucket index.
+ *
+ * @param i_data A pointer to the first \ref dox_bucket.
+ * @param j_data A pointer to the second \ref dox_bucket.
+ * @return Returns a number less than 0, 0, or greater than 0 if \a i_data
+ * should be before, is the same as, or should be after \a j_data,
+ * respectively.
+ */
+NODISCARD
+static int dox_bucket_cmp( void const *i_data, void const *j_data ) {
+  dox_bucket_t const *const i_bucket = i_data;
+  dox_bucket_t const *const j_bucket = j_data;
+  if ( i_bucket->len != j_bucket->len )
+    return i_bucket->len > j_bucket->len ? -1 : 1;
+  return (i_bucket->bucket > j_bucket->bucket) -
+         (i_bucket->bucket < j_bucket->bucket);
+}
+
+/**
+ * Tries to find a seed for \a b that gives all of its commands distinct slots
+ * not already used.
+ *
+ * @param b The \ref dox_bucket to find a seed for.
+ * @param used Indexed by slot, `true` if the slot is already used.
+ * @param slots An array of size `b->len` to receive the slots.
+ * @return Returns the seed.
+ */
+NODISCARD
+static uint16_t find_seed( dox_bucket_t const *b, bool const used[],
+                           size_t slots[] ) {
+  for ( uint32_t seed = 0; seed <= UINT16_MAX; ++seed ) {
+    size_t i = 0;
+    for ( ; i < b->len; ++i ) {
+      char const *const name = DOX_COMMANDS[ b->cmd_index[i] ].name;
+      slots[i] =
+        dox_hash_slot( dox_hash( name ), STATIC_CAST( uint16_t, seed ) );
+      if ( used[ slots[i] ] )
+        break;
+      size_t j = 0;
+      while ( j < i && slots[j] != slots[i] )
+        ++j;
+      if ( j < i )
+        break;
+    } // for
+    if ( i == b->len )
+      return STATIC_CAST( uint16_t, seed );
+  } // for
+
+  fprintf( stderr,
+    "gen_dox_hash: bucket %zu: no seed gives its %zu commands distinct slots;"
+    " increase DOX_HASH_BUCKET_BITS\n",
+    b->bucket, b->len
+  );
+  exit( EX_SOFTWARE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( void ) {
+  if ( DOX_COMMANDS_LEN > DOX_COMMANDS_MAX ) {
+    fprintf( stderr,
+      "gen_dox_hash: %zu commands: more than %d\n",
+      DOX_COMMANDS_LEN, DOX_COMMANDS_MAX
+    );
+    exit( EX_SOFTWARE );
+  }
+
+  dox_bucket_t buckets[ DOX_HASH_BUCKETS ];
+  for ( size_t i = 0; i < DOX_HASH_BUCKETS; ++i )
+    buckets[i] = (dox_bucket_t){ .bucket = i };
+
+  for ( size_t i = 0; i < DOX_COMMANDS_LEN; ++i ) {
+    if ( i > 0 &&
+         strcmp( DOX_COMMANDS[i-1].name, DOX_COMMANDS[i].name ) >= 0 ) {
+      fprintf( stderr,
+        "gen_dox_hash: \"%s\": DOX_COMMANDS not sorted\n",
+        DOX_COMMANDS[i].name
+      );
+      exit( EX_SOFTWARE );
+    }
+    dox_bucket_t *const b =
+      &buckets[ dox_hash_bucket( dox_hash( DOX_COMMANDS[i].name ) ) ];
+    if ( b->len == DOX_BUCKET_SIZE_MAX ) {
+      fprintf( stderr,
+        "gen_dox_hash: bucket %zu: more than %d commands;"
+        " increase DOX_HASH_BUCKET_BITS\n",
+        b->bucket, DOX_BUCKET_SIZE_MAX
+      );
+      exit( EX_SOFTWARE );
+    }
+    b->cmd_index[ b->len++ ] = i;
+  } // for
+
+  uint16_t  seeds[ DOX_HASH_BUCKETS ] = { 0 };
+  uint8_t   index[ DOX_COMMANDS_MAX ];
+  bool      used[ DOX_COMMANDS_MAX ] = { false };
+
+  qsort( buckets, DOX_HASH_BUCKETS, sizeof( buckets[0] ), &dox_bucket_cmp );
+
+  for ( size_t i = 0; i < DOX_HASH_BUCKETS && buckets[i].len > 0; ++i ) {
+    dox_bucket_t const *const b = &buckets[i];
+    size_t slots[ DOX_BUCKET_SIZE_MAX ];
+    seeds[ b->bucket ] = find_seed( b, used, slots );
+    for ( size_t j = 0; j < b->len; ++j ) {
+      used[ slots[j] ] = true;
+      index[ slots[j] ] = STATIC_CAST( uint8_t, b->cmd_index[j] );
+    } // for
+  } // for
+
+  printf(
+    "/* DO NOT EDIT! GENERATED AUTOMATICALLY by gen_dox_hash. */\n"
+    "\n"
+    "#include \"pjl_config.h\"\n"
+    "#include \"doxygen.h\"\n"
+    "\n"
+    "uint16_t const DOX_HASH_SEED[] = {\n"
+  );
+  for ( size_t i = 0; i < DOX_HASH_BUCKETS; ++i ) {
+    if ( i % 8 == 0 )
+      printf( "  " );
+    printf( "%5u,%c", seeds[i], i % 8 == 7 ? '\n' : ' ' );
+  } // for
+  printf( "};\n\nuint8_t const DOX_HASH_INDEX[] = {\n" );
+  for ( size_t i = 0; i < DOX_COMMANDS_LEN; ++i )
+    printf( "  %3u, // %s\n", index[i], DOX_COMMANDS[ index[i] ].name );
+  printf( "};\n" );
+
+  return fflush( stdout ) == 0 ? EX_OK : EX_IOERR;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,223 @@
+/*
+**      wrap -- text reformatter
+**      src/gen_html_hash.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Generates, at build time, the C source for the tables that, together with
+ * html_element_slot(), make a perfect hash function over the names in \ref
+ * HTML_BLOCK_ELEMENTS used by markdown_html_element(), e.g.:
+ *
+ *      $ ./gen_html_hash > html_hash.c
+ *
+ * Each element name is put into a bucket by html_element_bucket().  Then, for
+ * each bucket from the largest to the smallest, the smallest seed that gives
+ * all of its names distinct, still unused slots is found.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "markdown.h"
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint*_t */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Maximum number of elements per bucket.
+#define HTML_BUCKET_SIZE_MAX      16
+
+/**
+ * A bucket of element names having the same html_element_bucket().
+ */
+struct html_bucket {
+  size_t  bucket;                       ///< The bucket's index.
+  size_t  len;                          ///< Number of elements.
+
+  /// Indices into HTML_BLOCK_ELEMENTS.
+  size_t  element_index[ HTML_BUCKET_SIZE_MAX ];
+};
+typedef struct html_bucket html_bucket_t;
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Tries to find a seed for \a b that gives all of its elements distinct slots
+ * not already used.
+ *
+ * @param b The \ref html_bucket to find a seed for.
+ * @param used Indexed by slot, `true` if the slot is already used.
+ * @param slots An array of size `b->len` to receive the slots.
+ * @return Returns the seed.
+ */
+NODISCARD
+static uint8_t find_seed( html_bucket_t const *b, bool const used[],
+                          size_t slots[] ) {
+  for ( unsigned seed = 0; seed <= UINT8_MAX; ++seed ) {
+    size_t i = 0;
+    for ( ; i < b->len; ++i ) {
+      char const *const name = HTML_BLOCK_ELEMENTS[ b->element_index[i] ].name;
+      slots[i] = html_element_slot(
+        name, strlen( name ), STATIC_CAST( uint8_t, seed )
+      );
+      if ( used[ slots[i] ] )
+        break;
+      size_t j = 0;
+      while ( j < i && slots[j] != slots[i] )
+        ++j;
+      if ( j < i )
+        break;
+    } // for
+    if ( i == b->len )
+      return STATIC_CAST( uint8_t, seed );
+  } // for
+
+  fprintf( stderr,
+    "gen_html_hash: bucket %zu: no seed gives its %zu elements distinct slots;"
+    " increase HTML_ELEMENT_SLOTS\n",
+    b->bucket, b->len
+  );
+  exit( EX_SOFTWARE );
+}
+
+/**
+ * Compares two \ref html_bucket for qsort() by decreasing length, then by
+ * increasing bucket index.
+ *
+ * @param i_data A pointer to the first \ref html_bucket.
+ * @param j_data A pointer to the second \ref html_bucket.
+ * @return Returns a number less than 0, 0, or greater than 0 if \a i_data
+ * should be before, is the same as, or should be after \a j_data,
+ * respectively.
+ */
+NODISCARD
+static int html_bucket_cmp( void const *i_data, void const *j_data ) {
+  html_bucket_t const *const i_bucket = i_data;
+  html_bucket_t const *const j_bucket = j_data;
+  if ( i_bucket->len != j_bucket->len )
+    return i_bucket->len > j_bucket->len ? -1 : 1;
+  return (i_bucket->bucket > j_bucket->bucket) -
+         (i_bucket->bucket < j_bucket->bucket);
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( void ) {
+  if ( HTML_BLOCK_ELEMENTS_LEN > HTML_ELEMENT_SLOTS ) {
+    fprintf( stderr,
+      "gen_html_hash: %zu elements: more than %d slots;"
+      " increase HTML_ELEMENT_SLOTS\n",
+      HTML_BLOCK_ELEMENTS_LEN, HTML_ELEMENT_SLOTS
+    );
+    exit( EX_SOFTWARE );
+  }
+
+  html_bucket_t buckets[ HTML_ELEMENT_BUCKETS ];
+  for ( size_t i = 0; i < HTML_ELEMENT_BUCKETS; ++i )
+    buckets[i] = (html_bucket_t){ .bucket = i };
+
+  for ( size_t i = 0; i < HTML_BLOCK_ELEMENTS_LEN; ++i ) {
+    char const *const name = HTML_BLOCK_ELEMENTS[i].name;
+    if ( i > 0 && strcmp( HTML_BLOCK_ELEMENTS[i-1].name, name ) >= 0 ) {
+      fprintf( stderr,
+        "gen_html_hash: \"%s\": HTML_BLOCK_ELEMENTS not sorted\n", name
+      );
+      exit( EX_SOFTWARE );
+    }
+    size_t const len = strlen( name );
+    if ( len == 0 || len > HTML_ELEMENT_CHAR_MAX ) {
+      fprintf( stderr,
+        "gen_html_hash: \"%s\": length not 1-%d;"
+        " increase HTML_ELEMENT_CHAR_MAX\n",
+        name, HTML_ELEMENT_CHAR_MAX
+      );
+      exit( EX_SOFTWARE );
+    }
+    html_bucket_t *const b = &buckets[ html_element_bucket( name, len ) ];
+    if ( b->len == HTML_BUCKET_SIZE_MAX ) {
+      fprintf( stderr,
+        "gen_html_hash: bucket %zu: more than %d elements;"
+        " increase HTML_ELEMENT_BUCKETS\n",
+        b->bucket, HTML_BUCKET_SIZE_MAX
+      );
+      exit( EX_SOFTWARE );
+    }
+    b->element_index[ b->len++ ] = i;
+  } // for
+
+  uint8_t   seeds[ HTML_ELEMENT_BUCKETS ] = { 0 };
+  size_t    index[ HTML_ELEMENT_SLOTS ];
+  bool      used[ HTML_ELEMENT_SLOTS ] = { false };
+
+  qsort( buckets, HTML_ELEMENT_BUCKETS, sizeof( buckets[0] ),
+         &html_bucket_cmp );
+
+  for ( size_t i = 0; i < HTML_ELEMENT_BUCKETS && buckets[i].len > 0; ++i ) {
+    html_bucket_t const *const b = &buckets[i];
+    size_t slots[ HTML_BUCKET_SIZE_MAX ];
+    seeds[ b->bucket ] = find_seed( b, used, slots );
+    for ( size_t j = 0; j < b->len; ++j ) {
+      used[ slots[j] ] = true;
+      index[ slots[j] ] = b->element_index[j];
+    } // for
+  } // for
+
+  printf(
+    "/* DO NOT EDIT! GENERATED AUTOMATICALLY by gen_html_hash. */\n"
+    "\n"
+    "#include \"pjl_config.h\"\n"
+    "#include \"markdown.h\"\n"
+    "\n"
+    "uint8_t const HTML_ELEMENT_SEED[ HTML_ELEMENT_BUCKETS ] = {\n"
+  );
+  for ( size_t i = 0; i < HTML_ELEMENT_BUCKETS; ++i ) {
+    if ( i % 16 == 0 )
+      printf( "  " );
+    printf( "%u,%c", seeds[i], i % 16 == 15 ? '\n' : ' ' );
+  } // for
+  printf(
+    "};\n\nhtml_element_t const HTML_ELEMENT_TABLE[ HTML_ELEMENT_SLOTS ] = {\n"
+  );
+  for ( size_t i = 0; i < HTML_ELEMENT_SLOTS; ++i ) {
+    if ( !used[i] )
+      continue;
+    html_element_t const *const e = &HTML_BLOCK_ELEMENTS[ index[i] ];
+    printf(
+      "  [%3zu] = { \"%s\", %s },\n", i, e->name,
+      e->state == HTML_PRE ? "HTML_PRE" : "HTML_ELEMENT"
+    );
+  } // for
+  printf( "};\n" );
+
+  return fflush( stdout ) == 0 ? EX_OK : EX_IOERR;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,133 @@
+/*
+**      wrap -- text reformatter
+**      src/html_elements.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines the table of all HTML block-level elements and the functions for
+ * hashing their names.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+/// @cond DOXYGEN_IGNORE
+#define W_MARKDOWN_H_INLINE _GL_EXTERN_INLINE
+/// @endcond
+#include "markdown.h"
+#include "util.h"
+
+/**
+ * @addtogroup markdown-group
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Array of all block-level HTML 5 elements (including the pre-formatted
+ * elements).
+ *
+ * @note This must be sorted by name (in byte order) and no name may be longer
+ * than #HTML_ELEMENT_CHAR_MAX: `gen_html_hash` checks.
+ */
+html_element_t const HTML_BLOCK_ELEMENTS[] = {
+  { "article",    HTML_ELEMENT },
+  { "aside",      HTML_ELEMENT },
+  { "base",       HTML_ELEMENT },
+  { "basefont",   HTML_ELEMENT },
+  { "blockquote", HTML_ELEMENT },
+  { "body",       HTML_ELEMENT },
+  { "br",         HTML_ELEMENT },
+  { "button",     HTML_ELEMENT },
+  { "canvas",     HTML_ELEMENT },
+  { "caption",    HTML_ELEMENT },
+  { "center",     HTML_ELEMENT },
+  { "col",        HTML_ELEMENT },
+  { "colgroup",   HTML_ELEMENT },
+  { "dd",         HTML_ELEMENT },
+  { "details",    HTML_ELEMENT },
+  { "dialog",     HTML_ELEMENT },
+  { "dir",        HTML_ELEMENT },
+  { "div",        HTML_ELEMENT },
+  { "dl",         HTML_ELEMENT },
+  { "dt",         HTML_ELEMENT },
+  { "embed",      HTML_ELEMENT },
+  { "fieldset",   HTML_ELEMENT },
+  { "figcaption", HTML_ELEMENT },
+  { "figure",     HTML_ELEMENT },
+  { "footer",     HTML_ELEMENT },
+  { "form",       HTML_ELEMENT },
+  { "frame",      HTML_ELEMENT },
+  { "frameset",   HTML_ELEMENT },
+  { "h1",         HTML_ELEMENT },
+  { "h2",         HTML_ELEMENT },
+  { "h3",         HTML_ELEMENT },
+  { "h4",         HTML_ELEMENT },
+  { "h5",         HTML_ELEMENT },
+  { "h6",         HTML_ELEMENT },
+  { "head",       HTML_ELEMENT },
+  { "header",     HTML_ELEMENT },
+  { "hgroup",     HTML_ELEMENT },
+  { "hr",         HTML_ELEMENT },
+  { "html",       HTML_ELEMENT },
+  { "iframe",     HTML_ELEMENT },
+  { "legend",     HTML_ELEMENT },
+  { "li",         HTML_ELEMENT },
+  { "link",       HTML_ELEMENT },
+  { "main",       HTML_ELEMENT },
+  { "map",        HTML_ELEMENT },
+  { "menu",       HTML_ELEMENT },
+  { "menuitem",   HTML_ELEMENT },
+  { "meta",       HTML_ELEMENT },
+  { "nav",        HTML_ELEMENT },
+  { "noframes",   HTML_ELEMENT },
+  { "object",     HTML_ELEMENT },
+  { "ol",         HTML_ELEMENT },
+  { "optgroup",   HTML_ELEMENT },
+  { "option",     HTML_ELEMENT },
+  { "p",          HTML_ELEMENT },
+  { "param",      HTML_ELEMENT },
+  { "pre",        HTML_PRE     },
+  { "progress",   HTML_ELEMENT },
+  { "script",     HTML_PRE     },
+  { "section",    HTML_ELEMENT },
+  { "source",     HTML_ELEMENT },
+  { "style",      HTML_PRE     },
+  { "summary",    HTML_ELEMENT },
+  { "table",      HTML_ELEMENT },
+  { "tbody",      HTML_ELEMENT },
+  { "td",         HTML_ELEMENT },
+  { "textarea",   HTML_ELEMENT },
+  { "tfoot",      HTML_ELEMENT },
+  { "th",         HTML_ELEMENT },
+  { "thead",      HTML_ELEMENT },
+  { "title",      HTML_ELEMENT },
+  { "tr",         HTML_ELEMENT },
+  { "track",      HTML_ELEMENT },
+  { "ul",         HTML_ELEMENT },
+  { "video",      HTML_ELEMENT },
+};
+
+size_t const HTML_BLOCK_ELEMENTS_LEN = ARRAY_SIZE( HTML_BLOCK_ELEMENTS );
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+/* vim:set et sw=2 ts=2: */
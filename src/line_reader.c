@@ -0,0 +1,173 @@
+/*
+**      wrap -- text reformatter
+**      src/line_reader.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines functions to manipulate a buffered line reader.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "line_reader.h"
+#include "trace.h"
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdio.h>
+#include <string.h>                     /* for memchr(), ... */
+#include <sysexits.h>
+#include <unistd.h>                     /* for read() */
+
+/// @endcond
+
+/**
+ * @addtogroup line-reader-group
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Initial size of a line reader's buffer and the size of each read.
+#define LINE_READER_BUF_SIZE      (64 * 1024)
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Reads more bytes into a \ref line_reader's buffer, first moving any unread
+ * bytes to the start of it and growing it if it's full.
+ *
+ * @param lr The \ref line_reader to read into.
+ * @return Returns `false` only if EOF was reached.
+ */
+NODISCARD
+static bool line_reader_fill( line_reader_t *lr ) {
+  if ( lr->is_eof )
+    return false;
+
+  if ( lr->pos > 0 ) {
+    lr->buf_len -= lr->pos;
+    memmove( lr->buf, lr->buf + lr->pos, lr->buf_len );
+    lr->pos = 0;
+  }
+  if ( lr->buf_len == lr->buf_cap ) {
+    lr->buf_cap = lr->buf_cap == 0 ?
+      LINE_READER_BUF_SIZE : lr->buf_cap * 2;
+    REALLOC( lr->buf, char, lr->buf_cap );
+  }
+
+  for (;;) {
+    TRACE_BEGIN( prev_phase, TRACE_PHASE_READ );
+    ssize_t const n =
+      read( lr->fd, lr->buf + lr->buf_len, lr->buf_cap - lr->buf_len );
+    TRACE_END( prev_phase );
+    if ( n > 0 ) {
+      lr->buf_len += STATIC_CAST( size_t, n );
+      return true;
+    }
+    if ( n == 0 ) {
+      lr->is_eof = true;
+      return false;
+    }
+    PERROR_EXIT_IF( errno != EINTR, EX_IOERR );
+  } // for
+}
+
+////////// extern functions ///////////////////////////////////////////////////
+
+void line_reader_cleanup( line_reader_t *lr ) {
+  assert( lr != NULL );
+  free( lr->buf );
+  lr->buf = NULL;
+  lr->buf_cap = lr->buf_len = lr->pos = 0;
+}
+
+void line_reader_copy( line_reader_t *lr, FILE *fto ) {
+  assert( lr != NULL );
+  assert( fto != NULL );
+
+  char const *buf;
+  for ( size_t size; (buf = line_reader_read( lr, &size )) != NULL; )
+    PERROR_EXIT_IF( fwrite( buf, 1, size, fto ) < size, EX_IOERR );
+}
+
+char const* line_reader_getline( line_reader_t *lr, size_t max_size,
+                                 size_t *psize ) {
+  assert( lr != NULL );
+  assert( max_size > 0 );
+  assert( psize != NULL );
+
+  size_t size;
+  for ( size_t scanned = 0;; ) {
+    size_t const avail = lr->buf_len - lr->pos;
+    size_t const n = avail < max_size ? avail : max_size;
+    char const *const nl =
+      memchr( lr->buf + lr->pos + scanned, '\n', n - scanned );
+    if ( nl != NULL ) {
+      size = STATIC_CAST( size_t, nl - (lr->buf + lr->pos) ) + 1;
+      break;
+    }
+    if ( n == max_size ) {
+      size = max_size;
+      break;
+    }
+    if ( !line_reader_fill( lr ) ) {
+      if ( avail == 0 )
+        return NULL;
+      size = avail;                     // last line has no newline
+      break;
+    }
+    scanned = n;
+  } // for
+
+  char const *const line = lr->buf + lr->pos;
+  lr->pos += size;
+  *psize = size;
+  return line;
+}
+
+void line_reader_init( line_reader_t *lr, int fd ) {
+  assert( lr != NULL );
+  MEM_ZERO( lr );
+  lr->fd = fd;
+}
+
+char const* line_reader_read( line_reader_t *lr, size_t *psize ) {
+  assert( lr != NULL );
+  assert( psize != NULL );
+
+  if ( lr->pos == lr->buf_len && !line_reader_fill( lr ) )
+    return NULL;
+  char const *const buf = lr->buf + lr->pos;
+  *psize = lr->buf_len - lr->pos;
+  lr->pos = lr->buf_len;
+  return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+/* vim:set et sw=2 ts=2: */
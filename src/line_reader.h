@@ -0,0 +1,128 @@
+/*
+**      wrap -- text reformatter
+**      src/line_reader.h
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef wrap_line_reader_H
+#define wrap_line_reader_H
+
+/**
+ * @file
+ * Declares a type for a buffered line reader over a file descriptor and
+ * functions to manipulate it.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdio.h>                      /* for FILE */
+
+/// @endcond
+
+/**
+ * @defgroup line-reader-group Line Reader
+ * A buffered line reader over a file descriptor.  It reads in large blocks
+ * and finds newlines with memchr() so getting a line doesn't involve a
+ * function call per character as reading via `getc()` does.
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A buffered line reader over a file descriptor.
+ */
+struct line_reader {
+  int       fd;                         ///< File descriptor to read from.
+  char     *buf;                        ///< Buffer of bytes read.
+  size_t    buf_cap;                    ///< Capacity of \ref buf.
+  size_t    buf_len;                    ///< Number of bytes in \ref buf.
+  size_t    pos;                        ///< Position of first unread byte.
+  bool      is_eof;                     ///< Has EOF been reached?
+};
+typedef struct line_reader line_reader_t;
+
+////////// extern functions ///////////////////////////////////////////////////
+
+/**
+ * Frees all memory used by a \ref line_reader.
+ *
+ * @param lr The \ref line_reader to clean up.  The file descriptor is not
+ * closed.
+ *
+ * @sa line_reader_init()
+ */
+void line_reader_cleanup( line_reader_t *lr );
+
+/**
+ * Copies all the remaining bytes of a \ref line_reader to \a fto.
+ *
+ * @param lr The \ref line_reader to copy from.
+ * @param fto The `FILE` to copy to.
+ */
+void line_reader_copy( line_reader_t *lr, FILE *fto );
+
+/**
+ * Gets the next newline-terminated line.
+ *
+ * @param lr The \ref line_reader to get the line from.
+ * @param max_size The maximum number of bytes to get: lines that are longer
+ * are returned in parts.
+ * @param psize A pointer to receive the number of bytes comprising the line
+ * including the newline, if any.
+ * @return Returns a pointer to the start of the line or NULL on EOF.  The line
+ * is _not_ null-terminated and remains valid only until the next call to any
+ * \ref line_reader function.
+ */
+NODISCARD
+char const* line_reader_getline( line_reader_t *lr, size_t max_size,
+                                 size_t *psize );
+
+/**
+ * Initializes a \ref line_reader.
+ *
+ * @param lr The \ref line_reader to initialize.
+ * @param fd The file descriptor to read from.
+ *
+ * @sa line_reader_cleanup()
+ */
+void line_reader_init( line_reader_t *lr, int fd );
+
+/**
+ * Gets all the bytes read but not yet gotten, reading more first if there are
+ * none.
+ *
+ * @param lr The \ref line_reader to get the bytes from.
+ * @param psize A pointer to receive the number of bytes.
+ * @return Returns a pointer to the bytes or NULL on EOF.  The bytes remain
+ * valid only until the next call to any \ref line_reader function.
+ */
+NODISCARD
+char const* line_reader_read( line_reader_t *lr, size_t *psize );
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+#endif /* wrap_line_reader_H */
+/* vim:set et sw=2 ts=2: */
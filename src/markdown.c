@@ -37,6 +37,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint8_t */
 #include <stdlib.h>
 #include <string.h>
 
@@ -55,8 +56,8 @@
  *
  * @param TOKEN The token to push and return.
  */
-#define CLEAR_RETURN(TOKEN) \
-  BLOCK( md_stack_clear(); md_stack_push( (TOKEN), 0, 0 ); return &MD_TOP; )
+#define CLEAR_RETURN(TOKEN) BLOCK( \
+  md_stack_clear( md ); md_stack_push( md, (TOKEN), 0, 0 ); return &MD_TOP; )
 
 /**
  * Gets an lvalue reference to the Nth Markdown state down from the top of the
@@ -66,9 +67,9 @@
  * @return Returns an lvalue reference to the Nth Markdown state.
  *
  * @note This is a macro instead of an inline function so it'll be an lvalue
- * reference.
+ * reference.  It assumes a \ref md_parser pointer named `md` is in scope.
  */
-#define MD_STACK(N)               (md_stack[ md_stack_top - (N) ])
+#define MD_STACK(N)               (md->stack[ md->stack_top - (N) ])
 
 /**
  * Gets an lvalue reference to the top Markdown state on the stack.
@@ -82,13 +83,14 @@
 
 /**
  * Declares \a NAME as a local, `const` `bool` variable, initializes it with a
- * variable named `prev_`<i>NAME</i>, and sets `prev_`<i>NAME</i> to `false`.
+ * \ref md_parser member named `prev_`<i>NAME</i>, and sets
+ * `prev_`<i>NAME</i> to `false`.
  *
  * @param NAME The name of the local variable.
  */
-#define PREV_BOOL(NAME)           \
-  bool const NAME = prev_##NAME;  \
-  prev_##NAME = false
+#define PREV_BOOL(NAME)               \
+  bool const NAME = md->prev_##NAME;  \
+  md->prev_##NAME = false
 
 /**
  * Compares \a S to \a STRLIT for equality.
@@ -100,55 +102,8 @@
 #define STRN_EQ_LIT(S,STRLIT) \
   (strncmp( (S), (STRLIT ""), sizeof( STRLIT "" ) - 1 ) == 0)
 
-/**
- * HTML markup types.
- *
- * @remarks Every type that is not #HTML_NONE nor #HTML_ELEMENT is a "special"
- * type in that it (a) has a unique terminator and (b) does not nest.
- */
-enum html_state {
-  /// No state.
-  HTML_NONE,
-
-  /// <tt>&lt;![CDATA[</tt>...<tt>]]&gt;</tt>
-  HTML_CDATA,
-
-  /// <tt>&lt;!-\-</tt> ... <tt>-\-&gt;</tt>
-  HTML_COMMENT,
-
-  /// <tt>&lt;!DOCTYPE</tt> ...<tt>&gt;</tt>
-  HTML_DOCTYPE,
-
-  /// <tt>&lt;</tt> _tag_ <tt>&gt;</tt> ... <tt>&lt;/</tt> _tag_ <tt>&gt;</tt>
-  HTML_ELEMENT,
-
-  /// <tt>&lt;?</tt> ... <tt>?&gt;</tt>
-  HTML_PI,
-
-  /// <tt>&lt;pre&gt;</tt>, <tt>&lt;script&gt;</tt>, or <tt>&lt;style&gt;</tt>
-  HTML_PRE,
-
-  /// Ending HTML block.
-  HTML_END
-};
-typedef enum html_state html_state_t;
-
-/**
- * PHP Markdown Extra code fence info.
- */
-struct md_code_fence {
-  char    cf_c;                 ///< Character of the fence: `~` or <tt>`</tt>.
-  size_t  cf_len;               ///< Length of the fence.
-};
-typedef struct md_code_fence md_code_fence_t;
-
-typedef ssize_t md_stack_pos_t;         ///< Markdown stack position type.
-
 // local constant definitions
 
-/// HTML element name maximum length.
-#define HTML_ELEMENT_CHAR_MAX    10
-
 /// Maximum number of `#` in an atx header.
 #define MD_ATX_CHAR_MAX           6
 
@@ -180,47 +135,7 @@ typedef ssize_t md_stack_pos_t;         ///< Markdown stack position type.
 #define MD_OL_INDENT_MIN          3
 
 /// Number of md_state objects to allocate by default.
-#define MD_STATE_ALLOC_DEFAULT    5
-
-/// Number of md_state objects to increment by.
-#define MD_STATE_ALLOC_INCREMENT  5
-
-/**
- * Block-level HTML 5 elements.
- */
-static char const *const HTML_BLOCK_ELEMENT[] = {
-  "article", "aside",
-  "base", "basefont", "blockquote", "body", "br", "button",
-  "canvas", "caption", "center", "col", "colgroup",
-  "dd", "details", "dialog", "dir", "div", "dl", "dt",
-  "embed",
-  "fieldset", "figcaption", "figure", "footer", "form", "frame", "frameset",
-  "h1", "h2", "h3", "h4", "h5", "h6", "head", "header", "hgroup", "hr", "html",
-  "iframe",
-  "legend", "li", "link",
-  "main", "map", "menu", "menuitem", "meta",
-  "nav", "noframes",
-  "object", "ol", "optgroup", "option",
-  "p", "param", "progress",
-  "section", "source", "summary",
-  "table", "tbody", "td", "textarea", "tfoot", "th", "thead", "title", "tr",
-  "track",
-  "ul",
-  "video"
-};
-
-// local variable definitions
-static html_state_t   curr_html_state;  ///< Current HTML state.
-static md_state_t    *md_stack;         ///< Global stack of Markdown states.
-static md_stack_pos_t md_stack_top;     ///< Top of \ref md_stack.
-static md_seq_t       next_seq_num;     ///< Next sequence number.
-static bool           prev_blank_line;  ///< Previous blank line.
-
-/// Previous value for `code_fence_end` in markdown_parse().
-static bool           prev_code_fence_end;
-
-/// Previous value for `link_lable_has_title` in markdown_parse().
-static bool           prev_link_label_has_title;
+#define MD_STATE_ALLOC_DEFAULT    8
 
 // local functions
 NODISCARD
@@ -231,7 +146,7 @@ NODISCARD
 static html_state_t   md_is_html_tag( char const*, bool* );
 
 NODISCARD
-static md_line_t      md_nested_within( void );
+static md_line_t      md_nested_within( md_parser_t const* );
 
 NODISCARD
 static unsigned       md_ol_digits( md_ol_t );
@@ -239,42 +154,8 @@ static unsigned       md_ol_digits( md_ol_t );
 NODISCARD
 static char const*    skip_html_tag( char const*, bool* );
 
-NODISCARD
-static int            str_ptr_cmp( char const**, char const** );
-
 ////////// inline functions ///////////////////////////////////////////////////
 
-/**
- * Checks whether \a s is an HTML block-level element.
- *
- * @param s The null-terminated string to check. It is assumed to have been
- * converted to lower-case.
- * @return Returns `true` only if \a s is an HTML block-level element.
- */
-NODISCARD
-static inline bool is_html_block_element( char const *s ) {
-  return NULL != bsearch(
-    &s, HTML_BLOCK_ELEMENT, ARRAY_SIZE( HTML_BLOCK_ELEMENT ),
-    sizeof( HTML_BLOCK_ELEMENT[0] ),
-    POINTER_CAST( bsearch_cmp_fn_t, &str_ptr_cmp )
-  );
-}
-
-/**
- * Checks whether \a s is an HTML pre-formatted block-level element.
- *
- * @param s The null-terminated string to check. It is assumed to have been
- * converted to lower-case.
- * @return Returns `true` only if \a s is an HTML pre-formatted block-level
- * element.
- */
-NODISCARD
-static inline bool is_html_pre_element( char const *s ) {
-  return  strcmp( s, "pre"    ) == 0 ||
-          strcmp( s, "script" ) == 0 ||
-          strcmp( s, "style"  ) == 0;
-}
-
 /**
  * Checks whether \a c is an HTML element character.
  *
@@ -333,51 +214,57 @@ static inline bool md_is_ol_sep_char( char c ) {
 
 /**
  * Clears the Markdown stack down to the initial element.
+ *
+ * @param md The \ref md_parser to use.
  */
-static inline void md_stack_clear( void ) {
-  md_stack_top = 0;
+static inline void md_stack_clear( md_parser_t *md ) {
+  md->stack_top = 0;
 }
 
 /**
  * Checks whether the Markdown state stack is empty.
  *
+ * @param md The \ref md_parser to use.
  * @return Returns `true` only if it is.
  */
 NODISCARD
-static inline bool md_stack_empty( void ) {
-  return md_stack_top < 0;
+static inline bool md_stack_empty( md_parser_t const *md ) {
+  return md->stack_top < 0;
 }
 
 /**
  * Gets the size of the Markdown state stack.
  *
+ * @param md The \ref md_parser to use.
  * @return Returns said size.
  */
 NODISCARD
-static inline size_t md_stack_size( void ) {
-  return STATIC_CAST( size_t, md_stack_top + 1 );
+static inline size_t md_stack_size( md_parser_t const *md ) {
+  return STATIC_CAST( size_t, md->stack_top + 1 );
 }
 
 /**
  * Checks whether the line type that's part of the Markdown state on the top of
  * the stack is a particular type.
  *
+ * @param md The \ref md_parser to use.
  * @param line_type The line type to check for.
  * @return Returns `true` only if it is.
  */
 NODISCARD
-static inline bool md_top_is( md_line_t line_type ) {
+static inline bool md_top_is( md_parser_t const *md, md_line_t line_type ) {
   return MD_TOP.line_type == line_type;
 }
 
 /**
  * Calculates the minimum indent needed to be considered a line of code.
  *
+ * @param md The \ref md_parser to use.
  * @return Returns said indent.
  */
 NODISCARD
-static inline md_indent_t md_code_indent_min( void ) {
-  return (md_stack_size() - md_top_is( MD_CODE )) * MD_CODE_INDENT_MIN;
+static inline md_indent_t md_code_indent_min( md_parser_t const *md ) {
+  return (md_stack_size( md ) - md_top_is( md, MD_CODE )) * MD_CODE_INDENT_MIN;
 }
 
 ////////// local functions ////////////////////////////////////////////////////
@@ -439,13 +326,6 @@ static char const* is_uri_scheme( char const *s ) {
   return NULL;
 }
 
-/**
- * Cleans-up all Markdown data.
- */
-static void markdown_cleanup( void ) {
-  FREE( md_stack );
-}
-
 /**
  * Given an indent, gets its preferred divisor.
  *
@@ -456,12 +336,14 @@ static void markdown_cleanup( void ) {
  * As a special case, we also allow 2 spaces per indent for definition and
  * unordered lists.
  *
+ * @param md The \ref md_parser to use.
  * @param indent_left The raw indent (in spaces).
  * @return Returns the preferred divisor.
  */
 NODISCARD
-static md_indent_t md_indent_divisor( md_indent_t indent_left ) {
-  md_line_t const line_type = md_nested_within();
+static md_indent_t md_indent_divisor( md_parser_t const *md,
+                                      md_indent_t indent_left ) {
+  md_line_t const line_type = md_nested_within( md );
   bool const dl_or_ul = line_type == MD_DL || line_type == MD_UL;
   md_indent_t const mod_a =            indent_left % MD_LIST_INDENT_MAX     ;
   md_indent_t const mod_b =            indent_left % MD_OL_INDENT_MIN       ;
@@ -771,8 +653,9 @@ static html_state_t md_is_html_tag( char const *s, bool *is_end_tag ) {
     ++s;
 
   char element[ HTML_ELEMENT_CHAR_MAX + 1/*null*/ ];
+  size_t len = 0;
 
-  for ( size_t len = 0; ; ) {
+  for (;;) {
     if ( len == sizeof element - 1 )    // element too long
       return HTML_NONE;
     if ( !is_html_element_char( *s ) ) {
@@ -789,18 +672,20 @@ static html_state_t md_is_html_tag( char const *s, bool *is_end_tag ) {
     element[ len++ ] = STATIC_CAST( char, tolower( *s++ ) );
   } // for
 
-  if ( is_html_pre_element( element ) ) {
-    if ( !*is_end_tag ) {
-      //
-      // Does the HTML block end on the same line as it starts?
-      //
-      *is_end_tag = md_is_html_end( HTML_PRE, s );
-    }
-    return HTML_PRE;
-  }
-
-  if ( is_html_block_element( element ) )
-    return HTML_ELEMENT;
+  switch ( markdown_html_element( element, len ) ) {
+    case HTML_ELEMENT:
+      return HTML_ELEMENT;
+    case HTML_PRE:
+      if ( !*is_end_tag ) {
+        //
+        // Does the HTML block end on the same line as it starts?
+        //
+        *is_end_tag = md_is_html_end( HTML_PRE, s );
+      }
+      return HTML_PRE;
+    default:
+      break;
+  } // switch
 
   //
   // In order for inline HTML to be considered an HTML block, it has to be on
@@ -980,11 +865,12 @@ static bool md_is_Setext_header( char const *s ) {
 /**
  * Checks the innermost enclosing nestable line type, if any.
  *
+ * @param md The \ref md_parser to use.
  * @return Returns said line type or MD_NONE if none.
  */
 NODISCARD
-static md_line_t md_nested_within( void ) {
-  for ( md_stack_pos_t pos = md_stack_top; pos >= 0; --pos ) {
+static md_line_t md_nested_within( md_parser_t const *md ) {
+  for ( md_stack_pos_t pos = md->stack_top; pos >= 0; --pos ) {
     md_line_t const line_type = MD_STACK(pos).line_type;
     if ( md_is_nestable( line_type ) )
       return line_type;
@@ -1088,44 +974,48 @@ static char const* skip_html_tag( char const *s, bool *is_end_tag ) {
 
 /**
  * Pops a Markdown state from the stack.
+ *
+ * @param md The \ref md_parser to use.
  */
-static void md_stack_pop( void ) {
+static void md_stack_pop( md_parser_t *md ) {
   MD_DEBUG( "%s()\n", __func__ );
-  assert( !md_stack_empty() );
-  --md_stack_top;
+  assert( !md_stack_empty( md ) );
+  --md->stack_top;
 }
 
 /**
  * Pushes a new Markdown state onto the stack.
  *
+ * @param md The \ref md_parser to use.
  * @param line_type The type of line.
  * @param indent_left The left indent (in spaces).
  * @param indent_hang The indent relative to \a indent_left for a hang-indent.
  */
-static void md_stack_push( md_line_t line_type, md_indent_t indent_left,
-                           md_indent_t indent_hang ) {
-  static size_t md_stack_capacity = 0;
-
+static void md_stack_push( md_parser_t *md, md_line_t line_type,
+                           md_indent_t indent_left, md_indent_t indent_hang ) {
   MD_DEBUG(
     "%s(): T=%c L=%u H=%u\n",
     __func__, line_type, indent_left, indent_hang
   );
 
-  ++md_stack_top;
-  if ( md_stack_capacity == 0 ) {
-    md_stack_capacity = MD_STATE_ALLOC_DEFAULT;
-    md_stack = MALLOC( md_state_t, md_stack_capacity );
-  } else if ( STATIC_CAST( size_t, md_stack_top ) >= md_stack_capacity ) {
-    md_stack_capacity += MD_STATE_ALLOC_INCREMENT;
-    REALLOC( md_stack, md_state_t, md_stack_capacity );
+  ++md->stack_top;
+  if ( unlikely( md_stack_size( md ) > md->stack_capacity ) ) {
+    //
+    // Grow geometrically so a deeply nested document needs only a few
+    // reallocations.  The stack never shrinks: markdown_init() and
+    // markdown_restart() just reset stack_top.
+    //
+    md->stack_capacity = md->stack_capacity == 0 ?
+      MD_STATE_ALLOC_DEFAULT : md->stack_capacity * 2;
+    REALLOC( md->stack, md_state_t, md->stack_capacity );
+    PERROR_EXIT_IF( md->stack == NULL, EX_OSERR );
   }
-  PERROR_EXIT_IF( md_stack == NULL, EX_OSERR );
 
   md_state_t *const top = &MD_TOP;
   *top = (md_state_t){
     .line_type   = line_type,
-    .seq_num     = ++next_seq_num,
-    .depth       = md_stack_size() > 0 ? md_stack_size() - 1 : 0,
+    .seq_num     = ++md->next_seq_num,
+    .depth       = md_stack_size( md ) > 0 ? md_stack_size( md ) - 1 : 0,
     .indent_left = indent_left,
     .indent_hang = indent_hang,
     .ol_c        = '\0',
@@ -1133,44 +1023,48 @@ static void md_stack_push( md_line_t line_type, md_indent_t indent_left,
   };
 }
 
-/**
- * Compares two string pointers by comparing the string pointed to.
- *
- * @param i_sptr The first string pointer to compare.
- * @param j_sptr The first string pointer to compare.
- * @return Returns a number less than 0, 0, or greater than 0 if \a *i_sptr is
- * less than, equal to, or greater than \a *j_sptr, respectively.
- */
-NODISCARD
-static int str_ptr_cmp( char const **i_sptr, char const **j_sptr ) {
-  return strcmp( *i_sptr, *j_sptr );
+////////// extern functions ///////////////////////////////////////////////////
+
+void markdown_cleanup( md_parser_t *md ) {
+  assert( md != NULL );
+  FREE( md->stack );
+  MEM_ZERO( md );
 }
 
-////////// extern functions ///////////////////////////////////////////////////
+html_state_t markdown_html_element( char const *element, size_t len ) {
+  assert( element != NULL );
+  if ( len == 0 )
+    return HTML_NONE;
+  uint8_t const seed = HTML_ELEMENT_SEED[ html_element_bucket( element, len ) ];
+  html_element_t const *const e =
+    &HTML_ELEMENT_TABLE[ html_element_slot( element, len, seed ) ];
+  return e->name != NULL && strcmp( e->name, element ) == 0 ?
+    e->state : HTML_NONE;
+}
 
-void markdown_init( void ) {
-  RUN_ONCE ATEXIT( &markdown_cleanup );
+void markdown_init( md_parser_t *md ) {
+  assert( md != NULL );
 
-  curr_html_state = HTML_NONE;
-  prev_code_fence_end = false;
-  prev_link_label_has_title = false;
+  md->curr_html_state = HTML_NONE;
+  md->prev_code_fence_end = false;
+  md->prev_link_label_has_title = false;
   //
   // We have to start out prev_blank_line = true because if a "---" occurs as
   // the first line, there is no text line before it so it must be a horizontal
   // rule and not a Setext 2nd-level header.
   //
-  prev_blank_line = true;
+  md->prev_blank_line = true;
   //
   // Initialize the stack so that it always contains at least one element.
   //
-  md_stack_top = -1;
-  md_stack_push( MD_TEXT, 0, 0 );
+  md->stack_top = -1;
+  md_stack_push( md, MD_TEXT, 0, 0 );
 }
 
-md_state_t const* markdown_parse( char *s ) {
+md_state_t const* markdown_parse( md_parser_t *md, char *s ) {
+  assert( md != NULL );
   assert( s != NULL );
 
-  static md_code_fence_t code_fence;
   md_indent_t indent_left;
   char *const nws = first_non_whitespace( s, &indent_left );
 
@@ -1186,14 +1080,14 @@ md_state_t const* markdown_parse( char *s ) {
       // fence.
       //
       if ( code_fence_end )
-        md_stack_pop();
-      else if ( code_fence.cf_c != '\0' ) {
+        md_stack_pop( md );
+      else if ( md->code_fence.cf_c != '\0' ) {
         //
         // If code_fence.cf_c is set, that distinguishes a code fence from
         // indented code.
         //
-        if ( md_is_code_fence_end( nws, &code_fence ) )
-          prev_code_fence_end = true;
+        if ( md_is_code_fence_end( nws, &md->code_fence ) )
+          md->prev_code_fence_end = true;
         //
         // As long as we're in the MD_CODE state, we can just return without
         // further checks.
@@ -1210,7 +1104,7 @@ md_state_t const* markdown_parse( char *s ) {
       // These tokens are "one-shot," i.e., they never span multipe lines, so
       // pop them off the stack.
       //
-      md_stack_pop();
+      md_stack_pop( md );
       break;
 
     case MD_LINK_LABEL:
@@ -1219,7 +1113,7 @@ md_state_t const* markdown_parse( char *s ) {
       //
       if ( !link_label_has_title && md_is_link_title( nws ) )
         return &MD_TOP;
-      md_stack_pop();
+      md_stack_pop( md );
       break;
 
     case MD_TABLE:
@@ -1233,7 +1127,7 @@ md_state_t const* markdown_parse( char *s ) {
         //
         return &MD_TOP;
       }
-      md_stack_pop();
+      md_stack_pop( md );
       break;
 
     case MD_DL:
@@ -1260,27 +1154,27 @@ md_state_t const* markdown_parse( char *s ) {
   //
   PREV_BOOL( blank_line );
   if ( nws[0] == '\0' ) {               // blank line
-    prev_blank_line = true;
+    md->prev_blank_line = true;
     return &MD_TOP;
   }
 
   /////////////////////////////////////////////////////////////////////////////
 
-  if ( md_top_is( MD_HTML_BLOCK ) ) {
+  if ( md_top_is( md, MD_HTML_BLOCK ) ) {
     //
     // HTML blocks.
     //
-    switch ( curr_html_state ) {
+    switch ( md->curr_html_state ) {
       case HTML_ELEMENT:
         if ( blank_line )
-          md_stack_pop();
+          md_stack_pop( md );
         return &MD_TOP;
       case HTML_END:
-        md_stack_pop();
+        md_stack_pop( md );
         break;
       default:
-        if ( md_is_html_end( curr_html_state, s ) )
-          curr_html_state = HTML_END;
+        if ( md_is_html_end( md->curr_html_state, s ) )
+          md->curr_html_state = HTML_END;
         //
         // As long as we're in the MD_HTML_BLOCK state, we can just return
         // without further checks.
@@ -1292,10 +1186,10 @@ md_state_t const* markdown_parse( char *s ) {
     //
     // Markdown code blocks.
     //
-    md_indent_t const code_indent_min = md_code_indent_min();
+    md_indent_t const code_indent_min = md_code_indent_min( md );
     if ( indent_left >= code_indent_min ) {
-      if ( !md_top_is( MD_CODE ) )
-        md_stack_push( MD_CODE, code_indent_min, 0 );
+      if ( !md_top_is( md, MD_CODE ) )
+        md_stack_push( md, MD_CODE, code_indent_min, 0 );
       //
       // As long as we're in the MD_CODE state, we can just return without
       // further checks.
@@ -1332,12 +1226,12 @@ md_state_t const* markdown_parse( char *s ) {
       if ( indent_left <= MD_LINK_INDENT_MAX ) {
         bool def_has_text;
         if ( md_is_footnote_def( nws, &def_has_text ) ) {
-          md_stack_clear();
-          md_stack_push( MD_FOOTNOTE_DEF, 0, MD_FOOTNOTE_INDENT );
+          md_stack_clear( md );
+          md_stack_push( md, MD_FOOTNOTE_DEF, 0, MD_FOOTNOTE_INDENT );
           MD_TOP.footnote_def_has_text = def_has_text;
           return &MD_TOP;
         }
-        if ( md_is_link_label( nws, &prev_link_label_has_title ) )
+        if ( md_is_link_label( nws, &md->prev_link_label_has_title ) )
           CLEAR_RETURN( MD_LINK_LABEL );
       }
       break;
@@ -1345,8 +1239,8 @@ md_state_t const* markdown_parse( char *s ) {
     // PHP Markdown Extra code fences.
     case '`':
     case '~':
-      md_code_fence_init( &code_fence );
-      if ( md_is_code_fence( nws, &code_fence ) )
+      md_code_fence_init( &md->code_fence );
+      if ( md_is_code_fence( nws, &md->code_fence ) )
         CLEAR_RETURN( MD_CODE );
       break;
 
@@ -1354,11 +1248,11 @@ md_state_t const* markdown_parse( char *s ) {
     case '<':
       NO_OP;
       bool is_end_tag;
-      curr_html_state = md_is_html_tag( nws, &is_end_tag );
-      if ( curr_html_state != HTML_NONE ) {
+      md->curr_html_state = md_is_html_tag( nws, &is_end_tag );
+      if ( md->curr_html_state != HTML_NONE ) {
         if ( is_end_tag )               // HTML ends on same line as it begins
-          curr_html_state = HTML_END;
-        md_stack_push( MD_HTML_BLOCK, indent_left, 0 );
+          md->curr_html_state = HTML_END;
+        md_stack_push( md, MD_HTML_BLOCK, indent_left, 0 );
         return &MD_TOP;
       }
       break;
@@ -1426,7 +1320,7 @@ md_state_t const* markdown_parse( char *s ) {
   // Based on the indent, previous, and current line types, calculate the depth
   // of the current line.
   //
-  md_depth_t depth = indent_left / md_indent_divisor( indent_left );
+  md_depth_t depth = indent_left / md_indent_divisor( md, indent_left );
   if ( (!blank_line && md_is_nestable( MD_TOP.line_type )) ||
        md_is_nestable( curr_line_type ) ) {
     ++depth;
@@ -1438,21 +1332,21 @@ md_state_t const* markdown_parse( char *s ) {
   MD_DEBUG( "pop stack? D=%u MD_TOP.D=%u\n", depth, MD_TOP.depth );
   while ( depth < MD_TOP.depth ) {
     MD_DEBUG( "+ D=%u < MD_TOP.D=%u => ", depth, MD_TOP.depth );
-    md_stack_pop();
+    md_stack_pop( md );
   } // while
 
   md_indent_t const nested_indent_min = MD_TOP.depth * MD_LIST_INDENT_MAX;
   bool const is_nested = indent_left >= nested_indent_min;
   bool const is_same_type_not_nested =
-    md_top_is( curr_line_type ) && !is_nested;
+    md_top_is( md, curr_line_type ) && !is_nested;
 
   switch ( curr_line_type ) {
 
     case MD_NONE:
       if ( blank_line && md_is_table( s ) ) {
-        assert( !md_top_is( MD_TABLE ) );
+        assert( !md_top_is( md, MD_TABLE ) );
         if ( is_nested )
-          md_stack_push( MD_TABLE, indent_left, 0 );
+          md_stack_push( md, MD_TABLE, indent_left, 0 );
       }
       break;
 
@@ -1460,7 +1354,7 @@ md_state_t const* markdown_parse( char *s ) {
       NO_OP;
       bool const ol_same_char = MD_TOP.ol_c == ol_c;
       if ( is_same_type_not_nested && ol_same_char ) {
-        MD_TOP.seq_num = ++next_seq_num;  // reuse current state
+        MD_TOP.seq_num = ++md->next_seq_num;  // reuse current state
         md_ol_t const next_ol_num = ++MD_TOP.ol_num;
         if ( next_ol_num ==        10 ||
              next_ol_num ==       100 ||
@@ -1484,9 +1378,9 @@ md_state_t const* markdown_parse( char *s ) {
           // Just get rid of the current list (effectively replacing it with
           // the new list).
           //
-          md_stack_pop();
+          md_stack_pop( md );
         }
-        md_stack_push( MD_OL, indent_left, indent_hang );
+        md_stack_push( md, MD_OL, indent_left, indent_hang );
         MD_TOP.ol_c   = ol_c;
         MD_TOP.ol_num = ol_num;
       }
@@ -1495,9 +1389,9 @@ md_state_t const* markdown_parse( char *s ) {
     case MD_DL:
     case MD_UL:
       if ( is_same_type_not_nested )
-        MD_TOP.seq_num = ++next_seq_num;  // reuse current state
+        MD_TOP.seq_num = ++md->next_seq_num;  // reuse current state
       else
-        md_stack_push( curr_line_type, indent_left, indent_hang );
+        md_stack_push( md, curr_line_type, indent_left, indent_hang );
       break;
 
     default:
@@ -1507,6 +1401,13 @@ md_state_t const* markdown_parse( char *s ) {
   return &MD_TOP;
 }
 
+void markdown_restart( md_parser_t *md ) {
+  assert( md != NULL );
+  md->code_fence = (md_code_fence_t){ 0 };
+  md->next_seq_num = MD_SEQ_NUM_INIT - 1;
+  markdown_init( md );
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /** @} */
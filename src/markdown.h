@@ -35,9 +35,16 @@
 // standard
 #include <stdbool.h>
 #include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint*_t */
+#include <sys/types.h>                  /* for ssize_t */
 
 /// @endcond
 
+_GL_INLINE_HEADER_BEGIN
+#ifndef W_MARKDOWN_H_INLINE
+# define W_MARKDOWN_H_INLINE _GL_INLINE
+#endif /* W_MARKDOWN_H_INLINE */
+
 /**
  * @defgroup markdown-group Markdown Support
  * Macros, types, data structures, and functions for reformatting Markdown.
@@ -46,6 +53,15 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// Number of buckets for html_element_bucket(); must be a power of 2.
+#define HTML_ELEMENT_BUCKETS      32
+
+/// HTML element name maximum length.
+#define HTML_ELEMENT_CHAR_MAX     10
+
+/// Number of slots in \ref HTML_ELEMENT_TABLE; must be a power of 2.
+#define HTML_ELEMENT_SLOTS        128
+
 #define MD_SEQ_NUM_INIT           1u    /**< First Markdown state seq number. */
 #define MD_TAB_SPACES             4u    /**< Number of spaces a tab equals. */
 
@@ -136,12 +152,184 @@ struct md_state {
 };
 typedef struct md_state md_state_t;
 
+/**
+ * HTML markup types.
+ *
+ * @remarks Every type that is not #HTML_NONE nor #HTML_ELEMENT is a "special"
+ * type in that it (a) has a unique terminator and (b) does not nest.
+ */
+enum html_state {
+  /// No state.
+  HTML_NONE,
+
+  /// <tt>&lt;![CDATA[</tt>...<tt>]]&gt;</tt>
+  HTML_CDATA,
+
+  /// <tt>&lt;!-\-</tt> ... <tt>-\-&gt;</tt>
+  HTML_COMMENT,
+
+  /// <tt>&lt;!DOCTYPE</tt> ...<tt>&gt;</tt>
+  HTML_DOCTYPE,
+
+  /// <tt>&lt;</tt> _tag_ <tt>&gt;</tt> ... <tt>&lt;/</tt> _tag_ <tt>&gt;</tt>
+  HTML_ELEMENT,
+
+  /// <tt>&lt;?</tt> ... <tt>?&gt;</tt>
+  HTML_PI,
+
+  /// <tt>&lt;pre&gt;</tt>, <tt>&lt;script&gt;</tt>, or <tt>&lt;style&gt;</tt>
+  HTML_PRE,
+
+  /// Ending HTML block.
+  HTML_END
+};
+typedef enum html_state html_state_t;
+
+/**
+ * An HTML block-level element.
+ */
+struct html_element {
+  char const   *name;                   ///< Element name.
+  html_state_t  state;                  ///< #HTML_ELEMENT or #HTML_PRE.
+};
+typedef struct html_element html_element_t;
+
+/**
+ * PHP Markdown Extra code fence info.
+ */
+struct md_code_fence {
+  char    cf_c;                 ///< Character of the fence: `~` or <tt>`</tt>.
+  size_t  cf_len;               ///< Length of the fence.
+};
+typedef struct md_code_fence md_code_fence_t;
+
+typedef ssize_t md_stack_pos_t;         ///< Markdown stack position type.
+
+/**
+ * Markdown parser.
+ *
+ * @remarks All state the parser carries from one line to the next is kept
+ * here rather than in file-scope variables so that any number of documents
+ * may be parsed concurrently.  A parser must be zero-initialized before its
+ * first call to markdown_init().
+ */
+struct md_parser {
+  md_state_t       *stack;              ///< Stack of Markdown states.
+  size_t            stack_capacity;     ///< Allocated size of \ref stack.
+  md_stack_pos_t    stack_top;          ///< Top of \ref stack.
+  md_code_fence_t   code_fence;         ///< Current code fence, if any.
+  html_state_t      curr_html_state;    ///< Current HTML state.
+  md_seq_t          next_seq_num;       ///< Next sequence number.
+  bool              prev_blank_line;    ///< Previous blank line.
+
+  /// Previous value for `code_fence_end` in markdown_parse().
+  bool              prev_code_fence_end;
+
+  /// Previous value for `link_label_has_title` in markdown_parse().
+  bool              prev_link_label_has_title;
+};
+typedef struct md_parser md_parser_t;
+
+// extern variables
+
+/**
+ * Block-level HTML 5 elements (including the pre-formatted elements) sorted
+ * by name.
+ */
+extern html_element_t const HTML_BLOCK_ELEMENTS[];
+
+/**
+ * Number of elements in \ref HTML_BLOCK_ELEMENTS.
+ */
+extern size_t const         HTML_BLOCK_ELEMENTS_LEN;
+
+/**
+ * Indexed by html_element_bucket(), gives the seed to pass to
+ * html_element_slot().
+ *
+ * @note This is generated at build time by `gen_html_hash`.
+ */
+extern uint8_t const        HTML_ELEMENT_SEED[ HTML_ELEMENT_BUCKETS ];
+
+/**
+ * Indexed by html_element_slot(), gives the only element in \ref
+ * HTML_BLOCK_ELEMENTS that can have that slot, if any.
+ *
+ * @note This is generated at build time by `gen_html_hash`.
+ */
+extern html_element_t const HTML_ELEMENT_TABLE[ HTML_ELEMENT_SLOTS ];
+
+////////// inline functions ///////////////////////////////////////////////////
+
+/**
+ * Gets the bucket for an HTML element name.
+ *
+ * @param s The name.  It is assumed to have been converted to lower-case.
+ * @param len The length of \a s; must be &gt; 0.
+ * @return Returns the index into \ref HTML_ELEMENT_SEED of the seed to pass to
+ * html_element_slot().
+ */
+NODISCARD W_MARKDOWN_H_INLINE
+size_t html_element_bucket( char const *s, size_t len ) {
+  return (len * 3 + (unsigned char)s[0]) & (HTML_ELEMENT_BUCKETS - 1);
+}
+
+/**
+ * Gets the slot for an HTML element name.
+ *
+ * @remarks Together with the seeds in \ref HTML_ELEMENT_SEED, this is a
+ * perfect hash function over the names in \ref HTML_BLOCK_ELEMENTS: each
+ * element has a distinct slot.
+ *
+ * @param s The name.  It is assumed to have been converted to lower-case.
+ * @param len The length of \a s.
+ * @param seed The seed for the name's bucket.
+ * @return Returns the index into \ref HTML_ELEMENT_TABLE.
+ */
+NODISCARD W_MARKDOWN_H_INLINE
+size_t html_element_slot( char const *s, size_t len, uint8_t seed ) {
+  uint32_t hash = 2166136261u ^ seed;   // FNV-1a
+  for ( size_t i = 0; i < len; ++i )
+    hash = (hash ^ (unsigned char)s[i]) * 16777619u;
+  return hash & (HTML_ELEMENT_SLOTS - 1);
+}
+
 ////////// extern functions ///////////////////////////////////////////////////
 
 /**
- * Initializes the Markdown parser.
+ * Cleans-up all data used by a Markdown parser.
+ *
+ * @param md The \ref md_parser to clean-up.
+ *
+ * @sa markdown_init()
+ */
+void markdown_cleanup( md_parser_t *md );
+
+/**
+ * Checks whether \a element is the name of an HTML block-level element.
+ *
+ * @param element The null-terminated element name to check.  It is assumed to
+ * have been converted to lower-case.
+ * @param len The length of \a element.
+ * @return Returns #HTML_PRE for a pre-formatted element, #HTML_ELEMENT for any
+ * other block-level element, or #HTML_NONE otherwise.
  */
-void markdown_init( void );
+NODISCARD
+html_state_t markdown_html_element( char const *element, size_t len );
+
+/**
+ * Initializes (or re-initializes) a Markdown parser.
+ *
+ * @remarks Re-initializing within a document (e.g., after a line matching
+ * `--block-regex`) keeps sequence numbers increasing so that the caller still
+ * sees every new state.  Memory for the stack is kept.
+ *
+ * @param md The \ref md_parser to initialize.
+ *
+ * @sa markdown_cleanup()
+ * @sa markdown_restart()
+ */
+void markdown_init( md_parser_t *md );
 
 /**
  * Parses a line of Markdown text.  Note that this isn't a full Markdown parser
@@ -149,14 +337,28 @@ void markdown_init( void );
  * needs to parse block elements (headers, lists, code blocks, horizontal
  * rules) and not span elements (links, emphasis, inline code).
  *
+ * @param md The \ref md_parser to use.
  * @param s The null-terminated string to parse.
  * @return Returns a pointer to the current Markdown state.
  */
 NODISCARD
-md_state_t const* markdown_parse( char *s );
+md_state_t const* markdown_parse( md_parser_t *md, char *s );
+
+/**
+ * Restarts a Markdown parser for a new document: as if it were initialized for
+ * the first time, but in constant time and keeping the memory for the stack.
+ *
+ * @param md The \ref md_parser to restart.  It must have been either
+ * initialized or zero-initialized.
+ *
+ * @sa markdown_init()
+ */
+void markdown_restart( md_parser_t *md );
 
 ///////////////////////////////////////////////////////////////////////////////
 
+_GL_INLINE_HEADER_END
+
 /** @} */
 
 #endif /* wrap_markdown_H */
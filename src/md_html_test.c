@@ -0,0 +1,269 @@
+/*
+**      wrap -- text reformatter
+**      src/md_html_test.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Tests markdown_html_element() against a plain sorted list of HTML
+ * block-level elements searched via **bsearch**(3) and, with `-b`, benchmarks
+ * the two.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "markdown.h"
+#include "util.h"
+
+// standard
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Block-level HTML 5 elements, sorted, that must be #HTML_ELEMENT.
+ */
+static char const *const REF_BLOCK_ELEMENT[] = {
+  "article", "aside",
+  "base", "basefont", "blockquote", "body", "br", "button",
+  "canvas", "caption", "center", "col", "colgroup",
+  "dd", "details", "dialog", "dir", "div", "dl", "dt",
+  "embed",
+  "fieldset", "figcaption", "figure", "footer", "form", "frame", "frameset",
+  "h1", "h2", "h3", "h4", "h5", "h6", "head", "header", "hgroup", "hr", "html",
+  "iframe",
+  "legend", "li", "link",
+  "main", "map", "menu", "menuitem", "meta",
+  "nav", "noframes",
+  "object", "ol", "optgroup", "option",
+  "p", "param", "progress",
+  "section", "source", "summary",
+  "table", "tbody", "td", "textarea", "tfoot", "th", "thead", "title", "tr",
+  "track",
+  "ul",
+  "video"
+};
+
+/**
+ * Pre-formatted HTML elements, sorted, that must be #HTML_PRE.
+ */
+static char const *const REF_PRE_ELEMENT[] = {
+  "pre", "script", "style"
+};
+
+/**
+ * Inline HTML elements that are commonly at the beginning of a line to mix in
+ * with block-level elements when benchmarking.
+ */
+static char const *const BENCH_INLINE_ELEMENT[] = {
+  "a", "abbr", "b", "code", "em", "i", "img", "input", "kbd", "label",
+  "select", "small", "span", "strong", "sub", "sup"
+};
+
+/// Number of times each element is looked up when benchmarking.
+static unsigned const BENCH_REPS = 200000;
+
+// extern variable definitions
+char const       *me;                   ///< Program name.
+
+// local functions
+NODISCARD
+static html_state_t ref_html_element( char const* );
+
+NODISCARD
+static int          str_ptr_cmp( char const**, char const** );
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Benchmarks markdown_html_element() against ref_html_element().
+ */
+static void bench( void ) {
+  char const *names[ ARRAY_SIZE( REF_BLOCK_ELEMENT ) +
+                     ARRAY_SIZE( REF_PRE_ELEMENT ) +
+                     ARRAY_SIZE( BENCH_INLINE_ELEMENT ) ];
+  size_t names_len = 0;
+  for ( size_t i = 0; i < ARRAY_SIZE( REF_BLOCK_ELEMENT ); ++i )
+    names[ names_len++ ] = REF_BLOCK_ELEMENT[i];
+  for ( size_t i = 0; i < ARRAY_SIZE( REF_PRE_ELEMENT ); ++i )
+    names[ names_len++ ] = REF_PRE_ELEMENT[i];
+  for ( size_t i = 0; i < ARRAY_SIZE( BENCH_INLINE_ELEMENT ); ++i )
+    names[ names_len++ ] = BENCH_INLINE_ELEMENT[i];
+
+  size_t lens[ ARRAY_SIZE( names ) ];
+  for ( size_t i = 0; i < names_len; ++i )
+    lens[i] = strlen( names[i] );
+
+  //
+  // Accumulate the results so the compiler can't elide the lookups.
+  //
+  unsigned hash_sum = 0, ref_sum = 0;
+
+  struct timespec t0, t1, t2;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &t0 ) != 0, EX_OSERR );
+  for ( unsigned rep = 0; rep < BENCH_REPS; ++rep ) {
+    for ( size_t i = 0; i < names_len; ++i )
+      hash_sum += markdown_html_element( names[i], lens[i] );
+  } // for
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &t1 ) != 0, EX_OSERR );
+  for ( unsigned rep = 0; rep < BENCH_REPS; ++rep ) {
+    for ( size_t i = 0; i < names_len; ++i )
+      ref_sum += ref_html_element( names[i] );
+  } // for
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &t2 ) != 0, EX_OSERR );
+
+  if ( hash_sum != ref_sum )
+    fatal_error( EX_SOFTWARE, "perfect hash and bsearch results differ\n" );
+
+  double const lookups = STATIC_CAST( double, names_len ) * BENCH_REPS;
+  double const hash_ns =
+    (STATIC_CAST( double, t1.tv_sec - t0.tv_sec ) * 1e9 +
+     STATIC_CAST( double, t1.tv_nsec - t0.tv_nsec )) / lookups;
+  double const ref_ns =
+    (STATIC_CAST( double, t2.tv_sec - t1.tv_sec ) * 1e9 +
+     STATIC_CAST( double, t2.tv_nsec - t1.tv_nsec )) / lookups;
+
+  printf( "perfect hash: %7.2f ns/lookup\n", hash_ns );
+  printf( "bsearch     : %7.2f ns/lookup\n", ref_ns );
+  printf( "speedup     : %7.2fx\n", ref_ns / hash_ns );
+}
+
+/**
+ * Checks that markdown_html_element() and ref_html_element() agree on \a s.
+ *
+ * @param s The null-terminated string to check.
+ * @return Returns 1 if they disagree or 0 if they agree.
+ */
+NODISCARD
+static unsigned check( char const *s ) {
+  html_state_t const got = markdown_html_element( s, strlen( s ) );
+  html_state_t const expected = ref_html_element( s );
+  if ( got == expected )
+    return 0;
+  EPRINTF( "\"%s\": got %u; expected %u\n", s, got, expected );
+  return 1;
+}
+
+/**
+ * Checks \a name along with every string that's one edit away from it.
+ *
+ * @param name The null-terminated name to check.
+ * @return Returns the number of mismatches.
+ */
+NODISCARD
+static unsigned check_edits( char const *name ) {
+  static char const ALPHABET[] = "-0123456789abcdefghijklmnopqrstuvwxyz";
+  char buf[ 16 ];
+  size_t const len = strlen( name );
+  unsigned mismatches = check( name );
+
+  for ( size_t i = 0; i <= len; ++i ) {
+    if ( i < len ) {                    // deletion
+      memcpy( buf, name, i );
+      strcpy( buf + i, name + i + 1 );
+      mismatches += check( buf );
+    }
+    for ( char const *c = ALPHABET; *c != '\0'; ++c ) {
+      memcpy( buf, name, i );           // insertion
+      buf[i] = *c;
+      strcpy( buf + i + 1, name + i );
+      mismatches += check( buf );
+      if ( i < len ) {                  // substitution
+        strcpy( buf, name );
+        buf[i] = *c;
+        mismatches += check( buf );
+      }
+    } // for
+  } // for
+
+  return mismatches;
+}
+
+/**
+ * Looks up \a s in the reference lists via **bsearch**(3).
+ *
+ * @param s The null-terminated string to look up.
+ * @return Returns #HTML_PRE, #HTML_ELEMENT, or #HTML_NONE.
+ */
+NODISCARD
+static html_state_t ref_html_element( char const *s ) {
+  if ( bsearch( &s, REF_PRE_ELEMENT, ARRAY_SIZE( REF_PRE_ELEMENT ),
+                sizeof( REF_PRE_ELEMENT[0] ),
+                POINTER_CAST( bsearch_cmp_fn_t, &str_ptr_cmp ) ) != NULL ) {
+    return HTML_PRE;
+  }
+  if ( bsearch( &s, REF_BLOCK_ELEMENT, ARRAY_SIZE( REF_BLOCK_ELEMENT ),
+                sizeof( REF_BLOCK_ELEMENT[0] ),
+                POINTER_CAST( bsearch_cmp_fn_t, &str_ptr_cmp ) ) != NULL ) {
+    return HTML_ELEMENT;
+  }
+  return HTML_NONE;
+}
+
+/**
+ * Compares two string pointers by comparing the string pointed to.
+ *
+ * @param i_sptr The first string pointer to compare.
+ * @param j_sptr The second string pointer to compare.
+ * @return Returns a number less than 0, 0, or greater than 0 if \a *i_sptr is
+ * less than, equal to, or greater than \a *j_sptr, respectively.
+ */
+NODISCARD
+static int str_ptr_cmp( char const **i_sptr, char const **j_sptr ) {
+  return strcmp( *i_sptr, *j_sptr );
+}
+
+/**
+ * Prints the usage message to standard error and exits.
+ */
+_Noreturn
+static void usage( void ) {
+  EPRINTF( "usage: %s [-b]\n", me );
+  exit( EX_USAGE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( int argc, char const *argv[] ) {
+  me = base_name( argv[0] );
+  if ( argc > 2 || (argc == 2 && strcmp( argv[1], "-b" ) != 0) )
+    usage();
+  if ( argc == 2 ) {
+    bench();
+    exit( EX_OK );
+  }
+
+  unsigned mismatches = 0;
+  for ( size_t i = 0; i < ARRAY_SIZE( REF_BLOCK_ELEMENT ); ++i )
+    mismatches += check_edits( REF_BLOCK_ELEMENT[i] );
+  for ( size_t i = 0; i < ARRAY_SIZE( REF_PRE_ELEMENT ); ++i )
+    mismatches += check_edits( REF_PRE_ELEMENT[i] );
+  for ( size_t i = 0; i < ARRAY_SIZE( BENCH_INLINE_ELEMENT ); ++i )
+    mismatches += check_edits( BENCH_INLINE_ELEMENT[i] );
+
+  printf( "%u mismatches\n", mismatches );
+  exit( mismatches > 0 ? EX_SOFTWARE : EX_OK );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
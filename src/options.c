@@ -42,6 +42,7 @@
 #include <getopt.h>
 #include <inttypes.h>                   /* for SIZE_MAX */
 #include <stdbool.h>
+#include <unistd.h>                     /* for sysconf() */
 
 /// @endcond
 
@@ -95,11 +96,15 @@ eol_t               opt_eol = EOL_INPUT;
 bool                opt_eos_delimit;
 size_t              opt_eos_spaces = EOS_SPACES_DEFAULT;
 bool                opt_data_link_esc;
+char const *const  *opt_files;
+size_t              opt_files_len;
 char const         *opt_fin_name;
 size_t              opt_hang_spaces;
 size_t              opt_hang_tabs;
 size_t              opt_indt_spaces;
 size_t              opt_indt_tabs;
+size_t              opt_jobs;
+bool                opt_jobs_given;
 bool                opt_lead_dot_ignore;
 size_t              opt_lead_spaces;
 char const         *opt_lead_string;
@@ -112,10 +117,13 @@ size_t              opt_mirror_tabs;
 size_t              opt_newlines_delimit = NEWLINES_DELIMIT_DEFAULT;
 bool                opt_no_conf;
 bool                opt_no_hyphen;
+bool                opt_optimal;
 char const         *opt_para_delims;
 bool                opt_prototype;
+char const         *opt_stats;
 size_t              opt_tab_spaces = TAB_SPACES_DEFAULT;
 bool                opt_title_line;
+bool                opt_unbuffered;
 
 /// @endcond
 
@@ -153,11 +161,14 @@ static void         print_version( bool );
   SOPT(FILE)                  SOPT_REQUIRED_ARGUMENT  \
   SOPT(FILE_NAME)             SOPT_REQUIRED_ARGUMENT  \
   SOPT(HELP)                  SOPT_OPTIONAL_ARGUMENT  \
+  SOPT(JOBS)                  SOPT_REQUIRED_ARGUMENT  \
   SOPT(MARKDOWN)              SOPT_NO_ARGUMENT        \
   SOPT(NO_CONFIG)             SOPT_NO_ARGUMENT        \
   SOPT(NO_HYPHEN)             SOPT_NO_ARGUMENT        \
+  SOPT(OPTIMAL)               SOPT_NO_ARGUMENT        \
   SOPT(OUTPUT)                SOPT_REQUIRED_ARGUMENT  \
   SOPT(PARA_CHARS)            SOPT_REQUIRED_ARGUMENT  \
+  SOPT(STATS)                 SOPT_OPTIONAL_ARGUMENT  \
   SOPT(TAB_SPACES)            SOPT_REQUIRED_ARGUMENT  \
   SOPT(TITLE_LINE)            SOPT_NO_ARGUMENT        \
   SOPT(VERSION)               SOPT_NO_ARGUMENT        \
@@ -173,6 +184,7 @@ static void         print_version( bool );
   SOPT(FILE_NAME)                 \
   SOPT(NO_CONFIG)                 \
   SOPT(OUTPUT)                    \
+  SOPT(STATS)                     \
   SOPT(VERSION)
 
 /**
@@ -197,6 +209,7 @@ static void         print_version( bool );
   SOPT(MIRROR_TABS)           SOPT_REQUIRED_ARGUMENT  \
   SOPT(NO_NEWLINES_DELIMIT)   SOPT_NO_ARGUMENT        \
   SOPT(PROTOTYPE)             SOPT_NO_ARGUMENT        \
+  SOPT(UNBUFFERED)            SOPT_NO_ARGUMENT        \
   SOPT(WHITESPACE_DELIMIT)    SOPT_NO_ARGUMENT
 
 /**
@@ -243,11 +256,14 @@ static char const *const OPTS_SHORT[] = {
   { "file",                 required_argument,  NULL, COPT(FILE)          },  \
   { "file-name",            required_argument,  NULL, COPT(FILE_NAME)     },  \
   { "help",                 no_argument,        NULL, COPT(HELP)          },  \
+  { "jobs",                 required_argument,  NULL, COPT(JOBS)          },  \
   { "markdown",             no_argument,        NULL, COPT(MARKDOWN)      },  \
   { "no-config",            no_argument,        NULL, COPT(NO_CONFIG)     },  \
   { "no-hyphen",            no_argument,        NULL, COPT(NO_HYPHEN)     },  \
+  { "optimal",              no_argument,        NULL, COPT(OPTIMAL)       },  \
   { "output",               required_argument,  NULL, COPT(OUTPUT)        },  \
   { "para-chars",           required_argument,  NULL, COPT(PARA_CHARS)    },  \
+  { "stats",                optional_argument,  NULL, COPT(STATS)         },  \
   { "tab-spaces",           required_argument,  NULL, COPT(TAB_SPACES)    },  \
   { "title-line",           no_argument,        NULL, COPT(TITLE_LINE)    },  \
   { "version",              no_argument,        NULL, COPT(VERSION)       },  \
@@ -278,6 +294,7 @@ static struct option const WRAP_OPTS_LONG[] = {
   { "mirror-tabs",          required_argument,  NULL, COPT(MIRROR_TABS)   },
   { "no-newlines-delimit",  no_argument,        NULL, COPT(NO_NEWLINES_DELIMIT) },
   { "prototype",            no_argument,        NULL, COPT(PROTOTYPE)     },
+  { "unbuffered",           no_argument,        NULL, COPT(UNBUFFERED)    },
   { "whitespace-delimit",   no_argument,        NULL, COPT(WHITESPACE_DELIMIT) },
   { "_ENABLE-IPC",          no_argument,        NULL, COPT(ENABLE_IPC)    },
 
@@ -622,6 +639,10 @@ static void parse_options( int argc, char const *argv[],
       case COPT(INDENT_TABS):
         opt_indt_tabs = check_atou( optarg );
         break;
+      case COPT(JOBS):
+        opt_jobs = check_atou( optarg );
+        opt_jobs_given = true;
+        break;
       case COPT(LEAD_SPACES):
         opt_lead_spaces = check_atou( optarg );
         break;
@@ -650,6 +671,9 @@ static void parse_options( int argc, char const *argv[],
       case COPT(NO_NEWLINES_DELIMIT):
         opt_newlines_delimit = SIZE_MAX;
         break;
+      case COPT(OPTIMAL):
+        opt_optimal = true;
+        break;
       case COPT(OUTPUT):
         if ( SKIP_CHARS( optarg, WS_ST )[0] == '\0' )
           goto missing_arg;
@@ -663,12 +687,18 @@ static void parse_options( int argc, char const *argv[],
       case COPT(PROTOTYPE):
         opt_prototype = true;
         break;
+      case COPT(STATS):
+        opt_stats = optarg != NULL ? optarg : "";
+        break;
       case COPT(TAB_SPACES):
         opt_tab_spaces = check_atou( optarg );
         break;
       case COPT(TITLE_LINE):
         opt_title_line = true;
         break;
+      case COPT(UNBUFFERED):
+        opt_unbuffered = true;
+        break;
       case COPT(VERSION):
         ++opt_version;
         break;
@@ -718,6 +748,7 @@ static void parse_options( int argc, char const *argv[],
       SOPT(MIRROR_TABS)
       SOPT(NO_HYPHEN)
       SOPT(NO_NEWLINES_DELIMIT)
+      SOPT(OPTIMAL)
       SOPT(PARA_CHARS)
       SOPT(PROTOTYPE)
       SOPT(TITLE_LINE)
@@ -856,6 +887,9 @@ static void print_version( bool verbose ) {
 
   PUTS( "\nconfigure feature & package options:" );
   bool printed_opt = false;
+#ifdef WITH_TRACE
+  PUT_CONFIG_OPT( "enable-trace" );
+#endif /* WITH_TRACE */
 #ifdef WITH_WIDTH_TERM
   PUT_CONFIG_OPT( "disable-width" );
 #endif /* WITH_WIDTH_TERM */
@@ -894,8 +928,25 @@ void options_init( int argc, char const *argv[], void (*usage)(int) ) {
   argc -= optind;
   argv += optind;
   if ( argc > 0 ) {
-    (*usage)( EX_USAGE );
-    unreachable();
+    if ( opts_given[ STATIC_CAST( unsigned, COPT(FILE) ) ] ) {
+      fatal_error( EX_USAGE,
+        "%s option not allowed with file arguments\n",
+        opt_format( COPT(FILE) )
+      );
+    }
+    if ( argc == 1 ) {
+      //
+      // A single file argument is the same as --file so its name can be
+      // matched against a pattern.
+      //
+      fin_path = argv[0];
+      if ( opt_fin_name == NULL )
+        opt_fin_name = base_name( fin_path );
+    }
+    else {
+      opt_files = argv;
+      opt_files_len = STATIC_CAST( size_t, argc );
+    }
   }
 
   if ( !opt_no_conf && (opt_alias != NULL || opt_fin_name != NULL) ) {
@@ -925,6 +976,18 @@ void options_init( int argc, char const *argv[], void (*usage)(int) ) {
 
   if ( strcmp( fout_path, "-" ) != 0 && !freopen( fout_path, "w", stdout ) )
     fatal_error( EX_CANTCREAT, "\"%s\": %s\n", fout_path, STRERROR() );
+
+  if ( opt_unbuffered ) {
+    //
+    // Wrapping in parallel buffers the output of each part until all parts
+    // before it have been written which defeats writing it ASAP.
+    //
+    opt_jobs = 1;
+  }
+  else if ( opt_jobs == 0 ) {
+    long const cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    opt_jobs = cpus > 0 ? STATIC_CAST( size_t, cpus ) : 1;
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,7 @@
 #define OPT_HANG_SPACES           H
 #define OPT_INDENT_TABS           i
 #define OPT_INDENT_SPACES         I
+#define OPT_JOBS                  j
 #define OPT_EOL                   l
 #define OPT_LEAD_STRING           L
 #define OPT_MIRROR_TABS           m
@@ -61,6 +62,7 @@
 #define OPT_NO_NEWLINES_DELIMIT   n
 #define OPT_ALL_NEWLINES_DELIMIT  N
 #define OPT_OUTPUT                o
+#define OPT_OPTIMAL               O
 #define OPT_PARA_CHARS            p
 #define OPT_PROTOTYPE             P
 #define OPT_TAB_SPACES            s
@@ -68,11 +70,13 @@
 #define OPT_LEAD_TABS             t
 #define OPT_TITLE_LINE            T
 #define OPT_MARKDOWN              u
+#define OPT_UNBUFFERED            U
 #define OPT_VERSION               v
 #define OPT_WIDTH                 w
 #define OPT_WHITESPACE_DELIMIT    W
 #define OPT_DOXYGEN               x
 #define OPT_NO_HYPHEN             y
+#define OPT_STATS                 z
 #define OPT_ENABLE_IPC            Z
 
 /// Command-line option character as a character literal.
@@ -117,11 +121,15 @@ extern bool         opt_doxygen;        ///< Handle Doxygen commands?
 extern eol_t        opt_eol;            ///< End-of-line treatment.
 extern bool         opt_eos_delimit;    ///< End-of-sentence delimits para's?
 extern size_t       opt_eos_spaces;     ///< Spaces after end-of-sentence.
+extern char const *const *opt_files;    ///< File paths, if more than one.
+extern size_t       opt_files_len;      ///< Number of \ref opt_files.
 extern char const  *opt_fin_name;       ///< File in name (only).
 extern size_t       opt_hang_spaces;    ///< Hanging-indent spaces.
 extern size_t       opt_hang_tabs;      ///< Hanging-indent tabs.
 extern size_t       opt_indt_spaces;    ///< Indent spaces.
 extern size_t       opt_indt_tabs;      ///< Indent tabs.
+extern size_t       opt_jobs;           ///< Files to wrap at the same time.
+extern bool         opt_jobs_given;     ///< Was \ref opt_jobs given?
 extern bool         opt_lead_dot_ignore;///< Ignore lines starting with '.'?
 extern size_t       opt_lead_spaces;    ///< Number of leading spaces.
 extern char const  *opt_lead_string;    ///< Leading string.
@@ -137,10 +145,16 @@ extern size_t       opt_newlines_delimit;
 
 extern bool         opt_no_conf;        ///< Do not read configuration file.
 extern bool         opt_no_hyphen;      ///< Do not treat hyphens specially.
+extern bool         opt_optimal;        ///< Minimize raggedness?
 extern char const  *opt_para_delims;    ///< Additional para delimiter chars.
 extern bool         opt_prototype;      ///< First line whitespace is prototype?
+
+/// File to print statistics to: NULL for none or empty for standard error.
+extern char const  *opt_stats;
+
 extern size_t       opt_tab_spaces;     ///< Number of spaces 1 tab equals.
 extern bool         opt_title_line;     ///< First line of paragraph is title?
+extern bool         opt_unbuffered;     ///< Flush output after paragraphs?
 
 ////////// extern functions ///////////////////////////////////////////////////
 
@@ -162,6 +176,10 @@ char const* opt_format( char short_opt );
 /**
  * Initializes command-line option variables.
  *
+ * @remarks If exactly one file argument is given, it's treated as if it were
+ * given via `--file`; if more than one are given, they're stored in \ref
+ * opt_files (and standard input isn't read).
+ *
  * @param argc The argument count from main().
  * @param argv The argument values from main().
  * @param usage A pointer to a function to print a usage message.  It must not
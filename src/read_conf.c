@@ -27,6 +27,7 @@
 #include "pjl_config.h"                 /* must go first */
 #include "alias.h"
 #include "common.h"
+#include "line_reader.h"
 #include "pattern.h"
 #include "util.h"
 
@@ -36,6 +37,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>                      /* for open() */
 #include <limits.h>                     /* for PATH_MAX */
 #if HAVE_PWD_H
 # include <pwd.h>                       /* for getpwuid() */
@@ -45,7 +47,7 @@
 #include <stdio.h>
 #include <stdlib.h>                     /* for getenv(), ... */
 #include <string.h>
-#include <unistd.h>                     /* for geteuid() */
+#include <unistd.h>                     /* for close(), geteuid() */
 
 /// @endcond
 
@@ -189,17 +191,20 @@ char const* read_conf( char const *conf_file ) {
   }
 
   // open configuration file
-  FILE *const fconf = fopen( conf_file, "r" );
-  if ( fconf == NULL ) {
+  int const conf_fd = open( conf_file, O_RDONLY );
+  if ( conf_fd == -1 ) {
     if ( is_explicit_conf_file )
       fatal_error( EX_NOINPUT, "%s: %s\n", conf_file, STRERROR() );
     return NULL;
   }
 
   // parse configuration file
-  line_buf_t line_buf;
+  line_reader_t conf_lr;
+  line_reader_init( &conf_lr, conf_fd );
+  char *line_buf = NULL;
+  size_t line_cap = 0;
   unsigned line_no = 0;
-  while ( fgets( line_buf, sizeof line_buf, fconf ) != NULL ) {
+  while ( check_readline( &line_buf, &line_cap, &conf_lr ) > 0 ) {
     ++line_no;
     char *line = strip_comment( line_buf );
     if ( line == NULL ) {
@@ -240,9 +245,9 @@ char const* read_conf( char const *conf_file ) {
     } // switch
   } // while
 
-  if ( unlikely( ferror( fconf ) ) )
-    fatal_error( EX_IOERR, "%s: %s\n", conf_file, STRERROR() );
-  fclose( fconf );
+  free( line_buf );
+  line_reader_cleanup( &conf_lr );
+  close( conf_fd );
 
 #ifndef NDEBUG
   if ( is_affirmative( getenv( "WRAP_DUMP_CONF" ) ) ) {
@@ -20,29 +20,231 @@
 
 // local
 #include "pjl_config.h"                 /* must go first */
+#include "dfa.h"
+#include "uri.h"
 #include "util.h"
 #include "wregex.h"
 
 // standard
+#include <regex.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
 
 ///////////////////////////////////////////////////////////////////////////////
 
 // local constant definitions
 static char const TEST_SEP = ' ';
 
+/**
+ * Typical "block" regular expressions to benchmark, anchored as
+ * wrap_engine_compile() anchors them.
+ */
+static char const *const BENCH_BLOCK_RES[] = {
+  "^@",
+  "^[[:space:]]*[-*+][[:space:]]",
+  "^[[:space:]]*[@\\\\][[:alpha:]]+",
+};
+
+/// Number of times each line is matched when benchmarking.
+static unsigned const BENCH_REPS = 20;
+
 // extern variable definitions
 char const       *me;                   ///< Program name.
 
+// local functions
+static void       bench_engines( char const*, char *const[], size_t );
+NODISCARD
+static double     now_us( void );
+
 ////////// local functions ////////////////////////////////////////////////////
 
+/**
+ * Benchmarks both regular expression engines on #WRAP_RE and typical "block"
+ * regular expressions using the lines of a file as input.
+ *
+ * @param fin The file to read lines from.
+ */
+static void bench( FILE *fin ) {
+  char **lines = NULL;
+  size_t lines_len = 0;
+  char line_buf[ 1024 ];
+
+  while ( fgets( line_buf, sizeof line_buf, fin ) != NULL ) {
+    REALLOC( lines, char*, lines_len + 1 );
+    lines[ lines_len++ ] = check_strdup( line_buf );
+  } // while
+  FERROR( fin );
+
+  bench_engines( WRAP_RE, lines, lines_len );
+  for ( size_t i = 0; i < ARRAY_SIZE( BENCH_BLOCK_RES ); ++i )
+    bench_engines( BENCH_BLOCK_RES[i], lines, lines_len );
+
+  for ( size_t i = 0; i < lines_len; ++i )
+    FREE( lines[i] );
+  FREE( lines );
+}
+
+/**
+ * Benchmarks both regular expression engines matching \a pattern against
+ * every line in \a lines at every offset and prints the results.
+ *
+ * @param pattern The regular expression pattern to benchmark.
+ * @param lines The lines to match against.
+ * @param lines_len The number of \a lines.
+ */
+static void bench_engines( char const *pattern, char *const lines[],
+                           size_t lines_len ) {
+  regex_t posix;
+  dfa_t dfa;
+  dfa_cache_t dfa_cache = { 0 };
+  if ( regcomp( &posix, pattern, REG_EXTENDED ) != 0 ||
+       dfa_compile( &dfa, pattern ) != DFA_OK ) {
+    fatal_error( EX_SOFTWARE, "\"%s\": can not compile\n", pattern );
+  }
+
+  double posix_us = 0, dfa_us = 0;
+  size_t posix_matches = 0, dfa_matches = 0, runs = 0;
+
+  for ( unsigned rep = 0; rep < BENCH_REPS; ++rep ) {
+    for ( size_t i = 0; i < lines_len; ++i ) {
+      size_t const line_len = strlen( lines[i] );
+      for ( size_t offset = 0; offset <= line_len; ++offset ) {
+        char const *const so = lines[i] + offset;
+        regmatch_t match[1];
+        size_t range[2];
+
+        double const t0 = now_us();
+        bool const posix_matched =
+          regexec( &posix, so, 1, match, /*eflags=*/0 ) == 0;
+        double const t1 = now_us();
+        bool const dfa_matched = dfa_match( &dfa, &dfa_cache, so, range );
+        double const t2 = now_us();
+
+        posix_us += t1 - t0;
+        dfa_us += t2 - t1;
+        posix_matches += posix_matched;
+        dfa_matches += dfa_matched;
+        ++runs;
+      } // for
+    } // for
+  } // for
+
+  printf(
+    "%-32.32s %8zu runs  posix %7zu %8.3f us  dfa %7zu %8.3f us  %5.1fx\n",
+    pattern, runs,
+    posix_matches, posix_us / STATIC_CAST( double, runs ),
+    dfa_matches, dfa_us / STATIC_CAST( double, runs ),
+    dfa_us > 0 ? posix_us / dfa_us : 0
+  );
+
+  regfree( &posix );
+  dfa_cache_free( &dfa_cache );
+  dfa_free( &dfa );
+}
+
+/**
+ * Checks that uri_match() matches exactly what regex_match() does for every
+ * offset into \a subject.
+ *
+ * @param re The compiled #WRAP_RE.
+ * @param cache The wregex_cache_t to use for \a re.
+ * @param test_path The path of the test file.
+ * @param line_no The line number within the test file.
+ * @param subject The string to match.
+ * @return Returns the number of offsets at which they differ.
+ */
+NODISCARD
+static unsigned cross_check( wregex_t const *re, wregex_cache_t *cache,
+                             char const *test_path, unsigned line_no,
+                             char const *subject ) {
+  unsigned mismatches = 0;
+  size_t const subject_len = strlen( subject );
+
+  for ( size_t offset = 0; offset <= subject_len; ++offset ) {
+    size_t re_range[2] = { 0, 0 }, uri_range[2] = { 0, 0 };
+    bool const re_matched = regex_match( re, cache, subject, offset, re_range );
+    bool const uri_matched = uri_match( subject, offset, uri_range );
+    if ( uri_matched != re_matched || uri_range[0] != re_range[0] ||
+         uri_range[1] != re_range[1] ) {
+      EPRINTF(
+        "%s:%u: offset %zu: scanner match [%zu,%zu) does not equal regular"
+        " expression match [%zu,%zu)\n",
+        test_path, line_no, offset, uri_range[0], uri_range[1],
+        re_range[0], re_range[1]
+      );
+      ++mismatches;
+    }
+  } // for
+
+  return mismatches;
+}
+
+/**
+ * Checks that the built-in DFA engine matches exactly what POSIX regex does
+ * for every offset into \a subject.
+ *
+ * @param posix The compiled #WRAP_RE for POSIX regex.
+ * @param dfa The compiled #WRAP_RE for the DFA engine.
+ * @param dfa_cache The dfa_cache_t to use for \a dfa.
+ * @param test_path The path of the test file.
+ * @param line_no The line number within the test file.
+ * @param subject The string to match.
+ * @return Returns the number of offsets at which they differ.
+ */
+NODISCARD
+static unsigned cross_check_engines( regex_t const *posix, dfa_t const *dfa,
+                                     dfa_cache_t *dfa_cache,
+                                     char const *test_path, unsigned line_no,
+                                     char const *subject ) {
+  unsigned mismatches = 0;
+  size_t const subject_len = strlen( subject );
+
+  for ( size_t offset = 0; offset <= subject_len; ++offset ) {
+    regmatch_t match[1];
+    size_t posix_range[2] = { 0, 0 }, dfa_range[2] = { 0, 0 };
+    bool const posix_matched =
+      regexec( posix, subject + offset, 1, match, /*eflags=*/0 ) == 0;
+    if ( posix_matched ) {
+      posix_range[0] = STATIC_CAST( size_t, match[0].rm_so );
+      posix_range[1] = STATIC_CAST( size_t, match[0].rm_eo );
+    }
+    bool const dfa_matched =
+      dfa_match( dfa, dfa_cache, subject + offset, dfa_range );
+    if ( dfa_matched != posix_matched || dfa_range[0] != posix_range[0] ||
+         dfa_range[1] != posix_range[1] ) {
+      EPRINTF(
+        "%s:%u: offset %zu: DFA match [%zu,%zu) does not equal POSIX match"
+        " [%zu,%zu)\n",
+        test_path, line_no, offset, dfa_range[0], dfa_range[1],
+        posix_range[0], posix_range[1]
+      );
+      ++mismatches;
+    }
+  } // for
+
+  return mismatches;
+}
+
+/**
+ * Gets the current time in microseconds from an arbitrary epoch.
+ *
+ * @return Returns said time.
+ */
+NODISCARD
+static double now_us( void ) {
+  struct timespec ts;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0, EX_OSERR );
+  return STATIC_CAST( double, ts.tv_sec ) * 1e6 +
+         STATIC_CAST( double, ts.tv_nsec ) / 1e3;
+}
+
 _Noreturn
 static void usage( void ) {
-  EPRINTF( "usage: %s test\n", me );
+  EPRINTF( "usage: %s test\n       %s -b file\n", me, me );
   exit( EX_USAGE );
 }
 
@@ -50,6 +252,11 @@ static void usage( void ) {
 
 int main( int argc, char const *argv[] ) {
   me = base_name( argv[0] );
+  bool const is_bench = argc == 3 && strcmp( argv[1], "-b" ) == 0;
+  if ( is_bench ) {
+    --argc;
+    ++argv;
+  }
   if ( --argc != 1 )
     usage();
 
@@ -60,7 +267,14 @@ int main( int argc, char const *argv[] ) {
 
   setlocale_utf8();
 
+  if ( is_bench ) {
+    bench( fin );
+    fclose( fin );
+    exit( EX_OK );
+  }
+
   wregex_t re;
+  wregex_cache_t re_cache = { 0 };
   int const regex_err_code = regex_compile( &re, WRAP_RE );
   if ( regex_err_code != 0 ) {
     fatal_error( EX_SOFTWARE,
@@ -69,6 +283,14 @@ int main( int argc, char const *argv[] ) {
     );
   }
 
+  regex_t posix_re;
+  dfa_t dfa_re;
+  dfa_cache_t dfa_cache = { 0 };
+  if ( regcomp( &posix_re, WRAP_RE, REG_EXTENDED ) != 0 ||
+       dfa_compile( &dfa_re, WRAP_RE ) != DFA_OK ) {
+    fatal_error( EX_SOFTWARE, "internal regular expression error\n" );
+  }
+
   char line_buf[ 128 ];
   unsigned line_no = 0;
   unsigned mismatches = 0;
@@ -91,8 +313,13 @@ int main( int argc, char const *argv[] ) {
     size_t const expected_len = STATIC_CAST( size_t, sep - expected );
     char const *const subject = sep + 1;
 
+    mismatches += cross_check( &re, &re_cache, test_path, line_no, subject );
+    mismatches += cross_check_engines(
+      &posix_re, &dfa_re, &dfa_cache, test_path, line_no, subject
+    );
+
     size_t match_range[2];
-    bool const matched = regex_match( &re, subject, 0, match_range );
+    bool const matched = regex_match( &re, &re_cache, subject, 0, match_range );
 
     if ( !matched ) {
       if ( expected_len > 0 ) {
@@ -129,7 +356,11 @@ int main( int argc, char const *argv[] ) {
     }
   } // while
 
+  regex_cache_free( &re_cache );
   regex_free( &re );
+  regfree( &posix_re );
+  dfa_cache_free( &dfa_cache );
+  dfa_free( &dfa_re );
 
   FERROR( fin );
   fclose( fin );
@@ -0,0 +1,105 @@
+#! /bin/sh
+##
+#       wrap -- text reformatter
+#       src/run_bench.sh
+#
+#       Copyright (C) 2025  Paul J. Lucas
+#
+#       This program is free software: you can redistribute it and/or modify
+#       it under the terms of the GNU General Public License as published by
+#       the Free Software Foundation, either version 3 of the License, or
+#       (at your option) any later version.
+#
+#       This program is distributed in the hope that it will be useful,
+#       but WITHOUT ANY WARRANTY; without even the implied warranty of
+#       MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#       GNU General Public License for more details.
+#
+#       You should have received a copy of the GNU General Public License
+#       along with this program.  If not, see <http://www.gnu.org/licenses/>.
+##
+
+##
+# Runs the end-to-end throughput benchmarks: generates each synthetic corpus
+# via gen_corpus, then times wrap and wrapc in each mode via wrap_bench that
+# prints one line of JSON per benchmark.  Then runs the startup latency
+# benchmarks: times wrap and wrapc on a 3-line input many times since editor
+# integrations run them on every reflow where startup dominates.
+#
+# Environment variables:
+#
+#   BENCH_RUNS    Number of timed runs per benchmark [default: 5].
+#   BENCH_SIZE    Approximate size of each corpus in KiB [default: 4096].
+#   STARTUP_RUNS  Number of timed runs per startup benchmark [default: 200].
+##
+
+# Uncomment the following line for shell tracing.
+#set -x
+
+########## Functions ##########################################################
+
+bench() {
+  MODE=$1; CORPUS=$2; shift 2
+  ./wrap_bench -n $BENCH_RUNS $MODE $CORPUS_DIR/$CORPUS "$@" || exit
+}
+
+gen() {
+  ./gen_corpus $1 $BENCH_SIZE > $CORPUS_DIR/$2 || exit
+}
+
+startup() {
+  MODE=$1; CORPUS=$2; shift 2
+  ./wrap_bench -n $STARTUP_RUNS $MODE $CORPUS_DIR/$CORPUS "$@" || exit
+}
+
+########## Begin ##############################################################
+
+BENCH_RUNS=${BENCH_RUNS:-5}
+BENCH_SIZE=${BENCH_SIZE:-4096}
+STARTUP_RUNS=${STARTUP_RUNS:-200}
+CORPUS_DIR=bench-corpus
+
+[ -d $CORPUS_DIR ] || mkdir $CORPUS_DIR || exit
+
+gen code          code.c
+gen comments-c    comments-c.c
+gen comments-cxx  comments-cxx.cpp
+gen comments-lisp comments-lisp.lisp
+gen comments-md   comments-md.cpp
+gen comments-sh   comments-sh.sh
+gen comments-sql  comments-sql.sql
+gen doxygen       doxygen.h
+gen markdown      markdown.md
+gen plain         plain.txt
+gen unicode       unicode.txt
+gen uri           uri.txt
+
+bench default       plain.txt           ./wrap -C
+bench default       unicode.txt         ./wrap -C
+bench default       uri.txt             ./wrap -C
+bench markdown      markdown.md         ./wrap -C -u
+bench prototype     plain.txt           ./wrap -C -P
+bench lead-string   plain.txt           ./wrap -C -L '> '
+
+bench default       comments-c.c        ./wrapc -C
+bench default       comments-cxx.cpp    ./wrapc -C
+bench default       comments-lisp.lisp  ./wrapc -C
+bench default       comments-sh.sh      ./wrapc -C
+bench default       comments-sql.sql    ./wrapc -C
+bench markdown      comments-md.cpp     ./wrapc -C -u
+bench doxygen       doxygen.h           ./wrapc -C -x
+bench align-column  code.c              ./wrapc -C -A40
+
+printf '%s\n' \
+  'Editor integrations reflow a paragraph like this one' \
+  'on every keystroke, so the time it takes to start up' \
+  'matters far more than throughput does.' > $CORPUS_DIR/startup.txt
+printf '%s\n' \
+  '/* Editor integrations reflow a comment like this one' \
+  ' * on every keystroke, so the time it takes to start up' \
+  ' * matters far more than throughput does. */' > $CORPUS_DIR/startup.c
+
+startup startup     startup.txt         ./wrap -C
+startup startup     startup.c           ./wrapc -C
+
+# vim:set et sw=2 ts=2:
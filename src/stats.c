@@ -0,0 +1,224 @@
+/*
+**      wrap -- text reformatter
+**      src/stats.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines global variables and functions for the counters and timings printed
+ * as JSON via `--stats`.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "stats.h"
+#include "markdown.h"
+#include "options.h"
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdio.h>
+#include <sys/resource.h>               /* for getrusage() */
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+
+/// @endcond
+
+/**
+ * @addtogroup stats-group
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A Markdown line type and its name as printed.
+ */
+struct stats_md_name {
+  md_line_t   line_type;                ///< The Markdown line type.
+  char const *name;                     ///< Its name.
+};
+typedef struct stats_md_name stats_md_name_t;
+
+/**
+ * Markdown line type names in the order of \ref wrap_stats::md_lines.
+ */
+static stats_md_name_t const STATS_MD_NAMES[ STATS_MD_LINE_TYPES ] = {
+  { MD_NONE,          "none"          },
+  { MD_CODE,          "code"          },
+  { MD_DL,            "dl"            },
+  { MD_FOOTNOTE_DEF,  "footnote_def"  },
+  { MD_HEADER_ATX,    "header_atx"    },
+  { MD_HEADER_LINE,   "header_line"   },
+  { MD_HR,            "hr"            },
+  { MD_HTML_ABBR,     "html_abbr"     },
+  { MD_HTML_BLOCK,    "html_block"    },
+  { MD_LINK_LABEL,    "link_label"    },
+  { MD_OL,            "ol"            },
+  { MD_TABLE,         "table"         },
+  { MD_TEXT,          "text"          },
+  { MD_UL,            "ul"            },
+};
+
+/// @cond DOXYGEN_IGNORE
+/// Otherwise Doxygen generates two entries.
+
+// extern variable definitions
+wrap_stats_t        wrap_stats;
+wrapc_stats_t       wrapc_stats;
+
+/// @endcond
+
+// local variables
+static FILE        *stats_file;         ///< File to print to, if any.
+static double       stats_start_s;      ///< Time stats_init() was called.
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Converts a `struct timeval` to seconds.
+ *
+ * @param tv The `struct timeval` to convert.
+ * @return Returns said seconds.
+ */
+NODISCARD
+static double timeval_s( struct timeval const *tv ) {
+  return  STATIC_CAST( double, tv->tv_sec ) +
+          STATIC_CAST( double, tv->tv_usec ) / 1e6;
+}
+
+////////// extern functions ///////////////////////////////////////////////////
+
+void stats_add( wrap_stats_t *to, wrap_stats_t const *from ) {
+  assert( to != NULL );
+  assert( from != NULL );
+  to->bytes_read          += from->bytes_read;
+  to->lines_read          += from->lines_read;
+  to->cps_read            += from->cps_read;
+  to->paras_delimited     += from->paras_delimited;
+  to->lines_emitted       += from->lines_emitted;
+  to->long_line_breaks    += from->long_line_breaks;
+  to->hyphen_wraps        += from->hyphen_wraps;
+  to->block_regex_calls   += from->block_regex_calls;
+  to->block_regex_rejects += from->block_regex_rejects;
+  to->block_regex_execs   += from->block_regex_execs;
+  to->block_regex_matches += from->block_regex_matches;
+  to->uri_find_calls      += from->uri_find_calls;
+  to->uri_find_matches    += from->uri_find_matches;
+  for ( size_t i = 0; i < STATS_MD_LINE_TYPES; ++i )
+    to->md_lines[i] += from->md_lines[i];
+}
+
+double stats_clock( void ) {
+  struct timespec ts;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0, EX_OSERR );
+  return  STATIC_CAST( double, ts.tv_sec ) +
+          STATIC_CAST( double, ts.tv_nsec ) / 1e9;
+}
+
+void stats_init( void ) {
+  ASSERT_RUN_ONCE();
+  if ( opt_stats == NULL )
+    return;
+  if ( opt_stats[0] == '\0' ) {
+    stats_file = stderr;
+  } else {
+    stats_file = fopen( opt_stats, "w" );
+    if ( stats_file == NULL )
+      fatal_error( EX_CANTCREAT, "\"%s\": %s\n", opt_stats, STRERROR() );
+  }
+  stats_start_s = stats_clock();
+}
+
+void stats_md_line( wrap_stats_t *stats, md_line_t line_type ) {
+  assert( stats != NULL );
+  for ( size_t i = 0; i < STATS_MD_LINE_TYPES; ++i ) {
+    if ( STATS_MD_NAMES[i].line_type == line_type ) {
+      ++stats->md_lines[i];
+      return;
+    }
+  } // for
+  UNEXPECTED_INT_VALUE( line_type );
+}
+
+void stats_print( bool is_wrapc ) {
+  if ( stats_file == NULL )
+    return;
+
+  double const elapsed_s = stats_clock() - stats_start_s;
+  struct rusage ru;
+  PERROR_EXIT_IF( getrusage( RUSAGE_SELF, &ru ) != 0, EX_OSERR );
+
+  wrap_stats_t const *const s = &wrap_stats;
+  FPRINTF( stats_file,
+    "{\"tool\":\"%s\","
+    "\"elapsed_s\":%.6f,\"user_s\":%.6f,\"sys_s\":%.6f,"
+    "\"bytes_read\":%zu,\"lines_read\":%zu,\"codepoints_read\":%zu,"
+    "\"paragraphs\":%zu,\"lines_emitted\":%zu,"
+    "\"long_line_breaks\":%zu,\"hyphen_wraps\":%zu,"
+    "\"regex\":{"
+      "\"block\":{"
+        "\"calls\":%zu,\"prefilter_hits\":%zu,\"prefilter_misses\":%zu,"
+        "\"matches\":%zu"
+      "},"
+      "\"uri\":{\"calls\":%zu,\"matches\":%zu}"
+    "},"
+    "\"markdown\":{",
+    me,
+    elapsed_s, timeval_s( &ru.ru_utime ), timeval_s( &ru.ru_stime ),
+    s->bytes_read, s->lines_read, s->cps_read,
+    s->paras_delimited, s->lines_emitted,
+    s->long_line_breaks, s->hyphen_wraps,
+    s->block_regex_calls, s->block_regex_rejects, s->block_regex_execs,
+    s->block_regex_matches,
+    s->uri_find_calls, s->uri_find_matches
+  );
+  for ( size_t i = 0; i < STATS_MD_LINE_TYPES; ++i ) {
+    FPRINTF( stats_file,
+      "%s\"%s\":%zu",
+      i > 0 ? "," : "", STATS_MD_NAMES[i].name, s->md_lines[i]
+    );
+  } // for
+  FPUTC( '}', stats_file );
+
+  if ( is_wrapc ) {
+    FPRINTF( stats_file,
+      ",\"wipc\":{\"messages\":%zu,\"bytes_piped\":%zu,\"child_wait_s\":%.6f}",
+      wrapc_stats.wipc_msgs, wrapc_stats.bytes_piped, wrapc_stats.child_wait_s
+    );
+  }
+
+  FPUTS( "}\n", stats_file );
+  if ( stats_file == stderr ) {
+    PERROR_EXIT_IF( fflush( stats_file ) != 0, EX_IOERR );
+  } else {
+    PERROR_EXIT_IF( fclose( stats_file ) != 0, EX_IOERR );
+  }
+  stats_file = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+/* vim:set et sw=2 ts=2: */
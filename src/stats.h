@@ -0,0 +1,145 @@
+/*
+**      wrap -- text reformatter
+**      src/stats.h
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef wrap_stats_H
+#define wrap_stats_H
+
+/**
+ * @file
+ * Declares types, global variables, and functions for the counters and
+ * timings printed as JSON via `--stats`.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "markdown.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+
+/// @endcond
+
+/**
+ * @defgroup stats-group Statistics
+ * Types, global variables, and functions for `--stats`.
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Number of Markdown line types counted in \ref wrap_stats::md_lines.
+#define STATS_MD_LINE_TYPES       14
+
+/**
+ * Counters of what the wrap engine did.  Each \ref wrap_ctx has its own so
+ * they can be incremented without locking; they're added to \ref wrap_stats
+ * once a \ref wrap_ctx is done.
+ */
+struct wrap_stats {
+  size_t  bytes_read;                   ///< Bytes of input.
+  size_t  lines_read;                   ///< Lines of input.
+  size_t  cps_read;                     ///< Code-points of input.
+  size_t  paras_delimited;              ///< Non-empty paragraphs delimited.
+  size_t  lines_emitted;                ///< Lines ended by the engine.
+  size_t  long_line_breaks;             ///< Lines broken without whitespace.
+  size_t  hyphen_wraps;                 ///< Lines wrapped at a hyphen.
+  size_t  block_regex_calls;            ///< Lines matched against the regex.
+  size_t  block_regex_rejects;          ///< Lines rejected by its prefix.
+  size_t  block_regex_execs;            ///< Lines given to its engine.
+  size_t  block_regex_matches;          ///< Lines the block regex matched.
+  size_t  uri_find_calls;               ///< Calls to uri_find().
+  size_t  uri_find_matches;             ///< URIs found by uri_find().
+
+  /// Lines of each Markdown line type in the order of \ref stats_md_line().
+  size_t  md_lines[ STATS_MD_LINE_TYPES ];
+};
+typedef struct wrap_stats wrap_stats_t;
+
+/**
+ * Counters of what **wrapc**(1) did in addition to what's in \ref wrap_stats.
+ */
+struct wrapc_stats {
+  size_t  wipc_msgs;                    ///< IPC messages from the engine.
+  size_t  bytes_piped;                  ///< Bytes of wrapped text read back.
+  double  child_wait_s;                 ///< Seconds waiting for children.
+};
+typedef struct wrapc_stats wrapc_stats_t;
+
+// extern variables
+extern wrap_stats_t   wrap_stats;       ///< Totals of all \ref wrap_ctx.
+extern wrapc_stats_t  wrapc_stats;      ///< Totals for **wrapc**(1).
+
+////////// extern functions ///////////////////////////////////////////////////
+
+/**
+ * Adds the counters of \a from to those of \a to.
+ *
+ * @param to The \ref wrap_stats to add to.
+ * @param from The \ref wrap_stats to add.
+ */
+void stats_add( wrap_stats_t *to, wrap_stats_t const *from );
+
+/**
+ * Gets the current time in seconds from an arbitrary epoch for measuring
+ * elapsed time.
+ *
+ * @return Returns said time.
+ */
+NODISCARD
+double stats_clock( void );
+
+/**
+ * If `--stats` was given, opens the file to print to and starts the clock;
+ * otherwise does nothing.
+ *
+ * @note This must be called after options_init().
+ *
+ * @sa stats_print()
+ */
+void stats_init( void );
+
+/**
+ * Counts a line of Markdown of type \a line_type.
+ *
+ * @param stats The \ref wrap_stats to count in.
+ * @param line_type The Markdown line type.
+ */
+void stats_md_line( wrap_stats_t *stats, md_line_t line_type );
+
+/**
+ * If `--stats` was given, prints \ref wrap_stats (and, for **wrapc**(1),
+ * \ref wrapc_stats) along with the elapsed and CPU times as a single line of
+ * JSON; otherwise does nothing.
+ *
+ * @param is_wrapc If `true`, also prints \ref wrapc_stats.
+ *
+ * @sa stats_init()
+ */
+void stats_print( bool is_wrapc );
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+#endif /* wrap_stats_H */
+/* vim:set et sw=2 ts=2: */
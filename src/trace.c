@@ -0,0 +1,411 @@
+/*
+**      wrap -- text reformatter
+**      src/trace.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines functions for the hot-path phase timers and the ring buffer of wrap
+ * decisions that are compiled in only when configured with `--enable-trace`.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "trace.h"
+#include "engine.h"
+#include "util.h"
+
+#ifdef WITH_TRACE
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <assert.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>
+#include <stdlib.h>                     /* for getenv() */
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+#include <unistd.h>                     /* for getpid(), write() */
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>                    /* for pthread_atfork() */
+#endif /* HAVE_PTHREAD */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>                  /* for __rdtsc() */
+#define HAVE_RDTSC 1
+#endif
+
+/// @endcond
+
+/**
+ * @addtogroup trace-group
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Number of entries in the trace ring buffer; must be a power of 2.
+#define TRACE_RING_SIZE           4096
+
+/// Number of \ref trace_phase values.
+#define TRACE_PHASES              7
+
+/**
+ * A decision recorded in the trace ring buffer.
+ */
+struct trace_rec {
+  uint64_t  ticks;                      ///< When it happened.
+  uint32_t  line;                       ///< Input line number, if any.
+  uint32_t  pos;                        ///< Output position or length, if any.
+  uint8_t   event;                      ///< The \ref trace_event.
+  uint8_t   arg;                        ///< Event-specific argument.
+  uint8_t   hyphen;                     ///< The \ref hyphen state, if any.
+};
+typedef struct trace_rec trace_rec_t;
+
+/**
+ * A line of output being formatted by hand so it can be done from within a
+ * signal handler.
+ */
+struct trace_buf {
+  char    buf[ 128 ];                   ///< The line.
+  size_t  len;                          ///< Its length.
+};
+typedef struct trace_buf trace_buf_t;
+
+/// Names of \ref trace_delim values.
+static char const *const TRACE_DELIM_NAMES[] = {
+  "block-regex", "eos", "ipc", "lead-dot", "newlines", "title", "whitespace"
+};
+
+/// Names of \ref trace_event values.
+static char const *const TRACE_EVENT_NAMES[] = {
+  "readline", "delimit", "break", "ipc"
+};
+
+/// Names of \ref hyphen values.
+static char const *const TRACE_HYPHEN_NAMES[] = {
+  [ HYPHEN_NO    ] = "no",
+  [ HYPHEN_MAYBE ] = "maybe",
+  [ HYPHEN_YES   ] = "yes"
+};
+
+/// Names of \ref trace_phase values.
+static char const *const TRACE_PHASE_NAMES[ TRACE_PHASES ] = {
+  "none", "read", "classify", "regex", "markdown", "emit", "ipc"
+};
+
+// local variables
+static bool             trace_on;       ///< Is tracing on?
+static atomic_size_t    trace_next;     ///< Total events recorded.
+static _Atomic uint64_t trace_phase_ticks[ TRACE_PHASES ];
+static trace_rec_t      trace_ring[ TRACE_RING_SIZE ];
+static uint64_t         trace_start_ns; ///< Clock at trace_init().
+static uint64_t         trace_start_ticks;///< Ticks at trace_init().
+
+/// The calling thread's current \ref trace_phase.
+static _Thread_local trace_phase_t  trace_cur_phase;
+
+/// Ticks when the calling thread entered \ref trace_cur_phase.
+static _Thread_local uint64_t       trace_cur_since;
+
+// local functions
+static void       trace_buf_puts( trace_buf_t*, char const* );
+static void       trace_buf_putu( trace_buf_t*, uint64_t );
+static void       trace_buf_write( trace_buf_t* );
+static void       trace_cleanup( void );
+static void       trace_fork_child( void );
+
+NODISCARD
+static uint64_t   trace_ns( void );
+
+static void       trace_reset( void );
+static void       trace_signal( int );
+
+NODISCARD
+static uint64_t   trace_ticks( void );
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Appends \a s to \a tb.
+ *
+ * @param tb The \ref trace_buf to append to.
+ * @param s The string to append.
+ */
+static void trace_buf_puts( trace_buf_t *tb, char const *s ) {
+  for ( ; *s != '\0' && tb->len < sizeof tb->buf - 1/*\n*/; ++s )
+    tb->buf[ tb->len++ ] = *s;
+}
+
+/**
+ * Appends \a n in decimal to \a tb.
+ *
+ * @param tb The \ref trace_buf to append to.
+ * @param n The number to append.
+ */
+static void trace_buf_putu( trace_buf_t *tb, uint64_t n ) {
+  char digits[ 20 + 1/*\0*/ ];
+  char *d = digits + sizeof digits;
+  *--d = '\0';
+  do {
+    *--d = STATIC_CAST( char, '0' + n % 10 );
+    n /= 10;
+  } while ( n > 0 );
+  trace_buf_puts( tb, d );
+}
+
+/**
+ * Writes \a tb followed by a newline to standard error and clears it.
+ *
+ * @param tb The \ref trace_buf to write.
+ */
+static void trace_buf_write( trace_buf_t *tb ) {
+  tb->buf[ tb->len++ ] = '\n';
+  PJL_DISCARD_RV( write( STDERR_FILENO, tb->buf, tb->len ) );
+  tb->len = 0;
+}
+
+/**
+ * Dumps the trace at exit.
+ */
+static void trace_cleanup( void ) {
+  trace_phase_enter( TRACE_PHASE_NONE );
+  trace_dump();
+}
+
+/**
+ * Resets the trace in a child process so it dumps only its own.
+ */
+static void trace_fork_child( void ) {
+  trace_reset();
+}
+
+/**
+ * Gets the current time in nanoseconds from an arbitrary epoch.
+ *
+ * @return Returns said time.
+ */
+static uint64_t trace_ns( void ) {
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return  STATIC_CAST( uint64_t, ts.tv_sec ) * 1000000000u +
+          STATIC_CAST( uint64_t, ts.tv_nsec );
+}
+
+/**
+ * Resets the phase times, the ring buffer, and the start time.
+ */
+static void trace_reset( void ) {
+  for ( size_t i = 0; i < TRACE_PHASES; ++i )
+    atomic_store_explicit( &trace_phase_ticks[i], 0, memory_order_relaxed );
+  atomic_store_explicit( &trace_next, 0, memory_order_relaxed );
+  trace_start_ns = trace_ns();
+  trace_start_ticks = trace_cur_since = trace_ticks();
+}
+
+/**
+ * Dumps the trace upon receipt of a signal: for `SIGUSR1`, the process
+ * continues; for others, the signal is re-raised with its default action.
+ *
+ * @param sig The signal received.
+ */
+static void trace_signal( int sig ) {
+  trace_dump();
+  if ( sig != SIGUSR1 ) {
+    signal( sig, SIG_DFL );
+    raise( sig );
+  }
+}
+
+/**
+ * Gets the current number of ticks: CPU cycles if available; nanoseconds
+ * otherwise.
+ *
+ * @return Returns said number of ticks.
+ */
+static inline uint64_t trace_ticks( void ) {
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  return trace_ns();
+#endif /* HAVE_RDTSC */
+}
+
+////////// extern functions ///////////////////////////////////////////////////
+
+void trace_dump( void ) {
+  if ( !trace_on )
+    return;
+  uint64_t const elapsed_ns = trace_ns() - trace_start_ns;
+  uint64_t const elapsed_ticks = trace_ticks() - trace_start_ticks;
+  double const ns_per_tick = elapsed_ticks > 0 ?
+    STATIC_CAST( double, elapsed_ns ) / STATIC_CAST( double, elapsed_ticks ) :
+    1;
+
+  trace_buf_t tb = { .len = 0 };
+  trace_buf_t prefix = { .len = 0 };
+  trace_buf_puts( &prefix, me );
+  trace_buf_puts( &prefix, "[" );
+  trace_buf_putu( &prefix, STATIC_CAST( uint64_t, getpid() ) );
+  trace_buf_puts( &prefix, "]: trace: " );
+  prefix.buf[ prefix.len ] = '\0';
+
+  trace_buf_puts( &tb, prefix.buf );
+  trace_buf_puts( &tb, "elapsed_ns=" );
+  trace_buf_putu( &tb, elapsed_ns );
+#ifdef HAVE_RDTSC
+  trace_buf_puts( &tb, " ticks=rdtsc" );
+#else
+  trace_buf_puts( &tb, " ticks=ns" );
+#endif /* HAVE_RDTSC */
+  trace_buf_write( &tb );
+
+  for ( size_t i = TRACE_PHASE_NONE + 1; i < TRACE_PHASES; ++i ) {
+    uint64_t const ticks =
+      atomic_load_explicit( &trace_phase_ticks[i], memory_order_relaxed );
+    trace_buf_puts( &tb, prefix.buf );
+    trace_buf_puts( &tb, "phase=" );
+    trace_buf_puts( &tb, TRACE_PHASE_NAMES[i] );
+    trace_buf_puts( &tb, " ticks=" );
+    trace_buf_putu( &tb, ticks );
+    trace_buf_puts( &tb, " ns=" );
+    trace_buf_putu( &tb,
+      STATIC_CAST( uint64_t, STATIC_CAST( double, ticks ) * ns_per_tick )
+    );
+    trace_buf_write( &tb );
+  } // for
+
+  size_t const next = atomic_load_explicit( &trace_next, memory_order_relaxed );
+  size_t const n = next < TRACE_RING_SIZE ? next : TRACE_RING_SIZE;
+  trace_buf_puts( &tb, prefix.buf );
+  trace_buf_puts( &tb, "events=" );
+  trace_buf_putu( &tb, next );
+  trace_buf_puts( &tb, " last=" );
+  trace_buf_putu( &tb, n );
+  trace_buf_write( &tb );
+
+  for ( size_t i = next - n; i < next; ++i ) {
+    trace_rec_t const *const rec = &trace_ring[ i & (TRACE_RING_SIZE - 1) ];
+    trace_buf_puts( &tb, prefix.buf );
+    trace_buf_puts( &tb, "ns=" );
+    trace_buf_putu( &tb, STATIC_CAST( uint64_t,
+      STATIC_CAST( double, rec->ticks - trace_start_ticks ) * ns_per_tick
+    ) );
+    trace_buf_puts( &tb, " " );
+    trace_buf_puts( &tb, TRACE_EVENT_NAMES[ rec->event ] );
+    switch ( STATIC_CAST( trace_event_t, rec->event ) ) {
+      case TRACE_EVENT_READLINE:
+        trace_buf_puts( &tb, " line=" );
+        trace_buf_putu( &tb, rec->line );
+        trace_buf_puts( &tb, " pos=" );
+        trace_buf_putu( &tb, rec->pos );
+        trace_buf_puts( &tb, rec->arg ? " wrap=yes" : " wrap=no" );
+        break;
+      case TRACE_EVENT_DELIMIT:
+        trace_buf_puts( &tb, " line=" );
+        trace_buf_putu( &tb, rec->line );
+        trace_buf_puts( &tb, " pos=" );
+        trace_buf_putu( &tb, rec->pos );
+        trace_buf_puts( &tb, " reason=" );
+        trace_buf_puts( &tb, TRACE_DELIM_NAMES[ rec->arg ] );
+        trace_buf_puts( &tb, " hyphen=" );
+        trace_buf_puts( &tb, TRACE_HYPHEN_NAMES[ rec->hyphen ] );
+        break;
+      case TRACE_EVENT_BREAK:
+        trace_buf_puts( &tb, " line=" );
+        trace_buf_putu( &tb, rec->line );
+        trace_buf_puts( &tb, " pos=" );
+        trace_buf_putu( &tb, rec->pos );
+        trace_buf_puts( &tb, rec->arg ? " eol=yes" : " eol=no" );
+        trace_buf_puts( &tb, " hyphen=" );
+        trace_buf_puts( &tb, TRACE_HYPHEN_NAMES[ rec->hyphen ] );
+        break;
+      case TRACE_EVENT_IPC:
+        trace_buf_puts( &tb, " code=" );
+        trace_buf_putu( &tb, rec->arg );
+        trace_buf_puts( &tb, " len=" );
+        trace_buf_putu( &tb, rec->pos );
+        break;
+    } // switch
+    trace_buf_write( &tb );
+  } // for
+}
+
+void trace_event( trace_event_t event, unsigned arg, size_t line, size_t pos,
+                  unsigned hyphen ) {
+  if ( !trace_on )
+    return;
+  size_t const i =
+    atomic_fetch_add_explicit( &trace_next, 1, memory_order_relaxed );
+  trace_ring[ i & (TRACE_RING_SIZE - 1) ] = (trace_rec_t){
+    .ticks  = trace_ticks(),
+    .line   = STATIC_CAST( uint32_t, line ),
+    .pos    = STATIC_CAST( uint32_t, pos ),
+    .event  = STATIC_CAST( uint8_t, event ),
+    .arg    = STATIC_CAST( uint8_t, arg ),
+    .hyphen = STATIC_CAST( uint8_t, hyphen )
+  };
+}
+
+void trace_init( void ) {
+  ASSERT_RUN_ONCE();
+  if ( !is_affirmative( getenv( "WRAP_DUMP_TRACE" ) ) )
+    return;
+  trace_reset();
+  trace_on = true;
+  ATEXIT( trace_cleanup );
+#ifdef HAVE_PTHREAD
+  PERROR_EXIT_IF(
+    pthread_atfork( NULL, NULL, &trace_fork_child ) != 0, EX_OSERR
+  );
+#endif /* HAVE_PTHREAD */
+
+  struct sigaction sa = { .sa_handler = &trace_signal, .sa_flags = SA_RESTART };
+  sigemptyset( &sa.sa_mask );
+  PERROR_EXIT_IF( sigaction( SIGINT , &sa, NULL ) != 0, EX_OSERR );
+  PERROR_EXIT_IF( sigaction( SIGTERM, &sa, NULL ) != 0, EX_OSERR );
+  PERROR_EXIT_IF( sigaction( SIGUSR1, &sa, NULL ) != 0, EX_OSERR );
+}
+
+trace_phase_t trace_phase_enter( trace_phase_t phase ) {
+  trace_phase_t const prev = trace_cur_phase;
+  if ( trace_on ) {
+    uint64_t const now = trace_ticks();
+    if ( prev != TRACE_PHASE_NONE ) {
+      atomic_fetch_add_explicit(
+        &trace_phase_ticks[ prev ], now - trace_cur_since, memory_order_relaxed
+      );
+    }
+    trace_cur_since = now;
+  }
+  trace_cur_phase = phase;
+  return prev;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+#endif /* WITH_TRACE */
+/* vim:set et sw=2 ts=2: */
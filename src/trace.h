@@ -0,0 +1,206 @@
+/*
+**      wrap -- text reformatter
+**      src/trace.h
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef wrap_trace_H
+#define wrap_trace_H
+
+/**
+ * @file
+ * Declares types, macros, and functions for the hot-path phase timers and
+ * the ring buffer of wrap decisions that are compiled in only when configured
+ * with `--enable-trace`.
+ *
+ * @remarks Only the `TRACE_*` macros should be used: when `WITH_TRACE` isn't
+ * defined, they all expand to nothing (without evaluating their arguments) so
+ * tracing costs nothing.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stddef.h>                     /* for size_t */
+
+/// @endcond
+
+/**
+ * @defgroup trace-group Tracing
+ * Types, macros, and functions for phase timers and the trace ring buffer.
+ * @{
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Phases whose time is accounted for.
+ *
+ * @remarks Time is accounted for exclusively: the time spent in a phase
+ * entered while another phase is current is attributed only to the former.
+ */
+enum trace_phase {
+  TRACE_PHASE_NONE,                     ///< Not in any phase.
+  TRACE_PHASE_READ,                     ///< Reading &amp; assembling input.
+  TRACE_PHASE_CLASSIFY,                 ///< Classifying characters of a line.
+  TRACE_PHASE_REGEX,                    ///< Block regex &amp; URI matching.
+  TRACE_PHASE_MARKDOWN,                 ///< Parsing Markdown.
+  TRACE_PHASE_EMIT,                     ///< Printing wrapped lines.
+  TRACE_PHASE_IPC                       ///< Interprocess communication.
+};
+typedef enum trace_phase trace_phase_t;
+
+/**
+ * Kinds of events recorded in the trace ring buffer.
+ */
+enum trace_event {
+  TRACE_EVENT_READLINE,                 ///< buf_readline(); _arg_ = wrap?
+  TRACE_EVENT_DELIMIT,                  ///< A paragraph was delimited.
+  TRACE_EVENT_BREAK,                    ///< A line was printed.
+  TRACE_EVENT_IPC                       ///< An IPC message; _arg_ = its code.
+};
+typedef enum trace_event trace_event_t;
+
+/**
+ * Reasons a paragraph was delimited.
+ */
+enum trace_delim {
+  TRACE_DELIM_BLOCK_REGEX,              ///< The block regex matched.
+  TRACE_DELIM_EOS,                      ///< End-of-sentence, then newline.
+  TRACE_DELIM_IPC,                      ///< Told to by **wrapc**(1).
+  TRACE_DELIM_LEAD_DOT,                 ///< Line starting with `.`.
+  TRACE_DELIM_NEWLINES,                 ///< Consecutive newlines.
+  TRACE_DELIM_TITLE,                    ///< End of a title line.
+  TRACE_DELIM_WHITESPACE                ///< Long line, leading whitespace, ...
+};
+typedef enum trace_delim trace_delim_t;
+
+#ifdef WITH_TRACE
+
+/**
+ * Begins accounting time to a phase.
+ *
+ * @param VAR The name of a variable to declare that holds the previous phase
+ * to pass to #TRACE_END().
+ * @param PHASE The \ref trace_phase to begin.
+ *
+ * @sa #TRACE_END()
+ */
+#define TRACE_BEGIN(VAR,PHASE) \
+  trace_phase_t const VAR = trace_phase_enter( (PHASE) )
+
+/**
+ * Ends accounting time to the phase begun by #TRACE_BEGIN().
+ *
+ * @param VAR The name of the variable declared by #TRACE_BEGIN().
+ *
+ * @sa #TRACE_BEGIN()
+ */
+#define TRACE_END(VAR)            trace_phase_enter( (VAR) )
+
+/**
+ * Dumps the phase times and the trace ring buffer now, e.g., before calling
+ * `_exit(2)`.
+ *
+ * @sa trace_dump()
+ */
+#define TRACE_DUMP()              trace_dump()
+
+/**
+ * Records an event in the trace ring buffer.
+ *
+ * @param EVENT The \ref trace_event.
+ * @param ARG An event-specific argument, e.g., a \ref trace_delim.
+ * @param LINE The input line number, if any.
+ * @param POS The position in, or length of, the output buffer, if any.
+ * @param HYPHEN The hyphen state, if any.
+ */
+#define TRACE_EVENT(EVENT,ARG,LINE,POS,HYPHEN) \
+  trace_event( (EVENT), (ARG), (LINE), (POS), (HYPHEN) )
+
+/**
+ * Initializes tracing.
+ *
+ * @sa trace_init()
+ */
+#define TRACE_INIT()              trace_init()
+
+////////// extern functions ///////////////////////////////////////////////////
+
+/**
+ * If tracing is on, dumps the phase times and the ring buffer to standard
+ * error.
+ *
+ * @remarks It uses only async-signal-safe functions so it can be called from
+ * within a signal handler.
+ */
+void trace_dump( void );
+
+/**
+ * Records an event in the trace ring buffer.
+ *
+ * @param event The \ref trace_event.
+ * @param arg An event-specific argument.
+ * @param line The input line number, if any.
+ * @param pos The position in, or length of, the output buffer, if any.
+ * @param hyphen The hyphen state, if any.
+ *
+ * @remarks It's safe to call from multiple threads, but, once the ring
+ * buffer has wrapped around, concurrent events can overwrite one another.
+ */
+void trace_event( trace_event_t event, unsigned arg, size_t line, size_t pos,
+                  unsigned hyphen );
+
+/**
+ * Initializes tracing.  If the `WRAP_DUMP_TRACE` environment variable is
+ * affirmative, the phase times and the ring buffer are dumped to standard
+ * error at exit and upon receipt of `SIGINT`, `SIGTERM`, or `SIGUSR1` (after
+ * which the process continues).
+ *
+ * @note This function must be called exactly once.
+ */
+void trace_init( void );
+
+/**
+ * Enters \a phase: the time since the previous call is accounted to the
+ * current phase of the calling thread.
+ *
+ * @param phase The \ref trace_phase to enter.
+ * @return Returns the previous phase.
+ */
+trace_phase_t trace_phase_enter( trace_phase_t phase );
+
+#else /* WITH_TRACE */
+
+#define TRACE_BEGIN(VAR,PHASE)                  NO_OP
+#define TRACE_DUMP()                            NO_OP
+#define TRACE_END(VAR)                          NO_OP
+#define TRACE_EVENT(EVENT,ARG,LINE,POS,HYPHEN)  NO_OP
+#define TRACE_INIT()                            NO_OP
+
+#endif /* WITH_TRACE */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/** @} */
+
+#endif /* wrap_trace_H */
+/* vim:set et sw=2 ts=2: */
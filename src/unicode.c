@@ -49,9 +49,6 @@ static char32_t const CP_SURROGATE_HIGH_START = 0x00D800u;
 /// Unicode code-point surrogate low end.
 static char32_t const CP_SURROGATE_LOW_END    = 0x00DFFFu;
 
-/// Maximum valid Unicode code-point.
-static char32_t const CP_VALID_MAX            = 0x10FFFFu;
-
 /**
  * UTF-8 character length table indexed by the first octet of the character.
  */
@@ -89,118 +86,28 @@ static inline bool cp_is_valid( char32_t cp ) {
       || (cp > CP_SURROGATE_LOW_END && cp <= CP_VALID_MAX);
 }
 
-////////// extern functions ///////////////////////////////////////////////////
-
-bool cp_is_eos( char32_t cp ) {
-  switch ( cp ) {
-    case '.'   :  // FULL STOP
-    case 0xFF0E:  // FULLWIDTH FULL STOP
-
-    case '?'   :  // QUESTION MARK
-    case 0x037E:  // GREEK QUESTION MARK
-    case 0x055E:  // ARMENIAN QUESTION MARK
-    case 0x1367:  // ETHIOPIC QUESTION MARK
-    case 0x1945:  // LIMBU QUESTION MARK
-    case 0x2047:  // DOUBLE QUESTION MARK
-    case 0x2048:  // QUESTION EXCLAMATION MARK
-    case 0xA60F:  // VAI QUESTION MARK
-    case 0xA6F7:  // BAMUM QUESTION MARK
-    case 0xFE16:  // PRESENTATION FORM FOR VERTICAL QUESTION MARK
-    case 0xFE56:  // SMALL QUESTION MARK
-    case 0xFF1F:  // FULLWIDTH QUESTION MARK
-
-    case '!'   :  // EXCLAMATION MARK
-    case 0x055C:  // ARMENIAN EXCLAMATION MARK
-    case 0x07F9:  // NKO EXCLAMATION MARK
-    case 0x1944:  // LIMBU EXCLAMATION MARK
-    case 0x203C:  // DOUBLE EXCLAMATION MARK
-    case 0x2049:  // EXCLAMATION QUESTION MARK
-    case 0x2757:  // HEAVY EXCLAMATION MARK SYMBOL
-    case 0x2762:  // HEAVY EXCLAMATION MARK ORNAMENT
-    case 0x2763:  // HEAVY HEART EXCLAMATION MARK ORNAMENT
-    case 0xFE15:  // PRESENTATION FORM FOR VERTICAL EXCLAMATION MARK
-    case 0xFE57:  // SMALL EXCLAMATION MARK
-    case 0xFF01:  // FULLWIDTH EXCLAMATION MARK
-      return true;
-
-    default:
-      return false;
-  } // switch
-}
-
-bool cp_is_eos_ext( char32_t cp ) {
-  switch ( cp ) {
-    case '\''  :  // APOSTROPHE
-    case 0x2019:  // RIGHT SINGLE QUOTATION MARK
-    case 0x203A:  // SINGLE RIGHT-POINTING ANGLE QUOTATION MARK
-    case 0x275C:  // HEAVY SINGLE COMMA QUOTATION MARK ORNAMENT
-
-    case '"'   :  // QUOTATION MARK
-    case 0x00BB:  // RIGHT-POINTING DOUBLE ANGLE QUOTATION MARK
-    case 0x201D:  // RIGHT DOUBLE QUOTATION MARK
-    case 0x275E:  // HEAVY DOUBLE COMMA QUOTATION MARK ORNAMENT
-    case 0x276F:  // HEAVY RIGHT-POINTING ANGLE QUOTATION MARK ORNAMENT
-    case 0xFF02:  // FULLWIDTH QUOTATION MARK
-
-    case ')'   :  // RIGHT PARENTHESIS
-    case 0x2769:  // MEDIUM RIGHT PARENTHESIS ORNAMENT
-    case 0x276B:  // MEDIUM FLATTENED RIGHT PARENTHESIS ORNAMENT
-    case 0x27EF:  // MATHEMATICAL RIGHT FLATTENED PARENTHESIS
-    case 0x2986:  // RIGHT WHITE PARENTHESIS
-    case 0x2E29:  // RIGHT DOUBLE PARENTHESIS
-    case 0xFD3F:  // ORNATE RIGHT PARENTHESIS
-    case 0xFE5A:  // SMALL RIGHT PARENTHESIS
-    case 0xFF09:  // FULLWIDTH RIGHT PARENTHESIS
-    case 0xFF60:  // FULLWIDTH RIGHT WHITE PARENTHESIS
-
-    case ']'   :  // RIGHT SQUATE BRACKET
-    case 0x2046:  // RIGHT SQUARE BRACKET WITH QUILL
-    case 0x27E7:  // MATHEMATICAL RIGHT WHITE SQUARE BRACKET
-    case 0x298C:  // RIGHT SQUARE BRACKET WITH UNDERBAR
-    case 0x298E:  // RIGHT SQUARE BRACKET WITH TICK IN BOTTOM CORNER
-    case 0x2990:  // RIGHT SQUARE BRACKET WITH TICK IN TOP CORNER
-    case 0x301B:  // RIGHT WHITE SQUARE BRACKET
-    case 0xFF3D:  // FULLWIDTH RIGHT SQUARE BRACKET
-      return true;
-
-    default:
-      return false;
-  } // switch
+/**
+ * Gets the number of bytes and columns of the character at the start of a
+ * UTF-8 encoded string.
+ *
+ * @param s The UTF-8 encoded string.
+ * @param s_len The number of bytes of \a s; must be &gt; 0.
+ * @param width Set to the number of columns, as counted by utf8_width().
+ * @return Returns the number of bytes.
+ */
+static inline size_t utf8_char_width( char const *s, size_t s_len,
+                                     size_t *width ) {
+  size_t const len = utf8_len( *s );
+  if ( len <= 1 || len > s_len ) {
+    *width = 1;
+    return 1;
+  }
+  char32_t const cp = utf8_decode( s );
+  *width = cp == CP_INVALID ? 1 : cp_width( cp );
+  return len;
 }
 
-bool cp_is_hyphen( char32_t cp ) {
-  switch ( cp ) {
-    case '-'   :  // HYPHEN-MINUS
-    case 0x00AD:  // SOFT HYPHEN
-    case 0x058A:  // ARMENIAN HYPHEN
-    case 0x05BE:  // HEBREW PUNCTUATION MAQAF
-    case 0x1400:  // CANADIAN SYLLABICS HYPHEN
-    case 0x1806:  // MONGOLIAN SOFT HYPHEN
-    case 0x2010:  // HYPHEN
-//  case 0x2011:  // NON-BREAKING HYPHEN // obviously don't want to wrap here
-    case 0x2013:  // EN DASH
-    case 0x2014:  // EM DASH
-    case 0x2015:  // HORIZONTAL BAR
-    case 0x2027:  // HYPHENATION POINT
-    case 0x2043:  // HYPHEN BULLET
-    case 0x2053:  // SWUNG DASH
-    case 0x2E17:  // DOUBLE OBLIQUE HYPHEN
-    case 0x2E1A:  // HYPHEN WITH DIAERESIS
-    case 0x2E40:  // DOUBLE HYPHEN
-    case 0x301C:  // WAVE DASH
-    case 0x3030:  // WAVY DASH
-    case 0x30A0:  // KATAKANA-HIRAGANA DOUBLE HYPHEN
-    case 0x30FB:  // KATAKANA MIDDLE DOT
-    case 0xFE58:  // SMALL EM DASH
-    case 0xFE63:  // SMALL HYPHEN-MINUS
-    case 0xFF0D:  // FULLWIDTH HYPHEN-MINUS
-    case 0xFF65:  // HALFWIDTH KATAKANA MIDDLE DOT
-      return true;
-
-    default:
-      return false;
-  } // switch
-}
+////////// extern functions ///////////////////////////////////////////////////
 
 /**
  * Decodes a UTF-8 encoded character into its corresponding Unicode code-point.
@@ -259,6 +166,45 @@ char const* utf8_rsync_impl( char const *buf, char const *pos ) {
   return utf8_is_start( *pos ) ? pos : NULL;
 }
 
+size_t utf8_width( char const *s, size_t s_len ) {
+  assert( s != NULL );
+  size_t width = 0;
+  for ( size_t i = 0, cp_w; i < s_len; width += cp_w )
+    i += utf8_char_width( s + i, s_len - i, &cp_w );
+  return width;
+}
+
+size_t utf8_width_len( char const *s, size_t s_len, size_t width ) {
+  assert( s != NULL );
+  size_t i = 0;
+  for ( size_t cp_w; i < s_len; ) {
+    size_t const len = utf8_char_width( s + i, s_len - i, &cp_w );
+    if ( cp_w > width )
+      break;
+    width -= cp_w;
+    i += len;
+  } // for
+  return i;
+}
+
+bool utf8_is_word_begin( char const *s, char const *curr ) {
+  assert( s != NULL );
+  assert( curr != NULL );
+  assert( curr >= s );
+
+  if ( curr == s )
+    return true;
+  char const *const prev = utf8_rsync( s, curr - 1 );
+  if ( prev == NULL )
+    return true;
+
+  char32_t const curr_cp = utf8_decode( curr );
+  char32_t const prev_cp = utf8_decode( prev );
+
+  return (cp_is_word_char( curr_cp ) ^ cp_is_word_char( prev_cp ))
+      || (cp_is_space( curr_cp ) ^ cp_is_space( prev_cp ));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /** @} */
@@ -34,7 +34,6 @@
 /// @cond DOXYGEN_IGNORE
 
 // standard
-#include <ctype.h>
 #include <inttypes.h>                   /* for uint*_t */
 #include <stdbool.h>
 #include <stddef.h>                     /* for size_t */
@@ -42,7 +41,6 @@
 #if HAVE_CHAR8_T || HAVE_CHAR32_T
 #include <uchar.h>
 #endif /* HAVE_CHAR8_T || HAVE_CHAR32_T */
-#include <wctype.h>
 
 /// @endcond
 
@@ -77,16 +75,87 @@ typedef uint32_t char32_t;
 /// Value for invalid Unicode code-point.
 #define CP_INVALID                0x1FFFFFu
 
+/// Maximum valid Unicode code-point.
+#define CP_VALID_MAX              0x10FFFFu
+
 /// Max number of bytes needed for a UTF-8 character.
 #define UTF8_CHAR_SIZE_MAX        6
 
+/**
+ * Unicode code-point properties.
+ *
+ * @remarks These are bits so a single table lookup gets all of them.
+ *
+ * @sa cp_props()
+ */
+enum cp_prop {
+  CP_PROP_ALPHA   = 1u << 0,            ///< Alphabetic.
+  CP_PROP_CONTROL = 1u << 1,            ///< ASCII control character.
+  CP_PROP_EOS     = 1u << 2,            ///< End-of-sentence.
+  CP_PROP_EOS_EXT = 1u << 3,            ///< End-of-sentence extender.
+  CP_PROP_HYPHEN  = 1u << 4,            ///< Hyphen-like.
+  CP_PROP_SPACE   = 1u << 5,            ///< Whitespace.
+  CP_PROP_WORD    = 1u << 6             ///< Alphanumeric or `_`.
+};
+
 /**
  * UTF-8 character.
  */
 typedef char utf8c_t[ UTF8_CHAR_SIZE_MAX ];
 
+/**
+ * First-stage table of code-point properties: indexed by a code-point's high
+ * bits (`cp >> 8`), gives the index into \ref CP_PROPS_PAGES of the page for
+ * that code-point.
+ *
+ * @note This is generated at build time by `gen_cp_props`.
+ */
+extern uint8_t const CP_PROPS_PAGE_INDEX[];
+
+/**
+ * Second-stage table of code-point properties: indexed by a page index from
+ * \ref CP_PROPS_PAGE_INDEX and a code-point's low 8 bits, gives the
+ * bitwise-or of that code-point's \ref cp_prop values.  Page 0 covers
+ * code-points 0-255 so those need only a single lookup.
+ *
+ * @note This is generated at build time by `gen_cp_props`.
+ */
+extern uint8_t const CP_PROPS_PAGES[][256];
+
+/**
+ * First-stage table of code-point display widths: just like \ref
+ * CP_PROPS_PAGE_INDEX, but for \ref CP_WIDTH_PAGES.
+ *
+ * @note This is generated at build time by `gen_cp_props`.
+ */
+extern uint8_t const CP_WIDTH_PAGE_INDEX[];
+
+/**
+ * Second-stage table of code-point display widths: just like \ref
+ * CP_PROPS_PAGES, but gives a code-point's display width.
+ *
+ * @note This is generated at build time by `gen_cp_props`.
+ */
+extern uint8_t const CP_WIDTH_PAGES[][256];
+
 ////////// extern functions ///////////////////////////////////////////////////
 
+/**
+ * Gets the properties of \a cp.
+ *
+ * @param cp The Unicode code-point to get the properties of.
+ * @return Returns the bitwise-or of \a cp's \ref cp_prop values or 0 if \a cp
+ * is not a valid code-point.
+ */
+NODISCARD W_UNICODE_H_INLINE
+unsigned cp_props( char32_t cp ) {
+  if ( cp < 0x100 )
+    return CP_PROPS_PAGES[0][ cp ];
+  if ( cp > CP_VALID_MAX )
+    return 0;
+  return CP_PROPS_PAGES[ CP_PROPS_PAGE_INDEX[ cp >> 8 ] ][ cp & 0xFF ];
+}
+
 /**
  * Checks whether \a cp is an alphabetic character.
  *
@@ -99,7 +168,7 @@ typedef char utf8c_t[ UTF8_CHAR_SIZE_MAX ];
  */
 NODISCARD W_UNICODE_H_INLINE
 bool cp_is_alpha( char32_t cp ) {
-  return iswalpha( STATIC_CAST( wint_t, cp ) );
+  return (cp_props( cp ) & CP_PROP_ALPHA) != 0;
 }
 
 /**
@@ -129,7 +198,7 @@ bool cp_is_ascii( char32_t cp ) {
  */
 NODISCARD W_UNICODE_H_INLINE
 bool cp_is_control( char32_t cp ) {
-  return cp_is_ascii( cp ) && iscntrl( STATIC_CAST( int, cp ) );
+  return (cp_props( cp ) & CP_PROP_CONTROL) != 0;
 }
 
 /**
@@ -140,8 +209,10 @@ bool cp_is_control( char32_t cp ) {
  *
  * @sa cp_is_eos_ext()
  */
-NODISCARD
-bool cp_is_eos( char32_t cp );
+NODISCARD W_UNICODE_H_INLINE
+bool cp_is_eos( char32_t cp ) {
+  return (cp_props( cp ) & CP_PROP_EOS) != 0;
+}
 
 /**
  * Checks whether \a cp is an "end-of-sentence-extender" Unicode character,
@@ -154,8 +225,10 @@ bool cp_is_eos( char32_t cp );
  *
  * @sa cp_is_eos()
  */
-NODISCARD
-bool cp_is_eos_ext( char32_t cp );
+NODISCARD W_UNICODE_H_INLINE
+bool cp_is_eos_ext( char32_t cp ) {
+  return (cp_props( cp ) & CP_PROP_EOS_EXT) != 0;
+}
 
 /**
  * Checks whether the given Unicode code-point is a hyphen-like character.
@@ -165,8 +238,10 @@ bool cp_is_eos_ext( char32_t cp );
  *
  * @sa cp_is_hyphen_adjacent()
  */
-NODISCARD
-bool cp_is_hyphen( char32_t cp );
+NODISCARD W_UNICODE_H_INLINE
+bool cp_is_hyphen( char32_t cp ) {
+  return (cp_props( cp ) & CP_PROP_HYPHEN) != 0;
+}
 
 /**
  * Checks whether \a cp is a "hyphen adjacent" Unicode character, that is a
@@ -194,9 +269,66 @@ bool cp_is_hyphen_adjacent( char32_t cp ) {
  */
 NODISCARD W_UNICODE_H_INLINE
 bool cp_is_space( char32_t cp ) {
-  return iswspace( STATIC_CAST( wint_t, cp ) );
+  return (cp_props( cp ) & CP_PROP_SPACE) != 0;
 }
 
+/**
+ * Checks whether \a cp is a word character, that is an alphanumeric or \c _
+ * character.
+ *
+ * @param cp The code-point to check.
+ * @return Returns `true` only if \a cp is a word code-point.
+ */
+NODISCARD W_UNICODE_H_INLINE
+bool cp_is_word_char( char32_t cp ) {
+  return (cp_props( cp ) & CP_PROP_WORD) != 0;
+}
+
+/**
+ * Gets the number of columns \a cp occupies when displayed: 0 for combining
+ * and other zero-width characters; 2 for East Asian wide and fullwidth
+ * characters; 1 for all others.
+ *
+ * @param cp The Unicode code-point to get the width of.
+ * @return Returns said width.
+ */
+NODISCARD W_UNICODE_H_INLINE
+size_t cp_width( char32_t cp ) {
+  if ( cp < 0x100 )
+    return CP_WIDTH_PAGES[0][ cp ];
+  if ( cp > CP_VALID_MAX )
+    return 1;
+  return CP_WIDTH_PAGES[ CP_WIDTH_PAGE_INDEX[ cp >> 8 ] ][ cp & 0xFF ];
+}
+
+/**
+ * Gets the number of columns a UTF-8 encoded string occupies when displayed.
+ *
+ * @param s The UTF-8 encoded string.
+ * @param s_len The number of bytes of \a s.
+ * @return Returns the sum of the cp_width() of every code-point, except that
+ * every ASCII character (including a tab) and every invalid byte counts as 1.
+ *
+ * @sa utf8_width_len()
+ */
+NODISCARD
+size_t utf8_width( char const *s, size_t s_len );
+
+/**
+ * Gets the number of bytes of the longest prefix of a UTF-8 encoded string
+ * that occupies no more than a given number of columns when displayed.
+ *
+ * @param s The UTF-8 encoded string.
+ * @param s_len The number of bytes of \a s.
+ * @param width The maximum number of columns, as counted by utf8_width().
+ * @return Returns said number of bytes.  It's never in the middle of the
+ * bytes of a UTF-8 encoded character.
+ *
+ * @sa utf8_width()
+ */
+NODISCARD
+size_t utf8_width_len( char const *s, size_t s_len, size_t width );
+
 /**
  * Decodes a UTF-8 encoded character into its corresponding Unicode code-point.
  *
@@ -247,6 +379,20 @@ bool utf8_is_start( char c ) {
   return c8 <= 0x7F || (c8 >= 0xC2 && c8 < 0xFE);
 }
 
+/**
+ * Checks whether the character at \a curr is the beginning of a word, that is
+ * whether it differs from the character before it in being a word character
+ * or a space.
+ *
+ * @param s The UTF-8 encoded string to check within.
+ * @param curr A pointer to the first byte of the UTF-8 encoded character to
+ * check.
+ * @return Returns `true` only if the character at \a curr is at the beginning
+ * of a word.
+ */
+NODISCARD
+bool utf8_is_word_begin( char const *s, char const *curr );
+
 /**
  * Gets the number of bytes for the UTF-8 encoding of a Unicode code-point
  * given its first byte.
@@ -0,0 +1,483 @@
+/*
+**      wrap -- text reformatter
+**      src/uri.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Defines a function for finding e-mail addresses and URIs in text.
+ *
+ * @remarks The grammar recognized is exactly that of #WRAP_RE; each function
+ * below notes the part of it that it matches.  Every part other than a domain
+ * has only one way to match longest from a given position and a domain is
+ * never followed by a character that may be in it, so no backtracking is ever
+ * needed.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "uri.h"
+#include "unicode.h"
+#include "util.h"
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <assert.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint8_t */
+#include <string.h>
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Maximum number of characters in a host label or top-level domain.
+#define URI_LABEL_LEN_MAX         63
+
+/// Maximum number of digits in a port.
+#define URI_PORT_LEN_MAX          5
+
+/**
+ * Classes of ASCII punctuation characters that, in addition to alphanumeric
+ * characters, may be in parts of e-mail addresses and URIs.
+ */
+enum uri_cc {
+  URI_CC_ATEXT  = 1u << 0,              ///< E-mail local-part: `RE_ATEXT`.
+  URI_CC_PCHAR  = 1u << 1,              ///< Path: `RE_PCHAR`.
+  URI_CC_QF     = 1u << 2,              ///< Query or fragment: `RE_Q_OR_F`.
+  URI_CC_USER   = 1u << 3,              ///< User: `RE_USER`.
+};
+
+/// Sub-delimiter and unreserved characters are in all URI classes.
+#define URI_CC_URI                (URI_CC_PCHAR | URI_CC_QF | URI_CC_USER)
+
+/**
+ * ASCII punctuation character classes indexed by character.
+ */
+static uint8_t const URI_ASCII_CC[128] = {
+  [ '!' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '#' ] = URI_CC_ATEXT,
+  [ '$' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '%' ] = URI_CC_ATEXT,               // otherwise only when percent-encoded
+  [ '&' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '\''] = URI_CC_ATEXT | URI_CC_URI,
+  [ '(' ] =                URI_CC_URI,
+  [ ')' ] =                URI_CC_URI,
+  [ '*' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '+' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ ',' ] =                URI_CC_URI,
+  [ '-' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '.' ] =                URI_CC_URI,  // e-mail handles it specially
+  [ '/' ] = URI_CC_ATEXT | URI_CC_PCHAR | URI_CC_QF,
+  [ ':' ] =                URI_CC_URI,
+  [ ';' ] =                URI_CC_URI,
+  [ '=' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '?' ] = URI_CC_ATEXT | URI_CC_QF,
+  [ '@' ] =                URI_CC_PCHAR | URI_CC_QF,
+  [ '^' ] = URI_CC_ATEXT,
+  [ '_' ] = URI_CC_ATEXT | URI_CC_URI,
+  [ '`' ] = URI_CC_ATEXT,
+  [ '{' ] = URI_CC_ATEXT,
+  [ '|' ] = URI_CC_ATEXT,
+  [ '}' ] = URI_CC_ATEXT,
+  [ '~' ] = URI_CC_ATEXT | URI_CC_URI,
+};
+
+////////// inline functions ///////////////////////////////////////////////////
+
+/**
+ * Decodes the UTF-8 encoded character at \a s.
+ *
+ * @param s A pointer to the first byte of the UTF-8 encoded character.
+ * @param plen A pointer to receive the number of bytes in the character that
+ * is always at least 1, even for an invalid or truncated byte sequence.
+ * @return Returns said code-point or \ref #CP_INVALID if the UTF-8 byte
+ * sequence is invalid.
+ */
+NODISCARD
+static inline char32_t uri_decode( char const *s, size_t *plen ) {
+  size_t const len = utf8_len( *s );
+  if ( len == 1 ) {
+    *plen = 1;
+    return STATIC_CAST( char8_t, *s );
+  }
+  if ( len == 0 || strnlen( s, len ) < len ) {
+    *plen = 1;
+    return CP_INVALID;
+  }
+  *plen = len;
+  return utf8_decode( s );
+}
+
+/**
+ * Checks whether \a cp is alphanumeric: `[[:alnum:]]`.
+ *
+ * @param cp The code-point to check.
+ * @return Returns `true` only if \a cp is alphanumeric.
+ */
+NODISCARD
+static inline bool uri_is_alnum( char32_t cp ) {
+  return cp != '_' && cp_is_word_char( cp );
+}
+
+/**
+ * Checks whether \a cp is either alphanumeric or in any of \a cc.
+ *
+ * @param cp The code-point to check.
+ * @param cc The bitwise-or of \ref uri_cc classes.
+ * @return Returns `true` only if \a cp is in any of the classes.
+ */
+NODISCARD
+static inline bool uri_is_char( char32_t cp, unsigned cc ) {
+  return  uri_is_alnum( cp ) ||
+          (cp_is_ascii( cp ) && (URI_ASCII_CC[ cp ] & cc) != 0);
+}
+
+/**
+ * Checks whether the characters in \a s just before index \a i are \a word.
+ *
+ * @param s The string to check within.
+ * @param i The index into \a s just after where \a word would end.
+ * @param word The word to check for.
+ * @return Returns the length of \a word if it's there or 0 if not.
+ */
+NODISCARD
+static inline size_t uri_word_before( char const *s, size_t i,
+                                      char const *word ) {
+  size_t const word_len = strlen( word );
+  return i >= word_len && strncmp( s + i - word_len, word, word_len ) == 0 ?
+    word_len : 0;
+}
+
+/**
+ * Checks whether \a c is an ASCII decimal digit.
+ *
+ * @param c The character to check.
+ * @return Returns `true` only if \a c is a digit.
+ */
+NODISCARD
+static inline bool uri_is_digit( char c ) {
+  return c >= '0' && c <= '9';
+}
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Matches characters that are either alphanumeric or in any of \a cc, or, for
+ * any class other than #URI_CC_ATEXT, percent-encoded: `RE_PCT_ENC`.
+ *
+ * @param s The string to match within.
+ * @param i The index into \a s to start.
+ * @param cc The bitwise-or of \ref uri_cc classes.
+ * @return Returns the index one past the end of the longest match that is \a
+ * i if none.
+ */
+NODISCARD
+static size_t match_chars( char const *s, size_t i, unsigned cc ) {
+  for (;;) {
+    size_t len;
+    char32_t const cp = uri_decode( s + i, &len );
+    if ( uri_is_char( cp, cc ) )
+      i += len;
+    else if ( cp != '%' )
+      break;
+    else if ( s[ i + 1 ] == '%' )
+      i += 2;
+    else if ( isxdigit( STATIC_CAST( unsigned char, s[ i + 1 ] ) ) &&
+              isxdigit( STATIC_CAST( unsigned char, s[ i + 2 ] ) ) )
+      i += 3;
+    else
+      break;
+  } // for
+  return i;
+}
+
+/**
+ * Matches a domain: `RE_DOMAIN`.
+ *
+ * @param s The string to match within.
+ * @param i The index into \a s to start.
+ * @return Returns the index one past the end of the longest match or 0 if
+ * none.
+ */
+NODISCARD
+static size_t match_domain( char const *s, size_t i ) {
+  size_t end = 0;
+  for (;;) {
+    //
+    // Every host label must be followed by a '.' and so must span all the
+    // characters up to it.
+    //
+    size_t  label_len = 0;
+    bool    last_is_alnum = false;
+    for (;;) {
+      size_t len;
+      char32_t const cp = uri_decode( s + i, &len );
+      bool const is_alnum = uri_is_alnum( cp );
+      if ( !is_alnum && (cp != '-' || label_len == 0) )
+        break;
+      if ( ++label_len > URI_LABEL_LEN_MAX )
+        return end;
+      last_is_alnum = is_alnum;
+      i += len;
+    } // for
+    if ( !last_is_alnum || s[i] != '.' )
+      return end;
+    ++i;
+
+    //
+    // Whatever follows the '.' may be either the top-level domain (that may be
+    // a prefix of it) or the next host label.
+    //
+    size_t tld_end = i;
+    size_t tld_len = 0;
+    for ( ; tld_len < URI_LABEL_LEN_MAX; ++tld_len ) {
+      size_t len;
+      if ( !uri_is_alnum( uri_decode( s + tld_end, &len ) ) )
+        break;
+      tld_end += len;
+    } // for
+    if ( tld_len >= 2 )
+      end = tld_end;
+  } // for
+}
+
+/**
+ * Matches an e-mail address: #WRAP_RE_EMAIL.
+ *
+ * @param s The string to match within.
+ * @param at The index of an `@` within \a s.
+ * @param pstart A pointer to receive the index of the leftmost start of the
+ * match.
+ * @return Returns the index one past the end of the longest match or 0 if
+ * none.
+ */
+NODISCARD
+static size_t match_email( char const *s, size_t at, size_t *pstart ) {
+  size_t const end = match_domain( s, at + 1 );
+  if ( end == 0 )
+    return 0;
+
+  //
+  // The local-part can start at any of its atext characters, so the leftmost
+  // start is the first one in the run of atext and '.' characters before the
+  // '@' -- but the character just before the '@' must be atext.
+  //
+  char const *local = NULL;
+  for ( char const *p = s + at; p > s; ) {
+    char const *const prev = utf8_rsync( s, p - 1 );
+    if ( prev == NULL )
+      break;
+    char32_t const cp = utf8_decode( prev );
+    if ( cp == '.' ) {
+      if ( local == NULL )
+        return 0;
+    }
+    else if ( uri_is_char( cp, URI_CC_ATEXT ) ) {
+      local = prev;
+    }
+    else {
+      break;
+    }
+    p = prev;
+  } // for
+  if ( local == NULL )
+    return 0;
+
+  size_t const start = STATIC_CAST( size_t, local - s );
+  *pstart = start - uri_word_before( s, start, "mailto:" );
+  return end;
+}
+
+/**
+ * Gets the index of the first possible start of an e-mail address that is at
+ * the beginning of a word.
+ *
+ * @param s The string to check within.
+ * @param start The index of the leftmost start of the e-mail address as
+ * returned by match_email().
+ * @param at The index of the `@` of the e-mail address.
+ * @param pstart A pointer to receive said index.
+ * @return Returns `true` only if there is such a start.
+ */
+NODISCARD
+static bool match_email_word_begin( char const *s, size_t start, size_t at,
+                                    size_t *pstart ) {
+  if ( utf8_is_word_begin( s, s + start ) ) {
+    *pstart = start;
+    return true;
+  }
+  if ( strncmp( s + start, "mailto:", 7 ) == 0 )
+    start += 7;
+  //
+  // Any atext character in the local-part can start it, so any one that's at
+  // the beginning of a word will do.
+  //
+  for ( size_t i = start; i < at; i += utf8_len( s[i] ) ) {
+    if ( s[i] != '.' && utf8_is_word_begin( s, s + i ) ) {
+      *pstart = i;
+      return true;
+    }
+  } // for
+  return false;
+}
+
+/**
+ * Matches a host and optional port: `RE_HOSTPORT`, optionally preceded by a
+ * user: `(RE_USER@)?`.
+ *
+ * @param s The string to match within.
+ * @param i The index into \a s to start.
+ * @return Returns the index one past the end of the longest match or 0 if
+ * none.
+ */
+NODISCARD
+static size_t match_hostport( char const *s, size_t i ) {
+  //
+  // Since all host characters are also user characters, if there's a user and
+  // the host after it matches, that match is necessarily the longer one.
+  //
+  size_t const user_end = match_chars( s, i, URI_CC_USER );
+  size_t end = 0;
+  if ( user_end > i && s[ user_end ] == '@' )
+    end = match_domain( s, user_end + 1 );
+  if ( end == 0 && (end = match_domain( s, i )) == 0 )
+    return 0;
+
+  if ( s[ end ] == ':' && s[ end + 1 ] >= '1' && s[ end + 1 ] <= '9' &&
+       uri_is_digit( s[ end + 2 ] ) ) {
+    size_t port_len = 2;
+    while ( port_len < URI_PORT_LEN_MAX &&
+            uri_is_digit( s[ end + 1 + port_len ] ) ) {
+      ++port_len;
+    } // while
+    end += 1/*:*/ + port_len;
+  }
+  return end;
+}
+
+/**
+ * Matches a file, FTP, or HTTP URI: #WRAP_RE_FILE_URI, #WRAP_RE_FTP_URI, or
+ * #WRAP_RE_HTTP_URI.
+ *
+ * @param s The string to match within.
+ * @param colon The index of a `:` within \a s.
+ * @param pstart A pointer to receive the index of the start of the match.
+ * @return Returns the index one past the end of the longest match or 0 if
+ * none.
+ */
+NODISCARD
+static size_t match_uri( char const *s, size_t colon, size_t *pstart ) {
+  size_t scheme_len = uri_word_before( s, colon, "file" );
+  if ( scheme_len != 0 ) {
+    //
+    // Since all authority characters are also path characters, the longest
+    // match is always just a path.
+    //
+    if ( s[ colon + 1 ] != '/' )
+      return 0;
+    *pstart = colon - scheme_len;
+    return match_chars( s, colon + 2, URI_CC_PCHAR );
+  }
+
+  bool is_http = false;
+  if ( (scheme_len = uri_word_before( s, colon, "ftp" )) == 0 ) {
+    if ( (scheme_len = uri_word_before( s, colon, "http" )) == 0 &&
+         (scheme_len = uri_word_before( s, colon, "https" )) == 0 ) {
+      return 0;
+    }
+    is_http = true;
+  }
+  *pstart = colon - scheme_len;
+
+  if ( s[ colon + 1 ] != '/' || s[ colon + 2 ] != '/' )
+    return 0;
+  size_t end = match_hostport( s, colon + 3 );
+  if ( end == 0 )
+    return 0;
+
+  if ( s[ end ] == '/' )
+    end = match_chars( s, end + 1, URI_CC_PCHAR );
+  if ( is_http ) {
+    if ( s[ end ] == '?' )
+      end = match_chars( s, end + 1, URI_CC_QF );
+    if ( s[ end ] == '#' )
+      end = match_chars( s, end + 1, URI_CC_QF );
+  }
+  return end;
+}
+
+/**
+ * Finds the first e-mail address or file, FTP, or HTTP URI in \a s.
+ *
+ * @param s The null-terminated UTF-8 string to search.
+ * @param offset The offset into \a s to start.
+ * @param skip_non_word If `true`, skips a match that's not at the beginning of
+ * a word and keeps looking; if `false`, stops.
+ * @param range A pointer to an array of size 2 to receive the match, if any.
+ * @return Returns `true` only if there was a match.
+ */
+NODISCARD
+static bool uri_search( char const *s, size_t offset, bool skip_non_word,
+                        size_t *range ) {
+  assert( s != NULL );
+  char const *const so = s + offset;
+
+  //
+  // Every e-mail address contains an '@' and every URI a ':' and, because
+  // neither can be in an e-mail local-part nor a URI scheme, the first of them
+  // that's part of a match is part of the leftmost match.
+  //
+  for ( char const *p = so; (p = strpbrk( p, "@:" )) != NULL; ++p ) {
+    size_t const i = STATIC_CAST( size_t, p - so );
+    size_t start = 0;
+    size_t const end = *p == '@' ?
+      match_email( so, i, &start ) : match_uri( so, i, &start );
+    if ( end == 0 )
+      continue;
+    if ( !utf8_is_word_begin( so, so + start ) ) {
+      if ( !skip_non_word )
+        return false;
+      if ( *p != '@' || !match_email_word_begin( so, start, i, &start ) )
+        continue;
+    }
+    if ( range != NULL ) {
+      range[0] = start + offset;
+      range[1] = end + offset;
+    }
+    return true;
+  } // for
+
+  return false;
+}
+
+////////// extern functions ///////////////////////////////////////////////////
+
+bool uri_find( char const *s, size_t offset, size_t *range ) {
+  return uri_search( s, offset, /*skip_non_word=*/true, range );
+}
+
+bool uri_match( char const *s, size_t offset, size_t *range ) {
+  return uri_search( s, offset, /*skip_non_word=*/false, range );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,89 @@
+/*
+**      wrap -- text reformatter
+**      src/uri.h
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef wrap_uri_H
+#define wrap_uri_H
+
+/**
+ * @file
+ * Declares functions for finding e-mail addresses and URIs in text.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+
+/// @cond DOXYGEN_IGNORE
+
+// standard
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+
+/// @endcond
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Finds the first e-mail address or file, FTP, or HTTP URI in \a s that is at
+ * the beginning of a word.
+ *
+ * @remarks Unlike uri_match(), a match that's not at the beginning of a word
+ * doesn't stop the search: it's skipped (or, for an e-mail address, started
+ * later within its local-part) and the search continues after it.  Hence
+ * calling this repeatedly with \a offset set to the end of the previous match
+ * finds every match in \a s in a single left-to-right scan.
+ *
+ * @param s The null-terminated UTF-8 string to search.
+ * @param offset The offset into \a s to start.
+ * @param range A pointer to an array of size 2 to receive the beginning
+ * position and one past the end position of the match -- set only if not NULL
+ * and there was a match.
+ * @return Returns `true` only if there was a match.
+ *
+ * @sa uri_match()
+ */
+NODISCARD
+bool uri_find( char const *s, size_t offset, size_t *range );
+
+/**
+ * Finds the first e-mail address or file, FTP, or HTTP URI in \a s.
+ *
+ * @remarks This is a hand-written scanner that matches exactly what #WRAP_RE
+ * matches via regex_match(), i.e., the leftmost-longest match that must also
+ * be at the beginning of a word, but without the overhead of a general
+ * regular expression engine.  It looks only at the `@` and `:` characters in
+ * \a s and the characters around them.
+ *
+ * @param s The null-terminated UTF-8 string to search.
+ * @param offset The offset into \a s to start.
+ * @param range A pointer to an array of size 2 to receive the beginning
+ * position and one past the end position of the match -- set only if not NULL
+ * and there was a match.
+ * @return Returns `true` only if there was a match.
+ *
+ * @sa regex_match()
+ * @sa uri_find()
+ */
+NODISCARD
+bool uri_match( char const *s, size_t offset, size_t *range );
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* wrap_uri_H */
+/* vim:set et sw=2 ts=2: */
@@ -34,6 +34,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <langinfo.h>                   /* for nl_langinfo(3) */
 #include <locale.h>
 #ifndef NDEBUG
 #include <signal.h>                     /* for raise(3) */
@@ -56,6 +57,7 @@
 #   include <ncurses.h>
 # endif
 # include <term.h>                      /* for setupterm(3) */
+# include <sys/ioctl.h>                 /* for ioctl(2) */
 #endif /* WITH_WIDTH_TERM */
 
 /// @endcond
@@ -153,30 +155,6 @@ void fcopy( FILE *ffrom, FILE *fto ) {
   FERROR( ffrom );
 }
 
-char* fgetsz( char *buf, size_t *size, FILE *ffrom ) {
-  assert( buf != NULL );
-  assert( size != NULL );
-  assert( ffrom != NULL );
-  //
-  // Based on the implementation given in:
-  //
-  //  + Brian W. Kernighan and Dennis M. Ritchie: "The C Programming Language,"
-  //    2nd ed., section 7.7 "Line Input and Output," Prentice Hall, 1988, p.
-  //    134.
-  //
-  int c = 0;
-  char *s = buf;
-
-  for ( size_t n = *size; n > 0 && (c = getc( ffrom )) != EOF; --n )
-    if ( (*s++ = STATIC_CAST( char, c )) == '\n' )
-      break;
-
-  *s = '\0';
-  *size = STATIC_CAST( size_t, s - buf );
-
-  return c == EOF && *size == 0 ? NULL : buf;
-}
-
 void* free_later( void *p ) {
   assert( p != NULL );
   free_node_t *const new_node = MALLOC( free_node_t, 1 );
@@ -208,21 +186,43 @@ unsigned get_term_columns( void ) {
     char        reason_buf[ 128 ];
     char const *reason = NULL;
 
-    char const *const term = getenv( "TERM" );
-    if ( unlikely( term == NULL ) ) {
-      reason = "TERM environment variable not set";
-      goto error;
+    //
+    // COLUMNS, if set, takes precedence (as it does for curses).
+    //
+    char const *const env_cols = getenv( "COLUMNS" );
+    if ( env_cols != NULL && is_digits( env_cols ) ) {
+      cols = STATIC_CAST( unsigned, strtoul( env_cols, NULL, 10 ) );
+      if ( cols > 0 )
+        goto done;
     }
 
     char const *const cterm_path = ctermid( NULL );
     if ( unlikely( cterm_path == NULL || *cterm_path == '\0' ) ) {
       reason = "ctermid(3) failed to get controlling terminal";
-      goto error;
+      goto done;
     }
 
     if ( unlikely( (cterm_fd = open( cterm_path, O_RDWR )) == -1 ) ) {
       reason = STRERROR();
-      goto error;
+      goto done;
+    }
+
+#ifdef TIOCGWINSZ
+    //
+    // Asking the terminal directly is much cheaper than initializing curses
+    // that has to find and read the terminfo database.
+    //
+    struct winsize ws;
+    if ( ioctl( cterm_fd, TIOCGWINSZ, &ws ) == 0 && ws.ws_col > 0 ) {
+      cols = ws.ws_col;
+      goto done;
+    }
+#endif /* TIOCGWINSZ */
+
+    char const *const term = getenv( "TERM" );
+    if ( unlikely( term == NULL ) ) {
+      reason = "TERM environment variable not set";
+      goto done;
     }
 
     int sut_err;
@@ -247,7 +247,7 @@ unsigned get_term_columns( void ) {
             "setupterm(3) returned error code %d", sut_err
           );
       } // switch
-      goto error;
+      goto done;
     }
 
     int const ti_cols = tigetnum( CONST_CAST( char*, "cols" ) );
@@ -256,12 +256,12 @@ unsigned get_term_columns( void ) {
         reason_buf, sizeof reason_buf,
         "tigetnum(\"cols\") returned error code %d", ti_cols
       );
-      goto error;
+      goto done;
     }
 
     cols = STATIC_CAST( unsigned, ti_cols );
 
-error:
+done:
     if ( likely( cterm_fd != -1 ) )
       close( cterm_fd );
     if ( unlikely( reason != NULL ) ) {
@@ -276,7 +276,6 @@ error:
 }
 #endif /* WITH_WIDTH_TERM */
 
-#ifndef NDEBUG
 bool is_affirmative( char const *s ) {
   static char const *const AFFIRMATIVES[] = {
     "1",
@@ -288,7 +287,6 @@ bool is_affirmative( char const *s ) {
   };
   return is_any( s, AFFIRMATIVES );
 }
-#endif /* NDEBUG */
 
 bool is_any( char const *s, char const *const matches[const static 2] ) {
   if ( s != NULL ) {
@@ -312,9 +310,35 @@ void setlocale_utf8( void ) {
     "C.UTF-8",      "C.UTF8",
     NULL
   };
+  static char const *const UTF8_CODESETS[] = { "UTF-8", "UTF8", NULL };
+  static bool is_set;
+
+  if ( is_set )
+    return;
+
+  //
+  // The user's own locale is very likely UTF-8 already: if so, use it since
+  // that's a lot cheaper than probing for a locale that is.
+  //
+  char const *const env_loc = setlocale( LC_CTYPE, "" );
+  if ( env_loc != NULL && is_any( nl_langinfo( CODESET ), UTF8_CODESETS ) ) {
+    char *const loc = check_strdup( env_loc );
+    is_set = setlocale( LC_COLLATE, loc ) != NULL;
+    free( loc );
+    if ( is_set )
+      return;
+  }
+
   for ( char const *const *loc = UTF8_LOCALES; *loc != NULL; ++loc ) {
     if ( setlocale( LC_COLLATE, *loc ) != NULL &&
          setlocale( LC_CTYPE, *loc ) != NULL ) {
+      //
+      // Cache the locale in the environment so child processes, e.g.,
+      // wrap(1) exec'd by wrapc(1), find it on their first try.
+      //
+      if ( getenv( "LC_ALL" ) == NULL )
+        PJL_DISCARD_RV( setenv( "LC_CTYPE", *loc, /*overwrite=*/1 ) );
+      is_set = true;
       return;
     }
   } // for
@@ -336,6 +360,16 @@ void split_tws( char buf[const], size_t buf_len, char tws[const] ) {
   buf[ tnws_len ] = '\0';
 }
 
+char* str_reserve( char **ps, size_t *pcap, size_t size ) {
+  assert( ps != NULL );
+  assert( pcap != NULL );
+  if ( size > *pcap ) {
+    *pcap = *pcap * 2 < size ? size : *pcap * 2;
+    REALLOC( *ps, char, *pcap );
+  }
+  return *ps;
+}
+
 size_t strcpy_len( char *dst, char const *src ) {
   assert( dst != NULL );
   assert( src != NULL );
@@ -688,20 +688,6 @@ _Noreturn void fatal_error( int status, char const *format, ... );
  */
 void fcopy( FILE *ffrom, FILE *fto );
 
-/**
- * Gets a newline-terminated line from \a ffrom reading at most one fewer
- * characters than that given by \a size.
- *
- * @param buf A pointer to the buffer to receive the line.
- * @param size A pointer to the capacity of \a buf.  On return, it is set to
- * the number of characters read.
- * @param ffrom The FILE to read from.
- * @return Returns \a buf if any characters have been read or NULL on either
- * EOF or error.
- */
-NODISCARD
-char* fgetsz( char *buf, size_t *size, FILE *ffrom );
-
 /**
  * Adds a pointer to the head of the free-later-list.
  *
@@ -718,7 +704,9 @@ void free_now( void );
 
 #ifdef WITH_WIDTH_TERM
 /**
- * Gets the number of columns of the terminal.
+ * Gets the number of columns of the terminal: from `COLUMNS`, if set; from
+ * the terminal itself via `ioctl(2)`, if possible; or from the terminfo
+ * database otherwise.
  *
  * @return Returns said number of columns or 0 if it can not be determined.
  */
@@ -726,7 +714,6 @@ NODISCARD
 unsigned get_term_columns( void );
 #endif /* WITH_WIDTH_TERM */
 
-#ifndef NDEBUG
 /**
  * Checks whether \a s is an affirmative value.  An affirmative value is one of
  * 1, t, true, y, or yes, case-insensitive.
@@ -736,7 +723,6 @@ unsigned get_term_columns( void );
  */
 NODISCARD
 bool is_affirmative( char const *s );
-#endif /* NDEBUG */
 
 /**
  * Checks whether \a s is any one of \a matches, case-insensitive.
@@ -816,7 +802,9 @@ bool is_windows_eol( char const buf[const], size_t buf_len ) {
 _Noreturn void perror_exit( int status );
 
 /**
- * Sets the locale for the `LC_COLLATE` and `LC_CTYPE` categories to UTF-8.
+ * Sets the locale for the `LC_COLLATE` and `LC_CTYPE` categories to UTF-8:
+ * to the user's locale, if it's UTF-8; or to the first of several UTF-8
+ * locales that exists otherwise.  Calls after the first do nothing.
  */
 void setlocale_utf8( void );
 
@@ -833,6 +821,20 @@ void setlocale_utf8( void );
  */
 void split_tws( char buf[const], size_t buf_len, char tws[const] );
 
+/**
+ * Ensures a growable string buffer can hold at least \a size characters
+ * (including the terminating null), growing it, if necessary, by at least
+ * doubling its capacity so that appending to it costs amortized constant
+ * time.
+ *
+ * @param ps A pointer to the buffer.  It may point to NULL initially.
+ * @param pcap A pointer to the capacity of \a *ps.
+ * @param size The number of characters needed.
+ * @return Returns \a *ps.
+ */
+PJL_DISCARD
+char* str_reserve( char **ps, size_t *pcap, size_t size );
+
 /**
  * A variant of **strcpy**(3) that returns the number of characters copied.
  *
@@ -25,27 +25,40 @@
 
 // local
 #include "pjl_config.h"                 /* must go first */
-#include "alias.h"
 #include "common.h"
-#include "markdown.h"
+#include "engine.h"
+#include "line_reader.h"
 #include "options.h"
-#include "pattern.h"
-#include "unicode.h"
+#include "stats.h"
+#include "trace.h"
 #include "util.h"
-#include "wregex.h"
 
 /// @cond DOXYGEN_IGNORE
 
 // standard
 #include <assert.h>
-#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>                      /* for open() */
 #include <stdbool.h>
 #include <stddef.h>                     /* for size_t */
 #include <stdio.h>
 #include <stdlib.h>                     /* for exit(), ... */
-#include <string.h>
+#include <string.h>                     /* for strerror() */
 #include <sysexits.h>
-#include <unistd.h>
+#include <unistd.h>                     /* for close(), lseek() */
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif /* HAVE_PTHREAD */
+
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+# define WITH_MMAP                1
+# include <sys/mman.h>                  /* for mmap() */
+# include <sys/stat.h>                  /* for fstat() */
+#endif /* HAVE_MMAP && HAVE_SYS_MMAN_H */
+
+#if defined(HAVE_PTHREAD) && defined(HAVE_OPEN_MEMSTREAM)
+# define WITH_WORKER_THREADS      1
+#endif /* HAVE_PTHREAD && HAVE_OPEN_MEMSTREAM */
 
 /// @endcond
 
@@ -58,117 +71,128 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#define WIPC_DEFER(BUF,SIZE,CODE) WPIC_DEFERF( BUF, SIZE, CODE, "%c", '\n' )
+/// Default size of input after which to look for a paragraph at which to
+/// split a single input into chunks to be wrapped by worker threads.
+#define CHUNK_SIZE_MIN            (1024 * 1024)
+
+/// Multiple of \ref chunk_size_min after which to split input into a chunk
+/// even if no paragraph was found (such a chunk is wrapped sequentially).
+#define CHUNK_SIZE_MAX_MULT       8
 
-#define WIPC_DEFERF(BUF,SIZE,CODE,FORMAT,...) \
-  snprintf( (BUF), (SIZE), ("%c" FORMAT), (CODE), __VA_ARGS__ )
+/// Maximum number of wrapped files (or chunks) per worker thread that may be
+/// waiting to be printed.
+#define JOBS_AHEAD_PER_WORKER     4
 
 /**
- * Hyphenation states.
+ * A memory-mapped input file.
  */
-enum hyphen {                           // H = hyphen-adjacent char
-  HYPHEN_NO,                            ///< Didn't encounter a hyphen.
-  HYPHEN_MAYBE,                         ///< Encountered `H-`.
-  HYPHEN_YES                            ///< Encountered `H-H`.
+struct wrap_map {
+  char const *addr;                     ///< Start of the mapping, if any.
+  size_t      len;                      ///< Length of the mapping.
+  size_t      pos;                      ///< Position of the unread input.
 };
-typedef enum hyphen hyphen_t;
+typedef struct wrap_map wrap_map_t;
 
+#ifdef WITH_WORKER_THREADS
 /**
- * Line indentation type.
+ * A file to be wrapped by a worker thread when given more than one file.
  */
-enum indent {
-  INDENT_NONE,                          ///< No indentation.
-
-  /// Indent only first line of a paragraph.
-  INDENT_LINE,
+struct wrap_job {
+  char       *out_buf;                  ///< Wrapped output.
+  size_t      out_size;                 ///< Size of \ref out_buf.
+  wrap_stats_t stats;                   ///< Counters for `--stats`.
+  int         open_errno;               ///< If not 0, the file couldn't open.
+  bool        is_done;                  ///< Has the file been wrapped?
+};
+typedef struct wrap_job wrap_job_t;
 
-  /// Indent all lines but first of a paragraph.
-  INDENT_HANG
+/**
+ * A chunk of a single input to be wrapped by a worker thread.
+ */
+struct wrap_chunk {
+  char const *in_buf;                   ///< Input to wrap.
+  size_t      in_size;                  ///< Size of \ref in_buf.
+
+  /// The number of consecutive newlines that ended the paragraph just before
+  /// the chunk or 0 if the chunk doesn't start a paragraph.
+  size_t      consec_newlines;
+
+  wrap_ctx_t *ctx;                      ///< Context it was wrapped with, if any.
+  char       *out_buf;                  ///< Wrapped output.
+  size_t      out_size;                 ///< Size of \ref out_buf.
+  bool        is_done;                  ///< Has the chunk been wrapped?
 };
-typedef enum indent indent_t;
+typedef struct wrap_chunk wrap_chunk_t;
+#endif /* WITH_WORKER_THREADS */
 
 // extern variable definitions
 char const         *me;                 // executable name
 
+#ifdef WITH_WORKER_THREADS
 // local variable definitions
-static wregex_t     block_regex;        ///< Compiled from opt_block_regex.
-static size_t       consec_newlines;    ///< Number of consecutive newlines.
-static bool         encountered_nonws;  ///< Encountered a non-whitespace char?
-static hyphen_t     hyphen;             ///< Hyphen state.
-static indent_t     indent = INDENT_LINE;
-static line_buf_t   input_buf;          ///< Input buffer.
-static line_buf_t   ipc_buf;            ///< Deferred IPC message.
-static size_t       ipc_width;          ///< Deferred IPC line width.
-static bool         is_long_line;       ///< Line longer than line_width?
-static bool         is_preformatted;    ///< Passing through preformatted text?
-static size_t       line_width;         ///< Maximum width of a line.
-static size_t       nonws_no_wrap_range[2];
-static wregex_t     nonws_no_wrap_regex;
-static line_buf_t   output_buf;         ///< Output buffer.
-static size_t       output_len;         ///< Number of characters in output_buf.
-static size_t       output_width;       ///< Actual width of output_buf.
-static line_buf_t   proto_buf;          ///< Prototype buffer.
-static line_buf_t   proto_tws;          // prototype trailing whitespace, if any
-static size_t       put_spaces;         ///< Spaces to put between words.
-static bool         was_eos_char;       ///< Prev char an end-of-sentence char?
+static size_t           chunk_size_max; ///< See #CHUNK_SIZE_MAX_MULT.
+static size_t           chunk_size_min; ///< See #CHUNK_SIZE_MIN.
+static wrap_chunk_t    *chunks;         ///< Ring of chunks read.
+static size_t           chunks_cap;     ///< Capacity of \ref chunks.
+static size_t           chunks_len;     ///< Number of chunks read.
+static bool             chunks_eof;     ///< Has all input been read?
+static wrap_ctx_t     **ctx_pool;       ///< Contexts to reuse for chunks.
+static size_t           ctx_pool_len;   ///< Number of \ref ctx_pool.
+static char            *first_line;     ///< First line of single input.
+static size_t           first_line_len; ///< Length of \ref first_line.
+static wrap_map_t       in_map;         ///< Single input, if mapped.
+static pthread_cond_t   jobs_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t  jobs_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t           jobs_next;      ///< Index of next job to do.
+static size_t           jobs_printed;   ///< Number of files printed.
+static wrap_job_t      *jobs;           ///< One per file.
+#endif /* WITH_WORKER_THREADS */
 
 // local functions
+#ifdef WITH_WORKER_THREADS
 NODISCARD
-static char32_t     buf_getcp( char const**, utf8c_t );
+static wrap_ctx_t*  chunk_ctx_get( FILE* );
+
+static void         chunk_ctx_put( wrap_ctx_t* );
 
 NODISCARD
-static size_t       buf_readline( void );
+static bool         chunk_read( wrap_chunk_t*, line_reader_t* );
+
+NODISCARD
+static char*        chunk_read_stream( line_reader_t*, size_t*, size_t* );
+#endif /* WITH_WORKER_THREADS */
 
-static void         delimit_paragraph( void );
 static void         init( int, char const*[] );
 
+#ifdef WITH_WORKER_THREADS
+NODISCARD
+static bool         is_chunkable( int );
+#endif /* WITH_WORKER_THREADS */
+
+static bool         map_file( int, wrap_map_t* );
+
+#ifdef WITH_WORKER_THREADS
 NODISCARD
-static bool         markdown_adjust( void );
+static size_t       para_boundary( char const*, size_t, size_t, size_t* );
+#endif /* WITH_WORKER_THREADS */
 
-static void         markdown_reset( void );
-static void         put_lead_chars( void );
-static void         put_line( size_t, bool );
-static void         put_tabs_spaces( size_t, size_t );
+static void         unmap_file( wrap_map_t* );
 
 _Noreturn
 static void         usage( int );
 
-static void         wipc_parse( char const** );
-static void         wipc_send( char* );
-static void         wrap_cleanup( void );
+#ifdef WITH_WORKER_THREADS
+static void         wrap_chunks( int );
+static void*        wrap_chunks_worker( void* );
+#endif /* WITH_WORKER_THREADS */
 
-////////// inline functions ///////////////////////////////////////////////////
+static void         wrap_files( void );
 
-/**
- * Checks whether the "block" regular expression matches the input buffer.
- *
- * @return Returns `true` only if it does.
- */
-NODISCARD
-static inline bool block_regex_matches( void ) {
-  return  opt_block_regex != NULL &&
-          regex_match( &block_regex, input_buf, 0, NULL );
-}
-
-/**
- * Checks whether \a cp is a paragraph delimiter Unicode character.
- *
- * @param cp The Unicode code-point to check.
- * @return Returns `true` only if \a cp is a paragraph delimiter character.
- */
-NODISCARD
-static inline bool cp_is_para_delim( char32_t cp ) {
-  return  opt_para_delims != NULL && cp_is_ascii( cp ) &&
-          strchr( opt_para_delims, STATIC_CAST( int, cp ) ) != NULL;
-}
+#ifdef WITH_WORKER_THREADS
+static void*        wrap_files_worker( void* );
+#endif /* WITH_WORKER_THREADS */
 
-/**
- * Prints an end-of-line and sends any pending IPC message to **wrapc**(1).
- */
-static inline void put_eol( void ) {
-  PUTS( eol() );
-  wipc_send( ipc_buf );
-}
+static void         wrap_stream( wrap_ctx_t*, int, FILE*, wrap_stats_t* );
 
 ////////// main ///////////////////////////////////////////////////////////////
 
@@ -183,497 +207,195 @@ int main( int argc, char const *argv[] ) {
   wait_for_debugger_attach( "WRAP_DEBUG" );
   init( argc, argv );
 
-  bool        next_line_is_title = opt_title_line;
-  char const *pb = input_buf;           // pointer to current byte
-  utf8c_t     utf8c;                    // current character's UTF-8 byte(s)
-  size_t      wrap_pos = 0;             // position at which we can wrap
-
-  /////////////////////////////////////////////////////////////////////////////
-
-  for ( char32_t cp, cp_prev = '\n';    // current and previous codepoints
-        (cp = buf_getcp( &pb, utf8c )) != CP_EOF; cp_prev = cp ) {
-
-    if ( cp == CP_BYTE_ORDER_MARK || cp == CP_INVALID )
-      continue;
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  HANDLE NEWLINE(s)
-    ///////////////////////////////////////////////////////////////////////////
-
-    if ( cp == '\r' ) {
-      //
-      // The code is simpler if we always strip \r and add it back later (if
-      // opt_eol is EOL_WINDOWS).
-      //
-      continue;
-    }
-
-    if ( cp == '\n' ) {
-      encountered_nonws = false;
-
-      if ( ++consec_newlines >= opt_newlines_delimit ) {
-        //
-        // At least opt_newlines_delimit consecutive newlines: set that the
-        // next line is a title line and delimit the paragraph.
-        //
-        next_line_is_title = opt_title_line;
-        delimit_paragraph();
-        continue;
-      }
-      if ( output_len > 0 && true_clear( &next_line_is_title ) ) {
-        //
-        // The first line of the next paragraph is title line and the buffer
-        // isn't empty (there is a title): print the title.
-        //
-        delimit_paragraph();
-        indent = INDENT_HANG;
-        continue;
-      }
-      if ( was_eos_char ) {
-        if ( opt_eos_delimit ) {
-          //
-          // End-of-sentence characters delimit paragraphs and the previous
-          // character was an end-of-sentence character: delimit the paragraph.
-          //
-          delimit_paragraph();
-        } else {
-          //
-          // We are joining a line after the end of a sentence: force requested
-          // number of spaces.
-          //
-          put_spaces = opt_eos_spaces;
-        }
-        continue;
-      }
-      if ( hyphen == HYPHEN_MAYBE ) {
-        //
-        // We've encountered H-\n meaning that a potentially hyphenated word
-        // ends a line: eat the newline so the word can potentially be rejoined
-        // to the next word when wrapped, e.g.:
-        //
-        //      non-
-        //      whitespace
-        //
-        // can become:
-        //
-        //      non-whitespace
-        //
-        // instead of:
-        //
-        //      non- whitespace
-        //
-        continue;
-      }
-    } else {
-      consec_newlines = 0;
-    }
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  HANDLE WHITESPACE
-    ///////////////////////////////////////////////////////////////////////////
-
-    if ( cp_is_space( cp ) ) {
-      if (  //
-            // We've been handling a "long line" and finally got a whitespace
-            // character at which we can finally wrap: delimit the paragraph.
-            //
-            is_long_line ||
-            //
-            // Leading whitespace characters delimit paragraphs and the
-            // previous character was a newline which means this whitespace
-            // character is at the beginning of a line: delimit the paragraph.
-            //
-            (opt_lead_ws_delimit && cp_prev == '\n') ||
-            //
-            // End-of-sentence characters delimit paragraphs and the previous
-            // character was an end-of-sentence character: delimit the
-            // paragraph.
-            //
-            (opt_eos_delimit && was_eos_char) ||
-            //
-            // The previous character was a paragraph-delimiter character (set
-            // only if opt_para_delims was set): delimit the paragraph.
-            //
-            cp_is_para_delim( cp_prev ) ) {
-        delimit_paragraph();
-      }
-      else if ( hyphen == HYPHEN_MAYBE && !encountered_nonws ) {
-        //
-        // This case is similar to above: we've encountered H-\n meaning that a
-        // potentially hyphenated word ended a line and we've only encountered
-        // leading whitespace on the next line so far: eat the space so the
-        // word can potentially be rejoined to the next word when wrapped.
-        //
-      }
-      else if ( output_len > 0 &&
-                put_spaces < (was_eos_char ? opt_eos_spaces : 1) ) {
-        //
-        // We are not at the beginning of a line: remember to insert 1 space
-        // later and allow opt_eos_spaces after the end of a sentence.
-        //
-        ++put_spaces;
-      }
-      continue;
-    }
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  DISCARD CONTROL CHARACTERS
-    ///////////////////////////////////////////////////////////////////////////
-
-    if ( cp_is_control( cp ) )
-      continue;
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  HANDLE LEADING-PARAGRAPH-DELIMITERS, LEADING-DOT, END-OF-SENTENCE, AND
-    //  PARAGRAPH-DELIMITERS
-    ///////////////////////////////////////////////////////////////////////////
-
-    if ( cp_prev == '\n' ) {
-      if ( opt_lead_dot_ignore && cp == '.' ) {
-        consec_newlines = 0;
-        delimit_paragraph();
-        PUTS( input_buf );              // print the line as-is
-        //
-        // Make state as if line never happened.
-        //
-        PJL_DISCARD_RV( buf_readline() );
-        pb = input_buf;
-        cp = '\n';                      // so cp_prev will become this (again)
-        continue;
-      }
-      if ( block_regex_matches() ) {
-        delimit_paragraph();
-        if ( opt_markdown ) {
-          markdown_init();
-          markdown_reset();
-        }
-      }
-      else if ( hyphen == HYPHEN_MAYBE && !cp_is_hyphen_adjacent( cp ) ) {
-        //
-        // We had encountered H-\n on the previous line meaning that a
-        // potentially hyphenated word ends a line, but the first character on
-        // the next line is not a "hyphen adjacent character" so forget about
-        // hyphenation and put the previously eaten whitespace back.
-        //
-        hyphen = HYPHEN_NO;
-        put_spaces = 1;
-      }
-    }
-
-    was_eos_char = cp_is_eos( cp ) || (was_eos_char && cp_is_eos_ext( cp ));
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  INSERT SPACES
-    ///////////////////////////////////////////////////////////////////////////
-
-    if ( put_spaces > 0 ) {
-      if ( output_len > 0 ) {
-        //
-        // Mark position at a space to perform a wrap if necessary.
-        //
-        wrap_pos = output_len;
-        output_width += put_spaces;
-        do {
-          output_buf[ output_len++ ] = ' ';
-        } while ( --put_spaces > 0 );
-      } else {
-        //
-        // Never put spaces at the beginning of a line.
-        //
-        put_spaces = 0;
-      }
-    }
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  PERFORM INDENTATION
-    ///////////////////////////////////////////////////////////////////////////
-
-    switch ( indent ) {
-      case INDENT_NONE:
-        break;
-      case INDENT_HANG:
-        put_tabs_spaces( opt_hang_tabs, opt_hang_spaces );
-        break;
-      case INDENT_LINE:
-        put_tabs_spaces( opt_indt_tabs, opt_indt_spaces );
-        break;
-    } // switch
-    indent = INDENT_NONE;
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  INSERT NON-SPACE CHARACTER
-    ///////////////////////////////////////////////////////////////////////////
-
-    encountered_nonws = true;
-
-    if ( !opt_no_hyphen ) {
-      size_t const pos = STATIC_CAST( size_t, pb - input_buf );
-      if ( pos >= nonws_no_wrap_range[1] || pos < nonws_no_wrap_range[0] ) {
-        //
-        // We're outside the non-whitespace-no-wrap range.
-        //
-        if ( hyphen == HYPHEN_MAYBE ) {
-          if ( cp_is_hyphen_adjacent( cp ) ) {
-            //
-            // We've encountered H-H meaning that this is definitely a
-            // hyphenated word: set wrap_pos to be here.
-            //
-            hyphen = HYPHEN_YES;
-            wrap_pos = output_len;
-          }
-          else if ( !cp_is_hyphen( cp ) ) {
-            //
-            // We've encountered H-X meaning that this is not a hyphenated
-            // word.
-            //
-            hyphen = HYPHEN_NO;
-          }
-          else {
-            //
-            // We've encountered H-- meaning that this is still potentially a
-            // hyphenated word.
-            //
-          }
-        }
-        else if ( cp_is_hyphen_adjacent( cp_prev ) && cp_is_hyphen( cp ) ) {
-          //
-          // We've encountered H- meaning that this is potentially a
-          // hyphenated word.
-          //
-          hyphen = HYPHEN_MAYBE;
-        }
-      }
-    }
-
-    output_len += utf8_copy_char( output_buf + output_len, utf8c );
-    if ( ++output_width < line_width )
-      continue;                         // haven't exceeded line width yet
-
-    ///////////////////////////////////////////////////////////////////////////
-    //  EXCEEDED LINE WIDTH; PRINT LINE OUT
-    ///////////////////////////////////////////////////////////////////////////
-
-    if ( wrap_pos == 0 ) {
-      //
-      // We've exceeded the line width, but haven't encountered a whitespace
-      // character at which to wrap; therefore, we've got a "long line."
-      //
-      if ( !is_long_line )
-        put_lead_chars();
-      put_line( output_len, /*do_eol=*/false );
-      is_long_line = true;
-      continue;
-    }
-
-    //
-    // A call to put_line() will terminate output_buf with a NULL at wrap_pos
-    // that is ordinarily at a space and so doesn't need to be preserved.
-    // However, when wrapping at a hyphen, it's at the character past the
-    // hyphen that must be preserved in the output so we keep a copy of it to
-    // be restored after the call to put_line().
-    //
-    char const c_past_hyphen = output_buf[ wrap_pos ];
-
-    size_t const prev_output_len = output_len;
-    put_lead_chars();
-    put_line( wrap_pos, /*do_eol=*/true );
-
-    if ( hyphen != HYPHEN_NO ) {
-      //
-      // Per the above comment, put the preserved character back and include it
-      // in the slide-to-the-left (below).
-      //
-      output_buf[ wrap_pos-- ] = c_past_hyphen;
-    }
-
-    put_tabs_spaces( opt_hang_tabs, opt_hang_spaces );
-
-    //
-    // Slide the partial word to the left where we can pick up from where we
-    // left off the next time around.
-    //
-    for ( size_t from_pos = wrap_pos + 1/*null*/;
-          from_pos < prev_output_len; ) {
-      char const *const from = output_buf + from_pos;
-      size_t const len = utf8_len( from[0] );
-      if ( !cp_is_space( utf8_decode( from ) ) ) {
-        utf8_copy_char( output_buf + output_len, from );
-        output_len += len;
-        ++output_width;
-      }
-      from_pos += len;
-    } // for
-
-    hyphen = HYPHEN_NO;
-    is_long_line = false;
-    wrap_pos = 0;
-  } // for
-
-  /////////////////////////////////////////////////////////////////////////////
-
-  FERROR( stdin );
-  if ( output_len > 0 ) {               // print left-over text
-    if ( !is_long_line )
-      put_lead_chars();
-    put_line( output_len, /*do_eol=*/true );
+  if ( opt_files_len > 0 ) {
+    wrap_files();
   }
+#ifdef WITH_WORKER_THREADS
+  else if ( is_chunkable( fileno( stdin ) ) ) {
+    wrap_chunks( fileno( stdin ) );
+  }
+#endif /* WITH_WORKER_THREADS */
+  else {
+    static wrap_ctx_t ctx;
+    wrap_ctx_init( &ctx, stdout );
+    wrap_stream( &ctx, fileno( stdin ), stdout, &wrap_stats );
+    wrap_ctx_free( &ctx );
+  }
+  stats_print( /*is_wrapc=*/false );
   exit( EX_OK );
 }
 
 ////////// local functions ////////////////////////////////////////////////////
 
+#ifdef WITH_WORKER_THREADS
 /**
- * Gets the next character from the input.
+ * Gets a \ref wrap_ctx to wrap a chunk with: one from \ref ctx_pool, if any,
+ * or a new one.
  *
- * @param ppc A pointer to the pointer to character to advance.
- * @return Returns said character or \c EOF.
+ * @param fout The file to write the wrapped text to.
+ * @return Returns said \ref wrap_ctx reset as if by wrap_ctx_reset().
+ *
+ * @sa chunk_ctx_put()
  */
-NODISCARD
-static int buf_getc( char const **ppc ) {
-  assert( ppc != NULL );
-  assert( *ppc != NULL );
-  static bool check_for_nonws_no_wrap_match = true;
-
-  while ( **ppc == '\0' ) {
-read_line:
-    if ( unlikely( buf_readline() == 0 ) )
-      return EOF;
-    *ppc = input_buf;
-    nonws_no_wrap_range[1] = 0;
-    check_for_nonws_no_wrap_match = true;
-    //
-    // When wrapping Markdown, we have to strip leading whitespace from lines
-    // since it interferes with indenting.
-    //
-    if ( !opt_markdown || *SKIP_CHARS( *ppc, WS_STR ) != '\0' )
-      break;
-  } // while
-
-  if ( !opt_no_hyphen && check_for_nonws_no_wrap_match ) {
-    size_t const pos = STATIC_CAST( size_t, *ppc - input_buf );
-    //
-    // If there was a previous non-whitespace-no-wrap range and we're past it,
-    // see if there is another match on the same line.
-    //
-    if ( pos >= nonws_no_wrap_range[1] ) {
-      check_for_nonws_no_wrap_match = regex_match(
-        &nonws_no_wrap_regex, input_buf, pos, nonws_no_wrap_range
-      );
-    }
+static wrap_ctx_t* chunk_ctx_get( FILE *fout ) {
+  wrap_ctx_t *ctx = NULL;
+  pthread_mutex_lock( &jobs_mutex );
+  if ( ctx_pool_len > 0 )
+    ctx = ctx_pool[ --ctx_pool_len ];
+  pthread_mutex_unlock( &jobs_mutex );
+
+  if ( ctx != NULL ) {
+    wrap_ctx_reset( ctx, fout );
+  } else {
+    ctx = MALLOC( wrap_ctx_t, 1 );
+    wrap_ctx_init( ctx, fout );
   }
-
-  int const c = *(*ppc)++;
-
-  if ( !opt_data_link_esc )
-    return c;
-
-  if ( c == WIPC_CODE_HELLO ) {
-    wipc_parse( ppc );
-    goto read_line;
-  }
-
-  if ( is_preformatted ) {
-    PUTS( input_buf );
-    goto read_line;
-  }
-
-  return c;
+  return ctx;
 }
 
 /**
- * Gets bytes comprising the next UTF-8 character and its corresponding Unicode
- * code-point from the input.
+ * Puts a \ref wrap_ctx no longer needed into \ref ctx_pool so it (and all
+ * its memory) can be reused for another chunk.
  *
- * @param ppc A pointer to the pointer to character to advance.
- * @param utf8c The buffer to put the UTF-8 bytes into.
- * @return Returns said code-point or \c CP_EOF.
+ * @param ctx The \ref wrap_ctx to put.
+ *
+ * @sa chunk_ctx_get()
  */
-NODISCARD
-static char32_t buf_getcp( char const **ppc, utf8c_t utf8c ) {
-  int c;
-  if ( unlikely( (c = buf_getc( ppc )) == EOF ) )
-    return CP_EOF;
-  size_t const len = utf8_len( STATIC_CAST( char, c ) );
-  if ( unlikely( len == 0 ) )
-    return CP_INVALID;
-  utf8c[0] = STATIC_CAST( char, c );
-  for ( size_t i = 1; i < len; ++i ) {
-    if ( unlikely( (c = buf_getc( ppc )) == EOF ) )
-      return CP_EOF;
-    if ( unlikely( !utf8_is_cont( STATIC_CAST( char, c ) ) ) )
-      return CP_INVALID;
-    utf8c[i] = STATIC_CAST( char, c );
-  } // for
-
-  return utf8_decode( utf8c );
+static void chunk_ctx_put( wrap_ctx_t *ctx ) {
+  assert( ctx != NULL );
+  pthread_mutex_lock( &jobs_mutex );
+  //
+  // There can never be more contexts than one per chunk in the ring plus the
+  // one for all previous chunks.
+  //
+  assert( ctx_pool_len <= chunks_cap );
+  ctx_pool[ ctx_pool_len++ ] = ctx;
+  pthread_mutex_unlock( &jobs_mutex );
 }
 
 /**
- * Reads the next line of input.  If wrapping Markdown, adjust wrap's settings.
+ * Gets the next chunk of input: at least \ref chunk_size_min bytes (unless
+ * there is less input left) up to the start of a paragraph (or \ref
+ * chunk_size_max bytes if there is none).
  *
- * @return Returns the number of bytes read.
+ * @param chunk The \ref wrap_chunk to get into.
+ * @param lr The \ref line_reader to read from if \ref in_map isn't mapped; if
+ * it is, the chunk is merely the next part of it.
+ * @return Returns `false` only if there was no more input.
  */
-NODISCARD
-static size_t buf_readline( void ) {
-  size_t bytes_read;
-
-  while ( (bytes_read = check_readline( input_buf, stdin )) > 0 ) {
-    if ( !opt_markdown )
-      break;
-    //
-    // We're doing Markdown: we might have to adjust wrap's indent, hang-
-    // indent, and line-width for each Markdown line.
-    //
-    // However, don't pass either IPC lines or any lines while is_preformatted
-    // is true through the Markdown parser.
-    //
-    if ( input_buf[0] == WIPC_CODE_HELLO || is_preformatted )
-      break;
+static bool chunk_read( wrap_chunk_t *chunk, line_reader_t *lr ) {
+  static size_t next_consec_newlines;   // newlines ending the previous chunk
+
+  char const *buf;
+  size_t chunk_size = 0, consec_newlines = 0;
+
+  if ( in_map.addr != NULL ) {
+    buf = in_map.addr + in_map.pos;
+    size_t buf_size = in_map.len - in_map.pos;
+    if ( buf_size > chunk_size_max )
+      buf_size = chunk_size_max;
+    if ( buf_size > chunk_size_min ) {
+      chunk_size =
+        para_boundary( buf, buf_size, chunk_size_min, &consec_newlines );
+    }
+    if ( chunk_size == 0 )
+      chunk_size = buf_size;
+    in_map.pos += chunk_size;
+  } else {
+    buf = chunk_read_stream( lr, &chunk_size, &consec_newlines );
+  }
 
-    if ( markdown_adjust() )
-      break;
-  } // while
+  *chunk = (wrap_chunk_t){
+    .in_buf = buf,
+    .in_size = chunk_size
+  };
+  //
+  // The consecutive newlines found are those that end this chunk, but they
+  // belong to the next chunk.
+  //
+  chunk->consec_newlines = next_consec_newlines;
+  next_consec_newlines = consec_newlines;
 
-#ifdef DEBUG_MARKDOWN
-  if ( bytes_read == 0 )
-    MD_DEBUG( "====================\n" );
-#endif /* DEBUG_MARKDOWN */
-  return bytes_read;
+  if ( chunk_size == 0 ) {
+    if ( in_map.addr == NULL )
+      FREE( buf );
+    return false;
+  }
+  return true;
 }
 
 /**
- * Delimits a paragraph.
+ * Reads the next chunk of input from a \ref line_reader.
+ *
+ * @param lr The \ref line_reader to read from.
+ * @param chunk_size A pointer to receive the size of the chunk.
+ * @param consec_newlines A pointer to receive the number of consecutive
+ * newlines that end the chunk, if it ends at a paragraph.
+ * @return Returns a pointer to the chunk that must be freed.
+ *
+ * @sa chunk_read()
  */
-static void delimit_paragraph( void ) {
-  if ( output_len > 0 ) {
-    //
-    // Print what's in the buffer before delimiting the paragraph.  If we've
-    // been handling a "long line," it's now finally ended; otherwise, print
-    // the leading characters.
-    //
-    if ( !true_clear( &is_long_line ) )
-      put_lead_chars();
-    put_line( output_len, /*do_eol=*/true );
-  } else if ( is_long_line ) {
-    put_eol();                          // delimit the "long line"
-  }
-
-  encountered_nonws = false;
-  hyphen = HYPHEN_NO;
-  indent = opt_markdown ? INDENT_NONE : INDENT_LINE;
-  put_spaces = 0;
-  was_eos_char = false;
+static char* chunk_read_stream( line_reader_t *lr, size_t *chunk_size,
+                                size_t *consec_newlines ) {
+  static char  *carry_buf;              // input read past the previous chunk
+  static size_t carry_size;
+  static bool   is_eof;
+
+  size_t buf_cap = chunk_size_min * 2;
+  if ( buf_cap < carry_size )
+    buf_cap = carry_size;
+  char *buf = MALLOC( char, buf_cap );
+  size_t buf_size = carry_size;
+  if ( carry_size > 0 )
+    memcpy( buf, carry_buf, carry_size );
+  free( carry_buf );
+  carry_buf = NULL;
+  carry_size = 0;
+
+  size_t scan_from = chunk_size_min;
+  for (;;) {
+    if ( buf_size > scan_from ) {
+      *chunk_size = para_boundary( buf, buf_size, scan_from, consec_newlines );
+      if ( *chunk_size > 0 )
+        break;
+      if ( buf_size >= chunk_size_max ) {
+        *chunk_size = buf_size;
+        break;
+      }
+      scan_from = buf_size;
+    }
+    if ( is_eof ) {
+      *chunk_size = buf_size;
+      break;
+    }
+    size_t n;
+    char const *const read_buf = line_reader_read( lr, &n );
+    if ( read_buf == NULL ) {
+      is_eof = true;
+      continue;
+    }
+    if ( buf_cap - buf_size < n ) {
+      do {
+        buf_cap *= 2;
+      } while ( buf_cap - buf_size < n );
+      REALLOC( buf, char, buf_cap );
+    }
+    memcpy( buf + buf_size, read_buf, n );
+    buf_size += n;
+  } // for
 
-  if ( consec_newlines == 2 ||
-      (consec_newlines > 2 && opt_newlines_delimit == 1) ) {
-    put_lead_chars();
-    put_eol();
+  if ( *chunk_size < buf_size ) {
+    carry_size = buf_size - *chunk_size;
+    carry_buf = MALLOC( char, carry_size );
+    memcpy( carry_buf, buf + *chunk_size, carry_size );
   }
+  return buf;
 }
+#endif /* WITH_WORKER_THREADS */
 
 /**
  * Sets-up clean-up, parses command-line options, reads the conf. file, sets-up
- * I/O, and probes the input for end-of-line type.
+ * I/O, and initializes the wrap engine.
  *
  * @param argc The number of command-line arguments from main().
  * @param argv The command-line arguments from main().
@@ -681,284 +403,147 @@ static void delimit_paragraph( void ) {
 static void init( int argc, char const *argv[] ) {
   ASSERT_RUN_ONCE();
   ATEXIT( common_cleanup );
-  ATEXIT( wrap_cleanup );
 
   options_init( argc, argv, usage );
+  stats_init();
+  TRACE_INIT();
   setlocale_utf8();
+  wrap_engine_init();
 
-  if ( opt_markdown ) {
-    markdown_init();
-    opt_tab_spaces = MD_TAB_SPACES;
-  }
-
-  int const temp_width = STATIC_CAST( int, opt_line_width ) -
-    STATIC_CAST( int,
-      2 * (opt_mirror_tabs * opt_tab_spaces + opt_mirror_spaces) +
-      opt_lead_tabs * opt_tab_spaces + opt_lead_spaces
-    );
-
-  if ( temp_width < LINE_WIDTH_MINIMUM ) {
-    fatal_error( EX_USAGE,
-      "line-width (%d) is too small (<%d)\n",
-      temp_width, LINE_WIDTH_MINIMUM
-    );
-  }
-  opt_line_width = line_width = STATIC_CAST( size_t, temp_width );
-
-  opt_lead_tabs   += opt_mirror_tabs;
-  opt_lead_spaces += opt_mirror_spaces;
-
-  if ( !opt_no_hyphen ) {
-    int const regex_err_code = regex_compile( &nonws_no_wrap_regex, WRAP_RE );
-    if ( regex_err_code != 0 ) {
-      fatal_error( EX_SOFTWARE,
-        "internal regular expression error (%d): %s\n",
-        regex_err_code, regex_error( &nonws_no_wrap_regex, regex_err_code )
-      );
-    }
-  }
-
-  if ( opt_block_regex != NULL ) {
-    if ( opt_block_regex[0] != '^' ) {
-      char *const temp =
-        free_later( MALLOC( char, strlen( opt_block_regex ) + 1/*\0*/ ) );
-      temp[0] = '^';
-      strcpy( temp + 1, opt_block_regex );
-      opt_block_regex = temp;
-    }
-    int const regex_err_code = regex_compile( &block_regex, opt_block_regex );
-    if ( regex_err_code != 0 ) {
-      fatal_error( EX_USAGE,
-        "\"%s\": regular expression error (%d): %s\n",
-        opt_block_regex, regex_err_code,
-        regex_error( &block_regex, regex_err_code )
-      );
-    }
-  }
-
-  size_t const bytes_read = buf_readline();
-  if ( bytes_read == 0 )
-    exit( EX_OK );
-
-  if ( opt_eol == EOL_INPUT ) {
-    //
-    // We're supposed to use the same end-of-lines as the input, but we can't
-    // just wait until we read a \r as part of the normal character-at-a-time
-    // input stream to know it's using Windows end-of-lines because if the
-    // first line is a long line, we'll need to wrap it (by emitting a newline)
-    // before we get to the end of the line and read the \r.
-    //
-    // Therefore, we have to read only the first line in its entirety and peek
-    // ahead to see if it ends with \r\n.
-    //
-    opt_eol = is_windows_eol( input_buf, bytes_read ) ? EOL_WINDOWS : EOL_UNIX;
-  }
-
+#ifdef WITH_WORKER_THREADS
+  chunk_size_min = CHUNK_SIZE_MIN;
+#ifndef NDEBUG
   //
-  // Copy the prototype and calculate its width.
+  // Allow tests to split small inputs into many chunks.
   //
-  if ( opt_lead_string != NULL || opt_prototype ) {
-    size_t proto_len = 0;
-    size_t proto_width = 0;
-    for ( char const *s = opt_lead_string != NULL ? opt_lead_string : input_buf;
-          *s != '\0';
-          ++s, ++proto_len ) {
-      if ( opt_prototype && !is_space( *s ) )
-        break;
-      if ( proto_len == sizeof proto_buf - 1 )
-        break;
-      proto_buf[ proto_len ] = *s;
-      proto_width += *s == '\t' ?
-        (opt_tab_spaces - proto_len % opt_tab_spaces) : 1;
-    } // for
-    line_width = opt_line_width - proto_width;
-    if ( opt_lead_string != NULL ) {
-      //
-      // Split off the trailing whitespace (tws) from the prototype so that if
-      // we read a line that's empty, we won't emit trailing whitespace when we
-      // prepend the prototype. For example, given:
-      //
-      //      # foo
-      //      #
-      //      # bar
-      //
-      // and a prototype of "# ", if we didn't split off trailing whitespace,
-      // then when we wrapped the text above, the second line would become "# "
-      // containing a trailing whitespace.
-      //
-      split_tws( proto_buf, proto_len, proto_tws );
-    }
+  char const *const size_min = getenv( "WRAP_CHUNK_SIZE_MIN" );
+  if ( size_min != NULL ) {
+    unsigned const n = check_atou( size_min );
+    if ( n > 0 )
+      chunk_size_min = n;
   }
+#endif /* NDEBUG */
+  chunk_size_max = CHUNK_SIZE_MAX_MULT * chunk_size_min;
+#endif /* WITH_WORKER_THREADS */
 }
 
+#ifdef WITH_WORKER_THREADS
 /**
- * Adjusts wrap's indent, hang-indent, and line-width for each Markdown line.
+ * Checks whether \a fd should be wrapped by wrap_chunks().  It should be only
+ * if the input can be read ahead without making an interactive user wait for
+ * output, i.e., neither \a fd nor standard output is a terminal and either
+ * \a fd is a regular file or \ref opt_jobs was given explicitly.
  *
- * @return Returns `true` if we're to proceed or \c false if another line
- * should be read.
- */
-NODISCARD
-static bool markdown_adjust( void ) {
-  static md_line_t  prev_line_type;
-  static md_seq_t   prev_seq_num = MD_SEQ_NUM_INIT;
-
-  md_state_t const *const md = markdown_parse( input_buf );
-  MD_DEBUG(
-    "T=%c N=%2u D=%u L=%u H=%u|%s",
-    STATIC_CAST( char, md->line_type ), md->seq_num, md->depth,
-    md->indent_left, md->indent_hang, input_buf
-  );
-
-  if ( prev_line_type != md->line_type ) {
-    switch ( prev_line_type ) {
-      case MD_CODE:
-      case MD_HEADER_ATX:
-      case MD_HR:
-      case MD_HTML_ABBR:
-      case MD_HTML_BLOCK:
-      case MD_LINK_LABEL:
-      case MD_TABLE:
-        consec_newlines = 0;
-        if ( is_blank_line( input_buf ) ) {
-          //
-          // Prevent blank lines immediately after these Markdown line types
-          // from being swallowed by wrap by just printing them directly.
-          //
-          PUTS( input_buf );
-        }
-        break;
-      case MD_DL:
-      case MD_FOOTNOTE_DEF:
-      case MD_HEADER_LINE:
-      case MD_NONE:
-      case MD_OL:
-      case MD_TEXT:
-      case MD_UL:
-        // nothing to do
-        break;
-    } // switch
-
-    if ( md->line_type == MD_FOOTNOTE_DEF && !md->footnote_def_has_text ) {
-      //
-      // For a footnote definition line that does not have text on the same
-      // line:
-      //
-      //      [^1]:
-      //          Like this.
-      //
-      // print the marker line as-is "behind wrap's back" so it won't be
-      // wrapped.
-      //
-      PUTS( input_buf );
-      input_buf[0] = '\0';
-    }
-
-    prev_line_type = md->line_type;
-  }
-
-  switch ( md->line_type ) {
-    case MD_CODE:
-    case MD_HEADER_ATX:
-    case MD_HEADER_LINE:
-    case MD_HR:
-    case MD_HTML_ABBR:
-    case MD_HTML_BLOCK:
-    case MD_LINK_LABEL:
-    case MD_TABLE:
-      //
-      // Flush output_buf and print the Markdown line as-is "behind wrap's
-      // back" because these line types are never wrapped.
-      //
-      put_lead_chars();
-      put_line( output_len, /*do_eol=*/true );
-      PUTS( input_buf );
-      return false;
-
-    case MD_DL:
-    case MD_FOOTNOTE_DEF:
-    case MD_OL:
-    case MD_UL:
-      if ( md->seq_num > prev_seq_num ) {
-        //
-        // We're changing line types: flush output_buf.
-        //
-        put_lead_chars();
-        put_line( output_len, /*do_eol=*/true );
-        prev_seq_num = md->seq_num;
-      }
-      else if ( output_len == 0 && !is_blank_line( input_buf ) ) {
-        //
-        // Same line type, but new line: hang indent.
-        //
-        put_tabs_spaces( /*tabs=*/0, md->indent_hang );
-      }
-      line_width = opt_line_width - md->indent_left;
-      opt_lead_spaces = md->indent_left;
-      opt_hang_spaces = md->indent_hang;
-      return true;
-
-    case MD_NONE:
-    case MD_TEXT:
-      markdown_reset();
-      return true;
-  } // switch
-
-  UNEXPECTED_INT_VALUE( md->line_type );
-}
-
-/**
- * Resets variables affected by the Markdown parser.
+ * @param fd The file descriptor to check.  If it's mapped, it's mapped into
+ * \ref in_map.
+ * @return Returns `true` only if \a fd should be wrapped by wrap_chunks().
  */
-static void markdown_reset( void ) {
-  line_width = opt_line_width;
-  opt_hang_spaces = opt_lead_spaces = 0;
+static bool is_chunkable( int fd ) {
+  if ( opt_jobs < 2 || opt_markdown || opt_data_link_esc )
+    return false;
+  if ( isatty( fd ) || isatty( STDOUT_FILENO ) )
+    return false;
+  return map_file( fd, &in_map ) || opt_jobs_given;
 }
+#endif /* WITH_WORKER_THREADS */
 
 /**
- * Prints the leading characters for lines.
+ * Memory-maps the rest of \a fd, if possible.
+ *
+ * @param fd The file descriptor to map.  Only non-empty regular files can be
+ * mapped.
+ * @param map The \ref wrap_map to map \a fd into.  If \a fd can't be mapped,
+ * its \ref wrap_map::addr is set to NULL.
+ * @return Returns `true` only if \a fd was mapped.
+ *
+ * @sa unmap_file()
  */
-static void put_lead_chars( void ) {
-  if ( proto_buf[0] != '\0' ) {
-    PRINTF( "%s%s", proto_buf, output_len > 0 ? proto_tws : "" );
-  }
-  else if ( output_len > 0 ) {
-    for ( size_t i = 0; i < opt_lead_tabs; ++i )
-      PUTC( '\t' );
-    for ( size_t i = 0; i < opt_lead_spaces; ++i )
-      PUTC( ' ' );
-  }
+static bool map_file( int fd, wrap_map_t *map ) {
+  MEM_ZERO( map );
+#ifdef WITH_MMAP
+  struct stat st;
+  if ( fstat( fd, &st ) == -1 || !S_ISREG( st.st_mode ) || st.st_size == 0 )
+    return false;
+  off_t const pos = lseek( fd, 0, SEEK_CUR );
+  if ( pos == -1 || pos > st.st_size )
+    return false;
+  size_t const len = STATIC_CAST( size_t, st.st_size );
+  void *const addr = mmap( NULL, len, PROT_READ, MAP_PRIVATE, fd, 0 );
+  if ( addr == MAP_FAILED )
+    return false;
+#ifdef MADV_SEQUENTIAL
+  (void)madvise( addr, len, MADV_SEQUENTIAL );
+#endif /* MADV_SEQUENTIAL */
+  map->addr = addr;
+  map->len = len;
+  map->pos = STATIC_CAST( size_t, pos );
+  return true;
+#else
+  (void)fd;
+  return false;
+#endif /* WITH_MMAP */
 }
 
+#ifdef WITH_WORKER_THREADS
 /**
- * Prints the current output buffer as a line and resets the output buffer's
- * length.
+ * Finds the first place in \a buf, starting at \a from, at which a line
+ * starts just after a paragraph delimited by at least \ref
+ * opt_newlines_delimit newlines.
  *
- * @param len The length of the output buffer.
- * @param do_eol If `true`, prints and end-of-line afterwards.
+ * @param buf The buffer to search.
+ * @param buf_size The size of \a buf.
+ * @param from The position in \a buf to start searching at.  It must be > 0.
+ * @param consec_newlines A pointer to receive the number of consecutive
+ * newlines that delimited the paragraph.
+ * @return Returns said place or 0 if none.
  */
-static void put_line( size_t len, bool do_eol ) {
-  output_buf[ len ] = '\0';
-  if ( len > 0 ) {
-    PUTS( output_buf );
-    if ( do_eol )
-      put_eol();
-  }
-  output_len = output_width = 0;
+static size_t para_boundary( char const *buf, size_t buf_size, size_t from,
+                             size_t *consec_newlines ) {
+  assert( from > 0 );
+  for ( char const *nl = buf + from - 1, *const end = buf + buf_size;
+        (nl = memchr( nl, '\n', STATIC_CAST( size_t, end - nl ) )) != NULL;
+        ++nl ) {
+    //
+    // A line must start just after the newline and the newline must be the
+    // last of opt_newlines_delimit or more of them with nothing but \r
+    // between them (the same way wrap_line() counts them).
+    //
+    if ( nl + 1 == end )
+      break;
+    if ( nl[1] == '\n' || nl[1] == '\r' )
+      continue;
+    size_t n = 0;
+    for ( size_t i = STATIC_CAST( size_t, nl - buf ) + 1; i-- > 0; ) {
+      if ( buf[i] == '\n' )
+        ++n;
+      else if ( buf[i] != '\r' )
+        break;
+    } // for
+    if ( n >= opt_newlines_delimit ) {
+      *consec_newlines = n;
+      return STATIC_CAST( size_t, nl + 1 - buf );
+    }
+  } // for
+  return 0;
 }
+#endif /* WITH_WORKER_THREADS */
 
 /**
- * Puts \a tabs tabs and \a spaces spaces (in that order) into the output
- * buffer and increments the output width accordingly.
+ * Unmaps a file mapped by map_file(), if it was.
  *
- * @param tabs The number of tabs to put.
- * @param spaces The number of spaces to put.
+ * @param map The \ref wrap_map to unmap.
  */
-static void put_tabs_spaces( size_t tabs, size_t spaces ) {
-  output_width += tabs * opt_tab_spaces + spaces;
-  while ( tabs-- > 0 )
-    output_buf[ output_len++ ] = '\t';
-  while ( spaces-- > 0 )
-    output_buf[ output_len++ ] = ' ';
+static void unmap_file( wrap_map_t *map ) {
+#ifdef WITH_MMAP
+  if ( map->addr != NULL ) {
+    PERROR_EXIT_IF(
+      munmap( CONST_CAST( char*, map->addr ), map->len ) == -1, EX_OSERR
+    );
+    map->addr = NULL;
+  }
+#else
+  (void)map;
+#endif /* WITH_MMAP */
 }
 
 /**
@@ -969,7 +554,7 @@ static void put_tabs_spaces( size_t tabs, size_t spaces ) {
  */
 static void usage( int status ) {
   fprintf( status == EX_OK ? stdout : stderr,
-"usage: " PACKAGE " [options]\n"
+"usage: " PACKAGE " [options] [file...]\n"
 "options:\n"
 "  --alias=NAME           " UOPT(ALIAS)
                           "Use alias from configuration file.\n"
@@ -1001,6 +586,8 @@ static void usage( int status ) {
 "      Indent spaces after tabs for first line of every paragraph.\n"
 "  --indent-tabs=NUM      " UOPT(INDENT_TABS)
                           "Indent tabs for first line of every paragraph.\n"
+"  --jobs=NUM             " UOPT(JOBS)
+                          "Files or parts to wrap at once [default: CPUs].\n"
 "  --lead-spaces=NUM      " UOPT(LEAD_SPACES)
                           "Prepend leading spaces after tabs to every line.\n"
 "  --lead-string=STR      " UOPT(LEAD_STRING)
@@ -1019,16 +606,22 @@ static void usage( int status ) {
                           "Suppress wrapping at hyphen characters.\n"
 "  --no-newlines-delimit  " UOPT(NO_NEWLINES_DELIMIT)
                           "Do not treat newlines as paragraph delimiters.\n"
+"  --optimal              " UOPT(OPTIMAL)
+                          "Minimize raggedness instead of filling greedily.\n"
 "  --output=FILE          " UOPT(OUTPUT)
                           "Write to this file [default: stdout].\n"
 "  --para-chars=STR       " UOPT(PARA_CHARS)
                           "Additional paragraph delimiter characters.\n"
 "  --prototype            " UOPT(PROTOTYPE) "\n"
 "      Treat leading whitespace on first line as prototype.\n"
+"  --stats[=FILE]         " UOPT(STATS)
+                          "Print statistics as JSON [default: stderr].\n"
 "  --tab-spaces=NUM       " UOPT(TAB_SPACES)
                           "Tab-spaces equivalence [default: " STRINGIFY(TAB_SPACES_DEFAULT) "].\n"
 "  --title                " UOPT(TITLE_LINE)
                           "Treat paragraph's first line as title.\n"
+"  --unbuffered           " UOPT(UNBUFFERED)
+                          "Write output after every paragraph.\n"
 "  --version              " UOPT(VERSION)
                           "Print version and exit.\n"
 "  --whitespace-delimit   " UOPT(WHITESPACE_DELIMIT) "\n"
@@ -1042,111 +635,344 @@ PACKAGE_NAME " home page: " PACKAGE_URL "\n"
   exit( status );
 }
 
+#ifdef WITH_WORKER_THREADS
 /**
- * Parses a \ref wipc_code.
+ * Wraps all of \a fd to standard output by splitting it into chunks at
+ * paragraphs and wrapping up to \ref opt_jobs chunks at the same time by
+ * worker threads.
  *
- * @param ppc A pointer to the pointer to character to advance.  It must be
- * positioned at the IPC code after #WIPC_CODE_HELLO.
+ * @remarks Each chunk but the first is wrapped by a \ref wrap_ctx initialized
+ * by wrap_ctx_init_para(), i.e., presuming the state the \ref wrap_ctx that
+ * wrapped all the previous chunks would be in.  If it wouldn't be (e.g., a
+ * paragraph ended in a "long line"), the chunk's output is discarded and the
+ * chunk is wrapped again by that \ref wrap_ctx.  Hence, the output is always
+ * the same as had all of \a fd been wrapped by a single \ref wrap_ctx.
+ *
+ * @param fd The file descriptor to read from.  If it was mapped by
+ * is_chunkable(), it's read from \ref in_map instead.
  */
-static void wipc_parse( char const **ppc ) {
-  assert( ppc != NULL );
-  assert( *ppc != NULL );
-
-  char const c = *(*ppc)++;
-  if ( unlikely( c == '\0' ) )
+static void wrap_chunks( int fd ) {
+  chunks_cap = opt_jobs * JOBS_AHEAD_PER_WORKER;
+  chunks = MALLOC( wrap_chunk_t, chunks_cap );
+
+  line_reader_t lr;
+  line_reader_init( &lr, fd );
+  if ( !chunk_read( &chunks[0], &lr ) ) {
+    unmap_file( &in_map );
+    line_reader_cleanup( &lr );
+    free( chunks );
     return;
+  }
+  chunks_len = 1;
+  ctx_pool = MALLOC( wrap_ctx_t*, chunks_cap + 1 );
 
-  switch ( STATIC_CAST( wipc_code_t, c ) ) {
-    case WIPC_CODE_HELLO:               // shouldn't happen
-      break;
+  wrap_ctx_t *ctx = NULL;               // context for all previous chunks
 
-    case WIPC_CODE_DELIMIT_PARAGRAPH:
-      consec_newlines = 0;
-      delimit_paragraph();
-      WIPC_SEND( stdout, WIPC_CODE_DELIMIT_PARAGRAPH );
-      break;
+  if ( chunks[0].in_size < chunk_size_min ) {
+    //
+    // The input is too small to split: just wrap it.
+    //
+    ctx = chunk_ctx_get( stdout );
+    wrap_ctx_feed( ctx, chunks[0].in_buf, chunks[0].in_size );
+    if ( in_map.addr == NULL )
+      FREE( chunks[0].in_buf );
+    goto finish;
+  }
 
-    case WIPC_CODE_NEW_LEADER:
-      NO_OP;
-      //
-      // We've been told by wrapc (child 1) that the comment characters and/or
-      // leading whitespace has changed: we have to echo it back to the other
-      // wrapc process (parent).
-      //
-      // If an output line has already been started, we have to defer the IPC
-      // until just after the line is sent; otherwise, we must send it
-      // immediately.
-      //
-      char *sep;
-      size_t const new_line_width = strtoul( *ppc, &sep, 10 );
-      if ( output_len > 0 ) {
-        WIPC_DEFERF(
-          ipc_buf, sizeof ipc_buf,
-          WIPC_CODE_NEW_LEADER, "%zu" WIPC_PARAM_SEP "%s",
-          new_line_width, sep + 1
-        );
-        ipc_width = new_line_width;
-      } else {
-        WIPC_SENDF(
-          stdout,
-          WIPC_CODE_NEW_LEADER, "%zu" WIPC_PARAM_SEP "%s",
-          new_line_width, sep + 1
-        );
-        line_width = opt_line_width = new_line_width;
+  char const *const nl = memchr( chunks[0].in_buf, '\n', chunks[0].in_size );
+  first_line_len = nl != NULL ?
+    STATIC_CAST( size_t, nl - chunks[0].in_buf ) + 1 : chunks[0].in_size;
+  first_line = MALLOC( char, first_line_len );
+  memcpy( first_line, chunks[0].in_buf, first_line_len );
+
+  pthread_t *const workers = MALLOC( pthread_t, opt_jobs );
+  for ( size_t i = 0; i < opt_jobs; ++i ) {
+    int const err =
+      pthread_create( &workers[i], NULL, &wrap_chunks_worker, NULL );
+    if ( unlikely( err != 0 ) )
+      fatal_error( EX_OSERR, "can not create thread: %s\n", strerror( err ) );
+  } // for
+
+  wrap_ctx_t presumed;
+  wrap_ctx_init( &presumed, stdout );
+
+  for ( size_t i = 0; i < chunks_len; ++i ) {
+    //
+    // Read ahead as many chunks as will fit so the worker threads always have
+    // chunks to wrap.
+    //
+    while ( !chunks_eof && chunks_len - i < chunks_cap ) {
+      wrap_chunk_t chunk;
+      bool const got_chunk = chunk_read( &chunk, &lr );
+      pthread_mutex_lock( &jobs_mutex );
+      if ( got_chunk )
+        chunks[ chunks_len++ % chunks_cap ] = chunk;
+      else
+        chunks_eof = true;
+      pthread_cond_broadcast( &jobs_cond );
+      pthread_mutex_unlock( &jobs_mutex );
+    } // while
+
+    wrap_chunk_t *const chunk = &chunks[ i % chunks_cap ];
+    pthread_mutex_lock( &jobs_mutex );
+    while ( !chunk->is_done )
+      pthread_cond_wait( &jobs_cond, &jobs_mutex );
+    pthread_mutex_unlock( &jobs_mutex );
+
+    bool is_same_state = ctx == NULL;
+    if ( !is_same_state && chunk->ctx != NULL ) {
+      wrap_ctx_init_para(
+        &presumed, stdout, first_line, first_line_len, chunk->consec_newlines
+      );
+      is_same_state = wrap_ctx_same_state( ctx, &presumed );
+    }
+
+    if ( is_same_state ) {
+      PERROR_EXIT_IF(
+        fwrite( chunk->out_buf, 1, chunk->out_size, stdout ) < chunk->out_size,
+        EX_IOERR
+      );
+      if ( ctx != NULL ) {
+        stats_add( &wrap_stats, &ctx->stats );
+        chunk_ctx_put( ctx );
       }
-      break;
+      ctx = chunk->ctx;
+      ctx->fout = stdout;
+    } else {
+      if ( chunk->ctx != NULL )
+        chunk_ctx_put( chunk->ctx );
+      wrap_ctx_feed( ctx, chunk->in_buf, chunk->in_size );
+    }
+    if ( in_map.addr == NULL )
+      FREE( chunk->in_buf );
+    free( chunk->out_buf );
+  } // for
 
-    case WIPC_CODE_PREFORMATTED_BEGIN:
-      delimit_paragraph();
-      WIPC_SEND( stdout, WIPC_CODE_PREFORMATTED_BEGIN );
-      is_preformatted = true;
-      break;
+  for ( size_t i = 0; i < opt_jobs; ++i )
+    pthread_join( workers[i], NULL );
+  free( workers );
+  free( first_line );
+  wrap_ctx_free( &presumed );
+
+finish:
+  wrap_ctx_finish( ctx );
+  stats_add( &wrap_stats, &ctx->stats );
+  chunk_ctx_put( ctx );
+  while ( ctx_pool_len > 0 ) {
+    ctx = ctx_pool[ --ctx_pool_len ];
+    wrap_ctx_free( ctx );
+    free( ctx );
+  } // while
+  free( ctx_pool );
+  unmap_file( &in_map );
+  line_reader_cleanup( &lr );
+  free( chunks );
+}
 
-    case WIPC_CODE_PREFORMATTED_END:
-      consec_newlines = 1;
-      delimit_paragraph();
-      WIPC_SEND( stdout, WIPC_CODE_PREFORMATTED_END );
-      is_preformatted = false;
+/**
+ * Wraps chunks, one at a time, until there are no more chunks to wrap.  This
+ * is the start routine of each worker thread.
+ *
+ * @param arg Not used.
+ * @return Always returns NULL.
+ */
+static void* wrap_chunks_worker( void *arg ) {
+  (void)arg;
+
+  for (;;) {
+    pthread_mutex_lock( &jobs_mutex );
+    while ( jobs_next == chunks_len && !chunks_eof )
+      pthread_cond_wait( &jobs_cond, &jobs_mutex );
+    if ( jobs_next == chunks_len ) {
+      pthread_mutex_unlock( &jobs_mutex );
       break;
+    }
+    size_t const i = jobs_next++;
+    pthread_mutex_unlock( &jobs_mutex );
+
+    wrap_chunk_t *const chunk = &chunks[ i % chunks_cap ];
+    if ( i == 0 || chunk->consec_newlines > 0 ) {
+      FILE *const fout = open_memstream( &chunk->out_buf, &chunk->out_size );
+      PERROR_EXIT_IF( fout == NULL, EX_OSERR );
+      chunk->ctx = chunk_ctx_get( fout );
+      if ( i > 0 ) {
+        wrap_ctx_init_para(
+          chunk->ctx, fout, first_line, first_line_len,
+          chunk->consec_newlines
+        );
+      }
+      wrap_ctx_feed( chunk->ctx, chunk->in_buf, chunk->in_size );
+      PERROR_EXIT_IF( fclose( fout ) != 0, EX_IOERR );
+    }
 
-    case WIPC_CODE_WRAP_END:
-      //
-      // We've been told by wrapc (child 1) that we've reached the end of the
-      // comment: dump any remaining buffer, propagate the interprocess message
-      // to the other wrapc process (parent), and pass text through verbatim.
-      //
-      consec_newlines = 0;
-      delimit_paragraph();
-      WIPC_SEND( stdout, WIPC_CODE_WRAP_END );
-      fcopy( stdin, stdout );
-      exit( EX_OK );
-  } // switch
+    pthread_mutex_lock( &jobs_mutex );
+    chunk->is_done = true;
+    pthread_cond_broadcast( &jobs_cond );
+    pthread_mutex_unlock( &jobs_mutex );
+  } // for
+
+  return NULL;
 }
+#endif /* WITH_WORKER_THREADS */
 
 /**
- * Sends an already formatted IPC (interprocess communication) message (if not
- * empty) to **wrapc**(1).
+ * Wraps each of \ref opt_files to standard output in the order given.
  *
- * @param msg The message to send.  If sent, the buffer is truncated.
+ * @remarks If \ref opt_jobs is greater than 1, up to that many files are
+ * wrapped at the same time by worker threads each using its own \ref
+ * wrap_ctx; the output of each file is printed once it and all files before
+ * it have been wrapped.
  */
-static void wipc_send( char *msg ) {
-  assert( msg != NULL );
-  if ( msg[0] != '\0' ) {
-    WIPC_SENDF( stdout, /*IPC_code=*/msg[0], "%s", msg + 1 );
-    msg[0] = '\0';
-    if ( ipc_width > 0 ) {
-      line_width = opt_line_width = ipc_width;
-      ipc_width = 0;
-    }
+static void wrap_files( void ) {
+  assert( opt_files_len > 1 );
+
+#ifdef WITH_WORKER_THREADS
+  if ( opt_jobs > 1 ) {
+    size_t const workers_len =
+      opt_jobs < opt_files_len ? opt_jobs : opt_files_len;
+    pthread_t *const workers = MALLOC( pthread_t, workers_len );
+    jobs = MALLOC( wrap_job_t, opt_files_len );
+    memset( jobs, 0, opt_files_len * sizeof *jobs );
+
+    for ( size_t i = 0; i < workers_len; ++i ) {
+      int const err =
+        pthread_create( &workers[i], NULL, &wrap_files_worker, NULL );
+      if ( unlikely( err != 0 ) )
+        fatal_error( EX_OSERR, "can not create thread: %s\n", strerror( err ) );
+    } // for
+
+    for ( size_t i = 0; i < opt_files_len; ++i ) {
+      wrap_job_t *const job = &jobs[i];
+      pthread_mutex_lock( &jobs_mutex );
+      while ( !job->is_done )
+        pthread_cond_wait( &jobs_cond, &jobs_mutex );
+      pthread_mutex_unlock( &jobs_mutex );
+
+      if ( job->open_errno != 0 ) {
+        fatal_error( EX_NOINPUT,
+          "\"%s\": %s\n", opt_files[i], strerror( job->open_errno )
+        );
+      }
+      PERROR_EXIT_IF(
+        fwrite( job->out_buf, 1, job->out_size, stdout ) < job->out_size,
+        EX_IOERR
+      );
+      free( job->out_buf );
+      stats_add( &wrap_stats, &job->stats );
+
+      pthread_mutex_lock( &jobs_mutex );
+      ++jobs_printed;
+      pthread_cond_broadcast( &jobs_cond );
+      pthread_mutex_unlock( &jobs_mutex );
+    } // for
+
+    for ( size_t i = 0; i < workers_len; ++i )
+      pthread_join( workers[i], NULL );
+    free( jobs );
+    free( workers );
+    PERROR_EXIT_IF( fflush( stdout ) != 0, EX_IOERR );
+    return;
   }
+#endif /* WITH_WORKER_THREADS */
+
+  static wrap_ctx_t ctx;
+  wrap_ctx_init( &ctx, stdout );
+  for ( size_t i = 0; i < opt_files_len; ++i ) {
+    int const fd = open( opt_files[i], O_RDONLY );
+    if ( fd == -1 )
+      fatal_error( EX_NOINPUT, "\"%s\": %s\n", opt_files[i], STRERROR() );
+    wrap_stream( &ctx, fd, stdout, &wrap_stats );
+    close( fd );
+  } // for
+  wrap_ctx_free( &ctx );
+}
+
+#ifdef WITH_WORKER_THREADS
+/**
+ * Wraps files, one at a time, until there are no more files to wrap.  This is
+ * the start routine of each worker thread.
+ *
+ * @param arg Not used.
+ * @return Always returns NULL.
+ */
+static void* wrap_files_worker( void *arg ) {
+  (void)arg;
+  wrap_ctx_t *const ctx = MALLOC( wrap_ctx_t, 1 );
+  wrap_ctx_init( ctx, stdout );
+  size_t const max_ahead = opt_jobs * JOBS_AHEAD_PER_WORKER;
+
+  for (;;) {
+    pthread_mutex_lock( &jobs_mutex );
+    //
+    // Don't get too far ahead of the files printed so far so as not to use
+    // too much memory for the output of files that can't be printed yet.
+    //
+    while ( jobs_next < opt_files_len &&
+            jobs_next - jobs_printed >= max_ahead ) {
+      pthread_cond_wait( &jobs_cond, &jobs_mutex );
+    } // while
+    if ( jobs_next == opt_files_len ) {
+      pthread_mutex_unlock( &jobs_mutex );
+      break;
+    }
+    size_t const i = jobs_next++;
+    pthread_mutex_unlock( &jobs_mutex );
+
+    wrap_job_t *const job = &jobs[i];
+    int const fd = open( opt_files[i], O_RDONLY );
+    if ( fd == -1 ) {
+      job->open_errno = errno;
+    } else {
+      FILE *const fout = open_memstream( &job->out_buf, &job->out_size );
+      PERROR_EXIT_IF( fout == NULL, EX_OSERR );
+      wrap_stream( ctx, fd, fout, &job->stats );
+      close( fd );
+      PERROR_EXIT_IF( fclose( fout ) != 0, EX_IOERR );
+    }
+
+    pthread_mutex_lock( &jobs_mutex );
+    job->is_done = true;
+    pthread_cond_broadcast( &jobs_cond );
+    pthread_mutex_unlock( &jobs_mutex );
+  } // for
+
+  wrap_ctx_free( ctx );
+  free( ctx );
+  return NULL;
 }
+#endif /* WITH_WORKER_THREADS */
 
 /**
- * Cleans up wrap data.
+ * Wraps all of \a fd to \a fout.
+ *
+ * @remarks If \a fd is a regular file, it's memory-mapped and wrapped in
+ * place; otherwise (e.g., a pipe or a terminal), it's read via a \ref
+ * line_reader.
+ *
+ * @param ctx The \ref wrap_ctx to use.  It must have been initialized by
+ * wrap_ctx_init(); it's reset by wrap_ctx_reset() so it can be reused for
+ * any number of files.
+ * @param fd The file descriptor to read from.
+ * @param fout The file to write to.
+ * @param stats The \ref wrap_stats to add the counters of \a ctx to.
  */
-static void wrap_cleanup( void ) {
-  regex_free( &block_regex );
-  regex_free( &nonws_no_wrap_regex );
+static void wrap_stream( wrap_ctx_t *ctx, int fd, FILE *fout,
+                         wrap_stats_t *stats ) {
+  wrap_ctx_reset( ctx, fout );
+  wrap_map_t map;
+  if ( map_file( fd, &map ) ) {
+    wrap_ctx_feed( ctx, map.addr + map.pos, map.len - map.pos );
+    unmap_file( &map );
+  } else {
+    line_reader_t lr;
+    line_reader_init( &lr, fd );
+    char const *buf;
+    for ( size_t size; (buf = line_reader_read( &lr, &size )) != NULL; )
+      wrap_ctx_feed( ctx, buf, size );
+    line_reader_cleanup( &lr );
+  }
+  wrap_ctx_finish( ctx );
+  stats_add( stats, &ctx->stats );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
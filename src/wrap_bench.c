@@ -0,0 +1,206 @@
+/*
+**      wrap -- text reformatter
+**      src/wrap_bench.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Measures the end-to-end throughput of **wrap**(1) or **wrapc**(1) on a file
+ * and prints the result as a single line of JSON, e.g.:
+ *
+ *      $ ./wrap_bench -n 5 markdown markdown.md ./wrap -u
+ *      {"tool":"wrap","mode":"markdown","corpus":"markdown",...}
+ *
+ * The command is run once to warm up, then the given number of times; the
+ * median time is used to calculate the throughput.  The 99th percentile time
+ * is also printed which, for tiny inputs, measures startup latency.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "util.h"
+
+// standard
+#include <fcntl.h>                      /* for open() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>                   /* for waitpid() */
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+#include <unistd.h>                     /* for fork(), ... */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Default number of times to run the command.
+#define RUNS_DEFAULT              5
+
+// extern variable definitions
+char const       *me;                   ///< Program name.
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Counts the bytes and lines of \a path.
+ *
+ * @param path The path of the file.
+ * @param lines A pointer to receive the number of lines.
+ * @return Returns the number of bytes.
+ */
+NODISCARD
+static size_t count_file( char const *path, size_t *lines ) {
+  FILE *const file = fopen( path, "r" );
+  PERROR_EXIT_IF( file == NULL, EX_NOINPUT );
+  char buf[ 64 * 1024 ];
+  size_t bytes = 0;
+  *lines = 0;
+  for ( size_t n; (n = fread( buf, 1, sizeof buf, file )) > 0; ) {
+    bytes += n;
+    for ( size_t i = 0; i < n; ++i )
+      *lines += buf[i] == '\n';
+  } // for
+  PERROR_EXIT_IF( ferror( file ), EX_IOERR );
+  fclose( file );
+  return bytes;
+}
+
+/**
+ * Compares two `double` values for qsort().
+ *
+ * @param i_data A pointer to the first value.
+ * @param j_data A pointer to the second value.
+ * @return Returns a number less than 0, 0, or greater than 0 if \a i_data is
+ * less than, equal to, or greater than \a j_data, respectively.
+ */
+NODISCARD
+static int double_cmp( void const *i_data, void const *j_data ) {
+  double const i = *POINTER_CAST( double const*, i_data );
+  double const j = *POINTER_CAST( double const*, j_data );
+  return (i > j) - (i < j);
+}
+
+/**
+ * Gets the current time in seconds from an arbitrary epoch.
+ *
+ * @return Returns said time.
+ */
+NODISCARD
+static double now_s( void ) {
+  struct timespec ts;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0, EX_OSERR );
+  return STATIC_CAST( double, ts.tv_sec ) +
+         STATIC_CAST( double, ts.tv_nsec ) / 1e9;
+}
+
+/**
+ * Runs the command once and waits for it to exit.
+ *
+ * @param argv The arguments to exec.
+ * @param in_path The path of the file to use as standard input.
+ */
+static void run_once( char *const argv[], char const *in_path ) {
+  pid_t const pid = fork();
+  PERROR_EXIT_IF( pid == -1, EX_OSERR );
+  if ( pid == 0 ) {
+    int const in_fd = open( in_path, O_RDONLY );
+    PERROR_EXIT_IF( in_fd == -1, EX_NOINPUT );
+    int const out_fd = open( "/dev/null", O_WRONLY );
+    PERROR_EXIT_IF( out_fd == -1, EX_OSERR );
+    DUP2( in_fd, STDIN_FILENO );
+    DUP2( out_fd, STDOUT_FILENO );
+    execv( argv[0], argv );
+    perror_exit( EX_OSERR );
+  }
+
+  int wait_status;
+  PERROR_EXIT_IF( waitpid( pid, &wait_status, 0 ) == -1, EX_OSERR );
+  if ( !WIFEXITED( wait_status ) || WEXITSTATUS( wait_status ) != 0 )
+    fatal_error( EX_SOFTWARE, "%s failed\n", argv[0] );
+}
+
+_Noreturn
+static void usage( void ) {
+  EPRINTF(
+    "usage: %s [-n runs] mode file command [command-options...]\n", me
+  );
+  exit( EX_USAGE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( int argc, char *argv[] ) {
+  me = base_name( argv[0] );
+
+  //
+  // Don't use getopt() since it may permute the command's options.
+  //
+  size_t runs = RUNS_DEFAULT;
+  --argc;
+  ++argv;
+  if ( argc >= 2 && strcmp( argv[0], "-n" ) == 0 ) {
+    runs = check_atou( argv[1] );
+    argc -= 2;
+    argv += 2;
+  }
+  if ( argc < 3 || runs == 0 )
+    usage();
+
+  char const *const mode = argv[0];
+  char const *const in_path = argv[1];
+  char *const *const cmd_argv = argv + 2;
+
+  //
+  // The corpus name is the file's base name minus its extension.
+  //
+  char const *const corpus = base_name( in_path );
+  char const *const dot = strchr( corpus, '.' );
+  int const corpus_len = STATIC_CAST( int,
+    dot != NULL ? STATIC_CAST( size_t, dot - corpus ) : strlen( corpus )
+  );
+
+  size_t lines;
+  size_t const bytes = count_file( in_path, &lines );
+
+  double *const s = MALLOC( double, runs );
+  run_once( cmd_argv, in_path );        // warm up
+  for ( size_t i = 0; i < runs; ++i ) {
+    double const start = now_s();
+    run_once( cmd_argv, in_path );
+    s[i] = now_s() - start;
+  } // for
+  qsort( s, runs, sizeof s[0], &double_cmp );
+  double const median = s[ runs / 2 ];
+
+  PRINTF(
+    "{\"tool\":\"%s\",\"mode\":\"%s\",\"corpus\":\"%.*s\","
+    "\"bytes\":%zu,\"lines\":%zu,\"runs\":%zu,"
+    "\"min_s\":%.6f,\"median_s\":%.6f,\"p99_s\":%.6f,"
+    "\"mb_per_s\":%.2f,\"lines_per_s\":%.0f}\n",
+    base_name( cmd_argv[0] ), mode, corpus_len, corpus,
+    bytes, lines, runs,
+    s[0], median, s[ runs * 99 / 100 ],
+    STATIC_CAST( double, bytes ) / 1e6 / median,
+    STATIC_CAST( double, lines ) / median
+  );
+
+  free( s );
+  exit( EX_OK );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
@@ -0,0 +1,622 @@
+/*
+**      wrap -- text reformatter
+**      src/wrap_microbench.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Benchmarks each hot-path primitive in isolation and prints the time per call
+ * in nanoseconds and, on x86, in time-stamp counter ticks, e.g.:
+ *
+ *      $ ./wrap_microbench -n 2000000 utf8_decode regex_match
+ *
+ * Each benchmark is run once to warm up, then the given number of trials; the
+ * fastest trial is reported since it's the one least disturbed by the rest of
+ * the system.  The loop overhead (cycling through the inputs) is included.
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "cc_map.h"
+#include "common.h"
+#include "doxygen.h"
+#include "line_reader.h"
+#include "markdown.h"
+#include "options.h"
+#include "unicode.h"
+#include "uri.h"
+#include "util.h"
+#include "wregex.h"
+
+// standard
+#include <fcntl.h>                      /* for open() */
+#include <stdbool.h>
+#include <stddef.h>                     /* for size_t */
+#include <stdint.h>                     /* for uint64_t */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+#include <unistd.h>                     /* for dup(), getopt(), ... */
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>                  /* for __rdtsc() */
+#define HAVE_RDTSC                1
+#endif /* __x86_64__ || __i386__ */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Default number of calls per trial.
+#define CALLS_DEFAULT             1000000
+
+/// Default number of trials per benchmark.
+#define TRIALS_DEFAULT            5
+
+/// Number of lines in the file read by the line-reading benchmarks.
+#define FILE_LINES                10000
+
+/**
+ * Benchmark function.
+ *
+ * @param calls The number of calls of the primitive to make.
+ * @return Returns the number of calls actually made.
+ */
+typedef size_t (*bench_fn_t)( size_t calls );
+
+/**
+ * A benchmark.
+ */
+struct bench {
+  char const *name;                     ///< Benchmark name.
+  bench_fn_t  fn;                       ///< Benchmark function.
+  unsigned    calls_div;                ///< Divide calls by this if slow.
+};
+typedef struct bench bench_t;
+
+/**
+ * UTF-8 text mixing 1-, 2-, 3-, and 4-byte encodings including Unicode
+ * spaces, end-of-sentence characters, and hyphens.
+ */
+static char const UTF8_TEXT[] =
+  "The quick brown fox: naïve café façade — λόγος слово, 中文 漢字。"
+  "well‐known non‑breaking　ideographic space 😀 🎉! Done? Yes.";
+
+/**
+ * Lines for regex_match() on #WRAP_RE and uri_find(): most lines have no
+ * match.
+ */
+static char const *const REGEX_LINES[] = {
+  "The quick brown fox jumps over the lazy dog and keeps on running.\n",
+  "See https://www.example.com/some/path?q=1#frag for more details.\n",
+  "Send e-mail to user@example.com or the list for help with this.\n",
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do.\n",
+  "ftp://ftp.example.edu/pub/file.tar.gz is the old distribution.\n",
+  "Nothing to see here: just words, punctuation, and numbers 42.\n",
+};
+
+/**
+ * Lines of a Markdown document having representative line shapes.  They're
+ * arrays since markdown_parse() takes a non-`const` string.
+ */
+static char MD_LINES[][ 80 ] = {
+  "# Header\n",
+  "\n",
+  "A paragraph line of ordinary text that goes on for a while.\n",
+  "Its second line continues the paragraph.\n",
+  "\n",
+  "* A list item\n",
+  "    1. A nested numbered item\n",
+  "        * A doubly nested item\n",
+  "\n",
+  "> A block quote\n",
+  "> > A nested block quote\n",
+  "\n",
+  "```c\n",
+  "int main() { return 0; }\n",
+  "```\n",
+  "\n",
+  "<div>\n",
+  "</div>\n",
+  "\n",
+  "| a | b |\n",
+  "|---|---|\n",
+  "\n",
+  "[label]: http://example.com \"Title\"\n",
+  "\n",
+};
+
+/**
+ * Doxygen command names (and some non-commands) for dox_find_cmd().
+ */
+static char const *const DOX_NAMES[] = {
+  "param", "return", "brief", "code", "endcode", "note", "sa", "see",
+  "file", "verbatim", "xyzzy", "params", "warning", "li", "foo", "deprecated"
+};
+
+/**
+ * Lines of C code, most with end-of-line comments, for align_eol_comments().
+ */
+static char const *const CODE_LINES[] = {
+  "int f( int a, int b );   // Does f.\n",
+  "char buf[ 3 + 1/*null*/ ];\n",
+  "static size_t n; /* Number of things. */\n",
+  "} // for\n",
+  "#endif /* NDEBUG */\n",
+  "x = y + 1;                                      // Increment.\n",
+  "char const *s = \"// not a comment\"; // A string.\n",
+};
+
+// extern functions
+void align_eol_comments( char**, size_t*, line_reader_t* );
+
+// extern variable definitions
+char const       *me;                   ///< Program name.
+
+// local variable definitions
+static char32_t   bench_cps[ ARRAY_SIZE( UTF8_TEXT ) ]; ///< Code-points.
+static size_t     bench_cps_len;        ///< Length of \ref bench_cps.
+static int        code_fd = -1;         ///< File of CODE_LINES.
+static size_t     cp_starts[ ARRAY_SIZE( UTF8_TEXT ) ]; ///< UTF-8 starts.
+static size_t     cp_starts_len;        ///< Length of \ref cp_starts.
+static int        text_fd = -1;         ///< File of REGEX_LINES.
+static wregex_t   wrap_re;              ///< Compiled #WRAP_RE.
+static wregex_cache_t wrap_re_cache;    ///< For matching \ref wrap_re.
+
+/**
+ * Results of benchmarked calls are accumulated here so the compiler can't
+ * elide them.
+ */
+static volatile unsigned  bench_sink;
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Benchmarks align_eol_comments(): one call per line.
+ *
+ * @param calls The number of lines to align.
+ * @return Returns the number of lines aligned.
+ */
+static size_t bench_align_eol_comments( size_t calls ) {
+  //
+  // Since align_eol_comments() writes to stdout, temporarily redirect it to
+  // /dev/null.
+  //
+  PERROR_EXIT_IF( fflush( stdout ) != 0, EX_IOERR );
+  int const stdout_fd = dup( STDOUT_FILENO );
+  PERROR_EXIT_IF( stdout_fd == -1, EX_OSERR );
+  int const null_fd = open( "/dev/null", O_WRONLY );
+  PERROR_EXIT_IF( null_fd == -1, EX_OSERR );
+  DUP2( null_fd, STDOUT_FILENO );
+
+  char *line = NULL;
+  size_t line_cap = 0;
+  size_t done = 0;
+  while ( done < calls ) {
+    //
+    // Each call aligns all the lines in the file.
+    //
+    PERROR_EXIT_IF( lseek( code_fd, 0, SEEK_SET ) == -1, EX_IOERR );
+    line_reader_t lr;
+    line_reader_init( &lr, code_fd );
+    if ( check_readline( &line, &line_cap, &lr ) > 0 )
+      align_eol_comments( &line, &line_cap, &lr );
+    line_reader_cleanup( &lr );
+    done += FILE_LINES;
+  } // while
+  free( line );
+
+  PERROR_EXIT_IF( fflush( stdout ) != 0, EX_IOERR );
+  DUP2( stdout_fd, STDOUT_FILENO );
+  close( stdout_fd );
+  close( null_fd );
+  return done;
+}
+
+/**
+ * Benchmarks cc_map_get() over the characters of the first of \ref CODE_LINES.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_cc_map_get( size_t calls ) {
+  char const *const line = CODE_LINES[0];
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += cc_map_get( line[j] ) != NULL;
+    if ( line[ ++j ] == '\0' )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks check_readline() over a \ref line_reader (what was formerly
+ * `fgetsz()`).
+ *
+ * @param calls The number of lines to read.
+ * @return Returns the number of lines read.
+ */
+static size_t bench_check_readline( size_t calls ) {
+  char *line = NULL;
+  size_t line_cap = 0;
+  size_t done = 0;
+  unsigned sum = 0;
+  while ( done < calls ) {
+    PERROR_EXIT_IF( lseek( text_fd, 0, SEEK_SET ) == -1, EX_IOERR );
+    line_reader_t lr;
+    line_reader_init( &lr, text_fd );
+    for ( size_t len; (len = check_readline( &line, &line_cap, &lr )) > 0; ) {
+      sum += STATIC_CAST( unsigned, len );
+      ++done;
+    } // for
+    line_reader_cleanup( &lr );
+  } // while
+  free( line );
+  bench_sink += sum;
+  return done;
+}
+
+/**
+ * Benchmarks cp_is_eos() over the code-points of \ref UTF8_TEXT.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_cp_is_eos( size_t calls ) {
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += cp_is_eos( bench_cps[j] );
+    if ( ++j == bench_cps_len )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks cp_is_hyphen() over the code-points of \ref UTF8_TEXT.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_cp_is_hyphen( size_t calls ) {
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += cp_is_hyphen( bench_cps[j] );
+    if ( ++j == bench_cps_len )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks cp_is_space() over the code-points of \ref UTF8_TEXT.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_cp_is_space( size_t calls ) {
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += cp_is_space( bench_cps[j] );
+    if ( ++j == bench_cps_len )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks dox_find_cmd() over \ref DOX_NAMES.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_dox_find_cmd( size_t calls ) {
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += dox_find_cmd( DOX_NAMES[j] ) != NULL;
+    if ( ++j == ARRAY_SIZE( DOX_NAMES ) )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks markdown_parse() over \ref MD_LINES.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_markdown_parse( size_t calls ) {
+  md_parser_t md = { 0 };
+  markdown_init( &md );
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += markdown_parse( &md, MD_LINES[j] )->line_type;
+    if ( ++j == ARRAY_SIZE( MD_LINES ) )
+      j = 0;
+  } // for
+  markdown_cleanup( &md );
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks regex_match() on #WRAP_RE over \ref REGEX_LINES.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_regex_match( size_t calls ) {
+  unsigned sum = 0;
+  size_t range[2];
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += regex_match( &wrap_re, &wrap_re_cache, REGEX_LINES[j], 0, range );
+    if ( ++j == ARRAY_SIZE( REGEX_LINES ) )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks uri_find() over \ref REGEX_LINES for comparison with
+ * regex_match().
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_uri_find( size_t calls ) {
+  unsigned sum = 0;
+  size_t range[2];
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += uri_find( REGEX_LINES[j], 0, range );
+    if ( ++j == ARRAY_SIZE( REGEX_LINES ) )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks utf8_decode() at every code-point of \ref UTF8_TEXT.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_utf8_decode( size_t calls ) {
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += utf8_decode( UTF8_TEXT + cp_starts[j] );
+    if ( ++j == cp_starts_len )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Benchmarks utf8_len() at every code-point of \ref UTF8_TEXT.
+ *
+ * @param calls The number of calls to make.
+ * @return Returns \a calls.
+ */
+static size_t bench_utf8_len( size_t calls ) {
+  unsigned sum = 0;
+  for ( size_t i = 0, j = 0; i < calls; ++i ) {
+    sum += STATIC_CAST( unsigned, utf8_len( UTF8_TEXT[ cp_starts[j] ] ) );
+    if ( ++j == cp_starts_len )
+      j = 0;
+  } // for
+  bench_sink += sum;
+  return calls;
+}
+
+/**
+ * Gets the current time-stamp counter value, if available.
+ *
+ * @return Returns said value or 0 if unavailable.
+ */
+NODISCARD
+static uint64_t now_cycles( void ) {
+#ifdef HAVE_RDTSC
+  return __rdtsc();
+#else
+  return 0;
+#endif /* HAVE_RDTSC */
+}
+
+/**
+ * Gets the current time in nanoseconds from an arbitrary epoch.
+ *
+ * @return Returns said time.
+ */
+NODISCARD
+static double now_ns( void ) {
+  struct timespec ts;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0, EX_OSERR );
+  return STATIC_CAST( double, ts.tv_sec ) * 1e9 +
+         STATIC_CAST( double, ts.tv_nsec );
+}
+
+/**
+ * Runs \a b and prints its fastest trial.
+ *
+ * @param b The \ref bench to run.
+ * @param calls The number of calls per trial.
+ * @param trials The number of trials.
+ */
+static void run_bench( bench_t const *b, size_t calls, unsigned trials ) {
+  if ( b->calls_div > 1 )
+    calls = calls / b->calls_div + 1;
+  (void)(*b->fn)( calls / 10 + 1 );     // warm up
+
+  double best_ns = 0, best_cycles = 0;
+  size_t made = 0;
+  for ( unsigned t = 0; t < trials; ++t ) {
+    double const ns0 = now_ns();
+    uint64_t const c0 = now_cycles();
+    made = (*b->fn)( calls );
+    uint64_t const c1 = now_cycles();
+    double const ns1 = now_ns();
+    double const ns = (ns1 - ns0) / STATIC_CAST( double, made );
+    if ( t == 0 || ns < best_ns ) {
+      best_ns = ns;
+      best_cycles =
+        STATIC_CAST( double, c1 - c0 ) / STATIC_CAST( double, made );
+    }
+  } // for
+
+#ifdef HAVE_RDTSC
+  PRINTF( "%-24s %10zu %10.2f %10.1f\n", b->name, made, best_ns, best_cycles );
+#else
+  (void)best_cycles;
+  PRINTF( "%-24s %10zu %10.2f %10s\n", b->name, made, best_ns, "-" );
+#endif /* HAVE_RDTSC */
+}
+
+/**
+ * Sets up the inputs for all the benchmarks.
+ */
+static void setup( void ) {
+  setlocale_utf8();
+
+  for ( size_t i = 0; UTF8_TEXT[i] != '\0'; i += utf8_len( UTF8_TEXT[i] ) ) {
+    cp_starts[ cp_starts_len++ ] = i;
+    bench_cps[ bench_cps_len++ ] = utf8_decode( UTF8_TEXT + i );
+  } // for
+
+  int const regex_err_code = regex_compile( &wrap_re, WRAP_RE );
+  if ( regex_err_code != 0 ) {
+    fatal_error( EX_SOFTWARE,
+      "\"%s\": %s\n", WRAP_RE, regex_error( &wrap_re, regex_err_code )
+    );
+  }
+
+  opt_comment_chars = cc_map_compile( opt_comment_chars );
+  opt_align_column = 40;
+
+  //
+  // Write the files read by the line-reading benchmarks.
+  //
+  FILE *const text_file = tmpfile();
+  PERROR_EXIT_IF( text_file == NULL, EX_CANTCREAT );
+  FILE *const code_file = tmpfile();
+  PERROR_EXIT_IF( code_file == NULL, EX_CANTCREAT );
+  for ( size_t i = 0; i < FILE_LINES; ++i ) {
+    FPUTS( REGEX_LINES[ i % ARRAY_SIZE( REGEX_LINES ) ], text_file );
+    FPUTS( CODE_LINES[ i % ARRAY_SIZE( CODE_LINES ) ], code_file );
+  } // for
+  PERROR_EXIT_IF( fflush( text_file ) != 0, EX_IOERR );
+  PERROR_EXIT_IF( fflush( code_file ) != 0, EX_IOERR );
+  text_fd = fileno( text_file );
+  code_fd = fileno( code_file );
+}
+
+/**
+ * Prints the usage message to standard error and exits.
+ *
+ * @param benches The benchmarks.
+ * @param benches_len The number of benchmarks.
+ */
+_Noreturn
+static void usage( bench_t const *benches, size_t benches_len ) {
+  EPRINTF(
+    "usage: %s [-n calls] [-t trials] [benchmark...]\nbenchmarks:", me
+  );
+  for ( size_t i = 0; i < benches_len; ++i )
+    EPRINTF( " %s", benches[i].name );
+  EPRINTF( "\n" );
+  exit( EX_USAGE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( int argc, char *argv[] ) {
+  static bench_t const BENCHES[] = {
+    { "utf8_decode",        &bench_utf8_decode,        1    },
+    { "utf8_len",           &bench_utf8_len,           1    },
+    { "cp_is_space",        &bench_cp_is_space,        1    },
+    { "cp_is_eos",          &bench_cp_is_eos,          1    },
+    { "cp_is_hyphen",       &bench_cp_is_hyphen,       1    },
+    { "regex_match",        &bench_regex_match,        1000 },
+    { "uri_find",           &bench_uri_find,           1    },
+    { "markdown_parse",     &bench_markdown_parse,     1    },
+    { "dox_find_cmd",       &bench_dox_find_cmd,       1    },
+    { "cc_map_get",         &bench_cc_map_get,         1    },
+    { "check_readline",     &bench_check_readline,     1    },
+    { "align_eol_comments", &bench_align_eol_comments, 10   },
+  };
+
+  me = base_name( argv[0] );
+
+  size_t calls = CALLS_DEFAULT;
+  unsigned trials = TRIALS_DEFAULT;
+  for ( int opt; (opt = getopt( argc, argv, "n:t:" )) != -1; ) {
+    switch ( opt ) {
+      case 'n':
+        calls = check_atou( optarg );
+        break;
+      case 't':
+        trials = check_atou( optarg );
+        break;
+      default:
+        usage( BENCHES, ARRAY_SIZE( BENCHES ) );
+    } // switch
+  } // for
+  if ( calls == 0 || trials == 0 )
+    usage( BENCHES, ARRAY_SIZE( BENCHES ) );
+
+  //
+  // Check that every given benchmark name exists before running any.
+  //
+  for ( int i = optind; i < argc; ++i ) {
+    size_t j = 0;
+    while ( j < ARRAY_SIZE( BENCHES ) &&
+            strcmp( argv[i], BENCHES[j].name ) != 0 ) {
+      ++j;
+    } // while
+    if ( j == ARRAY_SIZE( BENCHES ) )
+      usage( BENCHES, ARRAY_SIZE( BENCHES ) );
+  } // for
+
+  setup();
+
+  PRINTF(
+    "%-24s %10s %10s %10s\n", "benchmark", "calls", "ns/call", "ticks/call"
+  );
+  for ( size_t j = 0; j < ARRAY_SIZE( BENCHES ); ++j ) {
+    bool run = optind == argc;
+    for ( int i = optind; i < argc && !run; ++i )
+      run = strcmp( argv[i], BENCHES[j].name ) == 0;
+    if ( run )
+      run_bench( &BENCHES[j], calls, trials );
+  } // for
+
+  regex_cache_free( &wrap_re_cache );
+  regex_free( &wrap_re );
+  exit( EX_OK );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
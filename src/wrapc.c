@@ -29,9 +29,14 @@
 #include "cc_map.h"
 #include "common.h"
 #include "doxygen.h"
+#include "engine.h"
+#include "line_reader.h"
 #include "markdown.h"
 #include "options.h"
 #include "pattern.h"
+#include "stats.h"
+#include "trace.h"
+#include "unicode.h"
 #include "util.h"
 
 /// @cond DOXYGEN_IGNORE
@@ -85,10 +90,12 @@
 /**
  * Aligns end-of-line comments to a particular column.
  *
- * @param input_buf The input buffer to use.  It must contain the first line of
- * text read.
+ * @param pline A pointer to the line buffer to use.  It must contain the first
+ * line of text read.
+ * @param pline_cap A pointer to the capacity of \a *pline.
+ * @param lr The \ref line_reader to read the remaining lines from.
  */
-void align_eol_comments( char input_buf[const] );
+void align_eol_comments( char **pline, size_t *pline_cap, line_reader_t *lr );
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -127,12 +134,23 @@ typedef enum delim delim_t;
  * at to determine how to proceed.
  */
 struct dual_line {
-  line_buf_t  dl_line[2];               ///< Two lines.
-  char       *dl_curr;                  ///< Pointer to current line.
-  char       *dl_next;                  ///< Pointer to next line.
+  char       *dl_curr;                  ///< Current line.
+  size_t      dl_curr_cap;              ///< Capacity of \ref dl_curr.
+  char       *dl_next;                  ///< Next line.
+  size_t      dl_next_cap;              ///< Capacity of \ref dl_next.
 };
 typedef struct dual_line dual_line_t;
 
+/**
+ * A child process wrapping the comments in one of \ref opt_files.
+ */
+struct wrap_child {
+  pid_t       pid;                      ///< Its process ID.
+  FILE       *fout;                     ///< Temporary file it writes to.
+  int         stats_fd;                 ///< Pipe it sends its stats to.
+};
+typedef struct wrap_child wrap_child_t;
+
 // extern variable definitions
 char const         *me;                 // executable name
 
@@ -140,12 +158,40 @@ char const         *me;                 // executable name
 static char         close_cc[2];        ///< Closing comment delimiter char(s).
 static delim_t      delim;              ///< Comment delimiter type.
 static dual_line_t  input_lines;        ///< Input lines.
+static line_reader_t stdin_lr;          ///< Reader of stdin.
 static line_buf_t   prefix_buf;         ///< Characters stripped/prepended.
 static size_t       prefix_len;         ///< Length of \ref prefix_buf.
 static line_buf_t   suffix_buf;         ///< Characters stripped/appended.
 static size_t       suffix_len;         ///< Length of \ref suffix_buf.
+
+/// @name Output state
+/// Copies of the prefix and line width used by write_wrapped_line().  They're
+/// separate from \ref prefix_buf and \ref opt_line_width because, when
+/// wrapping in-process, read_source() changes those before all the text
+/// wrapped with their old values has been written.
+/// @{
+static size_t       out_line_width;     ///< Line width of wrapped lines.
+static line_buf_t   out_prefix_buf;     ///< Prefix prepended to wrapped lines.
+static line_buf_t   out_proto_tws;      ///< Prototype trailing whitespace.
+static bool         out_wrap_ended;     ///< Got \ref WIPC_CODE_WRAP_END?
+/// @}
+
+#ifdef HAVE_OPEN_MEMSTREAM
+/// @name In-process wrapping
+/// @{
+static wrap_ctx_t   wrap_ctx;           ///< Wrap engine context.
+static FILE        *fto_wrap;           ///< Stripped text to be wrapped.
+static char        *to_wrap_buf;        ///< Buffer of \ref fto_wrap.
+static size_t       to_wrap_size;       ///< Size of \ref to_wrap_buf.
+static FILE        *ffrom_wrap;         ///< Text wrapped by \ref wrap_ctx.
+static char        *from_wrap_buf;      ///< Buffer of \ref ffrom_wrap.
+static size_t       from_wrap_size;     ///< Size of \ref from_wrap_buf.
+static size_t       from_wrap_pos;      ///< Position in \ref from_wrap_buf.
+/// @}
+#endif /* HAVE_OPEN_MEMSTREAM */
+
 /**
- * Two pipes:
+ * Two pipes (used only when exec'ing **wrap**(1)):
  *
  *      pipes[0][1] <- read_source_write_wrap()  [child 1]
  *              [0] -> wrap(1)                   [child 2]
@@ -175,14 +221,20 @@ static int          pipes[2][2];
 #define CURR        input_lines.dl_curr /**< Shorthand for current line. */
 #define NEXT        input_lines.dl_next /**< Shorthand for next line. */
 
+/// Shorthand for reading the next line.
+#define READ_NEXT() \
+  check_readline( &NEXT, &input_lines.dl_next_cap, &stdin_lr )
+
 #define TO_WRAP     0                   /**< To refer to \ref pipes[0]. */
 #define FROM_WRAP   1                   /**< To refer to \ref pipes[1]. */
 
 // local functions
-static void         adjust_comment_width( char* );
+static void         adjust_comment_width( void );
+static void         check_wait_status( int );
 static void         chop_suffix( char* );
 static void         fork_exec_wrap( pid_t );
 static void         init( int, char const*[] );
+static void         init_out( void );
 
 NODISCARD
 static bool         is_block_comment( char const* );
@@ -197,6 +249,7 @@ NODISCARD
 static size_t       prefix_span( char const* );
 
 static void         read_prototype( void );
+static void         read_source( FILE* );
 
 NODISCARD
 static pid_t        read_source_write_wrap( void );
@@ -209,6 +262,8 @@ static char*        skip_c( char*, char );
 
 NODISCARD
 static char*        skip_n( char*, size_t );
+static void         stats_receive( int );
+static void         stats_send( int );
 
 NODISCARD
 static size_t       strlen_no_eol( char const* );
@@ -222,10 +277,17 @@ static size_t       str_width( char const* );
 _Noreturn
 static void         usage( int );
 static void         wait_for_child_processes( void );
+static void         wrap_comments( void );
+static void         wrap_files( void );
+static void         wrap_in_process( void );
+static void         wrap_in_process_pump( bool );
 
 NODISCARD
 static bool         wrap_dox_line( char const*, FILE* );
 
+NODISCARD
+static bool         write_wrapped_line( char*, size_t );
+
 ////////// inline functions ///////////////////////////////////////////////////
 
 /**
@@ -266,9 +328,12 @@ static inline char const* is_line_comment( char const *s ) {
  * Swaps the two line buffers.
  */
 static inline void swap_line_bufs( void ) {
-  char *const temp = CURR;
-  CURR = NEXT;
-  NEXT = temp;
+  input_lines = (dual_line_t){
+    .dl_curr = input_lines.dl_next,
+    .dl_curr_cap = input_lines.dl_next_cap,
+    .dl_next = input_lines.dl_curr,
+    .dl_next_cap = input_lines.dl_curr_cap
+  };
 }
 
 ////////// main ///////////////////////////////////////////////////////////////
@@ -283,16 +348,11 @@ static inline void swap_line_bufs( void ) {
 int main( int argc, char const *argv[] ) {
   wait_for_debugger_attach( "WRAPC_DEBUG" );
   init( argc, argv );
-  if ( opt_align_column > 0 ) {
-    align_eol_comments( CURR );
-  } else {
-    read_prototype();
-    PIPE( pipes[ TO_WRAP ] );
-    PIPE( pipes[ FROM_WRAP ] );
-    fork_exec_wrap( read_source_write_wrap() );
-    read_wrap_write_stdout();
-    wait_for_child_processes();
-  }
+  if ( opt_files_len > 0 )
+    wrap_files();
+  else
+    wrap_comments();
+  stats_print( /*is_wrapc=*/true );
   exit( EX_OK );
 }
 
@@ -332,7 +392,7 @@ static void fork_exec_wrap( pid_t read_source_write_wrap_pid ) {
   arg_buf_t   arg_opt_tab_spaces;
 
   size_t argc = 0;
-  char *argv[17];                       // must be +1 of greatest arg below
+  char *argv[18];                       // must be +1 of greatest arg below
 
 #define ARG_CHECK                 assert( argc < ARRAY_SIZE( argv ) )
 #define ARG_SET(ARG)              BLOCK( ARG_CHECK; argv[ argc++ ] = (ARG); )
@@ -367,8 +427,9 @@ static void fork_exec_wrap( pid_t read_source_write_wrap_pid ) {
   /* 12 */    ARG_FMT( opt_line_width , "-" SOPT(WIDTH)       "%zu" );
   /* 13 */ IF_ARG_DUP( opt_doxygen    , "-" SOPT(DOXYGEN)           );
   /* 14 */ IF_ARG_DUP( opt_no_hyphen  , "-" SOPT(NO_HYPHEN)         );
-  /* 15 */    ARG_DUP(                  "-" SOPT(ENABLE_IPC)        );
-  /* 16 */    ARG_END;
+  /* 15 */ IF_ARG_DUP( opt_optimal    , "-" SOPT(OPTIMAL)           );
+  /* 16 */    ARG_DUP(                  "-" SOPT(ENABLE_IPC)        );
+  /* 17 */    ARG_END;
 
   //
   // Read from pipes[TO_WRAP] (read_source_write_wrap() in child 1) and write
@@ -417,121 +478,7 @@ static pid_t read_source_write_wrap( void ) {
   FILE *const fwrap = stdout;
 #endif /* DEBUG_RSWW */
 
-  if ( NEXT[0] != '\0' ) {
-    //
-    // For block comments, write the first line directly to the output.
-    //
-    adjust_comment_width( CURR );
-    PUTS( CURR );
-    swap_line_bufs();
-  }
-
-  //
-  // As a special case, if the first line is NOT a comment, then just wrap all
-  // lines using the leading whitespace of the first line as a prototype for
-  // all subsequent lines, i.e., do NOT ever tell wrap(1) to pass text through
-  // verbatim (below).
-  //
-  bool const proto_is_comment = is_line_comment( CURR ) != NULL;
-
-  for ( ; CURR[0] != '\0'; swap_line_bufs() ) {
-    //
-    // In order to know when a comment ends, we have to peek at the next line.
-    //
-    PJL_DISCARD_RV( check_readline( NEXT, stdin ) );
-
-    if ( proto_is_comment && is_line_comment( CURR ) == NULL ) {
-      //
-      // This handles cases like:
-      //
-      //      proto     ->  # This is a comment.
-      //      curr_buf  ->  not_a_comment();
-      //
-      goto verbatim;
-    }
-
-    if ( !(proto_is_comment && is_line_comment( NEXT ) != NULL) &&
-         is_block_comment( CURR ) ) {
-      //
-      // This handles cases like:
-      //
-      //                    /*
-      //      proto     ->  This is a comment.
-      //      curr_buf  ->  */
-      //
-      // or:
-      //                    /*
-      //                     * This is a comment.
-      //      curr_buf  ->   */
-      //      next_buf  ->  [empty]
-      //
-      adjust_comment_width( CURR );
-      goto verbatim;
-    }
-
-    size_t curr_prefix_len = prefix_span( CURR );
-    if ( opt_doxygen || opt_markdown ) {
-      if ( curr_prefix_len > prefix_len ) {
-        //
-        // We can't strip all whitespace after the comment delimiter characters
-        // because:
-        //
-        // 1. Doxygen needs the whitespace when doing preformatted text.
-        // 2. Markdown relies on indentation for state changes.
-        //
-        // Hence we strip only the length of the initial prototype -- but only
-        // if it's less.
-        //
-        curr_prefix_len = prefix_len;
-      }
-      else if ( curr_prefix_len < prefix_len &&
-                !is_eol( CURR[ curr_prefix_len ] ) ) {
-        //
-        // The leading comment delimiter characters and/or whitespace length
-        // has decreased.  This can happen in a case like:
-        //
-        //      *  + This is a list item.
-        //      *
-        //      * Not part of the list item.
-        //
-        // where the list item was indented 2 spaces after the + but the
-        // regular text was indented only 1 space.  If this check were not
-        // done, then the "Not" text would end up also being indented 2 spaces.
-        //
-        // We therefore have to increase opt_line_width by the delta and also
-        // notify both wrap(1) and the other wrapc(1) processes of the changes.
-        //
-        opt_line_width += prefix_len - curr_prefix_len;
-        set_prefix( CURR, curr_prefix_len );
-        WIPC_SENDF(
-          fwrap, WIPC_CODE_NEW_LEADER, "%zu" WIPC_PARAM_SEP "%s\n",
-          opt_line_width, prefix_buf
-        );
-      }
-    }
-
-    // Skip over the prefix and chop off the suffix.
-    char *const line = skip_n( CURR, curr_prefix_len );
-    if ( suffix_buf[0] != '\0' )
-      chop_suffix( line );
-
-    if ( opt_doxygen && wrap_dox_line( line, fwrap ) )
-      continue;
-
-    FPUTS( line, fwrap );
-  } // for
-  exit( EX_OK );
-
-verbatim:
-  //
-  // We've reached the end of the comment: signal wrap(1) that we're now
-  // ending wrapping, write any remaining lines, then just copy text through
-  // verbatim.
-  //
-  WIPC_SEND( fwrap, WIPC_CODE_WRAP_END );
-  FPUTS( CURR, fwrap );
-  FPUTS( NEXT, fwrap );
-  fcopy( stdin, fwrap );
+  read_source( fwrap );
   exit( EX_OK );
 }
 
@@ -552,155 +499,205 @@ static void read_wrap_write_stdout( void ) {
   //
   // Read from pipes[FROM_WRAP] (wrap) and write to stdout.
   //
-  FILE *const fwrap = fdopen( pipes[ FROM_WRAP ][ STDIN_FILENO ], "r" );
-  if ( unlikely( fwrap == NULL ) ) {
-    fatal_error( EX_OSERR,
-      "parent can't open pipe for reading: %s\n", STRERROR()
-    );
-  }
+  line_reader_t wrap_lr;
+  line_reader_init( &wrap_lr, pipes[ FROM_WRAP ][ STDIN_FILENO ] );
 
   wait_for_debugger_attach( "WRAPC_DEBUG_RW" );
 
-  //
-  // Split off the trailing whitespace (tws) from the prototype so that if we
-  // read a comment line that's empty except for the prototype, we won't emit
-  // trailing whitespace. For example, given:
-  //
-  //      # foo
-  //      #
-  //      # bar
-  //
-  // the prototype initially is "# " (because that's what's before "foo").  If
-  // we didn't split off trailing whitespace, then when we wrapped the comment
-  // above, the second line would become "# " containing a trailing whitespace.
-  //
-  line_buf_t proto_tws;                 // prototype trailing whitespace, if any
-  split_tws( prefix_buf, prefix_len, proto_tws );
-
-  line_buf_t line_buf;
+  char *line_buf = NULL;
+  size_t line_cap = 0;
 
   for (;;) {
-    size_t line_size = sizeof line_buf;
-    if ( unlikely( fgetsz( line_buf, &line_size, fwrap ) == NULL ) )
+    size_t const line_size = check_readline( &line_buf, &line_cap, &wrap_lr );
+    if ( unlikely( line_size == 0 ) )
       break;
-    line_size = chop_eol( line_buf, line_size );
-    char *line = line_buf;
-
-    if ( line[0] == WIPC_CODE_HELLO ) {
-      switch ( STATIC_CAST( wipc_code_t, line[1] ) ) {
-        case WIPC_CODE_HELLO:           // shouldn't happen
-          break;
-
-        case WIPC_CODE_NEW_LEADER:
-          NO_OP;
-          //
-          // We've been told by child 1 (read_source_write_wrap(), via child 2,
-          // wrap) that the leading comment delimiter characters and/or
-          // whitespace has changed: adjust opt_line_width and prefix_buf.
-          //
-          char *sep;
-          opt_line_width = strtoul( line + 2, &sep, 10 );
-          prefix_len = strcpy_len( prefix_buf, sep + 1 );
-          split_tws( prefix_buf, prefix_len, proto_tws );
-          continue;
-
-        case WIPC_CODE_DELIMIT_PARAGRAPH:
-        case WIPC_CODE_PREFORMATTED_BEGIN:
-        case WIPC_CODE_PREFORMATTED_END:
-          //
-          // We only have to "eat" these and do nothing else.
-          //
-          continue;
-
-        case WIPC_CODE_WRAP_END:
-          //
-          // We've been told by child 1 (read_source_write_wrap(), via child 2,
-          // wrap) that we've reached the end of the comment: dump any
-          // remaining buffer and pass text through verbatim.
-          //
-          fcopy( fwrap, stdout );
-          goto done;
-      } // switch
-
-      //
-      // We got a HELLO followed by an unknown WIPC code: skip over the HELLO
-      // and format the remaining buffer.
-      //
-      ++line;
-      --line_size;
-    }
-
-    if ( suffix_buf[0] != '\0' ) {
+    TRACE_BEGIN( prev_phase, TRACE_PHASE_IPC );
+    bool const is_wrapping = write_wrapped_line( line_buf, line_size );
+    TRACE_END( prev_phase );
+    if ( !is_wrapping ) {
       //
-      // Pad the width with spaces in order to append the terminating comment
-      // character(s) back.
+      // We've been told by child 1 (read_source_write_wrap(), via child 2,
+      // wrap) that we've reached the end of the comment: dump any remaining
+      // buffer and pass text through verbatim.
       //
-      while ( line_size < opt_line_width )
-        line[ line_size++ ] = ' ';
-      line[ line_size ] = '\0';
+      line_reader_copy( &wrap_lr, stdout );
+      break;
     }
-
-    // don't emit proto_tws for blank lines
-    PRINTF(
-      "%s%s%s%s%s",
-      prefix_buf, is_blank_line( line ) ? "" : proto_tws, line, suffix_buf,
-      eol()
-    );
   } // for
 
-done:
-  FERROR( fwrap );
+  free( line_buf );
+  line_reader_cleanup( &wrap_lr );
+  close( pipes[ FROM_WRAP ][ STDIN_FILENO ] );
 #endif /* DEBUG_RSWW */
 }
 
-////////// local functions ////////////////////////////////////////////////////
+#ifdef HAVE_OPEN_MEMSTREAM
+/**
+ * Wraps text in-process by calling the wrap engine directly rather than
+ * fork'ing and exec'ing **wrap**(1): read_source() writes the stripped text to
+ * an in-memory stream that's fed to the engine that, in turn, writes to
+ * another in-memory stream whose lines are written via write_wrapped_line().
+ *
+ * @sa read_source_write_wrap()
+ * @sa read_wrap_write_stdout()
+ */
+static void wrap_in_process( void ) {
+  fto_wrap = open_memstream( &to_wrap_buf, &to_wrap_size );
+  PERROR_EXIT_IF( fto_wrap == NULL, EX_OSERR );
+  ffrom_wrap = open_memstream( &from_wrap_buf, &from_wrap_size );
+  PERROR_EXIT_IF( ffrom_wrap == NULL, EX_OSERR );
+
+  setlocale_utf8();
+  opt_data_link_esc = true;
+
+  //
+  // The engine adjusts opt_line_width for its own use, but we still need the
+  // original for adjust_comment_width().
+  //
+  size_t const line_width = opt_line_width;
+  wrap_engine_init();
+  wrap_ctx_init( &wrap_ctx, ffrom_wrap );
+  opt_line_width = line_width;
+
+  read_source( fto_wrap );
+  wrap_in_process_pump( /*is_eof=*/false );
+  wrap_ctx_finish( &wrap_ctx );
+  wrap_in_process_pump( /*is_eof=*/true );
+
+  stats_add( &wrap_stats, &wrap_ctx.stats );
+  wrap_ctx_free( &wrap_ctx );
+  fclose( fto_wrap );
+  fclose( ffrom_wrap );
+  free( to_wrap_buf );
+  free( from_wrap_buf );
+}
 
 /**
- * Adjusts the width of a comment line so that it either does not exceed or is
- * lengthened to meet the line width.
+ * Feeds everything written to \ref fto_wrap so far to the wrap engine, then
+ * writes every complete line the engine has wrapped so far via
+ * write_wrapped_line().
  *
- * @param s The newline- and null-terminated string to adjust.
+ * @param is_eof If `true`, also writes a trailing partial line, if any.
  */
-static void adjust_comment_width( char *s ) {
-  assert( s != NULL );
+static void wrap_in_process_pump( bool is_eof ) {
+  PERROR_EXIT_IF( fflush( fto_wrap ) != 0, EX_IOERR );
+  if ( to_wrap_size > 0 ) {
+    wrap_ctx_feed( &wrap_ctx, to_wrap_buf, to_wrap_size );
+    rewind( fto_wrap );
+  }
+
+  PERROR_EXIT_IF( fflush( ffrom_wrap ) != 0, EX_IOERR );
+  static char   *line_buf;
+  static size_t  line_cap;
+
+  char const *p = from_wrap_buf + from_wrap_pos;
+  char const *const end = from_wrap_buf + from_wrap_size;
+
+  while ( p < end ) {
+    size_t line_size = STATIC_CAST( size_t, end - p );
+    if ( out_wrap_ended ) {
+      PERROR_EXIT_IF(
+        fwrite( p, 1, line_size, stdout ) < line_size, EX_IOERR
+      );
+      p = end;
+      break;
+    }
+    char const *const nl = memchr( p, '\n', line_size );
+    if ( nl != NULL )
+      line_size = STATIC_CAST( size_t, nl - p ) + 1;
+    else if ( !is_eof )
+      break;                            // partial line: wait for more
+    str_reserve( &line_buf, &line_cap, line_size + 1/*\0*/ );
+    memcpy( line_buf, p, line_size );
+    line_buf[ line_size ] = '\0';
+    p += line_size;
+    TRACE_BEGIN( prev_phase, TRACE_PHASE_IPC );
+    out_wrap_ended = !write_wrapped_line( line_buf, line_size );
+    TRACE_END( prev_phase );
+  } // while
+
+  from_wrap_pos = STATIC_CAST( size_t, p - from_wrap_buf );
+  if ( from_wrap_pos == from_wrap_size ) {
+    rewind( ffrom_wrap );
+    from_wrap_pos = 0;
+  }
+}
+#endif /* HAVE_OPEN_MEMSTREAM */
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Adjusts the width of the current comment line so that it either does not
+ * exceed or is lengthened to meet the line width.
+ */
+static void adjust_comment_width( void ) {
   size_t const delim_len = suffix_buf[0] ? suffix_len : 1 + !!close_cc[1];
   size_t const width = opt_line_width + prefix_len + suffix_len;
-  size_t s_len = strlen_no_eol( s );
+  size_t s_len = strlen_no_eol( CURR );
+  size_t const s_width = utf8_width( CURR, s_len );
+  size_t const fill_len = s_width < width ? width - s_width : 0;
+  char *const s = str_reserve(
+    &CURR, &input_lines.dl_curr_cap,
+    s_len + fill_len + 2/*\r\n*/ + 1/*\0*/
+  );
 
-  if ( s_len > width ) {
+  if ( s_width > width ) {
     //
     // Shorten the comment line by sliding the closing comment delimiter
     // character(s) to the left.
     //
+    size_t const cut_len = utf8_width_len( s, s_len, width - delim_len );
     memmove(
-      s + width - delim_len,
+      s + cut_len,
       suffix_buf[0] ? suffix_buf : s + s_len - delim_len,
       delim_len
     );
-    strcpy( s + width, eol() );
+    strcpy( s + cut_len + delim_len, eol() );
   }
-  else if ( suffix_buf[0] != '\0' && s_len < width ) {
+  else if ( suffix_buf[0] != '\0' && fill_len > 0 ) {
     //
     // If we're doing terminated comments, lengthen the comment line by
     // "inserting" a multiple of the first comment delimiter character.
     //
     switch ( delim ) {
       case DELIM_EOL:
-        for ( ; s_len < width; ++s_len )
-          s[ s_len ] = close_cc[0];
+        memset( s + s_len, close_cc[0], fill_len );
         break;
       case DELIM_SINGLE:
-        for ( --s_len; s_len < width; ++s_len )
-          s[ s_len ] = ' ';
-        s[ s_len - 1 ] = close_cc[0];
+        memset( s + s_len - 1, ' ', fill_len );
+        s[ s_len - 1 + fill_len ] = close_cc[0];
         break;
       case DELIM_DOUBLE:
-        for ( --s_len; s_len < width; ++s_len )
-          s[ s_len ] = close_cc[0];
-        s[ s_len - 1 ] = close_cc[1];
+        memset( s + s_len - 1, close_cc[0], fill_len );
+        s[ s_len - 1 + fill_len ] = close_cc[1];
         break;
     } // switch
-    strcpy( s + width, eol() );
+    s_len += fill_len;
+    strcpy( s + s_len, eol() );
+  }
+}
+
+/**
+ * Checks the status of a child process that has exited: if it failed, exits
+ * the same way.
+ *
+ * @param wait_status The status returned by **wait**(2).
+ */
+static void check_wait_status( int wait_status ) {
+  if ( WIFEXITED( wait_status ) ) {
+    int const exit_status = WEXITSTATUS( wait_status );
+    if ( exit_status != 0 ) {
+      fatal_error( exit_status,
+        "child process exited with status %d: %s\n",
+        exit_status, str_status( exit_status )
+      );
+    }
+  } else if ( WIFSIGNALED( wait_status ) ) {
+    int const signal = WTERMSIG( wait_status );
+    fatal_error( EX_OSERR,
+      "child process terminated with signal %d: %s\n",
+      signal, strsignal( signal )
+    );
   }
 }
 
@@ -755,8 +752,7 @@ done:
 }
 
 /**
- * Parses command-line options, sets-up I/O, sets-up the input buffers, sets
- * the end-of-lines.
+ * Parses command-line options, sets-up I/O, and sets-up the input buffers.
  *
  * @param argc The number of command-line arguments from main().
  * @param argv The command-line arguments from main().
@@ -766,21 +762,34 @@ static void init( int argc, char const *argv[] ) {
   ATEXIT( common_cleanup );
 
   options_init( argc, argv, usage );
+  stats_init();
+  TRACE_INIT();
   opt_comment_chars = cc_map_compile( opt_comment_chars );
 
-  CURR = input_lines.dl_line[0];
-  NEXT = input_lines.dl_line[1];
-
-  size_t const size = check_readline( CURR, stdin );
-  if ( size == 0 )
-    exit( EX_OK );
+  str_reserve( &CURR, &input_lines.dl_curr_cap, LINE_BUF_SIZE )[0] = '\0';
+  str_reserve( &NEXT, &input_lines.dl_next_cap, LINE_BUF_SIZE )[0] = '\0';
+}
 
-  if ( opt_eol == EOL_INPUT && is_windows_eol( CURR, size ) ) {
-    //
-    // Retroactively set opt_eol because we pass it to wrap(1).
-    //
-    opt_eol = EOL_WINDOWS;
-  }
+/**
+ * Initializes the state used by write_wrapped_line() from the prototype.
+ */
+static void init_out( void ) {
+  out_line_width = opt_line_width;
+  size_t const out_prefix_len = strcpy_len( out_prefix_buf, prefix_buf );
+  //
+  // Split off the trailing whitespace (tws) from the prototype so that if we
+  // read a comment line that's empty except for the prototype, we won't emit
+  // trailing whitespace. For example, given:
+  //
+  //      # foo
+  //      #
+  //      # bar
+  //
+  // the prototype initially is "# " (because that's what's before "foo").  If
+  // we didn't split off trailing whitespace, then when we wrapped the comment
+  // above, the second line would become "# " containing a trailing whitespace.
+  //
+  split_tws( out_prefix_buf, out_prefix_len, out_proto_tws );
 }
 
 /**
@@ -1063,7 +1072,7 @@ static void read_prototype( void ) {
     // + The first line should not be altered.
     // + The second line becomes the prototype.
     //
-    PJL_DISCARD_RV( check_readline( NEXT, stdin ) );
+    PJL_DISCARD_RV( READ_NEXT() );
     proto = NEXT;
   }
 
@@ -1078,7 +1087,8 @@ static void read_prototype( void ) {
   //
   char const *const tc = is_terminated_comment( proto );
   if ( tc != NULL ) {
-    suffix_len = chop_eol( suffix_buf, strcpy_len( suffix_buf, tc ) );
+    strncpy( suffix_buf, tc, sizeof suffix_buf - 1 );
+    suffix_len = chop_eol( suffix_buf, strlen( suffix_buf ) );
     line_width -= 1/*space*/ + STATIC_CAST( int, suffix_len );
   }
 
@@ -1091,14 +1101,161 @@ static void read_prototype( void ) {
   opt_line_width = STATIC_CAST( size_t, line_width );
 }
 
+/**
+ * Reads the source text to be wrapped and writes it, with the leading
+ * whitespace and comment delimiter characters stripped from each line, to
+ * \a fwrap.
+ *
+ * @param fwrap The file to write to: either a pipe to **wrap**(1) or, when
+ * wrapping in-process, \ref fto_wrap.
+ */
+static void read_source( FILE *fwrap ) {
+  assert( fwrap != NULL );
+
+  if ( NEXT[0] != '\0' ) {
+    //
+    // For block comments, write the first line directly to the output.
+    //
+    adjust_comment_width();
+    PUTS( CURR );
+    swap_line_bufs();
+  }
+
+  //
+  // As a special case, if the first line is NOT a comment, then just wrap all
+  // lines using the leading whitespace of the first line as a prototype for
+  // all subsequent lines, i.e., do NOT ever tell wrap(1) to pass text through
+  // verbatim (below).
+  //
+  bool const proto_is_comment = is_line_comment( CURR ) != NULL;
+
+  for ( ; CURR[0] != '\0'; swap_line_bufs() ) {
+#ifdef HAVE_OPEN_MEMSTREAM
+    if ( fwrap == fto_wrap )
+      wrap_in_process_pump( /*is_eof=*/false );
+#endif /* HAVE_OPEN_MEMSTREAM */
+
+    //
+    // In order to know when a comment ends, we have to peek at the next line.
+    //
+    PJL_DISCARD_RV( READ_NEXT() );
+
+    if ( proto_is_comment && is_line_comment( CURR ) == NULL ) {
+      //
+      // This handles cases like:
+      //
+      //      proto     ->  # This is a comment.
+      //      curr_buf  ->  not_a_comment();
+      //
+      goto verbatim;
+    }
+
+    if ( !(proto_is_comment && is_line_comment( NEXT ) != NULL) &&
+         is_block_comment( CURR ) ) {
+      //
+      // This handles cases like:
+      //
+      //                    /*
+      //      proto     ->  This is a comment.
+      //      curr_buf  ->  */
+      //
+      // or:
+      //                    /*
+      //                     * This is a comment.
+      //      curr_buf  ->   */
+      //      next_buf  ->  [empty]
+      //
+      adjust_comment_width();
+      goto verbatim;
+    }
+
+    size_t curr_prefix_len = prefix_span( CURR );
+    if ( opt_doxygen || opt_markdown ) {
+      if ( curr_prefix_len > prefix_len ) {
+        //
+        // We can't strip all whitespace after the comment delimiter characters
+        // because:
+        //
+        // 1. Doxygen needs the whitespace when doing preformatted text.
+        // 2. Markdown relies on indentation for state changes.
+        //
+        // Hence we strip only the length of the initial prototype -- but only
+        // if it's less.
+        //
+        curr_prefix_len = prefix_len;
+      }
+      else if ( curr_prefix_len < prefix_len &&
+                !is_eol( CURR[ curr_prefix_len ] ) ) {
+        //
+        // The leading comment delimiter characters and/or whitespace length
+        // has decreased.  This can happen in a case like:
+        //
+        //      *  + This is a list item.
+        //      *
+        //      * Not part of the list item.
+        //
+        // where the list item was indented 2 spaces after the + but the
+        // regular text was indented only 1 space.  If this check were not
+        // done, then the "Not" text would end up also being indented 2 spaces.
+        //
+        // We therefore have to increase opt_line_width by the delta and also
+        // notify both wrap(1) and write_wrapped_line() of the changes.
+        //
+        opt_line_width += prefix_len - curr_prefix_len;
+        set_prefix( CURR, curr_prefix_len );
+        WIPC_SENDF(
+          fwrap, WIPC_CODE_NEW_LEADER, "%zu" WIPC_PARAM_SEP "%s\n",
+          opt_line_width, prefix_buf
+        );
+      }
+    }
+
+    // Skip over the prefix and chop off the suffix.
+    char *const line = skip_n( CURR, curr_prefix_len );
+    if ( suffix_buf[0] != '\0' )
+      chop_suffix( line );
+
+    if ( opt_doxygen && wrap_dox_line( line, fwrap ) )
+      continue;
+
+    FPUTS( line, fwrap );
+  } // for
+  return;
+
+verbatim:
+  //
+  // We've reached the end of the comment: signal wrap(1) that we're now
+  // ending wrapping, write any remaining lines, then just copy text through
+  // verbatim.
+  //
+  WIPC_SEND( fwrap, WIPC_CODE_WRAP_END );
+  FPUTS( CURR, fwrap );
+  FPUTS( NEXT, fwrap );
+#ifdef HAVE_OPEN_MEMSTREAM
+  if ( fwrap == fto_wrap ) {
+    //
+    // Everything from here on would be passed through verbatim by both the
+    // engine and write_wrapped_line() anyway, so skip them both.
+    //
+    wrap_in_process_pump( /*is_eof=*/true );
+    line_reader_copy( &stdin_lr, stdout );
+    return;
+  }
+#endif /* HAVE_OPEN_MEMSTREAM */
+  line_reader_copy( &stdin_lr, fwrap );
+}
+
 /**
  * Sets the prefix string.
  *
  * @param prefix The new prefix string.
- * @param len The number of characters of \a prefix to use.
+ * @param len The number of characters of \a prefix to use.  If it's longer
+ * than will fit into \ref prefix_buf, it's truncated.
  */
 static void set_prefix( char const *prefix, size_t len ) {
   assert( prefix != NULL );
+  if ( len > sizeof prefix_buf - 1 )
+    len = sizeof prefix_buf - 1;
   strncpy( prefix_buf, prefix, len );
   prefix_buf[ len ] = '\0';
   prefix_len = len;
@@ -1135,6 +1292,47 @@ static char* skip_n( char *s, size_t n ) {
   return s;
 }
 
+/**
+ * Receives the statistics sent by stats_send() from a child process and adds
+ * them to ours.
+ *
+ * @param fd The file descriptor of the pipe to read from.
+ */
+static void stats_receive( int fd ) {
+  wrap_stats_t child_wrap_stats;
+  wrapc_stats_t child_wrapc_stats;
+  PERROR_EXIT_IF(
+    read( fd, &child_wrap_stats, sizeof child_wrap_stats ) !=
+      STATIC_CAST( ssize_t, sizeof child_wrap_stats ) ||
+    read( fd, &child_wrapc_stats, sizeof child_wrapc_stats ) !=
+      STATIC_CAST( ssize_t, sizeof child_wrapc_stats ),
+    EX_IOERR
+  );
+  stats_add( &wrap_stats, &child_wrap_stats );
+  wrapc_stats.wipc_msgs += child_wrapc_stats.wipc_msgs;
+  wrapc_stats.bytes_piped += child_wrapc_stats.bytes_piped;
+  wrapc_stats.child_wait_s += child_wrapc_stats.child_wait_s;
+}
+
+/**
+ * Sends our statistics to the parent process to be received by
+ * stats_receive().
+ *
+ * @param fd The file descriptor of the pipe to write to.
+ *
+ * @note Together, they're smaller than `PIPE_BUF`, so this never blocks even
+ * though the parent reads them only after we exit.
+ */
+static void stats_send( int fd ) {
+  PERROR_EXIT_IF(
+    write( fd, &wrap_stats, sizeof wrap_stats ) !=
+      STATIC_CAST( ssize_t, sizeof wrap_stats ) ||
+    write( fd, &wrapc_stats, sizeof wrapc_stats ) !=
+      STATIC_CAST( ssize_t, sizeof wrapc_stats ),
+    EX_IOERR
+  );
+}
+
 /**
  * A special variant of **strlen**(3) that gets the length not including
  * trailing end-of-line characters, if any.
@@ -1177,9 +1375,9 @@ static char const* str_status( int status ) {
 }
 
 /**
- * Computes the width of a string where tabs have a width of opt_tab_spaces
- * spaces minus the number of spaces we're into a tab-stop; all others
- * characters have a width of 1.
+ * Computes the width of a UTF-8 string where tabs have a width of
+ * opt_tab_spaces spaces minus the number of spaces we're into a tab-stop; all
+ * other characters have their display width per cp_width().
  *
  * @param s The null-terminated string to calculate the width of.
  * @return Returns said width.
@@ -1188,8 +1386,15 @@ NODISCARD
 static size_t str_width( char const *s ) {
   assert( s != NULL );
   size_t width = 0;
-  while ( *s != '\0' )
-    width += char_width( *s++, width );
+  while ( *s != '\0' ) {
+    size_t const len = utf8_len( *s );
+    if ( len <= 1 || strnlen( s, len ) < len ) {
+      width += char_width( *s++, width );
+      continue;
+    }
+    width += cp_width( utf8_decode( s ) );
+    s += len;
+  } // while
   return width;
 }
 
@@ -1201,7 +1406,7 @@ static size_t str_width( char const *s ) {
  */
 static void usage( int status ) {
   fprintf( status == EX_OK ? stdout : stderr,
-"usage: " PACKAGE "c [options]\n"
+"usage: " PACKAGE "c [options] [file...]\n"
 "options:\n"
 "  --alias=NAME           " UOPT(ALIAS)
                           "Use alias from configuration file.\n"
@@ -1227,16 +1432,22 @@ static void usage( int status ) {
                           "Filename for stdin.\n"
 "  --help                 " UOPT(HELP)
                           "Print this help and exit.\n"
+"  --jobs=NUM             " UOPT(JOBS)
+                          "Files to wrap at once [default: CPUs].\n"
 "  --markdown             " UOPT(MARKDOWN)
                           "Format Markdown.\n"
 "  --no-config            " UOPT(NO_CONFIG)
                           "Suppress reading configuration file.\n"
 "  --no-hyphen            " UOPT(NO_HYPHEN)
                           "Suppress wrapping at hyphen characters.\n"
+"  --optimal              " UOPT(OPTIMAL)
+                          "Minimize raggedness instead of filling greedily.\n"
 "  --output=FILE          " UOPT(OUTPUT)
                           "Write to this file [default: stdout].\n"
 "  --para-chars=STR       " UOPT(PARA_CHARS)
                           "Additional paragraph delimiter characters.\n"
+"  --stats[=FILE]         " UOPT(STATS)
+                          "Print statistics as JSON [default: stderr].\n"
 "  --tab-spaces=NUM       " UOPT(TAB_SPACES)
                           "Tab-spaces equivalence [default: " STRINGIFY(TAB_SPACES_DEFAULT) "].\n"
 "  --title                " UOPT(TITLE_LINE)
@@ -1256,27 +1467,52 @@ PACKAGE_NAME " home page: " PACKAGE_URL "\n"
  */
 static void wait_for_child_processes( void ) {
 #ifndef DEBUG_RSWW
+  double const start_s = stats_clock();
   int wait_status;
-  for ( pid_t pid; (pid = wait( &wait_status )) > 0; ) {
-    if ( WIFEXITED( wait_status ) ) {
-      int const exit_status = WEXITSTATUS( wait_status );
-      if ( exit_status != 0 ) {
-        fatal_error( exit_status,
-          "child process exited with status %d: %s\n",
-          exit_status, str_status( exit_status )
-        );
-      }
-    } else if ( WIFSIGNALED( wait_status ) ) {
-      int const signal = WTERMSIG( wait_status );
-      fatal_error( EX_OSERR,
-        "child process terminated with signal %d: %s\n",
-        signal, strsignal( signal )
-      );
-    }
-  } // for
+  for ( pid_t pid; (pid = wait( &wait_status )) > 0; )
+    check_wait_status( wait_status );
+  wrapc_stats.child_wait_s += stats_clock() - start_s;
 #endif /* DEBUG_RSWW */
 }
 
+/**
+ * Wraps the comments read from standard input and writes them to standard
+ * output.
+ */
+static void wrap_comments( void ) {
+  line_reader_init( &stdin_lr, fileno( stdin ) );
+  size_t const size =
+    check_readline( &CURR, &input_lines.dl_curr_cap, &stdin_lr );
+  if ( size == 0 )
+    return;
+
+  if ( opt_eol == EOL_INPUT && is_windows_eol( CURR, size ) ) {
+    //
+    // Retroactively set opt_eol because we pass it to wrap(1).
+    //
+    opt_eol = EOL_WINDOWS;
+  }
+
+  if ( opt_align_column > 0 ) {
+    align_eol_comments( &CURR, &input_lines.dl_curr_cap, &stdin_lr );
+    return;
+  }
+
+  read_prototype();
+  init_out();
+#ifdef HAVE_OPEN_MEMSTREAM
+  if ( !is_affirmative( getenv( "WRAPC_EXEC_WRAP" ) ) ) {
+    wrap_in_process();
+    return;
+  }
+#endif /* HAVE_OPEN_MEMSTREAM */
+  PIPE( pipes[ TO_WRAP ] );
+  PIPE( pipes[ FROM_WRAP ] );
+  fork_exec_wrap( read_source_write_wrap() );
+  read_wrap_write_stdout();
+  wait_for_child_processes();
+}
+
 /**
  * If \a line starts with a Doxygen command, handle it.
  *
@@ -1356,6 +1592,192 @@ static bool wrap_dox_line( char const *line, FILE *fout ) {
   return true;
 }
 
+/**
+ * Wraps the comments in each of \ref opt_files and writes them to standard
+ * output in the order given.
+ *
+ * @remarks Since the state used to wrap comments is global, each file is
+ * wrapped by its own child process that writes to a temporary file; up to
+ * \ref opt_jobs children run at the same time.  Everything that doesn't
+ * depend on the input (parsing options, reading the configuration file,
+ * compiling regular expressions, etc.) is done only once beforehand.
+ */
+static void wrap_files( void ) {
+  assert( opt_files_len > 1 );
+  size_t const children_len =
+    opt_jobs < opt_files_len ? opt_jobs : opt_files_len;
+  wrap_child_t *const children = MALLOC( wrap_child_t, children_len );
+  size_t started = 0;
+
+#ifdef HAVE_OPEN_MEMSTREAM
+  if ( !is_affirmative( getenv( "WRAPC_EXEC_WRAP" ) ) ) {
+    //
+    // Compile the wrap engine's regular expressions just once here rather
+    // than in every child.
+    //
+    setlocale_utf8();
+    wrap_engine_compile();
+  }
+#endif /* HAVE_OPEN_MEMSTREAM */
+
+  for ( size_t i = 0; i < opt_files_len; ++i ) {
+    for ( ; started < opt_files_len && started - i < children_len;
+          ++started ) {
+      wrap_child_t *const child = &children[ started % children_len ];
+      child->fout = tmpfile();
+      PERROR_EXIT_IF( child->fout == NULL, EX_CANTCREAT );
+      //
+      // Flush before forking so the child doesn't inherit (and later also
+      // print) anything still in our buffer.
+      //
+      PERROR_EXIT_IF( fflush( stdout ) != 0, EX_IOERR );
+      int stats_pipe[2] = { -1, -1 };
+      if ( opt_stats != NULL )
+        PIPE( stats_pipe );
+      child->pid = fork();
+      PERROR_EXIT_IF( child->pid == -1, EX_OSERR );
+      if ( child->pid == 0 ) {
+        char const *const path = opt_files[ started ];
+        if ( !freopen( path, "r", stdin ) )
+          fatal_error( EX_NOINPUT, "\"%s\": %s\n", path, STRERROR() );
+        DUP2( fileno( child->fout ), STDOUT_FILENO );
+        //
+        // Start counting from zero: the counters inherited from the parent
+        // include those of children it's already received from.
+        //
+        MEM_ZERO( &wrap_stats );
+        MEM_ZERO( &wrapc_stats );
+        wrap_comments();
+        //
+        // Skip the atexit() clean-up: freeing memory shared with the parent
+        // (e.g., the compiled regular expressions) would only make the kernel
+        // copy its pages first.
+        //
+        PERROR_EXIT_IF( fflush( stdout ) != 0, EX_IOERR );
+        if ( opt_stats != NULL )
+          stats_send( stats_pipe[ STDOUT_FILENO ] );
+        TRACE_DUMP();
+        _exit( EX_OK );
+      }
+      if ( opt_stats != NULL )
+        close( stats_pipe[ STDOUT_FILENO ] );
+      child->stats_fd = stats_pipe[ STDIN_FILENO ];
+    } // for
+
+    wrap_child_t *const child = &children[ i % children_len ];
+    double const start_s = stats_clock();
+    int wait_status;
+    PERROR_EXIT_IF( waitpid( child->pid, &wait_status, 0 ) == -1, EX_OSERR );
+    wrapc_stats.child_wait_s += stats_clock() - start_s;
+    check_wait_status( wait_status );
+    if ( child->stats_fd != -1 ) {
+      stats_receive( child->stats_fd );
+      close( child->stats_fd );
+    }
+    rewind( child->fout );
+    fcopy( child->fout, stdout );
+    fclose( child->fout );
+  } // for
+
+  free( children );
+}
+
+/**
+ * Handles a line of output of **wrap**(1): if it's an IPC message, handles
+ * that; otherwise, prepends the leading whitespace and comment characters
+ * back to it and writes it to stdout.
+ *
+ * @param line The newline- and null-terminated line to handle.
+ * @param line_size The length of \a line.
+ * @return Returns `false` only if **wrap**(1) sent \ref WIPC_CODE_WRAP_END in
+ * which case all subsequent output must be written verbatim.
+ */
+static bool write_wrapped_line( char *line, size_t line_size ) {
+  assert( line != NULL );
+  wrapc_stats.bytes_piped += line_size;
+  line_size = chop_eol( line, line_size );
+
+  if ( line[0] == WIPC_CODE_HELLO ) {
+    ++wrapc_stats.wipc_msgs;
+    TRACE_EVENT(
+      TRACE_EVENT_IPC, STATIC_CAST( unsigned char, line[1] ), /*line=*/0,
+      line_size, /*hyphen=*/0
+    );
+    switch ( STATIC_CAST( wipc_code_t, line[1] ) ) {
+      case WIPC_CODE_HELLO:             // shouldn't happen
+        break;
+
+      case WIPC_CODE_NEW_LEADER:
+        NO_OP;
+        //
+        // We've been told by read_source() (via wrap) that the leading comment
+        // delimiter characters and/or whitespace has changed: adjust
+        // out_line_width and out_prefix_buf.
+        //
+        char *sep;
+        out_line_width = strtoul( line + 2, &sep, 10 );
+        size_t const out_prefix_len = strcpy_len( out_prefix_buf, sep + 1 );
+        split_tws( out_prefix_buf, out_prefix_len, out_proto_tws );
+        return true;
+
+      case WIPC_CODE_DELIMIT_PARAGRAPH:
+      case WIPC_CODE_PREFORMATTED_BEGIN:
+      case WIPC_CODE_PREFORMATTED_END:
+        //
+        // We only have to "eat" these and do nothing else.
+        //
+        return true;
+
+      case WIPC_CODE_WRAP_END:
+        return false;
+    } // switch
+
+    //
+    // We got a HELLO followed by an unknown WIPC code: skip over the HELLO
+    // and format the remaining buffer.
+    //
+    ++line;
+    --line_size;
+  }
+
+  //
+  // If there's a suffix, pad the width with spaces in order to append the
+  // terminating comment character(s) back.
+  //
+  size_t pad_len = 0;
+  if ( suffix_buf[0] != '\0' ) {
+    size_t const line_width = utf8_width( line, line_size );
+    if ( line_width < out_line_width )
+      pad_len = out_line_width - line_width;
+  }
+
+  //
+  // Assemble the whole output line so it's written with a single call.
+  //
+  static char   *out_buf;
+  static size_t  out_cap;
+
+  str_reserve( &out_buf, &out_cap,
+    sizeof out_prefix_buf + sizeof out_proto_tws + line_size + pad_len +
+    sizeof suffix_buf + 2/*\r\n*/
+  );
+
+  char *p = out_buf;
+  p += strcpy_len( p, out_prefix_buf );
+  if ( !is_blank_line( line ) )         // don't emit proto_tws for blank lines
+    p += strcpy_len( p, out_proto_tws );
+  memcpy( p, line, line_size );
+  p += line_size;
+  memset( p, ' ', pad_len );
+  p += pad_len;
+  p += strcpy_len( p, suffix_buf );
+  p += strcpy_len( p, eol() );
+
+  size_t const out_len = STATIC_CAST( size_t, p - out_buf );
+  PERROR_EXIT_IF( fwrite( out_buf, 1, out_len, stdout ) < out_len, EX_IOERR );
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /** @} */
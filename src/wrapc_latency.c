@@ -0,0 +1,221 @@
+/*
+**      wrap -- text reformatter
+**      src/wrapc_latency.c
+**
+**      Copyright (C) 2025  Paul J. Lucas
+**
+**      This program is free software: you can redistribute it and/or modify
+**      it under the terms of the GNU General Public License as published by
+**      the Free Software Foundation, either version 3 of the License, or
+**      (at your option) any later version.
+**
+**      This program is distributed in the hope that it will be useful,
+**      but WITHOUT ANY WARRANTY; without even the implied warranty of
+**      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**      GNU General Public License for more details.
+**
+**      You should have received a copy of the GNU General Public License
+**      along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file
+ * Measures the per-invocation latency of **wrapc**(1) both when wrapping
+ * in-process (the default) and when exec'ing **wrap**(1) via pipes (when
+ * `WRAPC_EXEC_WRAP` is set), e.g.:
+ *
+ *      $ ./wrapc_latency -n 500 ./wrapc ../test/data/hello_01.c -w40
+ */
+
+// local
+#include "pjl_config.h"                 /* must go first */
+#include "util.h"
+
+// standard
+#include <fcntl.h>                      /* for open() */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>                   /* for waitpid() */
+#include <sysexits.h>
+#include <time.h>                       /* for clock_gettime() */
+#include <unistd.h>                     /* for fork(), ... */
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Default number of times to run **wrapc**(1) per mode.
+#define RUNS_DEFAULT              200
+
+// extern variable definitions
+char const       *me;                   ///< Program name.
+
+////////// local functions ////////////////////////////////////////////////////
+
+/**
+ * Compares two `double` values for qsort().
+ *
+ * @param i_data A pointer to the first value.
+ * @param j_data A pointer to the second value.
+ * @return Returns a number less than 0, 0, or greater than 0 if \a i_data is
+ * less than, equal to, or greater than \a j_data, respectively.
+ */
+NODISCARD
+static int double_cmp( void const *i_data, void const *j_data ) {
+  double const i = *POINTER_CAST( double const*, i_data );
+  double const j = *POINTER_CAST( double const*, j_data );
+  return (i > j) - (i < j);
+}
+
+/**
+ * Gets the current time in microseconds from an arbitrary epoch.
+ *
+ * @return Returns said time.
+ */
+NODISCARD
+static double now_us( void ) {
+  struct timespec ts;
+  PERROR_EXIT_IF( clock_gettime( CLOCK_MONOTONIC, &ts ) != 0, EX_OSERR );
+  return STATIC_CAST( double, ts.tv_sec ) * 1e6 +
+         STATIC_CAST( double, ts.tv_nsec ) / 1e3;
+}
+
+/**
+ * Runs **wrapc**(1) once and waits for it to exit.
+ *
+ * @param argv The arguments to exec.
+ * @param in_path The path of the file to use as standard input.
+ * @param exec_wrap If `true`, tell **wrapc**(1) to exec **wrap**(1).
+ */
+static void run_once( char *const argv[], char const *in_path,
+                      bool exec_wrap ) {
+  pid_t const pid = fork();
+  PERROR_EXIT_IF( pid == -1, EX_OSERR );
+  if ( pid == 0 ) {
+    int const in_fd = open( in_path, O_RDONLY );
+    PERROR_EXIT_IF( in_fd == -1, EX_NOINPUT );
+    int const out_fd = open( "/dev/null", O_WRONLY );
+    PERROR_EXIT_IF( out_fd == -1, EX_OSERR );
+    DUP2( in_fd, STDIN_FILENO );
+    DUP2( out_fd, STDOUT_FILENO );
+    if ( exec_wrap )
+      PERROR_EXIT_IF( setenv( "WRAPC_EXEC_WRAP", "1", 1 ) != 0, EX_OSERR );
+    else
+      PERROR_EXIT_IF( unsetenv( "WRAPC_EXEC_WRAP" ) != 0, EX_OSERR );
+    execv( argv[0], argv );
+    perror_exit( EX_OSERR );
+  }
+
+  int wait_status;
+  PERROR_EXIT_IF( waitpid( pid, &wait_status, 0 ) == -1, EX_OSERR );
+  if ( !WIFEXITED( wait_status ) || WEXITSTATUS( wait_status ) != 0 )
+    fatal_error( EX_SOFTWARE, "%s failed\n", argv[0] );
+}
+
+/**
+ * Runs **wrapc**(1) \a runs times and prints latency statistics.
+ *
+ * @param name The name of the mode.
+ * @param argv The arguments to exec.
+ * @param in_path The path of the file to use as standard input.
+ * @param exec_wrap If `true`, tell **wrapc**(1) to exec **wrap**(1).
+ * @param runs The number of times to run.
+ * @return Returns the mean latency in microseconds.
+ */
+static double run_mode( char const *name, char *const argv[],
+                        char const *in_path, bool exec_wrap, size_t runs ) {
+  double *const us = MALLOC( double, runs );
+  double total = 0;
+
+  run_once( argv, in_path, exec_wrap ); // warm up
+  for ( size_t i = 0; i < runs; ++i ) {
+    double const start = now_us();
+    run_once( argv, in_path, exec_wrap );
+    us[i] = now_us() - start;
+    total += us[i];
+  } // for
+
+  qsort( us, runs, sizeof us[0], &double_cmp );
+  double const mean = total / STATIC_CAST( double, runs );
+  PRINTF(
+    "%-12s %6zu %10.1f %10.1f %10.1f\n",
+    name, runs, mean, us[ runs / 2 ], us[ runs * 99 / 100 ]
+  );
+  free( us );
+  return mean;
+}
+
+_Noreturn
+static void usage( void ) {
+  EPRINTF( "usage: %s [-n runs] wrapc-path file [wrapc-options...]\n", me );
+  exit( EX_USAGE );
+}
+
+////////// main ///////////////////////////////////////////////////////////////
+
+int main( int argc, char *argv[] ) {
+  me = base_name( argv[0] );
+
+  //
+  // Don't use getopt() since it may permute wrapc's options.
+  //
+  size_t runs = RUNS_DEFAULT;
+  --argc;
+  ++argv;
+  if ( argc >= 2 && strcmp( argv[0], "-n" ) == 0 ) {
+    runs = check_atou( argv[1] );
+    argc -= 2;
+    argv += 2;
+  }
+  if ( argc < 2 || runs == 0 )
+    usage();
+
+  char const *const wrapc_path = argv[0];
+  char const *const in_path = argv[1];
+
+  //
+  // Make sure that wrapc exec's the wrap that's alongside it rather than
+  // whatever wrap happens to be in the user's PATH.
+  //
+  char const *const path = getenv( "PATH" );
+  size_t const dir_len =
+    strlen( wrapc_path ) - strlen( base_name( wrapc_path ) );
+  size_t const path_len = path != NULL ? strlen( path ) : 0;
+  char *const new_path =
+    MALLOC( char, dir_len + 1/*.*/ + 1/*:*/ + path_len + 1/*\0*/ );
+  if ( dir_len > 0 )
+    strncpy( new_path, wrapc_path, dir_len )[ dir_len ] = '\0';
+  else
+    strcpy( new_path, "." );
+  if ( path != NULL )
+    strcat( strcat( new_path, ":" ), path );
+  PERROR_EXIT_IF( setenv( "PATH", new_path, 1 ) != 0, EX_OSERR );
+  free( new_path );
+
+  //
+  // Build wrapc's argv: wrapc-path -c/dev/null [wrapc-options...]
+  //
+  char **const wrapc_argv = MALLOC( char*, STATIC_CAST( size_t, argc ) + 1 );
+  size_t wrapc_argc = 0;
+  wrapc_argv[ wrapc_argc++ ] = CONST_CAST( char*, wrapc_path );
+  wrapc_argv[ wrapc_argc++ ] = CONST_CAST( char*, "-c/dev/null" );
+  for ( int i = 2; i < argc; ++i )
+    wrapc_argv[ wrapc_argc++ ] = argv[i];
+  wrapc_argv[ wrapc_argc ] = NULL;
+
+  PRINTF(
+    "%-12s %6s %10s %10s %10s\n", "mode", "runs", "mean(us)", "p50(us)",
+    "p99(us)"
+  );
+  double const in_process =
+    run_mode( "in-process", wrapc_argv, in_path, /*exec_wrap=*/false, runs );
+  double const exec_wrap =
+    run_mode( "exec", wrapc_argv, in_path, /*exec_wrap=*/true, runs );
+  PRINTF( "speedup: %.2fx\n", exec_wrap / in_process );
+
+  free( wrapc_argv );
+  exit( EX_OK );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/* vim:set et sw=2 ts=2: */
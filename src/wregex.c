@@ -26,94 +26,222 @@
 // local
 #include "pjl_config.h"                 /* must go first */
 #include "wregex.h"
+#include "dfa.h"
 #include "unicode.h"
 #include "util.h"
 
 // standard
 #include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 #include <sysexits.h>
-#include <wctype.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
 // local constant definitions
+#ifndef WITH_DFA_REGEX
 static int const    WRAP_REGEX_COMPILE_FLAGS = REG_EXTENDED;
+#endif /* WITH_DFA_REGEX */
 
-////////// inline functions ///////////////////////////////////////////////////
+/// Characters that are special in a POSIX extended regular expression.
+static char const   RE_SPECIAL_CHARS[] = ".[]()*+?{}|^$\\";
+
+// local functions
+NODISCARD
+static char const*  regex_skip_bracket( char const* );
+
+////////// local functions ////////////////////////////////////////////////////
 
 /**
- * Checks whether \a cp is a word character, that is an alphanumeric or \c _
- * character.  Note that this function is locale sensitive.
+ * Checks whether \a p contains a `|` that's neither inside a parenthesized
+ * group nor a bracket expression, i.e., one that separates alternatives of
+ * the whole pattern.
  *
- * @param cp The code-point to check.
- * @return Returns `true` only if \a cp is a word code-point.
+ * @param p The part of a regular expression pattern to check.  It must not
+ * start inside a group or bracket expression.
+ * @return Returns `true` only if it does.
  */
 NODISCARD
-static inline bool cp_is_word_char( char32_t cp ) {
-  return iswalnum( STATIC_CAST( wint_t, cp ) ) || cp == '_';
+static bool regex_has_alternation( char const *p ) {
+  for ( unsigned depth = 0; *p != '\0'; ) {
+    switch ( *p++ ) {
+      case '\\':
+        if ( *p != '\0' )
+          ++p;
+        break;
+      case '[':
+        p = regex_skip_bracket( p );
+        break;
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        if ( depth > 0 )
+          --depth;
+        break;
+      case '|':
+        if ( depth == 0 )
+          return true;
+        break;
+    } // switch
+  } // for
+  return false;
 }
 
-////////// local functions ////////////////////////////////////////////////////
-
 /**
- * Checks whether the character at \a curr is the beginning of a word.  This
- * function exists because POSIX regular expressions don't support \c \\b
- * (match a word boundary).
+ * Extracts the literal prefix, if any, that every match of \a pattern must
+ * start with.
+ *
+ * @remarks This is conservative: it only bothers with patterns anchored by
+ * `^`, stops at the first character that isn't a plain literal, and then
+ * discards the prefix if the rest of the pattern has alternatives at the top
+ * level since they don't have to start with it.
  *
- * @param s The UTF-8 encoded string to check within.
- * @param curr A pointer to the first byte of the UTF-8 encoded character to
- * check.
- * @return Returns `true` only if the character at \a curr is at the beginning
- * of a word.
+ * @param re A pointer to the wregex_t to set the prefix of.
+ * @param pattern The regular expression pattern \a re was compiled from.
  */
-NODISCARD
-static bool is_begin_word_boundary( char const *s, char const *curr ) {
-  assert( s != NULL );
-  assert( curr != NULL );
-  assert( curr >= s );
+static void regex_find_prefix( wregex_t *re, char const *pattern ) {
+  if ( pattern[0] != '^' )
+    return;
 
-  if ( curr == s )
-    return true;
-  char const *const prev = utf8_rsync( s, curr - 1 );
-  if ( prev == NULL )
-    return true;
+  char const *p = pattern + 1;
+  while ( *p != '\0' ) {
+    char const *lit = p;
+    size_t lit_len;
+    if ( *p == '\\' ) {
+      //
+      // A backslash followed by anything other than a special character is
+      // either a back-reference or a GNU extension like \w.
+      //
+      if ( p[1] == '\0' || strchr( RE_SPECIAL_CHARS, p[1] ) == NULL )
+        break;
+      lit_len = 1;
+      ++lit;
+      p += 2;
+    }
+    else {
+      if ( strchr( RE_SPECIAL_CHARS, *p ) != NULL )
+        break;
+      lit_len = utf8_len( *p );
+      if ( lit_len == 0 || strnlen( p, lit_len ) < lit_len )
+        break;
+      p += lit_len;
+    }
 
-  char32_t const curr_cp = utf8_decode( curr );
-  char32_t const prev_cp = utf8_decode( prev );
+    //
+    // A literal followed by a quantifier that allows zero of it isn't
+    // required; one followed by '+' is, but nothing after it is.
+    //
+    if ( *p == '*' || *p == '?' || *p == '{' )
+      break;
+    if ( re->prefix_len + lit_len > WREGEX_PREFIX_MAX )
+      break;
+    memcpy( re->prefix + re->prefix_len, lit, lit_len );
+    re->prefix_len += lit_len;
+    if ( *p == '+' )
+      break;
+  } // while
 
-  return (cp_is_word_char( curr_cp ) ^ cp_is_word_char( prev_cp ))
-      || (cp_is_space( curr_cp ) ^ cp_is_space( prev_cp ));
+  if ( re->prefix_len > 0 && regex_has_alternation( p ) ) {
+    re->prefix_len = 0;
+    re->prefix[0] = '\0';
+  }
+}
+
+/**
+ * Skips over a bracket expression.
+ *
+ * @param p A pointer to just past the `[` that starts the bracket expression.
+ * @return Returns a pointer to just past the `]` that ends it or to the
+ * terminating null if there is none.
+ */
+NODISCARD
+static char const* regex_skip_bracket( char const *p ) {
+  if ( *p == '^' )
+    ++p;
+  if ( *p == ']' )                      // a leading ']' is a literal
+    ++p;
+  while ( *p != ']' ) {
+    if ( *p == '\0' )
+      return p;
+    if ( p[0] == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '=') ) {
+      char const end[] = { p[1], ']', '\0' };
+      char const *const end_p = strstr( p + 2, end );
+      if ( end_p == NULL )
+        return p + strlen( p );
+      p = end_p + 2;
+      continue;
+    }
+    ++p;
+  } // while
+  return p + 1;
 }
 
 ////////// extern functions ///////////////////////////////////////////////////
 
+bool regex_can_match( wregex_t const *re, char const *s, size_t offset ) {
+  assert( re != NULL );
+  assert( s != NULL );
+  if ( re->prefix_len == 0 )
+    return true;
+  return strncmp( s + offset, re->prefix, re->prefix_len ) == 0;
+}
+
+void regex_cache_free( wregex_cache_t *cache ) {
+  assert( cache != NULL );
+#ifdef WITH_DFA_REGEX
+  dfa_cache_free( &cache->dfa_cache );
+#else
+  (void)cache;
+#endif /* WITH_DFA_REGEX */
+}
+
 int regex_compile( wregex_t *re, char const *pattern ) {
   assert( re != NULL );
   assert( pattern != NULL );
-  return regcomp( re, pattern, WRAP_REGEX_COMPILE_FLAGS );
+  MEM_ZERO( re );
+#ifdef WITH_DFA_REGEX
+  int const err_code = dfa_compile( &re->dfa, pattern );
+#else
+  int const err_code =
+    regcomp( &re->regex, pattern, WRAP_REGEX_COMPILE_FLAGS );
+#endif /* WITH_DFA_REGEX */
+  if ( err_code == 0 )
+    regex_find_prefix( re, pattern );
+  return err_code;
 }
 
-char const* regex_error( wregex_t *re, int err_code ) {
+char const* regex_error( wregex_t const *re, int err_code ) {
   assert( re != NULL );
+#ifdef WITH_DFA_REGEX
+  return dfa_error( err_code );
+#else
   static char err_buf[ 128 ];
-  PJL_DISCARD_RV( regerror( err_code, re, err_buf, sizeof err_buf ) );
+  PJL_DISCARD_RV( regerror( err_code, &re->regex, err_buf, sizeof err_buf ) );
   return err_buf;
+#endif /* WITH_DFA_REGEX */
 }
 
-void regex_free( wregex_t *re ) {
-  assert( re != NULL );
-  regfree( re );
-}
-
-bool regex_match( wregex_t *re, char const *s, size_t offset, size_t *range ) {
+bool regex_exec( wregex_t const *re, wregex_cache_t *cache, char const *s,
+                 size_t offset, size_t *range ) {
   assert( re != NULL );
+  assert( cache != NULL );
   assert( s != NULL );
 
   char const *const so = s + offset;
-  regmatch_t match[ re->re_nsub + 1 ];
+  size_t match_range[2];
 
-  int const err_code = regexec( re, so, re->re_nsub + 1, match, /*eflags=*/0 );
+#ifdef WITH_DFA_REGEX
+  if ( !dfa_match( &re->dfa, &cache->dfa_cache, so, match_range ) )
+    return false;
+#else
+  (void)cache;
+  //
+  // Only the range of the whole match is needed, not those of any
+  // subexpressions.
+  //
+  regmatch_t match[1];
+  int const err_code = regexec( &re->regex, so, 1, match, /*eflags=*/0 );
 
   if ( err_code == REG_NOMATCH )
     return false;
@@ -123,15 +251,40 @@ bool regex_match( wregex_t *re, char const *s, size_t offset, size_t *range ) {
       err_code, regex_error( re, err_code )
     );
   }
-  if ( !is_begin_word_boundary( so, so + match[0].rm_so ) )
+  match_range[0] = STATIC_CAST( size_t, match[0].rm_so );
+  match_range[1] = STATIC_CAST( size_t, match[0].rm_eo );
+#endif /* WITH_DFA_REGEX */
+
+  //
+  // POSIX regular expressions don't support \b (match a word boundary), so
+  // check for one ourselves.  (The DFA engine does support \<, but a match
+  // that's not at the beginning of a word still means no match at all rather
+  // than looking for a later one so both engines match the same things.)
+  //
+  if ( !utf8_is_word_begin( so, so + match_range[0] ) )
     return false;
 
   if ( range != NULL ) {
-    range[0] = STATIC_CAST( size_t, match[0].rm_so ) + offset;
-    range[1] = STATIC_CAST( size_t, match[0].rm_eo ) + offset;
+    range[0] = match_range[0] + offset;
+    range[1] = match_range[1] + offset;
   }
   return true;
 }
 
+void regex_free( wregex_t *re ) {
+  assert( re != NULL );
+#ifdef WITH_DFA_REGEX
+  dfa_free( &re->dfa );
+#else
+  regfree( &re->regex );
+#endif /* WITH_DFA_REGEX */
+}
+
+bool regex_match( wregex_t const *re, wregex_cache_t *cache, char const *s,
+                  size_t offset, size_t *range ) {
+  return  regex_can_match( re, s, offset ) &&
+          regex_exec( re, cache, s, offset, range );
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /* vim:set et sw=2 ts=2: */
@@ -24,11 +24,13 @@
 /**
  * @file
  * Declares macros for e-mail and URI regular expressions as well as a wrapper
- * API around POSIX regex (that could easily be swapped out for, say, PCRE2).
+ * API around either POSIX regex or, if configured `--with-regex=dfa`, the
+ * built-in DFA regular expression engine.
  */
 
 // local
 #include "pjl_config.h"                 /* must go first */
+#include "dfa.h"
 
 // standard
 #include <regex.h>
@@ -108,6 +110,9 @@
 
 /**
  * Regular expression for all URIs not to wrap at hyphens.
+ *
+ * @note **wrap**(1) itself uses uri_match() that matches exactly the same
+ * thing, but much faster; this is kept as the reference it's tested against.
  */
 #define WRAP_RE                   \
   "(" WRAP_RE_EMAIL ")"     "|"   \
@@ -115,13 +120,75 @@
   "(" WRAP_RE_FTP_URI ")"   "|"   \
   "(" WRAP_RE_HTTP_URI ")"
 
-typedef regex_t wregex_t;
+/**
+ * Maximum number of bytes of a literal prefix kept by \ref wregex.
+ */
+#define WREGEX_PREFIX_MAX         32
+
+/**
+ * A compiled regular expression along with a literal prefix every match must
+ * start with, if any, that's used to reject strings that can't possibly match
+ * without running the regular expression engine at all.
+ */
+struct wregex {
+#ifdef WITH_DFA_REGEX
+  dfa_t     dfa;                        ///< Compiled regular expression.
+#else
+  regex_t   regex;                      ///< Compiled regular expression.
+#endif /* WITH_DFA_REGEX */
+  char      prefix[ WREGEX_PREFIX_MAX + 1 ];  ///< Literal prefix of matches.
+  size_t    prefix_len;                 ///< Length of \ref prefix.
+};
+typedef struct wregex wregex_t;
+
+/**
+ * State needed to match against a \ref wregex.  A \ref wregex is read-only
+ * once compiled, so any number of threads may match against the same one at
+ * the same time as long as each uses its own wregex_cache.
+ *
+ * @remarks It must be zero-initialized before its first use and freed by
+ * regex_cache_free().
+ */
+struct wregex_cache {
+#ifdef WITH_DFA_REGEX
+  dfa_cache_t dfa_cache;                ///< Lazily built DFA states.
+#else
+  char        unused;                   ///< POSIX regex needs no state.
+#endif /* WITH_DFA_REGEX */
+};
+typedef struct wregex_cache wregex_cache_t;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ * Checks whether \a s can possibly match the previously compiled regular
+ * expression pattern in \a re by checking only for its literal prefix.
+ *
+ * @param re A pointer to the wregex_t to check against.
+ * @param s The string to check.
+ * @param offset The offset into \a s to start.
+ * @return Returns `false` only if \a s can't possibly match.
+ *
+ * @sa regex_exec()
+ * @sa regex_match()
+ */
+NODISCARD
+bool regex_can_match( wregex_t const *re, char const *s, size_t offset );
+
+/**
+ * Frees all memory used by a wregex_cache_t.  It may then be used again.
+ *
+ * @param cache A pointer to the wregex_cache_t to free.
+ */
+void regex_cache_free( wregex_cache_t *cache );
+
 /**
  * Compiles a regular expression pattern.
  *
+ * @remarks If \a pattern is anchored by `^` and every match must start with a
+ * literal prefix, it's also extracted so regex_match() can reject strings that
+ * don't start with it with just a byte comparison.
+ *
  * @param re A pointer to the wregex_t to compile to.
  * @param pattern The regular expression pattern to compile.
  * @return Returns 0 on success or non-zero for an invalid \a pattern.
@@ -137,7 +204,27 @@ int regex_compile( wregex_t *re, char const *pattern );
  * @return Returns a pointer to a static buffer containing the error message.
  */
 NODISCARD
-char const* regex_error( wregex_t *re, int err_code );
+char const* regex_error( wregex_t const *re, int err_code );
+
+/**
+ * Attempts to match \a s against the previously compiled regular expression
+ * pattern in \a re without first calling regex_can_match().
+ *
+ * @param re A pointer to the wregex_t to match against.
+ * @param cache A pointer to the wregex_cache_t to use.
+ * @param s The string to match.
+ * @param offset The offset into \a s to start.
+ * @param range A pointer to an array of size 2 to receive the beginning
+ * position and one past the end position of the match -- set only if not NULL
+ * and there was a match.
+ * @return Returns `true` only if there was a match.
+ *
+ * @sa regex_can_match()
+ * @sa regex_match()
+ */
+NODISCARD
+bool regex_exec( wregex_t const *re, wregex_cache_t *cache, char const *s,
+                 size_t offset, size_t *range );
 
 /**
  * Frees all memory used by a wregex_t.
@@ -148,9 +235,11 @@ void regex_free( wregex_t *re );
 
 /**
  * Attempts to match \a s against the previously compiled regular expression
- * pattern in \a re.
+ * pattern in \a re.  It's the same as calling regex_can_match() and, only if
+ * it returns `true`, regex_exec().
  *
  * @param re A pointer to the wregex_t to match against.
+ * @param cache A pointer to the wregex_cache_t to use.
  * @param s The string to match.
  * @param offset The offset into \a s to start.
  * @param range A pointer to an array of size 2 to receive the beginning
@@ -159,8 +248,8 @@ void regex_free( wregex_t *re );
  * @return Returns `true` only if there was a match.
  */
 NODISCARD
-bool regex_match( wregex_t *re, char const *s, size_t offset,
-                  size_t *range );
+bool regex_match( wregex_t const *re, wregex_cache_t *cache, char const *s,
+                  size_t offset, size_t *range );
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,5 @@
+/* aaaa bbbb */
+/* é é é */
+/* 日本 語 */
+/* é 日本 é 語 é 日本語 */
+/* 日本語日本語日本語日本語日本語 */
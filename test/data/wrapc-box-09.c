@@ -0,0 +1,3 @@
+/* aaaa bbbb */
+/* é é é */
+/* 日本 語 */
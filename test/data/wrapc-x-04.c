@@ -0,0 +1,8 @@
+/**
+ * @file wrapc-x-04.c
+ * Commands that sort after others sharing their prefix must still be found.
+ * @namespace ns
+ * Each of these is an end-of-line command.
+ * @relatedalso Foo
+ * So none of this text should be joined to them.
+ */
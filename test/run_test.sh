@@ -190,6 +190,19 @@ run_regex_file() {
   fi
 }
 
+run_script_file() {
+  EXPECTED_OUTPUT="$EXPECTED_DIR/`echo $TEST_NAME | sed s/sh$/txt/`"
+  if sh $TEST > $OUTPUT 2> $LOG_FILE
+  then
+    if diff $EXPECTED_OUTPUT $OUTPUT > $LOG_FILE
+    then pass; mv $OUTPUT $LOG_FILE
+    else fail
+    fi
+  else
+    fail ERROR
+  fi
+}
+
 run_wrap_file() {
   [ "$IFS" ] && IFS_old=$IFS
   IFS='|'; read COMMAND CONFIG OPTIONS INPUT EXPECTED_EXIT < $TEST
@@ -245,10 +258,17 @@ unset WRAPC_DEBUG
 unset WRAPC_DEBUG_RSRW
 unset WRAPC_DEBUG_RW
 
+##
+# Script tests may need these.
+##
+export DATA_DIR
+TEST_TMP=/tmp/wrap_test_tmp_$$_; export TEST_TMP
+
 trap "x=$?; rm -f /tmp/*_$$_* 2>/dev/null; exit $x" EXIT HUP INT TERM
 
 case $TEST in
 *.regex)  run_regex_file ;;
+*.sh)     run_script_file ;;
 *.test)   run_wrap_file ;;
 esac
 
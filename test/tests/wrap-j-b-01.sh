@@ -0,0 +1,17 @@
+# Wraps many small chunks of non-ASCII input by worker threads that all match
+# lines against the same --block-regex: with the DFA regex engine, each
+# wrap_ctx must use its own DFA state cache.  The output must be the same as
+# wrapping it all at once.
+awk 'BEGIN {
+  for ( i = 0; i < 2000; ++i ) {
+    print "Ångström λόγος слово 日本語 façade über señor время 한국어 φύσις"
+    print "日本語 starts a line that the block regex matches"
+    print "ἀρχή слово λόγος naïve élève время 全角 文字 Café résumé"
+    print ""
+  }
+}' > ${TEST_TMP}in
+WRAP_CHUNK_SIZE_MIN=64; export WRAP_CHUNK_SIZE_MIN
+wrap -c /dev/null -b '[[:alpha:]]+語' -j1 -w40 < ${TEST_TMP}in > ${TEST_TMP}j1 &&
+wrap -c /dev/null -b '[[:alpha:]]+語' -j8 -w40 < ${TEST_TMP}in > ${TEST_TMP}j8 &&
+cmp ${TEST_TMP}j1 ${TEST_TMP}j8 >&2 &&
+LC_ALL=C sort ${TEST_TMP}j8 | uniq -c
@@ -0,0 +1,10 @@
+# Splits a single input into many small chunks (WRAP_CHUNK_SIZE_MIN is honored
+# only when not compiled with NDEBUG) wrapped by worker threads: the output
+# must be the same as wrapping it all at once, whether the input is mapped or
+# read from a pipe.
+WRAP_CHUNK_SIZE_MIN=16; export WRAP_CHUNK_SIZE_MIN
+for f in data-01.txt hyphen-01.txt long_line-05.txt
+do
+  wrap -c /dev/null -j4 -w40 < $DATA_DIR/$f || exit
+  cat $DATA_DIR/$f | wrap -c /dev/null -j4 -w40 || exit
+done
@@ -0,0 +1,8 @@
+# Wraps several files with more than one worker thread: the output of each
+# must be written in the order the files were given.
+wrap -c /dev/null -j2 -w40 \
+  $DATA_DIR/long_line-05.txt \
+  $DATA_DIR/data-01.txt \
+  $DATA_DIR/data-02.txt \
+  $DATA_DIR/hyphen-01.txt \
+  $DATA_DIR/wrap-b.txt
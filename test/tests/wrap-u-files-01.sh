@@ -0,0 +1,16 @@
+# Wraps several Markdown files, some of which end within a code fence, both
+# serially and by worker threads, each reusing a wrap_ctx for every file: all
+# Markdown state must be reset between files so the output must be the same
+# as wrapping each file by itself.
+head -3 $DATA_DIR/md-code-fence-01a.md > ${TEST_TMP}fence.md
+set -- ${TEST_TMP}fence.md $DATA_DIR/md-atx-01.md \
+       ${TEST_TMP}fence.md $DATA_DIR/md-code-fence-01a.md
+for f
+do
+  wrap -c /dev/null -u -w40 $f || exit
+done > ${TEST_TMP}each
+wrap -c /dev/null -u -w40 "$@" > ${TEST_TMP}j1 &&
+wrap -c /dev/null -j2 -u -w40 "$@" > ${TEST_TMP}j2 &&
+cmp ${TEST_TMP}each ${TEST_TMP}j1 >&2 &&
+cmp ${TEST_TMP}each ${TEST_TMP}j2 >&2 &&
+cat ${TEST_TMP}j2
@@ -0,0 +1,49 @@
+# Writes --stats to a file and prints its counters that don't depend on
+# timing.  With --jobs, the counters of each file, or of each chunk of a single
+# input, must add up to the same totals as wrapping without worker threads.
+stats() {
+  tr '{,}' '\n\n\n' < $1 | grep ':[0-9]' | grep -v '_s":'
+}
+sum() {
+  awk -F: '{ k[FNR] = $1; v[FNR] += $2 }
+    END { for ( i = 1; i <= FNR; ++i ) print k[i] ":" v[i] }' "$@"
+}
+
+wrap -c /dev/null -u -w40 -z${TEST_TMP}md \
+  < $DATA_DIR/md-atx-01.md > /dev/null || exit
+echo "# -u"
+stats ${TEST_TMP}md
+
+files= each=
+for f in data-01.txt hyphen-01.txt long_line-05.txt wrap-b.txt
+do
+  wrap -c /dev/null -b@ -w40 -z${TEST_TMP}$f < $DATA_DIR/$f > /dev/null ||
+    exit
+  stats ${TEST_TMP}$f > ${TEST_TMP}$f.stats
+  files="$files $DATA_DIR/$f" each="$each ${TEST_TMP}$f.stats"
+done
+wrap -c /dev/null -b@ -j2 -w40 -z${TEST_TMP}j2 $files > /dev/null || exit
+stats ${TEST_TMP}j2 > ${TEST_TMP}j2.stats
+sum $each | cmp - ${TEST_TMP}j2.stats >&2 || exit
+echo "# -j2 files"
+cat ${TEST_TMP}j2.stats
+
+awk 'BEGIN {
+  for ( i = 0; i < 200; ++i ) {
+    print "The quick brown fox jumps over the lazy dog.  It was a dark and"
+    print "stormy night; the rain fell in torrents -- except at occasional"
+    if ( i % 5 == 0 )
+      print "@param x A parameter."
+    if ( i % 7 == 0 )
+      print "intervals, when it was checked by a_violent_gust_of_wind_that_swept"
+    print ""
+  }
+}' > ${TEST_TMP}in
+WRAP_CHUNK_SIZE_MIN=64; export WRAP_CHUNK_SIZE_MIN
+wrap -c /dev/null -b@ -j1 -w40 -z${TEST_TMP}j1 < ${TEST_TMP}in > /dev/null &&
+wrap -c /dev/null -b@ -j4 -w40 -z${TEST_TMP}j4 < ${TEST_TMP}in > /dev/null ||
+  exit
+stats ${TEST_TMP}j1 > ${TEST_TMP}j1.stats
+stats ${TEST_TMP}j4 | cmp ${TEST_TMP}j1.stats - >&2 || exit
+echo "# -j4 chunks"
+cat ${TEST_TMP}j1.stats
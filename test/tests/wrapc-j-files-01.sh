@@ -0,0 +1,8 @@
+# Wraps several files with more than one child process: the output of each
+# must be written in the order the files were given.
+wrapc -c /dev/null -j2 -w40 \
+  $DATA_DIR/long_comment-01.c \
+  $DATA_DIR/hello_01.c \
+  $DATA_DIR/hello_02.c \
+  $DATA_DIR/wrapc-box-01.sh \
+  $DATA_DIR/hello_03.c
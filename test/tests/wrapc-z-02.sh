@@ -0,0 +1,22 @@
+# Writes --stats to a file and prints its counters that don't depend on
+# timing.  With --jobs, the counters of each file must add up to the same
+# totals as wrapping each file by itself.
+stats() {
+  tr '{,}' '\n\n\n' < $1 | grep ':[0-9]' | grep -v '_s":'
+}
+sum() {
+  awk -F: '{ k[FNR] = $1; v[FNR] += $2 }
+    END { for ( i = 1; i <= FNR; ++i ) print k[i] ":" v[i] }' "$@"
+}
+
+files= each=
+for f in long_comment-01.c hello_01.c hello_02.c hello_03.c
+do
+  wrapc -c /dev/null -w40 -z${TEST_TMP}$f < $DATA_DIR/$f > /dev/null || exit
+  stats ${TEST_TMP}$f > ${TEST_TMP}$f.stats
+  files="$files $DATA_DIR/$f" each="$each ${TEST_TMP}$f.stats"
+done
+wrapc -c /dev/null -j2 -w40 -z${TEST_TMP}j2 $files > /dev/null || exit
+stats ${TEST_TMP}j2 > ${TEST_TMP}j2.stats
+sum $each | cmp - ${TEST_TMP}j2.stats >&2 || exit
+cat ${TEST_TMP}j2.stats